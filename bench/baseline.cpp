@@ -0,0 +1,203 @@
+/*****************************************************************/ /**
+ * @file   baseline.cpp
+ * @brief  Contains the implementation of 'baseline.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include "baseline.h"
+
+namespace clt::bench
+{
+  /// @brief Parses an unsigned integer at the beginning of a string
+  /// @param str The string
+  /// @return The integer or None on errors
+  static Option<u64> parse_u64(StringView str) noexcept
+  {
+    u64 value = 0;
+    auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (err != std::errc{})
+      return None;
+    return value;
+  }
+
+  /// @brief Parses the result of a benchmark
+  /// @param object The JSON object of the result
+  /// @return The result or None on errors
+  static Option<BaselineResult> parse_result(StringView object) noexcept
+  {
+    static constexpr StringView NAME    = "{\"name\": \"";
+    static constexpr StringView SIZE    = "\"size\": ";
+    static constexpr StringView SAMPLES = "\"samples\": [";
+
+    const size_t name_end = object.find('"', NAME.size());
+    const size_t size_pos = object.find(SIZE);
+    const size_t list_pos = object.find(SAMPLES);
+    if (name_end == StringView::npos || size_pos == StringView::npos
+        || list_pos == StringView::npos)
+      return None;
+
+    auto size = parse_u64(object.substr(size_pos + SIZE.size()));
+    if (size.is_none())
+      return None;
+    BaselineResult result = {
+        String{object.substr(NAME.size(), name_end - NAME.size())}, *size, {}};
+
+    auto list = object.substr(list_pos + SAMPLES.size());
+    list      = list.substr(0, list.find(']'));
+    while (!list.empty())
+    {
+      auto sample = parse_u64(list);
+      if (sample.is_none())
+        return None;
+      result.samples.push_back(*sample);
+      const size_t comma = list.find(", ");
+      list = comma == StringView::npos ? StringView{} : list.substr(comma + 2);
+    }
+    if (result.samples.is_empty())
+      return None;
+    return result;
+  }
+
+  Option<Vector<BaselineResult>> load_baseline(const char* path) noexcept
+  {
+    static constexpr StringView NAME = "{\"name\": \"";
+
+    auto file = String::getFile(path);
+    if (file.is_error())
+      return None;
+    const auto json = StringView{*file};
+
+    Vector<BaselineResult> results;
+    size_t begin = json.find(NAME);
+    while (begin != StringView::npos)
+    {
+      const size_t end = json.find(NAME, begin + NAME.size());
+      auto result      = parse_result(json.substr(begin, end - begin));
+      if (result.is_none())
+        return None;
+      results.push_back(std::move(*result));
+      begin = end;
+    }
+    return results;
+  }
+
+  double mann_whitney_greater(View<u64> current, View<u64> baseline) noexcept
+  {
+    const size_t n1 = current.size();
+    const size_t n2 = baseline.size();
+    if (n1 == 0 || n2 == 0)
+      return 1.0;
+
+    // Pairs of (value, is from 'current'), sorted to compute ranks
+    Vector<std::pair<u64, bool>> all = Vector<std::pair<u64, bool>>(n1 + n2);
+    for (auto value : current)
+      all.push_back({value, true});
+    for (auto value : baseline)
+      all.push_back({value, false});
+    std::sort(all.begin(), all.end());
+
+    // Sum of the ranks of 'current' (ties get their average rank)
+    double rank_sum = 0.0;
+    double ties     = 0.0;
+    for (size_t i = 0; i < all.size();)
+    {
+      size_t j = i;
+      while (j < all.size() && all[j].first == all[i].first)
+        j++;
+      const double rank = static_cast<double>(i + j + 1) / 2.0;
+      for (size_t k = i; k < j; k++)
+        if (all[k].second)
+          rank_sum += rank;
+      const double t = static_cast<double>(j - i);
+      ties += t * t * t - t;
+      i = j;
+    }
+
+    const double a     = static_cast<double>(n1);
+    const double b     = static_cast<double>(n2);
+    const double n     = a + b;
+    const double u     = rank_sum - a * (a + 1.0) / 2.0;
+    const double mean  = a * b / 2.0;
+    const double sigma =
+        std::sqrt(a * b / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0))));
+    if (sigma == 0.0)
+      return u > mean ? 0.0 : 1.0;
+    // Continuity correction
+    const double z = (u - mean - 0.5) / sigma;
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+  }
+
+  /// @brief Returns the median of samples
+  /// @param samples The samples (not empty)
+  /// @return The median
+  static double median(View<u64> samples) noexcept
+  {
+    Vector<u64> sorted = Vector<u64>(samples.size());
+    for (auto sample : samples)
+      sorted.push_back(sample);
+    std::sort(sorted.begin(), sorted.end());
+    const size_t count = sorted.size();
+    return count % 2 == 1 ? static_cast<double>(sorted[count / 2])
+                          : (static_cast<double>(sorted[count / 2 - 1])
+                             + static_cast<double>(sorted[count / 2]))
+                                / 2.0;
+  }
+
+  u32 compare_with_baseline(
+      View<BenchResult> results, View<BaselineResult> baseline,
+      u32 threshold) noexcept
+  {
+    u32 regressions = 0;
+    io::print_message(
+        "Comparison with the baseline (p < {}, threshold {}%):", SIGNIFICANCE,
+        threshold);
+    io::print(
+        "{: <48} {: >8} {: >14} {: >14} {: >9} {: >9}  {}", "Benchmark", "Size",
+        "Base (ns)", "Median (ns)", "Change", "p-value", "Verdict");
+    for (auto& result : results)
+    {
+      auto it = std::find_if(
+          baseline.begin(), baseline.end(),
+          [&](const BaselineResult& base)
+          {
+            return StringView{base.name} == result.name
+                   && base.size == result.size;
+          });
+      if (it == baseline.end())
+      {
+        io::print(
+            "{: <48} {: >8} {: >14} {: >14.0f} {: >9} {: >9}  {}", result.name,
+            result.size, "-", result.median_ns, "-", "-", "not in baseline");
+        continue;
+      }
+
+      const double base_median = median(it->samples);
+      const double change =
+          (result.median_ns - base_median) * 100.0 / std::max(base_median, 1.0);
+      const double slower = mann_whitney_greater(result.samples, it->samples);
+      const double faster = mann_whitney_greater(it->samples, result.samples);
+
+      StringView verdict = "";
+      if (slower < SIGNIFICANCE && change > static_cast<double>(threshold))
+      {
+        verdict = "REGRESSION";
+        regressions++;
+      }
+      else if (faster < SIGNIFICANCE && -change > static_cast<double>(threshold))
+        verdict = "improvement";
+      io::print(
+          "{: <48} {: >8} {: >14.0f} {: >14.0f} {: >8.1f}% {: >9.4f}  {}",
+          result.name, result.size, base_median, result.median_ns, change, slower,
+          verdict);
+    }
+    if (regressions != 0)
+      io::print_error("{} benchmark(s) regressed!", regressions);
+    else
+      io::print_message("No regression.");
+    return regressions;
+  }
+} // namespace clt::bench
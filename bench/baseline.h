@@ -0,0 +1,63 @@
+/*****************************************************************/ /**
+ * @file   baseline.h
+ * @brief  Contains the comparison of benchmark results with a baseline
+ * (the JSON written by a previous run through '-json').
+ * Each benchmark is compared using a one-sided Mann-Whitney U test on
+ * the timed runs, so that noise is not reported as a regression: a
+ * benchmark regressed if it is significantly slower AND its median is
+ * slower by more than a threshold.
+ *
+ * Timings depend on the machine: the baseline must be written on the
+ * machine that runs the comparison.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_BENCH_BASELINE
+#define HG_COLT_BENCH_BASELINE
+
+#include "bench.h"
+
+namespace clt::bench
+{
+  /// @brief The p-value under which a slowdown is significant
+  static constexpr double SIGNIFICANCE = 0.01;
+
+  /// @brief The result of a benchmark of the baseline
+  struct BaselineResult
+  {
+    /// @brief The name of the benchmark
+    String name;
+    /// @brief The number of items processed by each run
+    u64 size;
+    /// @brief The duration of each run in nanoseconds
+    Vector<u64> samples;
+  };
+
+  /// @brief Loads the results of a JSON written by 'Bench::write_json'.
+  /// This is not a general JSON parser: only the format written by
+  /// 'write_json' is supported.
+  /// @param path The path of the JSON
+  /// @return The results or None if the file could not be read or parsed
+  Option<Vector<BaselineResult>> load_baseline(const char* path) noexcept;
+
+  /// @brief Computes the p-value of the one-sided Mann-Whitney U test,
+  /// whose alternative hypothesis is that 'current' tends to be greater
+  /// than 'baseline'. The normal approximation (corrected for ties) is used.
+  /// @param current The samples of the current run
+  /// @param baseline The samples of the baseline
+  /// @return The p-value (1.0 if any of the samples is empty)
+  double mann_whitney_greater(View<u64> current, View<u64> baseline) noexcept;
+
+  /// @brief Compares the results with the baseline and prints the comparison
+  /// @param results The results of the current run
+  /// @param baseline The results of the baseline
+  /// @param threshold The slowdown of the median (in percent) under which
+  /// significant slowdowns are not reported as regressions
+  /// @return The number of regressions
+  u32 compare_with_baseline(
+      View<BenchResult> results, View<BaselineResult> baseline,
+      u32 threshold) noexcept;
+} // namespace clt::bench
+
+#endif // !HG_COLT_BENCH_BASELINE
@@ -0,0 +1,178 @@
+/*****************************************************************/ /**
+ * @file   bench.cpp
+ * @brief  Contains the implementation of 'bench.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "bench.h"
+#include "io/buffered_writer.h"
+
+#if defined(COLT_LINUX)
+  #include <sched.h>
+#elif defined(COLT_WINDOWS)
+  #define NOMINMAX
+  #include <Windows.h>
+#endif
+
+namespace clt::bench
+{
+  bool pin_to_cpu(u32 cpu) noexcept
+  {
+#if defined(COLT_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+#elif defined(COLT_WINDOWS)
+    if (cpu >= sizeof(DWORD_PTR) * 8)
+      return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    // macOS does not support pinning threads to a CPU
+    (void)cpu;
+    return false;
+#endif
+  }
+
+  /// @brief Formats an optional value
+  /// @param value The value
+  /// @return The formatted value or "-" if None
+  static std::string format_optional(Option<double> value) noexcept
+  {
+    if (value.is_none())
+      return "-";
+    return fmt::format("{:.3f}", *value);
+  }
+
+  /// @brief Returns a counter divided by the number of items
+  /// @param sample The counters of a run
+  /// @param counter The counter
+  /// @param size The number of items of a run
+  /// @return The counter per item or None if not available
+  static Option<double> per_item(
+      const perf::PerfSample& sample, perf::Counter counter, u64 size) noexcept
+  {
+    auto value = sample.get(counter);
+    if (value.is_none())
+      return None;
+    return static_cast<double>(*value) / static_cast<double>(clt::max<u64>(size, 1));
+  }
+
+  void Bench::add_result(
+      StringView name, u64 size, u64 allocs, u64 alloc_bytes,
+      const perf::PerfSample& sample) noexcept
+  {
+    std::sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+    u64 total          = 0;
+    for (auto sample : samples)
+      total += sample;
+    // Nearest-rank percentiles
+    const auto percentile = [&](size_t percent)
+    { return static_cast<double>(samples[(count * percent + 99) / 100 - 1]); };
+
+    results.push_back(BenchResult{
+        name, size, static_cast<u32>(count), static_cast<double>(samples[0]),
+        count % 2 == 1 ? static_cast<double>(samples[count / 2])
+                       : (static_cast<double>(samples[count / 2 - 1])
+                          + static_cast<double>(samples[count / 2]))
+                             / 2.0,
+        percentile(99), static_cast<double>(total) / static_cast<double>(count),
+        static_cast<double>(allocs) / static_cast<double>(count),
+        static_cast<double>(alloc_bytes) / static_cast<double>(count),
+        sample.divided_by(count), samples});
+  }
+
+  void Bench::print() const noexcept
+  {
+    // Allocations are only counted with COLT_MEM_REPORT
+    constexpr bool with_allocs = mem::is_mem_report_enabled();
+    io::print<"">(
+        "{: <48} {: >8} {: >14} {: >14} {: >10}", "Benchmark", "Size", "Median (ns)",
+        "P99 (ns)", "ns/item");
+    if constexpr (with_allocs)
+      io::print<"">(" {: >12} {: >14}", "Allocs/run", "Bytes/run");
+    if (options.counters)
+      io::print<"">(
+          " {: >8} {: >10} {: >12} {: >12}", "IPC", "BrMiss %", "L1D miss/it",
+          "LLC miss/it");
+    io::print("");
+    for (auto& result : results)
+    {
+      io::print<"">(
+          "{: <48} {: >8} {: >14.0f} {: >14.0f} {: >10.3f}", result.name, result.size,
+          result.median_ns, result.p99_ns,
+          result.median_ns / static_cast<double>(clt::max<u64>(result.size, 1)));
+      if constexpr (with_allocs)
+        io::print<"">(" {: >12.1f} {: >14.1f}", result.allocs, result.alloc_bytes);
+      if (options.counters)
+      {
+        const auto& sample = result.counters;
+        io::print<"">(
+            " {: >8} {: >10} {: >12} {: >12}", format_optional(sample.ipc()),
+            format_optional(sample.branch_miss_rate()),
+            format_optional(
+                per_item(sample, perf::Counter::L1D_MISSES, result.size)),
+            format_optional(
+                per_item(sample, perf::Counter::LLC_MISSES, result.size)));
+      }
+      io::print("");
+    }
+  }
+
+  ErrorFlag Bench::write_json(const char* path) const noexcept
+  {
+    auto out = io::BufferedWriter::open(path);
+    if (out.is_none())
+      return ErrorFlag::error();
+
+    fmt::memory_buffer buffer;
+    auto it = fmt::appender(buffer);
+    it      = fmt::format_to(
+        it, "{{\n  \"version\": \"{}\",\n  \"config\": \"{}\",\n  \"runs\": {},\n"
+            "  \"warmup\": {},\n  \"results\": [",
+        COLT_VERSION_STRING, COLT_CONFIG_STRING, options.runs, options.warmup);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+      const auto& result = results[i];
+      // Names never contain characters that must be escaped
+      it = fmt::format_to(
+          it,
+          "{}\n    {{\"name\": \"{}\", \"size\": {}, \"runs\": {}, \"min_ns\": {:.1f}, "
+          "\"median_ns\": {:.1f}, \"p99_ns\": {:.1f}, \"mean_ns\": {:.1f}",
+          i == 0 ? "" : ",", result.name, result.size, result.runs, result.min_ns,
+          result.median_ns, result.p99_ns, result.mean_ns);
+      if constexpr (mem::is_mem_report_enabled())
+        it = fmt::format_to(
+            it, ", \"allocs\": {:.1f}, \"alloc_bytes\": {:.1f}", result.allocs,
+            result.alloc_bytes);
+      if (options.counters)
+      {
+        // Counters per run, only those that were available
+        static constexpr std::array<const char*, perf::COUNTER_COUNT> NAMES = {
+            "cycles",        "instructions", "branches",
+            "branch_misses", "l1d_misses",   "llc_misses"};
+        it = fmt::format_to(it, ", \"counters\": {{");
+        bool first = true;
+        for (size_t j = 0; j < perf::COUNTER_COUNT; j++)
+        {
+          auto value = result.counters.get(static_cast<perf::Counter>(j));
+          if (value.is_none())
+            continue;
+          it = fmt::format_to(
+              it, "{}\"{}\": {}", first ? "" : ", ", NAMES[j], *value);
+          first = false;
+        }
+        it = fmt::format_to(it, "}}");
+      }
+      it = fmt::format_to(it, ", \"samples\": [");
+      for (size_t j = 0; j < result.samples.size(); j++)
+        it = fmt::format_to(it, "{}{}", j == 0 ? "" : ", ", result.samples[j]);
+      it = fmt::format_to(it, "]}}");
+    }
+    it = fmt::format_to(it, "\n  ]\n}}\n");
+    out->write(StringView{buffer.data(), buffer.size()});
+    return out->flush();
+  }
+} // namespace clt::bench
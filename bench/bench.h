@@ -0,0 +1,196 @@
+/*****************************************************************/ /**
+ * @file   bench.h
+ * @brief  Contains Bench, the microbenchmark harness of 'colt_bench'.
+ * Each benchmark is warmed up, then timed over many runs, and the
+ * median and 99th percentile of the runs are reported.
+ * Results can be written as JSON so that runs can be compared.
+ * When built with the COLT_MEM_REPORT CMake option, the allocations
+ * done through the global allocator are also reported (counting them
+ * slows allocations down, so timings are not comparable to other builds).
+ * With 'counters', the hardware counters (see 'perf_counters.h') are
+ * read around the timed runs, and reported as IPC, branch miss rate
+ * and cache misses per item.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_BENCH
+#define HG_COLT_BENCH
+
+#include <chrono>
+#include <atomic>
+#include "common/colt_pch.h"
+#include "common/perf_counters.h"
+
+namespace clt::bench
+{
+  /// @brief The options of the harness
+  struct BenchOptions
+  {
+    /// @brief The number of untimed runs before measuring
+    u32 warmup = 3;
+    /// @brief The number of timed runs
+    u32 runs = 31;
+    /// @brief If not empty, only benchmarks whose name contains it are run
+    StringView filter = {};
+    /// @brief If true, reads the hardware counters around the timed runs
+    bool counters = false;
+  };
+
+  /// @brief The result of a benchmark
+  struct BenchResult
+  {
+    /// @brief The name of the benchmark (a literal)
+    StringView name;
+    /// @brief The number of items processed by each run
+    u64 size;
+    /// @brief The number of timed runs
+    u32 runs;
+    /// @brief The fastest run in nanoseconds
+    double min_ns;
+    /// @brief The median run in nanoseconds
+    double median_ns;
+    /// @brief The 99th percentile run in nanoseconds
+    double p99_ns;
+    /// @brief The mean run in nanoseconds
+    double mean_ns;
+    /// @brief The mean number of global allocations per run
+    double allocs;
+    /// @brief The mean bytes allocated through the global allocator per run
+    double alloc_bytes;
+    /// @brief The mean hardware counters per run (empty if not read)
+    perf::PerfSample counters;
+    /// @brief The duration of each run in nanoseconds (sorted)
+    Vector<u64> samples;
+  };
+
+  template<typename T>
+  /// @brief Prevents the compiler from optimizing away a value
+  /// @param value The value whose computation must be kept
+  inline void do_not_optimize(T& value) noexcept
+  {
+#if defined(COLT_MSVC)
+    // No inline assembly: a volatile read has the same effect
+    (void)*reinterpret_cast<const volatile char*>(&value);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+  }
+
+  /// @brief Pins the current thread to a CPU
+  /// @param cpu The index of the CPU
+  /// @return True if the thread was pinned
+  bool pin_to_cpu(u32 cpu) noexcept;
+
+  /// @brief Runs benchmarks and collects their results.
+  /// @code{.cpp}
+  /// Bench bench{options};
+  /// bench.run("Vector<u64>::push_back", 1024, [] {
+  ///   Vector<u64> vec;
+  ///   for (u64 i = 0; i < 1024; i++)
+  ///     vec.push_back(i);
+  ///   do_not_optimize(vec);
+  /// });
+  /// bench.write_json("results.json");
+  /// @endcode
+  class Bench
+  {
+    /// @brief The options
+    BenchOptions options;
+    /// @brief The results of the benchmarks that were run
+    Vector<BenchResult> results{};
+    /// @brief The duration of each run of the current benchmark
+    Vector<u64> samples{};
+    /// @brief The hardware counters (only started if 'options.counters')
+    perf::PerfCounters counters{};
+
+    /// @brief Computes the result of the current benchmark from 'samples'
+    /// @param name The name of the benchmark
+    /// @param size The number of items processed by each run
+    /// @param allocs The global allocations done by all the runs
+    /// @param alloc_bytes The bytes allocated by all the runs
+    /// @param sample The hardware counters of all the runs
+    void add_result(
+        StringView name, u64 size, u64 allocs, u64 alloc_bytes,
+        const perf::PerfSample& sample) noexcept;
+
+  public:
+    /// @brief Constructor
+    /// @param options The options of the harness
+    Bench(const BenchOptions& options) noexcept
+        : options(options)
+    {
+      assert_true("At least one run is required!", options.runs != 0);
+      if (options.counters && !counters.is_available())
+        io::print_warn("Hardware counters are not available on this machine!");
+    }
+
+    /// @brief Check if a benchmark should be run
+    /// @param name The name of the benchmark
+    /// @return True if the name matches the filter
+    bool matches(StringView name) const noexcept
+    {
+      return options.filter.empty() || name.find(options.filter) != StringView::npos;
+    }
+
+    template<typename Fn>
+    /// @brief Runs a benchmark (if it matches the filter)
+    /// @param name The name of the benchmark (a literal)
+    /// @param size The number of items processed by each run of 'fn'
+    /// @param fn The function to time
+    void run(StringView name, u64 size, Fn&& fn) noexcept
+    {
+      using clock = std::chrono::steady_clock;
+      if (!matches(name))
+        return;
+      for (u32 i = 0; i < options.warmup; i++)
+        fn();
+      samples.clear();
+      const u64 allocs      = mem::GlobalUsedStats.allocations();
+      const u64 alloc_bytes = mem::GlobalUsedStats.total();
+      if (options.counters)
+        counters.start();
+      for (u32 i = 0; i < options.runs; i++)
+      {
+        const auto start = clock::now();
+        fn();
+        const auto end = clock::now();
+        samples.push_back(static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count()));
+      }
+      const auto sample = options.counters ? counters.stop() : perf::PerfSample{};
+      add_result(
+          name, size, mem::GlobalUsedStats.allocations() - allocs,
+          mem::GlobalUsedStats.total() - alloc_bytes, sample);
+    }
+
+    /// @brief Returns the results of the benchmarks that were run
+    /// @return The results
+    View<BenchResult> bench_results() const noexcept { return results; }
+
+    /// @brief Prints the results as a table to stdout
+    void print() const noexcept;
+
+    /// @brief Writes the results as JSON
+    /// @param path The path of the file to write to
+    /// @return Success if the file was written
+    ErrorFlag write_json(const char* path) const noexcept;
+  };
+
+  /// @brief Registers the benchmarks of the containers and hashes
+  /// @param bench The harness
+  void bench_containers(Bench& bench) noexcept;
+
+  /// @brief Registers the benchmarks of the allocators
+  /// @param bench The harness
+  void bench_allocators(Bench& bench) noexcept;
+
+  /// @brief Registers the benchmarks of the front-end
+  /// @param bench The harness
+  /// @param corpus The directory of programs to parse (or empty)
+  void bench_frontend_suite(Bench& bench, StringView corpus) noexcept;
+} // namespace clt::bench
+
+#endif // !HG_COLT_BENCH
@@ -0,0 +1,144 @@
+/*****************************************************************/ /**
+ * @file   bench_alloc.cpp
+ * @brief  Benchmarks of the allocators of 'simple_alloc.h' and
+ * 'composable_alloc.h'.
+ * Each allocator is measured on two patterns: 'churn', which
+ * allocates and immediately frees a block (as temporaries do),
+ * and 'batch', which allocates blocks of mixed sizes before freeing
+ * them in reverse order (as a compilation phase does).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "bench.h"
+#include "mem/global_alloc.h"
+
+namespace clt::bench
+{
+  using namespace mem;
+
+  /// @brief The number of blocks allocated by each run
+  static constexpr std::array<u64, 3> COUNTS = {16, 1024, 16384};
+  /// @brief The sizes of the blocks of the 'batch' pattern
+  static constexpr std::array<u64, 4> BATCH_SIZES = {16, 48, 128, 512};
+
+  template<typename Alloc>
+  /// @brief Allocates a block (SaveSizeAllocator returns a pointer)
+  /// @param alloc The allocator
+  /// @param size The size of the block
+  /// @return The block
+  static MemBlock allocate(Alloc& alloc, u64 size) noexcept
+  {
+    if constexpr (std::is_same_v<decltype(alloc.alloc(ByteSize<Byte>{size})), void*>)
+      return MemBlock{alloc.alloc(ByteSize<Byte>{size}), size};
+    else
+      return alloc.alloc(ByteSize<Byte>{size});
+  }
+
+  template<typename Alloc>
+  /// @brief Frees a block (SaveSizeAllocator takes a pointer)
+  /// @param alloc The allocator
+  /// @param blk The block to free
+  static void deallocate(Alloc& alloc, MemBlock blk) noexcept
+  {
+    if constexpr (std::is_same_v<decltype(alloc.alloc(ByteSize<Byte>{1})), void*>)
+      alloc.dealloc(blk.ptr());
+    else
+      alloc.dealloc(blk);
+  }
+
+  template<typename Alloc>
+  /// @brief Benchmarks an allocator on the 'churn' pattern
+  /// @param bench The harness
+  /// @param name The name of the benchmark
+  /// @param alloc The allocator
+  /// @param count The number of blocks allocated by each run
+  static void bench_churn(
+      Bench& bench, StringView name, Alloc& alloc, u64 count) noexcept
+  {
+    bench.run(
+        name, count,
+        [&]
+        {
+          for (u64 i = 0; i < count; i++)
+          {
+            auto blk = allocate(alloc, 64);
+            do_not_optimize(blk);
+            deallocate(alloc, blk);
+          }
+        });
+  }
+
+  template<typename Alloc>
+  /// @brief Benchmarks an allocator on the 'batch' pattern
+  /// @param bench The harness
+  /// @param name The name of the benchmark
+  /// @param alloc The allocator
+  /// @param count The number of blocks allocated by each run
+  /// @param blocks The storage for the blocks (reused across runs)
+  static void bench_batch(
+      Bench& bench, StringView name, Alloc& alloc, u64 count,
+      Vector<MemBlock>& blocks) noexcept
+  {
+    bench.run(
+        name, count,
+        [&]
+        {
+          blocks.clear();
+          for (u64 i = 0; i < count; i++)
+            blocks.push_back(allocate(alloc, BATCH_SIZES[i % BATCH_SIZES.size()]));
+          do_not_optimize(blocks);
+          for (size_t i = blocks.size(); i != 0; i--)
+            deallocate(alloc, blocks[i - 1]);
+        });
+  }
+
+  void bench_allocators(Bench& bench) noexcept
+  {
+    // Allocators are stateful: they are shared by all the runs, so that
+    // free lists are measured warm, as they are in the compiler.
+    static NULLAllocator null_alloc;
+    static Mallocator mallocator;
+    static StackAllocator<64_KiB> stack;
+    static FreeList<Mallocator, 16_B, 4_KiB, 1024> free_list;
+    static FallbackAllocator<StackAllocator<256_KiB>, Mallocator> fallback;
+    static Segregator<
+        256_B, FreeList<Mallocator, 16_B, 256_B, 1024>,
+        FreeList<Mallocator, 256_B, 4_KiB, 1024>>
+        segregator;
+    static AffixAllocator<Mallocator, u64, void> affix;
+    static MemCorruptDetector<Mallocator, 16_B> corrupt_detector;
+    static AbortOnNULLAllocator<Mallocator> abort_on_null;
+    static SaveSizeAllocator<FreeList<Mallocator, 16_B, 4_KiB, 1024>> save_size;
+    static ThreadSafeAllocator<FreeList<Mallocator, 16_B, 4_KiB, 1024>> thread_safe;
+
+    Vector<MemBlock> blocks = Vector<MemBlock>(COUNTS.back());
+    for (auto count : COUNTS)
+    {
+      bench_churn(bench, "NULLAllocator (churn)", null_alloc, count);
+      bench_churn(bench, "Mallocator (churn)", mallocator, count);
+      bench_churn(bench, "StackAllocator (churn)", stack, count);
+      bench_churn(bench, "FreeList (churn)", free_list, count);
+      bench_churn(bench, "FallbackAllocator (churn)", fallback, count);
+      bench_churn(bench, "Segregator (churn)", segregator, count);
+      bench_churn(bench, "AffixAllocator (churn)", affix, count);
+      bench_churn(bench, "MemCorruptDetector (churn)", corrupt_detector, count);
+      bench_churn(bench, "AbortOnNULLAllocator (churn)", abort_on_null, count);
+      bench_churn(bench, "SaveSizeAllocator (churn)", save_size, count);
+      bench_churn(bench, "ThreadSafeAllocator (churn)", thread_safe, count);
+      bench_churn(bench, "GlobalAllocator (churn)", GlobalAllocator, count);
+
+      // StackAllocator alone cannot hold the biggest batches
+      bench_batch(bench, "Mallocator (batch)", mallocator, count, blocks);
+      bench_batch(bench, "FreeList (batch)", free_list, count, blocks);
+      bench_batch(bench, "FallbackAllocator (batch)", fallback, count, blocks);
+      bench_batch(bench, "Segregator (batch)", segregator, count, blocks);
+      bench_batch(bench, "AffixAllocator (batch)", affix, count, blocks);
+      bench_batch(bench, "MemCorruptDetector (batch)", corrupt_detector, count, blocks);
+      bench_batch(bench, "AbortOnNULLAllocator (batch)", abort_on_null, count, blocks);
+      bench_batch(bench, "SaveSizeAllocator (batch)", save_size, count, blocks);
+      bench_batch(bench, "ThreadSafeAllocator (batch)", thread_safe, count, blocks);
+      bench_batch(bench, "GlobalAllocator (batch)", GlobalAllocator, count, blocks);
+    }
+  }
+} // namespace clt::bench
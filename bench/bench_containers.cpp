@@ -0,0 +1,269 @@
+/*****************************************************************/ /**
+ * @file   bench_containers.cpp
+ * @brief  Benchmarks of the containers of 'util/structs' and of
+ * the 'hash<>' specializations.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "bench.h"
+
+namespace clt::bench
+{
+  /// @brief The number of items processed by each run
+  static constexpr std::array<u64, 3> SIZES = {16, 1024, 16384};
+
+  /// @brief Generates deterministic pseudo-random keys (xorshift64)
+  /// @param count The number of keys to generate
+  /// @return The keys
+  static Vector<u64> make_keys(u64 count) noexcept
+  {
+    Vector<u64> keys = Vector<u64>(count);
+    u64 state        = 0x9E37'79B9'7F4A'7C15;
+    for (u64 i = 0; i < count; i++)
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      keys.push_back(state);
+    }
+    return keys;
+  }
+
+  /// @brief Generates identifier-like strings, as found in source code
+  /// @param keys The keys from which to generate the strings
+  /// @return The strings
+  static Vector<String> make_strings(View<u64> keys) noexcept
+  {
+    Vector<String> strings = Vector<String>(keys.size());
+    for (auto key : keys)
+    {
+      String str;
+      auto formatted = fmt::format("identifier_{:x}", key % 1'000'000'007);
+      str.push_back(StringView{formatted.data(), formatted.size()});
+      strings.push_back(std::move(str));
+    }
+    return strings;
+  }
+
+  /// @brief Benchmarks Vector, FlatList and String
+  /// @param bench The harness
+  /// @param keys The keys to insert
+  static void bench_sequences(Bench& bench, View<u64> keys) noexcept
+  {
+    const u64 size = keys.size();
+    bench.run(
+        "Vector<u64>::push_back", size,
+        [&]
+        {
+          Vector<u64> vec;
+          for (auto key : keys)
+            vec.push_back(key);
+          do_not_optimize(vec);
+        });
+    bench.run(
+        "Vector<u64>::push_back (reserved)", size,
+        [&]
+        {
+          Vector<u64> vec = Vector<u64>(size);
+          for (auto key : keys)
+            vec.push_back(key);
+          do_not_optimize(vec);
+        });
+    Vector<u64> filled = Vector<u64>(size);
+    for (auto key : keys)
+      filled.push_back(key);
+    bench.run(
+        "Vector<u64>::iterate", size,
+        [&]
+        {
+          u64 sum = 0;
+          for (auto value : filled)
+            sum += value;
+          do_not_optimize(sum);
+        });
+
+    bench.run(
+        "FlatList<u64>::push_back", size,
+        [&]
+        {
+          FlatList<u64> list;
+          for (auto key : keys)
+            list.push_back(key);
+          do_not_optimize(list);
+        });
+    FlatList<u64, 64> list;
+    for (auto key : keys)
+      list.push_back(key);
+    bench.run(
+        "FlatList<u64, 64>::iterate", size,
+        [&]
+        {
+          u64 sum = 0;
+          for (auto value : list)
+            sum += value;
+          do_not_optimize(sum);
+        });
+
+    bench.run(
+        "String::push_back(char)", size,
+        [&]
+        {
+          String str;
+          for (auto key : keys)
+            str.push_back(static_cast<char>('a' + key % 26));
+          do_not_optimize(str);
+        });
+    bench.run(
+        "String::push_back(StringView)", size,
+        [&]
+        {
+          String str;
+          for (u64 i = 0; i < size; i++)
+            str.push_back("identifier");
+          do_not_optimize(str);
+        });
+  }
+
+  /// @brief Benchmarks Map, StableSet and IndexedSet
+  /// @param bench The harness
+  /// @param keys The keys to insert
+  /// @param strings The strings to insert
+  static void bench_associative(
+      Bench& bench, View<u64> keys, View<String> strings) noexcept
+  {
+    const u64 size = keys.size();
+    bench.run(
+        "Map<u64, u64>::insert", size,
+        [&]
+        {
+          Map<u64, u64> map;
+          for (auto key : keys)
+            map.insert(key, key);
+          do_not_optimize(map);
+        });
+    Map<u64, u64> map;
+    for (auto key : keys)
+      map.insert(key, key);
+    bench.run(
+        "Map<u64, u64>::find (hit)", size,
+        [&]
+        {
+          u64 found = 0;
+          for (auto key : keys)
+            found += map.find(key) != nullptr;
+          do_not_optimize(found);
+        });
+    bench.run(
+        "Map<u64, u64>::find (miss)", size,
+        [&]
+        {
+          u64 found = 0;
+          for (auto key : keys)
+            found += map.find(~key) != nullptr;
+          do_not_optimize(found);
+        });
+    bench.run(
+        "Map<StringView, u64>::insert", size,
+        [&]
+        {
+          Map<StringView, u64> map;
+          for (u64 i = 0; i < size; i++)
+            map.insert(strings[i], i);
+          do_not_optimize(map);
+        });
+
+    bench.run(
+        "StableSet<u64>::insert", size,
+        [&]
+        {
+          StableSet<u64> set;
+          for (auto key : keys)
+            set.insert(key);
+          do_not_optimize(set);
+        });
+    bench.run(
+        "IndexedSet<u64>::insert", size,
+        [&]
+        {
+          IndexedSet<u64> set;
+          for (auto key : keys)
+            set.insert(key);
+          do_not_optimize(set);
+        });
+    bench.run(
+        "IndexedSet<StringView>::insert", size,
+        [&]
+        {
+          IndexedSet<StringView> set;
+          for (auto& str : strings)
+            set.insert(str);
+          do_not_optimize(set);
+        });
+  }
+
+  /// @brief Benchmarks the 'hash<>' specializations
+  /// @param bench The harness
+  /// @param keys The keys to hash
+  /// @param strings The strings to hash
+  static void bench_hashes(
+      Bench& bench, View<u64> keys, View<String> strings) noexcept
+  {
+    const u64 size = keys.size();
+    bench.run(
+        "hash<u64>", size,
+        [&]
+        {
+          size_t seed = 0;
+          for (auto key : keys)
+            seed ^= hash_value(key);
+          do_not_optimize(seed);
+        });
+    bench.run(
+        "hash<u32>", size,
+        [&]
+        {
+          size_t seed = 0;
+          for (auto key : keys)
+            seed ^= hash_value(static_cast<u32>(key));
+          do_not_optimize(seed);
+        });
+    bench.run(
+        "hash<double>", size,
+        [&]
+        {
+          size_t seed = 0;
+          for (auto key : keys)
+            seed ^= hash_value(static_cast<double>(key));
+          do_not_optimize(seed);
+        });
+    bench.run(
+        "hash<StringView>", size,
+        [&]
+        {
+          size_t seed = 0;
+          for (auto& str : strings)
+            seed ^= hash_value(StringView{str});
+          do_not_optimize(seed);
+        });
+    bench.run(
+        "hash<View<u64>>", size,
+        [&]
+        {
+          size_t seed = hash_value(keys);
+          do_not_optimize(seed);
+        });
+  }
+
+  void bench_containers(Bench& bench) noexcept
+  {
+    for (auto size : SIZES)
+    {
+      const auto keys    = make_keys(size);
+      const auto strings = make_strings(keys);
+      bench_sequences(bench, keys);
+      bench_associative(bench, keys, strings);
+      bench_hashes(bench, keys, strings);
+    }
+  }
+} // namespace clt::bench
@@ -0,0 +1,116 @@
+/*****************************************************************/ /**
+ * @file   bench_frontend_suite.cpp
+ * @brief  Benchmarks of the front-end (lexing and AST construction),
+ * on a corpus of example programs and on generated programs.
+ * These catch superlinear regressions that the functional tests
+ * cannot (see '-bench-frontend' of the compiler to measure scaling).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "bench.h"
+#include "ast/ast.h"
+#include "err/composable_reporter.h"
+#include "bench/source_generator.h"
+
+namespace clt::bench
+{
+  /// @brief The sizes of the generated programs
+  static constexpr std::array<u64, 2> GENERATED_SIZES = {16 * 1024, 64 * 1024};
+
+  /// @brief Loads the programs of the corpus (sorted by path)
+  /// @param corpus The directory containing the programs
+  /// @return The programs
+  static Vector<String> load_corpus(StringView corpus) noexcept
+  {
+    Vector<String> programs;
+    if (corpus.empty())
+      return programs;
+
+    std::error_code err;
+    const auto path = std::filesystem::path{
+        std::string_view{corpus.data(), corpus.size()}};
+    Vector<std::filesystem::path> paths;
+    for (auto& entry : std::filesystem::directory_iterator{path, err})
+      if (entry.is_regular_file(err))
+        paths.push_back(entry.path());
+    if (err)
+      io::print_warn("Could not read the corpus '{}'!", corpus);
+    std::sort(paths.begin(), paths.end());
+
+    for (auto& file : paths)
+    {
+      auto content = String::getFile(file.string().c_str());
+      if (content.is_error())
+        io::print_warn("Could not read '{}'!", file.string());
+      else
+        programs.push_back(std::move(*content));
+    }
+    return programs;
+  }
+
+  /// @brief Benchmarks lexing and parsing a set of programs
+  /// @param bench The harness
+  /// @param lex_name The name of the lexing benchmark (a literal)
+  /// @param parse_name The name of the parsing benchmark (a literal)
+  /// @param programs The programs, processed in order by each run
+  static void bench_programs(
+      Bench& bench, StringView lex_name, StringView parse_name,
+      View<String> programs) noexcept
+  {
+    using namespace lng;
+
+    u64 size = 0;
+    for (auto& program : programs)
+      size += program.size();
+    if (size == 0)
+      return;
+
+    auto reporter = make_error_reporter<SinkReporter>();
+    const Vector<std::filesystem::path> includes = {};
+    bench.run(
+        lex_name, size,
+        [&]
+        {
+          for (auto& program : programs)
+          {
+            auto buffer = lex(*reporter, program);
+            do_not_optimize(buffer);
+          }
+        });
+    bench.run(
+        parse_name, size,
+        [&]
+        {
+          for (auto& program : programs)
+          {
+            auto parsed = ParsedProgram{
+                *reporter, StringView{program}, includes, WarnFor::warn_all()};
+            do_not_optimize(parsed);
+          }
+        });
+  }
+
+  void bench_frontend_suite(Bench& bench, StringView corpus) noexcept
+  {
+    // The AST must not be printed while timing
+    const bool print_ast = lng::DebugPrintAST;
+    lng::DebugPrintAST   = false;
+    ON_SCOPE_EXIT
+    {
+      lng::DebugPrintAST = print_ast;
+    };
+
+    const auto programs = load_corpus(corpus);
+    bench_programs(
+        bench, "Frontend::lex (corpus)", "Frontend::parse (corpus)", programs);
+    for (auto size : GENERATED_SIZES)
+    {
+      const auto program = generate_source(SourceShape{}, size);
+      bench_programs(
+          bench, "Frontend::lex (generated)", "Frontend::parse (generated)",
+          View<String>{&program, 1});
+    }
+  }
+} // namespace clt::bench
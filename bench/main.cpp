@@ -0,0 +1,119 @@
+/*****************************************************************/ /**
+ * @file   main.cpp
+ * @brief  Starting point of 'colt_bench', the microbenchmarks of
+ * the util containers and allocators, and of the front-end.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "bench.h"
+#include "baseline.h"
+#include "io/args_parsing.h"
+
+namespace clt::bench
+{
+  /// @brief The number of untimed runs
+  inline u32 WarmupRuns = 3;
+  /// @brief The number of timed runs
+  inline u32 TimedRuns = 31;
+  /// @brief Only runs the benchmarks whose name contains the filter
+  inline std::string_view Filter = {};
+  /// @brief The CPU to which to pin the benchmarks
+  inline Option<u32> PinnedCPU = None;
+  /// @brief The path of the JSON results (or empty)
+  inline std::string_view JSONFile = {};
+  /// @brief Read the hardware counters around the benchmarks
+  inline bool HardwareCounters = false;
+  /// @brief The directory of programs used by the front-end benchmarks
+  inline std::string_view Corpus = {};
+  /// @brief The path of the JSON results to compare with (or empty)
+  inline std::string_view BaselineFile = {};
+  /// @brief The slowdown (in percent) under which regressions are ignored
+  inline u32 Threshold = 10;
+
+  /// @brief The command line arguments of 'colt_bench'
+  using CMDs = meta::type_list<
+      cl::Opt<
+          "nocolor", cl::desc<"Turns off colored output">, cl::alias<"C">,
+          cl::callback<[] { clt::io::OutputColor = false; }>>,
+      cl::Opt<
+          "warmup", cl::desc<"Number of untimed runs of each benchmark">,
+          cl::value_desc<"count">, cl::location<WarmupRuns>>,
+      cl::Opt<
+          "runs", cl::desc<"Number of timed runs of each benchmark">,
+          cl::value_desc<"count">, cl::location<TimedRuns>>,
+      cl::Opt<
+          "filter", cl::desc<"Only runs benchmarks whose name contains the filter">,
+          cl::value_desc<"name">, cl::location<Filter>>,
+      cl::Opt<
+          "pin", cl::desc<"Pins the benchmarks to a CPU">,
+          cl::value_desc<"[None|cpu]">, cl::location<PinnedCPU>>,
+      cl::Opt<
+          "json", cl::desc<"Writes the results as JSON">,
+          cl::value_desc<"file_path">, cl::location<JSONFile>>,
+      cl::Opt<
+          "counters", cl::desc<"Reports hardware counters (IPC, misses...)">,
+          cl::callback<[] { clt::bench::HardwareCounters = true; }>>,
+      cl::Opt<
+          "corpus", cl::desc<"Directory of programs for the front-end benchmarks">,
+          cl::value_desc<"directory">, cl::location<Corpus>>,
+      cl::Opt<
+          "baseline",
+          cl::desc<"Compares with the results of a previous '-json' run">,
+          cl::value_desc<"file_path">, cl::location<BaselineFile>>,
+      cl::Opt<
+          "threshold",
+          cl::desc<"Slowdown (in %) under which regressions are ignored">,
+          cl::value_desc<"percent">, cl::location<Threshold>>>;
+} // namespace clt::bench
+
+using namespace clt;
+
+int main(int argc, const char** argv)
+{
+  cl::parse_command_line_options<bench::CMDs>(
+      argc, argv, "colt_bench",
+      "Microbenchmarks of the Colt util library and front-end.");
+  if (bench::TimedRuns == 0)
+  {
+    io::print_error("'-runs' must be at least 1!");
+    return 1;
+  }
+  if (bench::PinnedCPU.is_value() && !bench::pin_to_cpu(*bench::PinnedCPU))
+    io::print_warn("Could not pin the benchmarks to CPU {}!", *bench::PinnedCPU);
+
+  auto harness = bench::Bench{bench::BenchOptions{
+      bench::WarmupRuns, bench::TimedRuns,
+      StringView{bench::Filter.data(), bench::Filter.size()},
+      bench::HardwareCounters}};
+  bench::bench_containers(harness);
+  bench::bench_allocators(harness);
+  bench::bench_frontend_suite(
+      harness, StringView{bench::Corpus.data(), bench::Corpus.size()});
+  harness.print();
+
+  if (!bench::JSONFile.empty())
+  {
+    const auto path = std::string{bench::JSONFile};
+    if (harness.write_json(path.c_str()).is_error())
+    {
+      io::print_error("Could not write results to '{}'!", path);
+      return 1;
+    }
+  }
+
+  if (!bench::BaselineFile.empty())
+  {
+    const auto path = std::string{bench::BaselineFile};
+    auto baseline   = bench::load_baseline(path.c_str());
+    if (baseline.is_none())
+    {
+      io::print_error("Could not load the baseline '{}'!", path);
+      return 1;
+    }
+    if (bench::compare_with_baseline(
+            harness.bench_results(), *baseline, bench::Threshold)
+        != 0)
+      return 1;
+  }
+}
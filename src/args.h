@@ -10,8 +10,10 @@
 
 #include <io/print.h>
 #include "common/colt_config.h"
+#include "common/cpu_features.h"
 #include <io/args_parsing.h>
 #include <err/warn.h>
+#include "structs/vector.h"
 
 #define NO_WARN_FOR_ARG(name, descr, member) \
   cl::Opt<"!W" name, cl::desc<descr>, cl::callback<[] { member = false; }>>
@@ -26,15 +28,91 @@ namespace clt
   inline u8 OutputSpace = 2;
   /// @brief The output file name
   inline std::string_view OutputFile = {};
-  /// @brief The input file name
-  inline std::string_view InputFile = {};
+  /// @brief The input file names (which may be response files: '@path')
+  inline Vector<std::string_view> InputFiles = {};
+  /// @brief The number of files to compile concurrently (0 for one per
+  /// hardware thread)
+  inline u32 JobCount = 0;
+  /// @brief True if '-j' was specified
+  inline bool JobCountSet = false;
   /// @brief The file whose info to print
   inline std::string_view DisasmFile = {};
+  /// @brief The only section to disassemble (or empty for all)
+  inline std::string_view DisasmSection = {};
+  /// @brief The offset from which to disassemble code sections
+  inline u64 DisasmFrom = 0;
+  /// @brief The offset until which to disassemble code sections
+  inline u64 DisasmTo = std::numeric_limits<u64>::max();
+
+  /// @brief Print the time taken by each phase of the compiler
+  inline bool TimeReport = false;
+  /// @brief The path of the Chrome trace to write (or empty)
+  inline std::string_view TraceFile = {};
+  /// @brief Print the memory used by the data structures of the compiler
+  inline bool MemReport = false;
+  /// @brief Discard the tokens of each unit once its AST is built
+  inline bool LowMemory = false;
+
+  /// @brief The socket on which to run the compile server (or empty)
+  inline std::string_view ServeSocket = {};
+  /// @brief The socket of the compile server to send the input file to
+  inline std::string_view ConnectSocket = {};
+
+  /// @brief The path of the module image to build from the input files
+  inline std::string_view EmitImageFile = {};
+  /// @brief The path of the module image to link before compiling
+  inline std::string_view ImageFile = {};
 
   /// @brief Lexer test file name
   inline std::string_view LexerTestFile = {};
+  /// @brief Directory of '.ct' tests to run in parallel
+  inline std::string_view TestCorpusDir = {};
   /// @brief Test Foreign Functional Inteface used by the interpreter
   inline bool FFITest = false;
+  /// @brief Test writing and loading of Colti executables
+  inline bool ColtiTest = false;
+  /// @brief Test the dispatched kernels at each CPU level
+  inline bool CpuTest = false;
+  /// @brief Test the rollback of rejected REPL lines
+  inline bool ReplTest = false;
+  /// @brief Test the encoding of the compile server requests
+  inline bool ServerTest = false;
+  /// @brief Test the compilation of many input files (-j N)
+  inline bool BatchTest = false;
+  /// @brief Test the source information of compacted units
+  inline bool LowMemoryTest = false;
+  /// @brief Test the position index against a linear scan
+  inline bool PositionIndexTest = false;
+  /// @brief Test the C backend
+  inline bool CBackendTest = false;
+  /// @brief Test building, loading and validating module images
+  inline bool ModuleImageTest = false;
+
+  /// @brief The level to which to restrict the CPU features (or empty)
+  inline std::string_view CpuLevelName = {};
+
+  /// @brief Benchmark the front-end
+  inline bool BenchFrontend = false;
+  /// @brief The size of the biggest program generated by the benchmark
+  inline u64 BenchMaxSize = 64 * 1024 * 1024;
+  /// @brief The number of timed runs for each size of the benchmark
+  inline u32 BenchRuns = 3;
+  /// @brief Stops the benchmark once a run takes longer (in seconds)
+  inline u32 BenchTimeBudget = 10;
+  /// @brief Print the hardware counters of each phase of the benchmark
+  inline bool BenchCounters = false;
+  /// @brief The maximum nesting of parenthesis in generated programs
+  inline u8 GenExprDepth = 3;
+  /// @brief The length of identifiers in generated programs
+  inline u8 GenIdentLen = 8;
+  /// @brief The percentage of operands that are literals in generated programs
+  inline u8 GenLiteralDensity = 70;
+  /// @brief The percentage of lines that are comments in generated programs
+  inline u8 GenCommentRatio = 10;
+  /// @brief The nesting of scopes in generated programs
+  inline u8 GenScopeDepth = 2;
+  /// @brief The number of locals per scope in generated programs
+  inline u8 GenLocals = 4;
 
   /// @brief The maximum number of messages
   inline Option<u16> MaxMessages = 128;
@@ -60,6 +138,18 @@ namespace clt
       to_validate = init;
     }
 
+    /// @brief Callback to restrict the CPU features to the level of '-cpu'
+    inline void select_cpu_level() noexcept
+    {
+      auto level = reflect<cpu::Level>::from(CpuLevelName);
+      if (level.is_none())
+        io::print_warn("'{}' is not a valid value for flag '-cpu'!", CpuLevelName);
+      else if (!cpu::set_level(*level))
+        io::print_warn(
+            "The CPU does not support all the features of '-cpu={}'!",
+            CpuLevelName);
+    }
+
     /// @brief Prints the current version of Colt and exits
     [[noreturn]] inline void print_version() noexcept
     {
@@ -111,12 +201,72 @@ namespace clt
 
       cl::Opt<"o", cl::desc<"Output file name">, cl::location<OutputFile>>,
 
-      cl::OptPos<"input_file", cl::desc<"The input file">, cl::location<InputFile>>,
+      cl::PosList<
+          "input_files", cl::desc<"The input files (or @file for response files)">,
+          cl::location<InputFiles>>,
+
+      cl::Opt<
+          "j", cl::desc<"Compiles multiple files concurrently (0 for all cores)">,
+          cl::value_desc<"jobs">, cl::location<JobCount>,
+          cl::callback<[] { clt::JobCountSet = true; }>>,
 
       cl::Opt<
           "disasm", cl::desc<"Disassembles a colti executable.">,
           cl::value_desc<"file_path">, cl::location<DisasmFile>>,
 
+      cl::Opt<
+          "disasm-section", cl::desc<"Only disassembles a section (if -disasm).">,
+          cl::value_desc<"name">, cl::location<DisasmSection>>,
+
+      cl::Opt<
+          "disasm-from", cl::desc<"Offset from which to disassemble code (if -disasm).">,
+          cl::value_desc<"offset">, cl::location<DisasmFrom>>,
+
+      cl::Opt<
+          "disasm-to", cl::desc<"Offset until which to disassemble code (if -disasm).">,
+          cl::value_desc<"offset">, cl::location<DisasmTo>>,
+
+      cl::Opt<
+          "time-report", cl::desc<"Prints the time taken by each phase">,
+          cl::callback<[] { clt::TimeReport = true; }>>,
+
+      cl::Opt<
+          "trace", cl::desc<"Writes the phases as a Chrome trace">,
+          cl::value_desc<"file_path">, cl::location<TraceFile>>,
+
+      cl::Opt<
+          "mem-report",
+          cl::desc<"Prints the memory used by the compiler (or -bench-frontend)">,
+          cl::callback<[] { clt::MemReport = true; }>>,
+
+      cl::Opt<
+          "low-memory",
+          cl::desc<"Discards the tokens of each file once its AST is built">,
+          cl::callback<[] { clt::LowMemory = true; }>>,
+
+      cl::Opt<
+          "cpu", cl::desc<"Restricts the CPU features used by the compiler">,
+          cl::value_desc<"[baseline|sse42|avx2|avx512|native]">,
+          cl::location<CpuLevelName>, cl::callback<&details::select_cpu_level>>,
+
+      cl::Opt<
+          "serve", cl::desc<"Runs a compile server on a UNIX socket">,
+          cl::value_desc<"socket_path">, cl::location<ServeSocket>>,
+
+      cl::Opt<
+          "connect",
+          cl::desc<"Compiles through a server (started with -serve)">,
+          cl::value_desc<"socket_path">, cl::location<ConnectSocket>>,
+
+      cl::Opt<
+          "emit-image",
+          cl::desc<"Builds a module image from the input files (a/b.ct is a.b)">,
+          cl::value_desc<"file_path">, cl::location<EmitImageFile>>,
+
+      cl::Opt<
+          "image", cl::desc<"Links a module image (built with -emit-image)">,
+          cl::value_desc<"file_path">, cl::location<ImageFile>>,
+
       cl::Opt<
           "run-tests", cl::desc<"Run unit tests on Debug configuration">,
           cl::callback<[] { clt::RunTests = true; }>>,
@@ -125,10 +275,100 @@ namespace clt
           "test-lexer", cl::desc<"Lexer test file name (if -run-tests)">,
           cl::location<LexerTestFile>, cl::value_desc<"file_path">>,
 
+      cl::Opt<
+          "test-dir", cl::desc<"Runs the .ct tests of a directory (if -run-tests)">,
+          cl::location<TestCorpusDir>, cl::value_desc<"dir_path">>,
+
       cl::Opt<"test-ffi", cl::desc<"Test FFI (if -run-tests)">, cl::callback<[] {
                 clt::FFITest = true;
               }>>,
 
+      cl::Opt<
+          "bench-frontend", cl::desc<"Benchmark lexing and AST construction">,
+          cl::callback<[] { clt::BenchFrontend = true; }>>,
+
+      cl::Opt<
+          "bench-max-size",
+          cl::desc<"Size of the biggest generated program (if -bench-frontend)">,
+          cl::value_desc<"bytes">, cl::location<BenchMaxSize>>,
+
+      cl::Opt<
+          "bench-runs",
+          cl::desc<"Number of timed runs per size (if -bench-frontend)">,
+          cl::value_desc<"count">, cl::location<BenchRuns>>,
+
+      cl::Opt<
+          "bench-budget",
+          cl::desc<"Stops once a run would take longer (if -bench-frontend)">,
+          cl::value_desc<"seconds">, cl::location<BenchTimeBudget>>,
+
+      cl::Opt<
+          "bench-counters",
+          cl::desc<"Prints hardware counters of each phase (if -bench-frontend)">,
+          cl::callback<[] { clt::BenchCounters = true; }>>,
+
+      cl::Opt<
+          "gen-depth", cl::desc<"Nesting of parenthesis in generated programs">,
+          cl::value_desc<"[0-32]">, cl::location<GenExprDepth>>,
+
+      cl::Opt<
+          "gen-ident", cl::desc<"Length of identifiers in generated programs">,
+          cl::value_desc<"[0-255]">, cl::location<GenIdentLen>>,
+
+      cl::Opt<
+          "gen-literals",
+          cl::desc<"Percentage of literal operands in generated programs">,
+          cl::value_desc<"[0-100]">, cl::location<GenLiteralDensity>>,
+
+      cl::Opt<
+          "gen-comments",
+          cl::desc<"Percentage of comment lines in generated programs">,
+          cl::value_desc<"[0-100]">, cl::location<GenCommentRatio>>,
+
+      cl::Opt<
+          "gen-scopes", cl::desc<"Nesting of scopes in generated programs">,
+          cl::value_desc<"[0-255]">, cl::location<GenScopeDepth>>,
+
+      cl::Opt<
+          "gen-locals", cl::desc<"Number of locals per scope in generated programs">,
+          cl::value_desc<"[0-255]">, cl::location<GenLocals>>,
+
+      cl::Opt<
+          "test-colti", cl::desc<"Test Colti executables (if -run-tests)">,
+          cl::callback<[] { clt::ColtiTest = true; }>>,
+
+      cl::Opt<
+          "test-cpu", cl::desc<"Test the kernels at each CPU level (if -run-tests)">,
+          cl::callback<[] { clt::CpuTest = true; }>>,
+
+      cl::Opt<
+          "test-repl", cl::desc<"Test the rollback of REPL lines (if -run-tests)">,
+          cl::callback<[] { clt::ReplTest = true; }>>,
+
+      cl::Opt<
+          "test-server", cl::desc<"Test the compile server requests (if -run-tests)">,
+          cl::callback<[] { clt::ServerTest = true; }>>,
+
+      cl::Opt<
+          "test-batch", cl::desc<"Test response files and the compilation of many files (if -run-tests)">,
+          cl::callback<[] { clt::BatchTest = true; }>>,
+
+      cl::Opt<
+          "test-low-memory", cl::desc<"Test the low-memory mode (if -run-tests)">,
+          cl::callback<[] { clt::LowMemoryTest = true; }>>,
+
+      cl::Opt<
+          "test-position-index", cl::desc<"Test the position index (if -run-tests)">,
+          cl::callback<[] { clt::PositionIndexTest = true; }>>,
+
+      cl::Opt<
+          "test-c-backend", cl::desc<"Test the C backend (if -run-tests)">,
+          cl::callback<[] { clt::CBackendTest = true; }>>,
+
+      cl::Opt<
+          "test-module-image", cl::desc<"Test the module image (if -run-tests)">,
+          cl::callback<[] { clt::ModuleImageTest = true; }>>,
+
       NO_WARN_FOR_ARG(
           "cf_nan", "No warnings for NaNs when constant folding.",
           GlobalWarnFor.constant_folding_nan),
@@ -0,0 +1,157 @@
+/*****************************************************************/ /**
+ * @file   c_code_writer.h
+ * @brief  Contains CodeWriter, used to generate indented source code.
+ * The code is appended to a String using bulk copies (rather than
+ * formatting each token), and the indentation of each line is a prefix
+ * of a precomputed string of spaces (see IndentTable).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_C_CODE_WRITER
+#define HG_COLT_C_CODE_WRITER
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "structs/string.h"
+
+namespace clt::c
+{
+  /// @brief The indentation strings of each depth.
+  /// All the indentations are prefixes of a single string of spaces.
+  class IndentTable
+  {
+    /// @brief The spaces of the deepest precomputed indentation
+    String spaces{};
+    /// @brief The count of spaces per depth
+    u8 _width;
+
+  public:
+    /// @brief The deepest precomputed indentation (deeper indentations
+    /// are written in multiple parts)
+    static constexpr u64 MAX_DEPTH = 64;
+
+    /// @brief Constructor
+    /// @param width The count of spaces per depth
+    IndentTable(u8 width) noexcept
+        : _width(width)
+    {
+      spaces.reserve(MAX_DEPTH * width);
+      spaces.push_back(' ', MAX_DEPTH * width);
+    }
+
+    /// @brief Returns the count of spaces per depth
+    /// @return The count of spaces per depth
+    u8 width() const noexcept { return _width; }
+
+    /// @brief Returns the indentation of a depth
+    /// @param depth The depth (at most MAX_DEPTH)
+    /// @return The indentation
+    StringView indent(u64 depth) const noexcept
+    {
+      assert_true("Depth is too big!", depth <= MAX_DEPTH);
+      return StringView{spaces.data(), depth * _width};
+    }
+  };
+
+  /// @brief Writes indented code to a String
+  class CodeWriter
+  {
+    /// @brief The output
+    String& output;
+    /// @brief The indentation strings
+    const IndentTable& indents;
+    /// @brief The current depth
+    u64 depth = 0;
+
+  public:
+    /// @brief Constructor
+    /// @param output The String to which to append the code
+    /// @param indents The indentation strings
+    CodeWriter(String& output, const IndentTable& indents) noexcept
+        : output(output)
+        , indents(indents)
+    {
+    }
+
+    /// @brief Appends a string
+    /// @param str The string to append
+    void write(StringView str) noexcept
+    {
+      if (output.capacity() - output.size() < str.size())
+        output.reserve(std::max(output.capacity(), str.size()));
+      std::memcpy(output.data() + output.size(), str.data(), str.size());
+      output._Unsafe_size(output.size() + str.size());
+    }
+
+    /// @brief Appends a character
+    /// @param chr The character to append
+    void write(char chr) noexcept { output.push_back(chr); }
+
+    template<meta::Integral T>
+    /// @brief Appends an integer (in decimal)
+    /// @param value The integer
+    void write_int(T value) noexcept
+    {
+      char buffer[24];
+      auto [end, _] = std::to_chars(buffer, buffer + sizeof buffer, value);
+      write(StringView{buffer, end});
+    }
+
+    template<std::floating_point T>
+    /// @brief Appends a finite floating point value as an exact
+    /// hexadecimal literal (without suffix)
+    /// @param value The value
+    void write_hex_float(T value) noexcept
+    {
+      assert_true("Value must be finite!", std::isfinite(value));
+      char buffer[48];
+      if (std::signbit(value))
+      {
+        write('-');
+        value = -value;
+      }
+      auto [end, _] = std::to_chars(
+          buffer, buffer + sizeof buffer, value, std::chars_format::hex);
+      write("0x");
+      write(StringView{buffer, end});
+    }
+
+    /// @brief Writes the indentation of the current depth
+    void indent() noexcept
+    {
+      u64 left = depth;
+      for (; left > IndentTable::MAX_DEPTH; left -= IndentTable::MAX_DEPTH)
+        write(indents.indent(IndentTable::MAX_DEPTH));
+      write(indents.indent(left));
+    }
+
+    /// @brief Writes an indented line
+    /// @param line The line (without new line)
+    void write_line(StringView line) noexcept
+    {
+      indent();
+      write(line);
+      write('\n');
+    }
+
+    /// @brief Writes an indented '{' line, and increments the depth
+    void open_block() noexcept
+    {
+      write_line("{");
+      ++depth;
+    }
+
+    /// @brief Decrements the depth, and writes an indented '}' line
+    void close_block() noexcept
+    {
+      assert_true("No block to close!", depth != 0);
+      --depth;
+      write_line("}");
+    }
+  };
+} // namespace clt::c
+
+#endif // !HG_COLT_C_CODE_WRITER
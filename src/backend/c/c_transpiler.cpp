@@ -0,0 +1,783 @@
+/*****************************************************************/ /**
+ * @file   c_transpiler.cpp
+ * @brief  Contains the implementation of 'c_transpiler.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "c_transpiler.h"
+#include "ast/ast.h"
+#include "io/buffered_writer.h"
+#include "common/parallel.h"
+#include "common/trace.h"
+
+namespace clt::c
+{
+  /// @brief The beginning of all the generated files
+  static constexpr StringView C_PRELUDE =
+      "/* Generated by the Colt compiler. */\n"
+      "#include <math.h>\n"
+      "#include <stdbool.h>\n"
+      "#include <stdint.h>\n\n";
+
+  /// @brief The C types of each built-in type (indexed by BuiltinID)
+  static constexpr std::array<StringView, 16> C_BUILTIN_NAMES = {
+      "bool",    "char",     "uint8_t", "uint16_t", "uint32_t", "uint64_t",
+      "int8_t",  "int16_t",  "int32_t", "int64_t",  "float",    "double",
+      "uint8_t", "uint16_t", "uint32_t", "uint64_t"};
+
+  /// @brief The minimum of each signed built-in type (indexed by size)
+  static constexpr std::array<StringView, 9> C_SIGNED_MIN = {
+      "", "INT8_MIN", "INT16_MIN", "", "INT32_MIN", "", "", "", "INT64_MIN"};
+
+  /// @brief Returns the size of a built-in type
+  /// @param id The built-in type
+  /// @return The size in bytes
+  static constexpr u64 sizeof_builtin(lng::BuiltinID id) noexcept
+  {
+    constexpr std::array<u8, 16> SIZES = {1, 1, 1, 2, 4, 8, 1, 2,
+                                          4, 8, 4, 8, 1, 2, 4, 8};
+    return SIZES[static_cast<u8>(id)];
+  }
+
+  /// @brief Returns the unsigned type in which the wrapping arithmetic
+  /// of an integral type is done (at least as wide as 'unsigned int',
+  /// as narrower types are promoted to 'int', which could overflow)
+  /// @param id The integral type
+  /// @return The unsigned type
+  static constexpr StringView wrapping_type(lng::BuiltinID id) noexcept
+  {
+    return sizeof_builtin(id) == 8 ? "uint64_t" : "uint32_t";
+  }
+
+  /// @brief Lowers the expressions of a unit
+  class UnitLowering
+  {
+    /// @brief The expressions of the unit
+    const lng::ExprBuffer& exprs;
+    /// @brief The types of the program
+    const lng::TypeBuffer& types;
+    /// @brief The writer to which to write
+    CodeWriter writer;
+    /// @brief The ID of the unit
+    u64 unit_id;
+
+    /// @brief Returns the expression represented by a token
+    /// @param tkn The token
+    /// @return The expression
+    const lng::ExprBase& expr(lng::ProdExprToken tkn) const noexcept
+    {
+      return *exprs.expr(tkn).as_base();
+    }
+    /// @brief Returns the expression represented by a token
+    /// @param tkn The token
+    /// @return The expression
+    const lng::ExprBase& expr(lng::StmtExprToken tkn) const noexcept
+    {
+      return *exprs.expr(tkn).as_base();
+    }
+
+    /// @brief Returns the built-in type of an expression
+    /// @param expr The expression
+    /// @return The built-in type or nullptr if not built-in
+    const lng::BuiltinType* builtin_of(const lng::ExprBase& expr) const noexcept
+    {
+      return types.type(expr.type()).as<lng::BuiltinType>();
+    }
+
+    /// @brief Writes a type
+    /// @param tkn The type to write
+    /// @param is_const True if the type is const qualified
+    void write_type(lng::TypeToken tkn, bool is_const = false) noexcept
+    {
+      using enum lng::TypeID;
+
+      auto& type = types.type(tkn);
+      switch (type.type_id())
+      {
+      case TYPE_BUILTIN:
+        if (is_const)
+          writer.write("const ");
+        writer.write(
+            C_BUILTIN_NAMES[static_cast<u8>(
+                type.as<lng::BuiltinType>()->type_id())]);
+        return;
+      case TYPE_VOID:
+        writer.write("void");
+        return;
+      case TYPE_OPTR:
+      case TYPE_MUT_OPTR:
+        writer.write(type.is_mut_ptr() ? "void*" : "const void*");
+        break;
+      case TYPE_PTR:
+        write_type(type.as<lng::PtrType>()->pointing_to(), true);
+        writer.write('*');
+        break;
+      case TYPE_MUT_PTR:
+        write_type(type.as<lng::MutPtrType>()->pointing_to(), false);
+        writer.write('*');
+        break;
+      default:
+        unreachable("Type cannot be lowered to C!");
+      }
+      // The pointer itself is const
+      if (is_const)
+        writer.write(" const");
+    }
+
+    /// @brief Writes the name of a local variable
+    /// @param decl The declaration of the variable
+    void write_name(const lng::VarDeclExpr& decl) noexcept
+    {
+      // The local ID distinguishes redeclarations of a variable
+      writer.write("l_");
+      writer.write(decl.var_name());
+      writer.write('_');
+      writer.write_int(decl.local_id());
+    }
+
+    /// @brief Writes the name of a global variable
+    /// @param decl The declaration of the variable
+    void write_name(const lng::GlobalDeclExpr& decl) noexcept
+    {
+      // Globals of different units may have the same name
+      writer.write('g');
+      writer.write_int(unit_id);
+      writer.write('_');
+      writer.write(decl.global_name());
+    }
+
+    /// @brief Writes the name of a (local or global) variable
+    /// @param tkn The declaration of the variable
+    void write_name(lng::StmtExprToken tkn) noexcept
+    {
+      auto& decl = exprs.expr(tkn);
+      if (auto var = decl.as<lng::VarDeclExpr>(); var != nullptr)
+        return write_name(*var);
+      if (auto global = decl.as<lng::GlobalDeclExpr>(); global != nullptr)
+        return write_name(*global);
+      unreachable("Expected a variable declaration!");
+    }
+
+    /// @brief Writes a literal
+    /// @param value The value of the literal
+    /// @param id The type of the literal
+    void write_literal(QWORD_t value, lng::BuiltinID id) noexcept
+    {
+      using enum lng::BuiltinID;
+
+      switch_no_default(id)
+      {
+      case BOOL:
+        return writer.write(value.as<bool>() ? "true" : "false");
+      case CHAR:
+        // Written as an integer to avoid escaping
+        writer.write("((char)");
+        writer.write_int(static_cast<i8>(value.as<char>()));
+        return writer.write(')');
+      case U8:
+      case U16:
+      case U32:
+      case BYTE:
+      case WORD:
+      case DWORD:
+        writer.write("((");
+        writer.write(C_BUILTIN_NAMES[static_cast<u8>(id)]);
+        writer.write(')');
+        writer.write_int(value.as<u32>() & (~0U >> (32 - 8 * sizeof_builtin(id))));
+        return writer.write("u)");
+      case U64:
+      case QWORD:
+        writer.write("UINT64_C(");
+        writer.write_int(value.as<u64>());
+        return writer.write(')');
+      case I8:
+      case I16:
+      case I32:
+      case I64:
+      {
+        const u64 size = sizeof_builtin(id);
+        const i64 sint = size == 1   ? value.as<i8>()
+                         : size == 2 ? value.as<i16>()
+                         : size == 4 ? value.as<i32>()
+                                     : value.as<i64>();
+        // The minimum cannot be written as the negation of a literal
+        if (sint == (size == 8 ? std::numeric_limits<i64>::min()
+                               : -(i64{1} << (8 * size - 1))))
+          return writer.write(C_SIGNED_MIN[size]);
+        writer.write(size == 8 ? "INT64_C(" : "((");
+        if (size != 8)
+        {
+          writer.write(C_BUILTIN_NAMES[static_cast<u8>(id)]);
+          writer.write(')');
+        }
+        writer.write_int(sint);
+        return writer.write(')');
+      }
+      case F32:
+      {
+        const auto fp = value.as<f32>();
+        if (std::isnan(fp))
+          return writer.write("NAN");
+        if (std::isinf(fp))
+          return writer.write(fp < 0 ? "(-INFINITY)" : "INFINITY");
+        writer.write_hex_float(fp);
+        return writer.write('f');
+      }
+      case F64:
+      {
+        const auto fp = value.as<f64>();
+        if (std::isnan(fp))
+          return writer.write("((double)NAN)");
+        if (std::isinf(fp))
+          return writer.write(
+              fp < 0 ? "(-(double)INFINITY)" : "((double)INFINITY)");
+        return writer.write_hex_float(fp);
+      }
+      }
+    }
+
+    /// @brief Writes a unary expression
+    /// @param unary The expression
+    void write_unary(const lng::UnaryExpr& unary) noexcept
+    {
+      using enum lng::UnaryOp;
+
+      const auto op = unary.op();
+      if (op == OP_BOOL_NOT)
+      {
+        writer.write("(!");
+        write_expr(expr(unary.expr()));
+        return writer.write(')');
+      }
+      auto builtin = builtin_of(unary);
+      assert_true("Expected a built-in type!", builtin != nullptr);
+      const auto id = builtin->type_id();
+      if (lng::is_fp(id))
+      {
+        writer.write(op == OP_NEGATE ? "(-" : "(");
+        write_expr(expr(unary.expr()));
+        if (op == OP_INC || op == OP_DEC)
+          writer.write(op == OP_INC ? " + 1" : " - 1");
+        return writer.write(')');
+      }
+      // Integral operations wrap (as in the interpreter), which
+      // in C is only the case for unsigned arithmetic
+      writer.write("((");
+      writer.write(C_BUILTIN_NAMES[static_cast<u8>(id)]);
+      writer.write(op == OP_NEGATE ? ")(0u - (" : op == OP_BIT_NOT ? ")~(" : ")((");
+      writer.write(wrapping_type(id));
+      writer.write(")(");
+      write_expr(expr(unary.expr()));
+      switch_no_default(op)
+      {
+      case OP_NEGATE:
+        return writer.write(")))");
+      case OP_BIT_NOT:
+        return writer.write("))");
+      case OP_INC:
+        return writer.write(") + 1u))");
+      case OP_DEC:
+        return writer.write(") - 1u))");
+      }
+    }
+
+    /// @brief Writes a binary expression
+    /// @param binary The expression
+    void write_binary(const lng::BinaryExpr& binary) noexcept
+    {
+      using enum lng::BinaryOp;
+
+      const auto op  = binary.op();
+      auto& lhs      = expr(binary.lhs());
+      auto& rhs      = expr(binary.rhs());
+      auto builtin   = builtin_of(lhs);
+      const auto sym = StringView{lng::to_str(op)};
+      // Comparisons and boolean operators do not need any cast
+      if (builtin == nullptr || op >= OP_BOOL_AND)
+      {
+        writer.write('(');
+        write_expr(lhs);
+        writer.write(' ');
+        writer.write(sym);
+        writer.write(' ');
+        write_expr(rhs);
+        return writer.write(')');
+      }
+
+      const auto id = builtin->type_id();
+      if (lng::is_fp(id) && op == OP_MOD)
+      {
+        writer.write(id == lng::BuiltinID::F32 ? "fmodf(" : "fmod(");
+        write_expr(lhs);
+        writer.write(", ");
+        write_expr(rhs);
+        return writer.write(')');
+      }
+      // Integral operations wrap (as in the interpreter), which
+      // in C is only the case for unsigned arithmetic
+      const bool wraps = !lng::is_fp(id)
+                         && (op == OP_SUM || op == OP_SUB || op == OP_MUL
+                             || op == OP_BIT_LSHIFT);
+      writer.write("((");
+      writer.write(C_BUILTIN_NAMES[static_cast<u8>(id)]);
+      writer.write(")(");
+      if (wraps)
+      {
+        writer.write('(');
+        writer.write(wrapping_type(id));
+        writer.write(')');
+      }
+      write_expr(lhs);
+      writer.write(' ');
+      writer.write(sym);
+      writer.write(' ');
+      // The shift amount is not converted
+      if (wraps && op != OP_BIT_LSHIFT)
+      {
+        writer.write('(');
+        writer.write(wrapping_type(id));
+        writer.write(')');
+      }
+      write_expr(rhs);
+      writer.write("))");
+    }
+
+    /// @brief Writes a cast
+    /// @param cast The expression
+    void write_cast(const lng::CastExpr& cast) noexcept
+    {
+      auto& to_cast = expr(cast.to_cast());
+      if (!cast.is_bit_cast())
+      {
+        writer.write("((");
+        write_type(cast.type());
+        writer.write(')');
+        write_expr(to_cast);
+        return writer.write(')');
+      }
+      // Type punning through a union is defined in C
+      writer.write("(((union { ");
+      write_type(to_cast.type());
+      writer.write(" from; ");
+      write_type(cast.type());
+      writer.write(" to; }){.from = ");
+      write_expr(to_cast);
+      writer.write("}).to)");
+    }
+
+    /// @brief Writes an assignment (without parenthesis)
+    /// @param to The declaration of the variable to which to assign
+    /// @param value The value to assign
+    void write_assign(lng::StmtExprToken to, const lng::ExprBase& value) noexcept
+    {
+      write_name(to);
+      writer.write(" = ");
+      write_expr(value);
+    }
+
+    /// @brief Writes an expression that has side effects (without parenthesis)
+    /// @param side The expression
+    /// @return False if the expression has no side effects (nothing is written)
+    bool write_side_effect(const lng::ExprBase& side) noexcept
+    {
+      using enum lng::ExprID;
+      switch (side.classof())
+      {
+      case EXPR_VAR_WRITE:
+      {
+        auto& write = static_cast<const lng::VarWriteExpr&>(side);
+        write_assign(write.decl(), expr(write.to_write()));
+        return true;
+      }
+      case EXPR_GLOBAL_WRITE:
+      {
+        auto& write = static_cast<const lng::GlobalWriteExpr&>(side);
+        write_assign(write.decl(), expr(write.to_write()));
+        return true;
+      }
+      case EXPR_PTR_STORE:
+      {
+        auto& store = static_cast<const lng::PtrStoreExpr&>(side);
+        writer.write("*(");
+        write_expr(expr(store.where()));
+        writer.write(") = ");
+        write_expr(expr(store.to_store()));
+        return true;
+      }
+      case EXPR_MOVE:
+      {
+        // Built-in types are trivially movable
+        auto& move = static_cast<const lng::MoveExpr&>(side);
+        write_name(move.move_to());
+        writer.write(" = ");
+        write_name(move.to_move());
+        return true;
+      }
+      case EXPR_COPY:
+      {
+        auto& copy = static_cast<const lng::CopyExpr&>(side);
+        write_name(copy.copy_to());
+        writer.write(" = ");
+        write_name(copy.to_copy());
+        return true;
+      }
+      case EXPR_CMOVE:
+      {
+        auto& cmove = static_cast<const lng::CMoveExpr&>(side);
+        write_name(cmove.cmove_to());
+        writer.write(" = ");
+        write_name(cmove.to_cmove());
+        return true;
+      }
+      default:
+        return false;
+      }
+    }
+
+    /// @brief Writes an expression (fully parenthesized)
+    /// @param to_write The expression
+    void write_expr(const lng::ExprBase& to_write) noexcept
+    {
+      using enum lng::ExprID;
+
+      switch (to_write.classof())
+      {
+      case EXPR_NOP:
+        return writer.write("((void)0)");
+      case EXPR_LITERAL:
+      {
+        auto builtin = builtin_of(to_write);
+        assert_true("Expected a built-in type!", builtin != nullptr);
+        return write_literal(
+            static_cast<const lng::LiteralExpr&>(to_write).value(),
+            builtin->type_id());
+      }
+      case EXPR_UNARY:
+        return write_unary(static_cast<const lng::UnaryExpr&>(to_write));
+      case EXPR_BINARY:
+        return write_binary(static_cast<const lng::BinaryExpr&>(to_write));
+      case EXPR_CAST:
+        return write_cast(static_cast<const lng::CastExpr&>(to_write));
+      case EXPR_ADDRESSOF:
+        writer.write("(&");
+        write_name(static_cast<const lng::AddressOfExpr&>(to_write).name());
+        return writer.write(')');
+      case EXPR_PTR_LOAD:
+        writer.write("(*");
+        write_expr(expr(static_cast<const lng::PtrLoadExpr&>(to_write).to_load()));
+        return writer.write(')');
+      case EXPR_VAR_READ:
+      case EXPR_GLOBAL_READ:
+        return write_name(static_cast<const lng::ReadExpr&>(to_write).decl());
+      case EXPR_CALL_FN:
+        unreachable("Function calls cannot be lowered yet!");
+      case EXPR_ERROR:
+        unreachable("Only programs without errors can be lowered!");
+      default:
+        writer.write('(');
+        if (!write_side_effect(to_write))
+          unreachable("Expected an expression!");
+        writer.write(')');
+      }
+    }
+
+    /// @brief Check if an expression is a constant expression in C, which
+    /// can thus initialize a global at file scope
+    /// @param value The expression
+    /// @return True if constant
+    bool is_c_constant(const lng::ExprBase& value) const noexcept
+    {
+      using enum lng::ExprID;
+
+      switch (value.classof())
+      {
+      case EXPR_LITERAL:
+        return true;
+      case EXPR_UNARY:
+        return is_c_constant(expr(static_cast<const lng::UnaryExpr&>(value).expr()));
+      case EXPR_BINARY:
+      {
+        auto& binary = static_cast<const lng::BinaryExpr&>(value);
+        auto builtin = builtin_of(expr(binary.lhs()));
+        // The modulo of floating points is a call to 'fmod'
+        if (builtin != nullptr && lng::is_fp(builtin->type_id())
+            && binary.op() == lng::BinaryOp::OP_MOD)
+          return false;
+        return is_c_constant(expr(binary.lhs()))
+               && is_c_constant(expr(binary.rhs()));
+      }
+      case EXPR_CAST:
+      {
+        // Bit casts are written as compound literals
+        auto& cast = static_cast<const lng::CastExpr&>(value);
+        return !cast.is_bit_cast() && is_c_constant(expr(cast.to_cast()));
+      }
+      default:
+        // Reads of variables, side effects...
+        return false;
+      }
+    }
+
+    /// @brief Writes a statement as a block
+    /// @param stmt The statement
+    void write_block(const lng::ExprBase& stmt) noexcept
+    {
+      if (stmt.classof() == lng::ExprID::EXPR_SCOPE)
+        return write_stmt(stmt);
+      writer.open_block();
+      write_stmt(stmt);
+      writer.close_block();
+    }
+
+    /// @brief Writes a condition (and its 'elif' and 'else' branches)
+    /// @param cond The condition
+    void write_condition(const lng::ConditionExpr& cond) noexcept
+    {
+      const lng::ConditionExpr* branch = &cond;
+      writer.indent();
+      while (true)
+      {
+        writer.write("if (");
+        write_expr(expr(branch->if_condition()));
+        writer.write(")\n");
+        write_block(expr(branch->if_statement()));
+        if (!branch->has_else())
+          return;
+        auto& else_stmt = expr(branch->else_statement().value());
+        writer.indent();
+        if (else_stmt.classof() != lng::ExprID::EXPR_CONDITION)
+        {
+          writer.write("else\n");
+          return write_block(else_stmt);
+        }
+        // 'elif' branches are lowered to 'else if'
+        writer.write("else ");
+        branch = static_cast<const lng::ConditionExpr*>(&else_stmt);
+      }
+    }
+
+    /// @brief Writes a statement (which is not a global declaration)
+    /// @param stmt The statement
+    void write_stmt(const lng::ExprBase& stmt) noexcept
+    {
+      using enum lng::ExprID;
+
+      switch (stmt.classof())
+      {
+      case EXPR_NOP:
+        // 'pass' and empty scopes
+        return;
+      case EXPR_SCOPE:
+        writer.open_block();
+        for (auto child : static_cast<const lng::ScopeExpr&>(stmt).exprs())
+          write_stmt(*child);
+        return writer.close_block();
+      case EXPR_CONDITION:
+        return write_condition(static_cast<const lng::ConditionExpr&>(stmt));
+      case EXPR_VAR_DECL:
+      {
+        auto& decl = static_cast<const lng::VarDeclExpr&>(stmt);
+        writer.indent();
+        // Variables initialized later cannot be const in C
+        write_type(decl.type(), decl.is_const() && decl.is_init());
+        writer.write(' ');
+        write_name(decl);
+        if (decl.is_init())
+        {
+          writer.write(" = ");
+          write_expr(expr(decl.init().value()));
+        }
+        return writer.write(";\n");
+      }
+      case EXPR_GLOBAL_DECL:
+        unreachable("Globals are lowered at file scope!");
+      default:
+        writer.indent();
+        if (!write_side_effect(stmt))
+        {
+          // Avoids warnings about unused values
+          if (!types.type(stmt.type()).is_void())
+            writer.write("(void)");
+          write_expr(stmt);
+        }
+        writer.write(";\n");
+      }
+    }
+
+  public:
+    /// @brief Constructor
+    /// @param unit The unit to lower
+    /// @param unit_id The ID of the unit
+    /// @param indents The indentation strings
+    /// @param output The String to which to write
+    UnitLowering(
+        const lng::ParsedUnit& unit, u64 unit_id, const IndentTable& indents,
+        String& output) noexcept
+        : exprs(unit.expr_buffer())
+        , types(unit.program().type_buffer())
+        , writer(output, indents)
+        , unit_id(unit_id)
+    {
+    }
+
+    /// @brief Lowers the globals and the statements of the unit.
+    /// Globals whose initial value is not a constant expression in C
+    /// are declared at file scope, but initialized by 'clt_unit_N' (in the
+    /// order in which they are declared among the statements).
+    void lower() noexcept
+    {
+      const auto top_level = exprs.top_level_stmts();
+      for (auto stmt : top_level)
+      {
+        if (stmt->classof() != lng::ExprID::EXPR_GLOBAL_DECL)
+          continue;
+        auto& decl          = static_cast<const lng::GlobalDeclExpr&>(*stmt);
+        const bool constant = is_c_constant(expr(decl.init()));
+        writer.write("static ");
+        // Globals initialized later cannot be const in C
+        write_type(decl.type(), decl.is_const() && constant);
+        writer.write(' ');
+        write_name(decl);
+        if (constant)
+        {
+          writer.write(" = ");
+          write_expr(expr(decl.init()));
+        }
+        writer.write(";\n");
+      }
+
+      writer.write("\nstatic void clt_unit_");
+      writer.write_int(unit_id);
+      writer.write("(void)\n");
+      writer.open_block();
+      for (auto stmt : top_level)
+      {
+        if (stmt->classof() != lng::ExprID::EXPR_GLOBAL_DECL)
+        {
+          write_stmt(*stmt);
+          continue;
+        }
+        auto& decl = static_cast<const lng::GlobalDeclExpr&>(*stmt);
+        if (is_c_constant(expr(decl.init())))
+          continue;
+        writer.indent();
+        write_name(decl);
+        writer.write(" = ");
+        write_expr(expr(decl.init()));
+        writer.write(";\n");
+      }
+      writer.close_block();
+    }
+  };
+
+  std::filesystem::path default_output_path(
+      const std::filesystem::path& path) noexcept
+  {
+    auto output = path;
+    output.replace_extension(".c");
+    // Never overwrite the input
+    if (output == path)
+      output += ".c";
+    return output;
+  }
+
+  void transpile_unit(
+      const lng::ParsedUnit& unit, u64 unit_id, const IndentTable& indents,
+      String& output) noexcept
+  {
+    COLT_TRACE_SCOPE("transpile unit");
+    assert_true("Unit must be parsed without errors!", unit.error_count() == 0);
+    // Rough estimate of the size of the generated code
+    auto& exprs = unit.expr_buffer();
+    output.reserve(32 * (u64{exprs.prod_count()} + exprs.stmt_count()));
+    UnitLowering(unit, unit_id, indents, output).lower();
+  }
+
+  /// @brief Writes the 'main' function, which calls the function of each unit
+  /// @param unit_count The count of units
+  /// @param indents The indentation strings
+  /// @param output The String to which to write
+  static void write_main(
+      u64 unit_count, const IndentTable& indents, String& output) noexcept
+  {
+    auto writer = CodeWriter{output, indents};
+    writer.write("\nint main(void)\n");
+    writer.open_block();
+    for (u64 i = 0; i < unit_count; i++)
+    {
+      writer.indent();
+      writer.write("clt_unit_");
+      writer.write_int(i);
+      writer.write("();\n");
+    }
+    writer.write_line("return 0;");
+    writer.close_block();
+  }
+
+  /// @brief Writes a C file
+  /// @param path The path of the file
+  /// @param parts The parts of the file (written in order after the prelude)
+  /// @return Success if the file was written
+  static ErrorFlag write_c_file(const char* path, View<String> parts) noexcept
+  {
+    COLT_TRACE_SCOPE("write C file");
+    auto writer = io::BufferedWriter::open(path);
+    if (writer.is_none())
+      return ErrorFlag::error();
+    writer->write(C_PRELUDE);
+    for (auto& part : parts)
+      writer->write(StringView{part});
+    return writer->flush();
+  }
+
+  ErrorFlag transpile_unit_to(
+      const lng::ParsedUnit& unit, const char* path, u8 indent) noexcept
+  {
+    const auto indents = IndentTable{indent};
+    std::array<String, 2> parts;
+    transpile_unit(unit, 0, indents, parts[0]);
+    write_main(1, indents, parts[1]);
+    return write_c_file(path, View<String>{parts.data(), parts.size()});
+  }
+
+  /// @brief A unit of a program, with its path
+  struct UnitEntry
+  {
+    /// @brief The path of the unit
+    const std::filesystem::path* path;
+    /// @brief The unit
+    const lng::ParsedUnit* unit;
+  };
+
+  ErrorFlag transpile(
+      const lng::ParsedProgram& program, const char* path,
+      const TranspileOptions& options) noexcept
+  {
+    COLT_TRACE_SCOPE("transpile");
+    // The units are sorted by path for the output to be deterministic
+    Vector<UnitEntry> units = Vector<UnitEntry>(program.units().size());
+    for (auto& [path, unit] : program.units())
+      units.push_back(UnitEntry{&path, &unit});
+    std::sort(
+        units.begin(), units.end(),
+        [](const UnitEntry& a, const UnitEntry& b) { return *a.path < *b.path; });
+
+    const auto indents = IndentTable{options.indent};
+    // One part per unit, followed by 'main'
+    Vector<String> parts = Vector<String>(units.size() + 1);
+    for (u64 i = 0; i <= units.size(); i++)
+      parts.push_back(String{});
+
+    auto queue = IndexQueue{units.size()};
+    auto work  = [&]() noexcept
+    {
+      for (auto next = queue.pop(); next.is_value(); next = queue.pop())
+        transpile_unit(*units[*next].unit, *next, indents, parts[*next]);
+    };
+    run_on_workers(worker_count(options.jobs, units.size()), work);
+    write_main(units.size(), indents, parts.back());
+    return write_c_file(path, parts);
+  }
+} // namespace clt::c
@@ -0,0 +1,71 @@
+/*****************************************************************/ /**
+ * @file   c_transpiler.h
+ * @brief  Contains the C backend, which lowers a ParsedProgram to
+ * portable C (C99) that can be compiled by any C compiler.
+ * The top-level statements of each unit are lowered to a function
+ * 'clt_unit_N', which are called in order by the generated 'main'.
+ * The code of each unit is generated (in parallel) in its own String,
+ * and the Strings are then written (in order) through a BufferedWriter.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_C_TRANSPILER
+#define HG_COLT_C_TRANSPILER
+
+#include "c_code_writer.h"
+#include "ast/parsed_program.h"
+
+namespace clt::c
+{
+  /// @brief The options of the C backend
+  struct TranspileOptions
+  {
+    /// @brief The count of spaces per indentation
+    u8 indent = 2;
+    /// @brief The count of worker threads (0 for one per hardware thread)
+    u32 jobs = 0;
+  };
+
+  /// @brief Returns the path of the C file to which to lower a file
+  /// @param path The path of the file ('main.ct' is lowered to 'main.c')
+  /// @return The path of the C file
+  std::filesystem::path default_output_path(
+      const std::filesystem::path& path) noexcept;
+
+  /// @brief Lowers the top-level statements of a unit to C.
+  /// The unit must have been parsed without errors.
+  /// This writes the globals of the unit, followed by the function
+  /// 'clt_unit_<unit_id>' containing the other statements.
+  /// Globals whose initial value is not a constant expression in C
+  /// (e.g. a bit cast) are initialized by that function.
+  /// @param unit The unit to lower
+  /// @param unit_id The ID of the unit (unique in the generated file)
+  /// @param indents The indentation strings
+  /// @param output The String to which to append the code
+  void transpile_unit(
+      const lng::ParsedUnit& unit, u64 unit_id, const IndentTable& indents,
+      String& output) noexcept;
+
+  /// @brief Lowers a single unit to a C file.
+  /// The unit must have been parsed without errors.
+  /// @param unit The unit to lower
+  /// @param path The path of the C file to write
+  /// @param indent The count of spaces per indentation
+  /// @return Success if the file was written
+  ErrorFlag transpile_unit_to(
+      const lng::ParsedUnit& unit, const char* path, u8 indent) noexcept;
+
+  /// @brief Lowers a program to a C file.
+  /// The program must have been parsed without errors.
+  /// The units are lowered concurrently.
+  /// @param program The program to lower
+  /// @param path The path of the C file to write
+  /// @param options The options of the backend
+  /// @return Success if the file was written
+  ErrorFlag transpile(
+      const lng::ParsedProgram& program, const char* path,
+      const TranspileOptions& options) noexcept;
+} // namespace clt::c
+
+#endif // !HG_COLT_C_TRANSPILER
@@ -2,10 +2,345 @@
 
 namespace clt
 {
-  void disassemble_file(StringView file) noexcept
+  using namespace run;
+
+  /// @brief The mnemonics of BinaryTypeInst::Op
+  static constexpr std::array<StringView, 11> BINARY_TYPE_MNEMONICS = {
+      "add", "sub", "mul", "div", "mod", "eq", "neq", "le", "ge", "leq", "geq"};
+  /// @brief The mnemonics of BinaryBitsInst::Op
+  static constexpr std::array<StringView, 6> BINARY_BITS_MNEMONICS = {
+      "and", "or", "xor", "lsr", "lsl", "asr"};
+  /// @brief The mnemonics of BranchInst::Op
+  static constexpr std::array<StringView, 4> BRANCH_MNEMONICS = {
+      "b", "bt", "bf", "call"};
+  /// @brief The mnemonics of GlobalInst::Op
+  static constexpr std::array<StringView, 3> GLOBAL_MNEMONICS = {
+      "load_global", "store_global", "call_global"};
+
+  /// @brief Returns the mnemonic of an operation
+  /// @param encoding The encoding of the instruction
+  /// @param op The operation (which must be valid)
+  /// @return The mnemonic
+  static StringView mnemonic_of(InstEncoding encoding, u8 op) noexcept
+  {
+    using enum InstEncoding;
+    switch_no_default(encoding)
+    {
+    case BINARY_TYPE:
+      return BINARY_TYPE_MNEMONICS[op];
+    case BINARY_BITS:
+      return BINARY_BITS_MNEMONICS[op];
+    case BRANCH:
+      return BRANCH_MNEMONICS[op];
+    case SIGNED_IMM:
+      return "imms";
+    case UNSIGNED_IMM:
+      return "immu";
+    case GLOBAL:
+      return GLOBAL_MNEMONICS[op];
+    }
+  }
+
+  template<ExtractWith WITH>
+  /// @brief Decodes the operation and operands of an instruction
+  /// @tparam WITH How to extract the fields of binary instructions
+  /// @param encoded The encoded instruction
+  /// @return The decoded instruction (invalid if its operation is invalid)
+  static DecodedInst decode_inst(u64 encoded) noexcept
+  {
+    using enum InstEncoding;
+    auto decoded = DecodedInst{encoded};
+    switch (encoding_of(encoded))
+    {
+    case BINARY_TYPE:
+    {
+      auto inst = BinaryTypeInst::decode(encoded).unpack<WITH>();
+      decoded   = DecodedInst{
+          encoded,
+          (u8)inst.op < BINARY_TYPE_MNEMONICS.size()
+              && (u8)inst.type < reflect<TypeOp>::count(),
+          (u8)inst.op,
+          inst.dest,
+          inst.op1,
+          inst.op2,
+          (u8)inst.type};
+      break;
+    }
+    case BINARY_BITS:
+    {
+      auto inst = BinaryBitsInst::decode(encoded).unpack<WITH>();
+      decoded   = DecodedInst{
+          encoded, (u8)inst.op < BINARY_BITS_MNEMONICS.size(),
+          (u8)inst.op, inst.dest, inst.op1, inst.op2, inst.n};
+      break;
+    }
+    case BRANCH:
+    {
+      const auto op    = (u8)BranchInst::decode(encoded).op();
+      decoded.is_valid = op < BRANCH_MNEMONICS.size();
+      decoded.op       = op;
+      break;
+    }
+    case SIGNED_IMM:
+    case UNSIGNED_IMM:
+      decoded.is_valid = true;
+      break;
+    case GLOBAL:
+    {
+      const auto op    = (u8)GlobalInst::decode(encoded).op();
+      decoded.is_valid = op < GLOBAL_MNEMONICS.size();
+      decoded.op       = op;
+      break;
+    }
+    default:
+      break;
+    }
+    return decoded;
+  }
+
+  /// @brief Reads the instruction at index 'index'
+  /// @param code The code
+  /// @param index The index of the instruction
+  /// @return The encoded instruction
+  static u64 read_inst(View<u8> code, u64 index) noexcept
+  {
+    u64 encoded;
+    std::memcpy(&encoded, code.data() + index * sizeof(u64), sizeof(u64));
+    return ltoh(encoded);
+  }
+
+  /// @brief Returns the target of a branch if it points to an instruction
+  /// @param code The code
+  /// @param address The address of the branch
+  /// @param inst The branch
+  /// @return The target of the branch or None
+  static Option<u64> branch_target(
+      View<u8> code, u64 address, BranchInst inst) noexcept
+  {
+    const i64 offset = inst.offset();
+    // Branches are relative to the branch instruction
+    if (offset < 0 && static_cast<u64>(-offset) > address)
+      return None;
+    const u64 target = address + static_cast<u64>(offset);
+    if (target % sizeof(u64) != 0 || target >= code.size())
+      return None;
+    return target;
+  }
+
+  template<ExtractWith WITH>
+  /// @brief Decodes instructions (see 'decode_code')
+  /// @tparam WITH How to extract the fields of binary instructions
+  /// @param code The code
+  /// @param first The index of the first instruction to decode
+  /// @param count The count of instructions to decode
+  /// @param out The decoded instructions
+  static void decode_code_with(
+      View<u8> code, u64 first, u64 count, DecodedInst* out) noexcept
+  {
+    for (u64 i = 0; i < count; i++)
+      out[i] = decode_inst<WITH>(read_inst(code, first + i));
+  }
+
+#if defined(COLT_BITS_BMI2) && !defined(__BMI2__)
+  #if defined(COLT_GNU) || defined(COLT_CLANG)
+  __attribute__((target("bmi2"), flatten))
+  #endif
+  /// @brief Decodes instructions using PEXT and PDEP (see 'decode_code').
+  /// The whole loop is compiled for BMI2 and flattened: the extraction of
+  /// the fields (also compiled for BMI2) can only be inlined in it.
+  /// @param code The code
+  /// @param first The index of the first instruction to decode
+  /// @param count The count of instructions to decode
+  /// @param out The decoded instructions
+  static void decode_code_bmi2(
+      View<u8> code, u64 first, u64 count, DecodedInst* out) noexcept
+  {
+    decode_code_with<ExtractWith::pext>(code, first, count, out);
+  }
+#endif // COLT_BITS_BMI2 && !__BMI2__
+
+  /// @brief The implementations of 'decode_code', from the preferred one
+  static constinit const cpu::Dispatch<void(View<u8>, u64, u64, DecodedInst*)>
+      DECODE_CODE{
+#if defined(COLT_BITS_BMI2) && !defined(__BMI2__)
+          // PEXT and PDEP are slower than shifts when microcoded
+          {cpu::BMI2 | cpu::FAST_PEXT, &decode_code_bmi2},
+#endif // COLT_BITS_BMI2 && !__BMI2__
+          {cpu::NONE, &decode_code_with<DEFAULT_EXTRACT>}};
+
+  void decode_code(View<u8> code, u64 first, u64 count, DecodedInst* out) noexcept
+  {
+    assert_true("Invalid range!", first + count <= code.size() / sizeof(u64));
+    DECODE_CODE(code, first, count, out);
+  }
+
+  StringView opcode_key_mnemonic(u8 key) noexcept
+  {
+    using enum InstEncoding;
+    const u8 op = key & 0b1111;
+    switch (static_cast<InstEncoding>(key >> 4))
+    {
+    case BINARY_TYPE:
+      return op < BINARY_TYPE_MNEMONICS.size() ? BINARY_TYPE_MNEMONICS[op] : "invalid";
+    case BINARY_BITS:
+      return op < BINARY_BITS_MNEMONICS.size() ? BINARY_BITS_MNEMONICS[op] : "invalid";
+    case BRANCH:
+      return op < BRANCH_MNEMONICS.size() ? BRANCH_MNEMONICS[op] : "invalid";
+    case SIGNED_IMM:
+      return "imms";
+    case UNSIGNED_IMM:
+      return "immu";
+    case GLOBAL:
+      return op < GLOBAL_MNEMONICS.size() ? GLOBAL_MNEMONICS[op] : "invalid";
+    default:
+      return "invalid";
+    }
+  }
+
+  u64 InstHistogram::total() const noexcept
+  {
+    u64 total = invalid;
+    for (auto count : counts)
+      total += count;
+    return total;
+  }
+
+  void InstHistogram::print() const noexcept
+  {
+    const u64 total_count = total();
+    if (total_count == 0)
+      return;
+
+    Vector<std::pair<u64, u8>> sorted;
+    for (size_t i = 0; i < counts.size(); i++)
+      if (counts[i] != 0)
+        sorted.push_back(std::pair{counts[i], static_cast<u8>(i)});
+    std::sort(
+        sorted.begin(), sorted.end(),
+        [](auto& a, auto& b) { return a.first > b.first; });
+
+    io::print("Instruction histogram ({} instructions):", total_count);
+    for (auto [count, key] : sorted)
+    {
+      io::print(
+          "  {: <8} {: >12} ({:5.2f}%)",
+          opcode_key_mnemonic(key), count,
+          100.0 * static_cast<double>(count) / static_cast<double>(total_count));
+    }
+    if (invalid != 0)
+    {
+      io::print(
+          "  {: <8} {: >12} ({:5.2f}%)", "invalid", invalid,
+          100.0 * static_cast<double>(invalid) / static_cast<double>(total_count));
+    }
+  }
+
+  void disassemble_code(
+      View<u8> code, u64 from, u64 to, io::BufferedWriter& out,
+      InstHistogram& histogram) noexcept
   {
-    using namespace run;
+    const u64 count = code.size() / sizeof(u64);
+
+    // Find the targets of all the branches, so that labels can be
+    // emitted even for branches outside of [from, to).
+    auto targets = Vector<u8>(count, InPlace, static_cast<u8>(0));
+    for (u64 i = 0; i < count; i++)
+    {
+      const u64 encoded = read_inst(code, i);
+      if (encoding_of(encoded) != InstEncoding::BRANCH)
+        continue;
+      if (auto target = branch_target(code, i * sizeof(u64), BranchInst::decode(encoded));
+          target.is_value())
+        targets[*target / sizeof(u64)] = 1;
+    }
+
+    const u64 end   = clt::min(count, to / sizeof(u64) + (to % sizeof(u64) != 0));
+    const u64 first = clt::min(from / sizeof(u64), end);
+    // The instructions are decoded at once, then formatted
+    auto decoded = Vector<DecodedInst>(end - first, InPlace);
+    decode_code(code, first, end - first, decoded.data());
+
+    fmt::memory_buffer line;
+    for (u64 i = first; i < end; i++)
+    {
+      const u64 address = i * sizeof(u64);
+      const auto& inst  = decoded[i - first];
+      const u64 encoded = inst.encoded;
+      histogram.add(encoded, inst.is_valid);
+
+      line.clear();
+      auto it = fmt::appender(line);
+      if (targets[i])
+        it = fmt::format_to(it, "L{:x}:\n", address);
+      it = fmt::format_to(it, "  {:08x}:  {:016x}  ", address, encoded);
+      if (!inst.is_valid)
+      {
+        it = fmt::format_to(it, ".invalid\n");
+        out.write(line.data(), line.size());
+        continue;
+      }
+
+      using enum InstEncoding;
+      const auto encoding = encoding_of(encoded);
+      const auto mnemonic = mnemonic_of(encoding, inst.op);
+      switch_no_default(encoding)
+      {
+      case BINARY_TYPE:
+      {
+        auto type = reflect<TypeOp>::to_str(static_cast<TypeOp>(inst.extra));
+        // Remove the '_t' suffix of the type
+        type.remove_suffix(2);
+        it = fmt::format_to(
+            it, "{}.{} r{}, r{}, r{}\n", mnemonic, type, inst.dest, inst.op1,
+            inst.op2);
+        break;
+      }
+      case BINARY_BITS:
+      {
+        it = fmt::format_to(
+            it, "{}.{} r{}, r{}, r{}\n", mnemonic, inst.extra, inst.dest,
+            inst.op1, inst.op2);
+        break;
+      }
+      case BRANCH:
+      {
+        auto branch = BranchInst::decode(encoded);
+        if (auto target = branch_target(code, address, branch); target.is_value())
+          it = fmt::format_to(it, "{} L{:x} ({:+})\n", mnemonic, *target, branch.offset());
+        else
+          it = fmt::format_to(it, "{} <invalid> ({:+})\n", mnemonic, branch.offset());
+        break;
+      }
+      case SIGNED_IMM:
+        it = fmt::format_to(it, "{} {}\n", mnemonic, signed_imm_of(encoded));
+        break;
+      case UNSIGNED_IMM:
+        it = fmt::format_to(it, "{} {}\n", mnemonic, unsigned_imm_of(encoded));
+        break;
+      case GLOBAL:
+      {
+        auto global = GlobalInst::decode(encoded);
+        if (global.op() == GlobalInst::Op::call)
+          it = fmt::format_to(it, "{} @{}\n", mnemonic, global.slot());
+        else
+          it = fmt::format_to(it, "{} r{}, @{}\n", mnemonic, global.reg(), global.slot());
+        break;
+      }
+      }
+      out.write(line.data(), line.size());
+    }
+    if (code.size() % sizeof(u64) != 0 && to > count * sizeof(u64))
+    {
+      line.clear();
+      fmt::format_to(
+          fmt::appender(line), "  {:08x}:  <{} trailing bytes>\n",
+          count * sizeof(u64), code.size() % sizeof(u64));
+      out.write(line.data(), line.size());
+    }
+  }
 
+  void disassemble_file(StringView file, const DisasmOptions& options) noexcept
+  {
     auto str = String::getFile(file.data());
     if (str.is_error())
       return io::print_error("Could not open file at path '{}'!", file);
@@ -40,10 +375,58 @@ namespace clt
     for (u16 i = 0; i < exe.section_count(); i++)
     {
       auto section = exe.section(i);
-      io::print(
-          "  - {}: {} ({} byte{})", i, section.name, section.size,
-          section.size == 1 ? "." : "s.");
+      if (section.is_compressed)
+      {
+        io::print(
+            "  - {}: {} ({} byte{} compressed to {}){}", i, section.name,
+            section.raw_size, section.raw_size == 1 ? "" : "s", section.size,
+            exe.verify_section(i) ? "" : " [CORRUPTED]");
+      }
+      else
+      {
+        io::print(
+            "  - {}: {} ({} byte{}){}", i, section.name, section.size,
+            section.size == 1 ? "." : "s.",
+            exe.verify_section(i) ? "" : " [CORRUPTED]");
+      }
     }
-  }
-}
 
+    if (!options.section.empty() && exe.find_section(options.section).is_none())
+    {
+      return io::print_error(
+          "Section '{}' does not exist or is corrupted!", options.section);
+    }
+
+    // The instructions are streamed to stdout
+    auto out = io::BufferedWriter::from(stdout);
+    InstHistogram histogram;
+    for (u16 i = 0; i < exe.section_count(); i++)
+    {
+      const auto name = exe.section_name(i);
+      if (!options.section.empty() && name != options.section)
+        continue;
+      if (!is_code_section(name))
+      {
+        if (!options.section.empty())
+          io::print_warn("Section '{}' does not contain code!", name);
+        continue;
+      }
+      auto section = exe.checked_section(i);
+      if (section.is_none())
+      {
+        io::print_error("Section '{}' is corrupted!", name);
+        continue;
+      }
+      io::print("\nSection '{}':", name);
+      disassemble_code(
+          {section->begin, section->size}, options.from, options.to, out,
+          histogram);
+      out.flush().discard();
+    }
+    if (histogram.total() != 0)
+    {
+      io::print("");
+      histogram.print();
+    }
+  }
+} // namespace clt
@@ -2,12 +2,108 @@
 #define HG_COLTI_DISASSEMBLER
 
 #include "colti_exe.h"
+#include "colti_opcodes.h"
+#include "io/buffered_writer.h"
 
 namespace clt
 {
+  /// @brief Options of the disassembler
+  struct DisasmOptions
+  {
+    /// @brief If not empty, only the section of that name is disassembled
+    StringView section = {};
+    /// @brief The offset (in bytes) from which to disassemble code sections
+    u64 from = 0;
+    /// @brief The offset (in bytes) until which to disassemble code sections
+    u64 to = std::numeric_limits<u64>::max();
+  };
+
+  /// @brief Counts the number of occurrences of each instruction
+  class InstHistogram
+  {
+    /// @brief The count of each [4b: InstEncoding][4b: Operation]
+    std::array<u64, 256> counts{};
+    /// @brief The count of invalid instructions
+    u64 invalid = 0;
+
+  public:
+    /// @brief Registers an instruction
+    /// @param encoded The encoded instruction
+    /// @param valid False if the instruction is invalid
+    void add(u64 encoded, bool valid) noexcept
+    {
+      if (valid)
+        ++counts[run::opcode_key_of(encoded)];
+      else
+        ++invalid;
+    }
+
+    /// @brief Returns the total count of instructions registered
+    /// @return The total count of instructions
+    u64 total() const noexcept;
+
+    /// @brief Prints the histogram (sorted by count) to stdout
+    void print() const noexcept;
+  };
+
+  /// @brief Returns the mnemonic of an opcode key
+  /// @param key The opcode key (as returned by 'opcode_key_of')
+  /// @return The mnemonic or "invalid"
+  StringView opcode_key_mnemonic(u8 key) noexcept;
+
+  /// @brief Check if a section contains code
+  /// @param name The name of the section
+  /// @return True if the name is 'code' or starts with 'code.'
+  constexpr bool is_code_section(StringView name) noexcept
+  {
+    return name == "code" || name.starts_with("code.");
+  }
+
+  /// @brief An instruction decoded by 'decode_code'
+  struct DecodedInst
+  {
+    /// @brief The encoded instruction
+    u64 encoded = 0;
+    /// @brief False if the instruction is invalid
+    bool is_valid = false;
+    /// @brief The operation (0 for immediates)
+    u8 op = 0;
+    /// @brief The destination register (of binary instructions)
+    u8 dest = 0;
+    /// @brief The first operand register (of binary instructions)
+    u8 op1 = 0;
+    /// @brief The second operand register (of binary instructions)
+    u8 op2 = 0;
+    /// @brief The TypeOp (BINARY_TYPE) or count of bits (BINARY_BITS)
+    u8 extra = 0;
+  };
+
+  /// @brief Decodes the operations and operands of instructions.
+  /// The decoding loop is compiled both for the baseline and for BMI2
+  /// (extracting the fields with PEXT and PDEP), and the implementation
+  /// to use is bound once for all the calls (see cpu::Dispatch).
+  /// @param code The code
+  /// @param first The index of the first instruction to decode
+  /// @param count The count of instructions to decode
+  /// @param out The decoded instructions (of size 'count')
+  void decode_code(View<u8> code, u64 first, u64 count, DecodedInst* out) noexcept;
+
+  /// @brief Disassembles code, writing one instruction per line.
+  /// Branch targets are resolved, and labels are emitted before
+  /// each instruction that is the target of a branch.
+  /// @param code The code (whose size should be a multiple of 8)
+  /// @param from The offset from which to disassemble
+  /// @param to The offset until which to disassemble
+  /// @param out The writer to which to write
+  /// @param histogram The histogram to update
+  void disassemble_code(
+      View<u8> code, u64 from, u64 to, io::BufferedWriter& out,
+      InstHistogram& histogram) noexcept;
+
   /// @brief Disassembles a file, printing the result to stdout
   /// @param file The file to disassemble
-  void disassemble_file(StringView file) noexcept;
+  /// @param options The options of the disassembler
+  void disassemble_file(StringView file, const DisasmOptions& options = {}) noexcept;
 } // namespace clt
 
 #endif // !HG_COLTI_DISASSEMBLER
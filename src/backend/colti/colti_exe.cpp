@@ -1,9 +1,63 @@
 #include "colti_exe.h"
+#include "common/crc32.h"
+#include "common/trace.h"
+#include "common/lz4.h"
 
 namespace clt::run
 {
-  Option<ColtiExecutable> ColtiExecutable::load(View<u8> bytes) noexcept
+  ColtiExecutable::ColtiExecutable(View<u8> bytes) noexcept
+      : bytes(bytes)
+      , states(header()->sections(), InPlace,
+          header()->has_checksums() ? SectionState::UNVERIFIED
+                                    : SectionState::VALID)
+      , decompressed(header()->sections(), InPlace)
   {
+  }
+
+  bool ColtiExecutable::is_structure_valid(View<u8> bytes) noexcept
+  {
+    auto header = reinterpret_cast<const ColtiHeader*>(bytes.data());
+    const u64 directory_end = sizeof(ColtiHeader) + header->directory_size();
+    if (bytes.size() < directory_end)
+      return false;
+
+    auto offsets = reinterpret_cast<const u64*>(bytes.data() + sizeof(ColtiHeader));
+    for (u16 i = 0; i < header->sections(); i++)
+    {
+      const u64 offset = ltoh(offsets[i]);
+      // The name (and its NUL-terminator) followed by the size must fit
+      if (offset % 8 != 0 || offset < directory_end
+          || offset > bytes.size() - sizeof(u64))
+        return false;
+      auto name = reinterpret_cast<const char*>(bytes.data() + offset);
+      const u64 max_name = clt::min<u64>(32, bytes.size() - offset);
+      u64 name_size      = 0;
+      while (name_size < max_name && name[name_size] != '\0')
+        ++name_size;
+      if (name_size == max_name)
+        return false;
+      const u64 size_offset = align_to_next<8>(offset + name_size + 1);
+      if (size_offset > bytes.size() - sizeof(u64))
+        return false;
+      u64 size = ltoh(*reinterpret_cast<const u64*>(bytes.data() + size_offset));
+      const bool is_compressed = (size & ColtiHeader::SECTION_COMPRESSED) != 0;
+      size &= ~ColtiHeader::SECTION_COMPRESSED;
+      if (size > bytes.size() - size_offset - sizeof(u64))
+        return false;
+      // Compressed sections start with their decompressed size
+      if (is_compressed
+          && (size < sizeof(u64)
+              || ltoh(*reinterpret_cast<const u64*>(bytes.data() + size_offset + sizeof(u64)))
+                     > (size - sizeof(u64)) * 255))
+        return false;
+    }
+    return true;
+  }
+
+  Option<ColtiExecutable> ColtiExecutable::load(
+      View<u8> bytes, bool verify_all) noexcept
+  {
+    COLT_TRACE_SCOPE("load colti");
     assert_true(
         "Bytes must be aligned!",
         (uintptr_t)bytes.data() % alignof(ColtiHeader) == 0);
@@ -14,7 +68,13 @@ namespace clt::run
     if (reinterpret_cast<const ColtiHeader*>(bytes.data())->signature()
         != ColtiHeader::MAGIC_NUMBER)
       return None;
-    return ColtiExecutable(bytes);
+    // Truncated executables are detected here
+    if (!is_structure_valid(bytes))
+      return None;
+    auto exe = ColtiExecutable(bytes);
+    if (verify_all && !exe.verify_all())
+      return None;
+    return exe;
   }
 
   Option<time_point> ColtiExecutable::compilation_time() const noexcept
@@ -53,9 +113,16 @@ namespace clt::run
     auto section_size_ptr = reinterpret_cast<const u64*>(
         align_to_next<8>(section_name + section_name_size + 1));
 
+    const u64 size   = ltoh(*section_size_ptr);
+    const auto begin = reinterpret_cast<const u8*>(section_size_ptr + 1);
+    if ((size & ColtiHeader::SECTION_COMPRESSED) == 0)
+      return ExecutableSection{
+          StringView{section_name, section_name_size}, begin, size, size, false};
+
     return ExecutableSection{
-        StringView{section_name, section_name_size},
-        reinterpret_cast<const u8*>(section_size_ptr + 1), *section_size_ptr};
+        StringView{section_name, section_name_size}, begin,
+        size & ~ColtiHeader::SECTION_COMPRESSED,
+        ltoh(*reinterpret_cast<const u64*>(begin)), true};
   }
 
   StringView ColtiExecutable::section_name(u16 index) const noexcept
@@ -63,12 +130,62 @@ namespace clt::run
     return section(index).name;
   }
 
+  Option<ExecutableSection> ColtiExecutable::checked_section(
+      u16 index) const noexcept
+  {
+    if (!verify_section(index))
+      return None;
+    auto section_ = section(index);
+    if (!section_.is_compressed)
+      return section_;
+
+    auto& content = decompressed[index];
+    if (content.size() != section_.raw_size)
+    {
+      auto buffer = Vector<u8>(section_.raw_size);
+      if (!lz4::decompress(
+              {section_.begin + sizeof(u64), section_.size - sizeof(u64)},
+              buffer.data(), section_.raw_size))
+      {
+        states[index] = SectionState::CORRUPTED;
+        return None;
+      }
+      buffer._Unsafe_size(section_.raw_size);
+      content = std::move(buffer);
+    }
+    section_.begin = content.data();
+    section_.size  = content.size();
+    return section_;
+  }
+
+  bool ColtiExecutable::verify_section(u16 index) const noexcept
+  {
+    assert_true("Invalid index!", index < section_count());
+    if (states[index] == SectionState::UNVERIFIED)
+    {
+      auto section_  = section(index);
+      states[index] = crc32c(0, section_.begin, section_.size)
+                              == ltoh(section_checksums()[index])
+                          ? SectionState::VALID
+                          : SectionState::CORRUPTED;
+    }
+    return states[index] == SectionState::VALID;
+  }
+
+  bool ColtiExecutable::verify_all() const noexcept
+  {
+    bool valid = true;
+    for (u16 i = 0; i < section_count(); i++)
+      valid &= verify_section(i);
+    return valid;
+  }
+
   Option<ExecutableSection> ColtiExecutable::find_section(
       StringView name) const noexcept
   {
     for (u16 i = 0; i < section_count(); i++)
-      if (auto section_ = section(i); section_.name == name)
-        return section_;
+      if (section_name(i) == name)
+        return checked_section(i);
     return None;
   }
 
@@ -77,5 +194,15 @@ namespace clt::run
     return {
         reinterpret_cast<const u64*>(bytes.data() + sizeof(ColtiHeader)),
         section_count()};
+  }
+
+  View<u32> ColtiExecutable::section_checksums() const noexcept
+  {
+    if (!has_checksums())
+      return {};
+    return {
+        reinterpret_cast<const u32*>(
+            bytes.data() + sizeof(ColtiHeader) + sizeof(u64) * section_count()),
+        section_count()};
   }  
 } // namespace clt::run
\ No newline at end of file
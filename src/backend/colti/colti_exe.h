@@ -14,6 +14,10 @@ namespace clt::run
   public:
     /// @brief This magic number is TLOC (for COLT) in ASCII
     static constexpr u32 MAGIC_NUMBER = htol(static_cast<u32>(0x434F4C54));
+    /// @brief Flag set if the section directory contains checksums
+    static constexpr u32 FLAG_CHECKSUMS = 1;
+    /// @brief Bit set in the size of a section if its content is compressed
+    static constexpr u64 SECTION_COMPRESSED = static_cast<u64>(1) << 63;
 
   private:
     // While bit fields could have simplified the code,
@@ -40,17 +44,23 @@ namespace clt::run
 
     /// @brief This must be equal to 'MAGIC_NUMBER'
     u32 magic_number = MAGIC_NUMBER;
-    /// @brief Unused for now
-    u32 padding = 0;
+    /// @brief The flags of the executable (FLAG_*)
+    u32 flags = 0;
 
-    // After the padding, there is a u64 containing the offset
+    // After the flags, there is a u64 containing the offset
     // to each section.
+    // If FLAG_CHECKSUMS is set, the offsets are followed by the
+    // CRC32C of the content of each section, padded to 8 bytes.
     // Each section begins with the NUL-terminated section name
     // (31 characters at most, without counting NUL-terminator),
     // followed by a u64 representing the size in bytes of the
     // content, then followed by the content of the section.
     // The content of the section must always be 8-byte aligned.
+    // If the most significant bit of the size is set (SECTION_COMPRESSED),
+    // the content is a u64 representing the decompressed size followed
+    // by the content compressed as an LZ4 block.
     // u64 offset_to_section[section_count]
+    // u32 crc32c_of_section[section_count] (if FLAG_CHECKSUMS)
 
     /// @brief Encodes a version
     /// @param version The version to encode
@@ -88,9 +98,10 @@ namespace clt::run
     /// @param section_count The section count
     /// @param version The language version
     /// @param time_point The compilation time stamp or None
+    /// @param flags The flags of the executable (FLAG_*)
     constexpr ColtiHeader(
         u16 section_count, const ColtVersion& version,
-        Option<time_point> time_point);
+        Option<time_point> time_point, u32 flags = 0);
 
     /// @brief Returns the compilation time or None if it doesn't exist.
     /// This function decodes the value every time it is called, so
@@ -117,6 +128,23 @@ namespace clt::run
       return section_count;
     }
 
+    /// @brief Check if the section directory contains checksums
+    /// @return True if the checksums of the sections are stored
+    constexpr bool has_checksums() const noexcept
+    {
+      return (ltoh(flags) & FLAG_CHECKSUMS) != 0;
+    }
+
+    /// @brief Returns the size of the section directory (offsets and checksums)
+    /// @return The size in bytes of the section directory
+    constexpr u64 directory_size() const noexcept
+    {
+      u64 size = sizeof(u64) * section_count;
+      if (has_checksums())
+        size += (sizeof(u32) * section_count + 7) & ~u64(7);
+      return size;
+    }
+
     /// @brief The magic number to verify that the header is a Colt header
     /// @return Magic number (must be MAGIC_NUMBER to be valid)
     constexpr u32 signature() const noexcept
@@ -134,7 +162,10 @@ namespace clt::run
     requires std::is_pointer_v<T> || meta::UnsignedIntegral<T>
   constexpr T align_to_next(T to_align) noexcept;
 
-  /// @brief Represents an executable section
+  /// @brief Represents an executable section.
+  /// When returned by 'ColtiExecutable::section', 'begin' and 'size'
+  /// describe the content as stored (which may be compressed).
+  /// Otherwise, they describe the decompressed content.
   struct ExecutableSection
   {
     /// @brief The name of the section
@@ -143,19 +174,56 @@ namespace clt::run
     const u8* begin;
     /// @brief The size of the section
     u64 size;
+    /// @brief The size of the decompressed content of the section
+    u64 raw_size;
+    /// @brief True if the section is stored compressed
+    bool is_compressed;
   };
 
+  /// @brief The integrity state of a section
+  enum class SectionState : u8
+  {
+    /// @brief The checksum of the section was not yet verified
+    UNVERIFIED,
+    /// @brief The checksum matches (or the executable has no checksums)
+    VALID,
+    /// @brief The checksum does not match
+    CORRUPTED
+  };
+
+  /// @brief Read-only view over a Colti executable.
+  /// The structure of the executable (offsets and sizes) is validated
+  /// by 'load'. The checksum of a section is verified lazily the first
+  /// time it is accessed through 'checked_section' or 'find_section',
+  /// unless 'load' is asked to verify all the sections eagerly.
+  /// Compressed sections are decompressed on their first access through
+  /// these same functions, and the decompressed content is cached.
   class ColtiExecutable
   {
+    /// @brief The bytes of the executable
     View<u8> bytes;
+    /// @brief The integrity state of each section
+    mutable Vector<SectionState> states;
+    /// @brief The decompressed content of each compressed section (lazily filled)
+    mutable Vector<Vector<u8>> decompressed;
 
-    ColtiExecutable(View<u8> bytes) noexcept
-        : bytes(bytes)
-    {
-    }
+    /// @brief Constructor
+    /// @param bytes The bytes of the executable
+    ColtiExecutable(View<u8> bytes) noexcept;
+
+    /// @brief Check that the offset table and the sections are in range
+    /// @param bytes The bytes of the executable (of at least a header)
+    /// @return True if the structure is valid
+    static bool is_structure_valid(View<u8> bytes) noexcept;
 
   public:
-    static Option<ColtiExecutable> load(View<u8> bytes) noexcept;
+    /// @brief Loads an executable from bytes.
+    /// The bytes must be 8-byte aligned and outlive the executable.
+    /// @param bytes The bytes of the executable
+    /// @param verify_all If true, verifies the checksums of all sections
+    /// @return None if the executable is invalid, truncated or corrupted
+    static Option<ColtiExecutable> load(
+        View<u8> bytes, bool verify_all = false) noexcept;
 
     /// @brief Returns the ColtiHeader of the executable.
     /// It is error prone to use the header directly: every information
@@ -178,7 +246,8 @@ namespace clt::run
     /// @return The section count
     u16 section_count() const noexcept;
 
-    /// @brief Returns the section at index 'index'
+    /// @brief Returns the section at index 'index' as stored.
+    /// The content of compressed sections is not decompressed.
     /// @param index The index of the section (index < section_count)
     /// @return Section at index 'index'
     ExecutableSection section(u16 index) const noexcept;
@@ -188,15 +257,41 @@ namespace clt::run
     /// @return The section name
     StringView section_name(u16 index) const noexcept;
 
-    /// @brief Searches for a section of name 'name'
+    /// @brief Returns the section at index 'index' if it is not corrupted.
+    /// The checksum of the section is verified on the first call, and
+    /// the section is decompressed if needed.
+    /// @param index The index of the section (index < section_count)
+    /// @return Section at index 'index' or None if corrupted
+    Option<ExecutableSection> checked_section(u16 index) const noexcept;
+
+    /// @brief Verifies the checksum of a section (the result is cached)
+    /// @param index The index of the section (index < section_count)
+    /// @return True if the section is not corrupted
+    bool verify_section(u16 index) const noexcept;
+
+    /// @brief Verifies the checksums of all the sections
+    /// @return True if no section is corrupted
+    bool verify_all() const noexcept;
+
+    /// @brief Check if the executable stores checksums of its sections
+    /// @return True if the executable stores checksums
+    bool has_checksums() const noexcept { return header()->has_checksums(); }
+
+    /// @brief Searches for a section of name 'name'.
+    /// The checksum of the section found is verified on the first access.
     /// @param name The name of the section
-    /// @return The section or None if not found
+    /// @return The section or None if not found or corrupted
     Option<ExecutableSection> find_section(StringView name) const noexcept;
 
     /// @brief Returns a view over the sections offset
     /// @return View over the sections offset
     View<u64> section_offsets() const noexcept;
 
+    /// @brief Returns a view over the sections checksums.
+    /// The view is empty if the executable does not store checksums.
+    /// @return View over the sections checksums
+    View<u32> section_checksums() const noexcept;
+
     /// @brief Check if an offset points inside the executable
     /// @param offset The offset (from the start of the executable)
     /// @return True if the offset points inside the executable
@@ -290,9 +385,11 @@ namespace clt::run
   }
 
   constexpr ColtiHeader::ColtiHeader(
-      u16 section_count, const ColtVersion& version, Option<time_point> time_point)
+      u16 section_count, const ColtVersion& version, Option<time_point> time_point,
+      u32 flags)
       : section_count(section_count)
       , colt_version(encode_version(version))
+      , flags(htol(flags))
   {
     // Encode the time stamp
     if (time_point.is_value())
@@ -0,0 +1,52 @@
+/*****************************************************************/ /**
+ * @file   colti_globals.cpp
+ * @brief  Contains the implementation of 'colti_globals.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "colti_globals.h"
+
+namespace clt::run
+{
+  /// @brief Reads the u64 at index 'index' of a section
+  /// @param section The section
+  /// @param index The index of the u64
+  /// @return The u64
+  static u64 read_u64(const ExecutableSection& section, u64 index) noexcept
+  {
+    u64 value;
+    std::memcpy(&value, section.begin + index * sizeof(u64), sizeof(u64));
+    return ltoh(value);
+  }
+
+  Option<GlobalMemory> GlobalMemory::load(const ColtiExecutable& exe) noexcept
+  {
+    u16 index = 0;
+    while (index < exe.section_count() && exe.section_name(index) != SECTION_NAME)
+      ++index;
+    if (index == exe.section_count())
+      return GlobalMemory(Vector<QWORD_t>{}, Vector<u64>{});
+    auto section = exe.checked_section(index);
+    if (section.is_none())
+      return None;
+
+    const u64 count = section->size / sizeof(u64);
+    if (count < 2 || section->size % sizeof(u64) != 0)
+      return None;
+    const u64 var_count = read_u64(*section, 0);
+    const u64 fn_count  = read_u64(*section, 1);
+    if (var_count > count - 2 || fn_count != count - 2 - var_count
+        || var_count > std::numeric_limits<u32>::max()
+        || fn_count > std::numeric_limits<u32>::max())
+      return None;
+
+    auto values = Vector<QWORD_t>(var_count);
+    for (u64 i = 0; i < var_count; i++)
+      values.push_back(QWORD_t{read_u64(*section, 2 + i)});
+    auto functions = Vector<u64>(fn_count);
+    for (u64 i = 0; i < fn_count; i++)
+      functions.push_back(read_u64(*section, 2 + var_count + i));
+    return GlobalMemory(std::move(values), std::move(functions));
+  }
+} // namespace clt::run
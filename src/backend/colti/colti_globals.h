@@ -0,0 +1,80 @@
+/*****************************************************************/ /**
+ * @file   colti_globals.h
+ * @brief  Contains GlobalMemory, the global state of a running
+ * Colti executable.
+ * Globals are resolved to dense slots at link time (see GlobalLinker),
+ * so that the VM accesses them through a single contiguous array,
+ * without any string comparison or hashing at run time.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLTI_GLOBALS
+#define HG_COLTI_GLOBALS
+
+#include "colti_exe.h"
+#include "run/qword_op.h"
+
+namespace clt::run
+{
+  /// @brief The global variables and the function table of an executable.
+  /// The globals section has the following layout:
+  /// [u64 var_count] [u64 fn_count] [u64 values[var_count]]
+  /// [u64 fn_offsets[fn_count]]
+  /// where 'fn_offsets' are the offsets of the functions in the code section.
+  class GlobalMemory
+  {
+    /// @brief The values of the global variables (indexed by slot)
+    Vector<QWORD_t> values;
+    /// @brief The offsets of the functions (indexed by slot)
+    Vector<u64> functions;
+
+    /// @brief Constructor
+    /// @param values The values of the global variables
+    /// @param functions The offsets of the functions
+    GlobalMemory(Vector<QWORD_t>&& values, Vector<u64>&& functions) noexcept
+        : values(std::move(values))
+        , functions(std::move(functions))
+    {
+    }
+
+  public:
+    /// @brief The name of the section containing the globals
+    static constexpr StringView SECTION_NAME = "globals";
+
+    GlobalMemory(GlobalMemory&&) noexcept = default;
+
+    /// @brief Loads the globals of an executable.
+    /// An executable without a globals section has no globals.
+    /// @param exe The executable
+    /// @return None if the globals section is corrupted or malformed
+    static Option<GlobalMemory> load(const ColtiExecutable& exe) noexcept;
+
+    /// @brief Returns the number of global variables
+    /// @return The number of global variables
+    u32 var_count() const noexcept { return static_cast<u32>(values.size()); }
+    /// @brief Returns the number of functions
+    /// @return The number of functions
+    u32 fn_count() const noexcept { return static_cast<u32>(functions.size()); }
+
+    /// @brief Returns the global variable at slot 'slot'
+    /// @param slot The slot (slot < var_count())
+    /// @return The global variable
+    QWORD_t& operator[](u32 slot) noexcept { return values[slot]; }
+    /// @brief Returns the global variable at slot 'slot'
+    /// @param slot The slot (slot < var_count())
+    /// @return The global variable
+    const QWORD_t& operator[](u32 slot) const noexcept { return values[slot]; }
+
+    /// @brief Returns the offset of the function at slot 'slot'
+    /// @param slot The slot (slot < fn_count())
+    /// @return The offset of the function in the code section
+    u64 function(u32 slot) const noexcept { return functions[slot]; }
+
+    /// @brief Returns the global variables
+    /// @return The contiguous array of global variables
+    View<QWORD_t> variables() const noexcept { return {values.data(), values.size()}; }
+  };
+} // namespace clt::run
+
+#endif // !HG_COLTI_GLOBALS
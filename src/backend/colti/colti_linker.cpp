@@ -0,0 +1,105 @@
+/*****************************************************************/ /**
+ * @file   colti_linker.cpp
+ * @brief  Contains the implementation of 'colti_linker.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "colti_linker.h"
+#include "common/trace.h"
+
+namespace clt::run
+{
+  void GlobalLinker::link(const lng::ParsedProgram& program) noexcept
+  {
+    for (auto& [path, unit] : program.units())
+      link(unit.expr_buffer());
+  }
+
+  void GlobalLinker::link(const lng::ExprBuffer& exprs) noexcept
+  {
+    COLT_TRACE_SCOPE("link globals");
+    auto [unit, _] = units.insert(
+        &exprs, UnitState{static_cast<u32>(units.size())});
+    auto& state = unit->second;
+
+    // The lists are iterated, as indexing a FlatList walks it: the
+    // initializers are created in the order of their declarations, so the
+    // producers are walked in step with the statements
+    const u32 count = exprs.stmt_count();
+    auto stmt       = exprs.stmt_exprs().begin();
+    stmt += state.linked;
+    auto prod      = exprs.prod_exprs().begin();
+    u32 prod_index = 0;
+    for (u32 i = state.linked; i < count; i++, ++stmt)
+    {
+      auto decl = stmt->as<lng::GlobalDeclExpr>();
+      if (decl == nullptr)
+        continue;
+
+      const u32 init_index = decl->init().getID();
+      if (init_index >= prod_index)
+      {
+        prod += init_index - prod_index;
+        prod_index = init_index;
+      }
+      auto& init_expr = init_index == prod_index ? *prod : exprs.expr(decl->init());
+      QWORD_t value;
+      if (auto init = init_expr.as<lng::LiteralExpr>(); init != nullptr)
+        value = init->value();
+      var_slots.insert(key_of(state.index, lng::StmtExprToken{i}), var_count());
+      initial_values.push_back(value);
+    }
+    state.linked = count;
+  }
+
+  Option<u32> GlobalLinker::var_slot(
+      const lng::ExprBuffer& exprs, lng::StmtExprToken decl) const noexcept
+  {
+    auto unit = units.find(&exprs);
+    if (unit == nullptr)
+      return None;
+    if (auto slot = var_slots.find(key_of(unit->second.index, decl)); slot != nullptr)
+      return slot->second;
+    return None;
+  }
+
+  u32 GlobalLinker::fn_slot(StringView name) noexcept
+  {
+    auto [index, result] = fn_names.insert(name);
+    if (result == InsertionResult::SUCCESS)
+      fn_offsets.push_back(UNRESOLVED);
+    return static_cast<u32>(index);
+  }
+
+  Option<GlobalInst> GlobalLinker::lower(
+      const lng::ExprBuffer& exprs, lng::ProdExprToken access, u8 reg) const noexcept
+  {
+    auto& expr = exprs.expr(access);
+    if (auto read = expr.as<lng::GlobalReadExpr>(); read != nullptr)
+    {
+      if (auto slot = var_slot(exprs, read->decl()); slot.is_value())
+        return GlobalInst(GlobalInst::Op::load, reg, *slot);
+      return None;
+    }
+    if (auto write = expr.as<lng::GlobalWriteExpr>(); write != nullptr)
+    {
+      if (auto slot = var_slot(exprs, write->decl()); slot.is_value())
+        return GlobalInst(GlobalInst::Op::store, reg, *slot);
+      return None;
+    }
+    return None;
+  }
+
+  void GlobalLinker::write_to(ColtiWriter& writer, bool compress) const noexcept
+  {
+    writer.begin_section(GlobalMemory::SECTION_NAME, compress);
+    writer.write_le<u64>(initial_values.size());
+    writer.write_le<u64>(fn_offsets.size());
+    for (auto value : initial_values)
+      writer.write_le(value.as<u64>());
+    for (auto offset : fn_offsets)
+      writer.write_le(offset);
+    writer.end_section();
+  }
+} // namespace clt::run
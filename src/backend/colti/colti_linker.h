@@ -0,0 +1,138 @@
+/*****************************************************************/ /**
+ * @file   colti_linker.h
+ * @brief  Contains GlobalLinker, which resolves the globals of a
+ * ParsedProgram to dense slot indices.
+ * Every global variable and function is assigned a slot, and
+ * accesses to globals are lowered to GlobalInst referring to that
+ * slot. The initial values of the global variables and the
+ * function table are then written as the globals section of the
+ * executable (see GlobalMemory), so that the VM never has to look
+ * up a global by name.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLTI_LINKER
+#define HG_COLTI_LINKER
+
+#include "colti_opcodes.h"
+#include "colti_globals.h"
+#include "colti_writer.h"
+#include "ast/parsed_program.h"
+
+namespace clt::run
+{
+  /// @brief Assigns dense slots to the globals of a program.
+  /// Global variables are numbered in declaration order, unit after unit.
+  /// As functions do not carry any information yet, they are
+  /// identified by their name.
+  /// @code{.cpp}
+  /// GlobalLinker linker;
+  /// linker.link(program);
+  /// auto inst = linker.lower(unit.expr_buffer(), read, 1); // load_global r1, @0
+  /// linker.write_to(writer);
+  /// @endcode
+  class GlobalLinker
+  {
+    /// @brief The linking state of an ExprBuffer
+    struct UnitState
+    {
+      /// @brief The index of the unit (in linking order)
+      u32 index;
+      /// @brief The number of statements already linked
+      u32 linked = 0;
+    };
+
+    /// @brief The state of each linked unit
+    Map<const lng::ExprBuffer*, UnitState> units{};
+    /// @brief Maps [32b: unit index][32b: StmtExprToken] of a GlobalDeclExpr to its slot
+    Map<u64, u32> var_slots{};
+    /// @brief The initial value of each global variable (by slot)
+    Vector<QWORD_t> initial_values{};
+    /// @brief The name of each function (by slot)
+    IndexedSet<StringView> fn_names{};
+    /// @brief The offset of each function in the code section (by slot)
+    Vector<u64> fn_offsets{};
+
+    /// @brief Returns the key of a global declaration in 'var_slots'
+    /// @param unit The index of the unit
+    /// @param decl The declaration
+    /// @return The key
+    static constexpr u64 key_of(u32 unit, lng::StmtExprToken decl) noexcept
+    {
+      return (static_cast<u64>(unit) << 32) | decl.getID();
+    }
+
+  public:
+    /// @brief The offset of a function whose body was not resolved
+    static constexpr u64 UNRESOLVED = std::numeric_limits<u64>::max();
+
+    /// @brief Assigns slots to the global variables of all the units
+    /// @param program The program to link
+    void link(const lng::ParsedProgram& program) noexcept;
+
+    /// @brief Assigns slots to the global variables declared in 'exprs'.
+    /// Linking the same buffer again only assigns slots to the new declarations,
+    /// which allows linking incrementally.
+    /// @param exprs The expressions of a unit
+    void link(const lng::ExprBuffer& exprs) noexcept;
+
+    /// @brief Returns the slot of a global variable
+    /// @param exprs The expressions of the unit declaring the variable
+    /// @param decl The GlobalDeclExpr
+    /// @return The slot or None if the declaration was not linked
+    Option<u32> var_slot(
+        const lng::ExprBuffer& exprs, lng::StmtExprToken decl) const noexcept;
+
+    /// @brief Returns the slot of a function, assigning one if needed.
+    /// The name must live as long as the linker.
+    /// @param name The name of the function
+    /// @return The slot of the function
+    u32 fn_slot(StringView name) noexcept;
+
+    /// @brief Sets the offset of the body of a function
+    /// @param slot The slot of the function (slot < fn_count())
+    /// @param offset The offset of the function in the code section
+    void resolve_fn(u32 slot, u64 offset) noexcept { fn_offsets[slot] = offset; }
+
+    /// @brief Lowers an access to a global variable.
+    /// A GlobalReadExpr is lowered to a load to 'reg', and a GlobalWriteExpr
+    /// to a store from 'reg' (which must contain the value to write).
+    /// @param exprs The expressions of the unit containing 'access'
+    /// @param access The GlobalReadExpr or GlobalWriteExpr
+    /// @param reg The register to load to or store from
+    /// @return None if 'access' is not an access to a linked global variable
+    Option<GlobalInst> lower(
+        const lng::ExprBuffer& exprs, lng::ProdExprToken access,
+        u8 reg) const noexcept;
+
+    /// @brief Lowers a call to a function
+    /// @param name The name of the function
+    /// @return The call instruction
+    GlobalInst lower_call(StringView name) noexcept
+    {
+      return GlobalInst(GlobalInst::Op::call, 0, fn_slot(name));
+    }
+
+    /// @brief Returns the number of global variables
+    /// @return The number of global variables
+    u32 var_count() const noexcept { return static_cast<u32>(initial_values.size()); }
+    /// @brief Returns the number of functions
+    /// @return The number of functions
+    u32 fn_count() const noexcept { return static_cast<u32>(fn_offsets.size()); }
+
+    /// @brief Returns the initial value of a global variable.
+    /// Variables whose initializer is not a literal are zero-initialized,
+    /// and must be initialized by the startup code of the program.
+    /// @param slot The slot of the variable (slot < var_count())
+    /// @return The initial value
+    QWORD_t initial_value(u32 slot) const noexcept { return initial_values[slot]; }
+
+    /// @brief Writes the globals section (see GlobalMemory)
+    /// @param writer The writer to which to write
+    /// @param compress True to compress the section
+    void write_to(ColtiWriter& writer, bool compress = false) const noexcept;
+  };
+} // namespace clt::run
+
+#endif // !HG_COLTI_LINKER
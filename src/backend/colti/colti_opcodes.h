@@ -32,8 +32,49 @@ namespace clt::run
     /// @brief Represents an unsigned immediate load instruction.
     /// [OpCode: 0100][Unsigned Immediate: 60b]
     UNSIGNED_IMM,
+    /// @brief Represents an access to a global through its slot.
+    /// This represents instruction similar to 'load_global' and 'call'.
+    /// [OpCode: 0101][Operation: 4b] [Reg: 8b] [0: 16b] [Slot: 32b]
+    GLOBAL,
   };
 
+  /// @brief Returns the encoding of an encoded instruction
+  /// @param encoded The encoded instruction
+  /// @return The encoding (which may be out of range for invalid instructions)
+  constexpr InstEncoding encoding_of(u64 encoded) noexcept
+  {
+    return static_cast<InstEncoding>(encoded >> 60);
+  }
+
+  /// @brief Returns the key identifying the opcode of an instruction.
+  /// The key is [4b: InstEncoding][4b: Operation], where the operation
+  /// of immediates (which do not have any) is always 0.
+  /// @param encoded The encoded instruction
+  /// @return The opcode key
+  constexpr u8 opcode_key_of(u64 encoded) noexcept
+  {
+    if (encoding_of(encoded) == InstEncoding::SIGNED_IMM
+        || encoding_of(encoded) == InstEncoding::UNSIGNED_IMM)
+      return static_cast<u8>((encoded >> 56) & 0xF0);
+    return static_cast<u8>(encoded >> 56);
+  }
+
+  /// @brief Returns the immediate of a SIGNED_IMM instruction
+  /// @param encoded The encoded instruction
+  /// @return The sign extended immediate
+  constexpr i64 signed_imm_of(u64 encoded) noexcept
+  {
+    return sign_extend(encoded & bitmask<u64>(60), 60);
+  }
+
+  /// @brief Returns the immediate of an UNSIGNED_IMM instruction
+  /// @param encoded The encoded instruction
+  /// @return The immediate
+  constexpr u64 unsigned_imm_of(u64 encoded) noexcept
+  {
+    return encoded & bitmask<u64>(60);
+  }
+
   /// @brief Represents a binary typed instruction
   class BinaryTypeInst
   {
@@ -63,6 +104,8 @@ namespace clt::run
 
     _type storage{};
 
+    constexpr BinaryTypeInst() noexcept = default;
+
   public:
     /// @brief Represents the possible operations
     enum class Op : u8
@@ -99,6 +142,21 @@ namespace clt::run
       storage.set<Type>((u64)type);
     }
 
+    /// @brief Decodes an instruction
+    /// @param encoded The encoded instruction (whose encoding must be BINARY_TYPE)
+    /// @return The decoded instruction
+    static constexpr BinaryTypeInst decode(u64 encoded) noexcept
+    {
+      assert_true("Invalid encoding!", encoding_of(encoded) == InstEncoding::BINARY_TYPE);
+      BinaryTypeInst inst;
+      inst.storage = _type{encoded};
+      return inst;
+    }
+
+    /// @brief Returns the encoded instruction
+    /// @return The encoded instruction
+    constexpr u64 encoded() const noexcept { return storage.value(); }
+
     /// @brief Returns the operation of the instruction
     /// @return The operation
     constexpr Op op() const noexcept { return (Op)storage.get<Field::Operation>(); }
@@ -117,6 +175,33 @@ namespace clt::run
     {
       return (TypeOp)storage.get<Field::Type>();
     }
+
+    /// @brief All the fields of the instruction
+    struct Unpacked
+    {
+      /// @brief The operation
+      Op op;
+      /// @brief The destination register
+      u8 dest;
+      /// @brief The first operand register
+      u8 op1;
+      /// @brief The second operand register
+      u8 op2;
+      /// @brief The type on which to apply the operation
+      TypeOp type;
+    };
+
+    /// @brief Decodes all the fields of the instruction at once
+    /// @tparam WITH How to extract the fields (see Bitfields::get_all_with)
+    /// @return The fields of the instruction
+    template<ExtractWith WITH = DEFAULT_EXTRACT>
+    constexpr Unpacked unpack() const noexcept
+    {
+      using enum BinaryTypeInst::Field;
+      const auto [op, dest, a, b, type] =
+          storage.get_all_with<WITH, Operation, Dest, A, B, Type>();
+      return Unpacked{(Op)op, (u8)dest, (u8)a, (u8)b, (TypeOp)type};
+    }
   };
 
   /// @brief Represents a binary bits instruction
@@ -148,6 +233,8 @@ namespace clt::run
 
     _type storage{};
 
+    constexpr BinaryBitsInst() noexcept = default;
+
   public:
     /// @brief Represents the possible operations
     enum class Op : u8
@@ -179,9 +266,24 @@ namespace clt::run
       storage.set<N>(         (u64)n);
     }
 
+    /// @brief Decodes an instruction
+    /// @param encoded The encoded instruction (whose encoding must be BINARY_BITS)
+    /// @return The decoded instruction
+    static constexpr BinaryBitsInst decode(u64 encoded) noexcept
+    {
+      assert_true("Invalid encoding!", encoding_of(encoded) == InstEncoding::BINARY_BITS);
+      BinaryBitsInst inst;
+      inst.storage = _type{encoded};
+      return inst;
+    }
+
+    /// @brief Returns the encoded instruction
+    /// @return The encoded instruction
+    constexpr u64 encoded() const noexcept { return storage.value(); }
+
     /// @brief Returns the operation of the instruction
     /// @return The operation
-    constexpr Op op() const noexcept { return (Op)storage.get<Field::OpCode>(); }
+    constexpr Op op() const noexcept { return (Op)storage.get<Field::Operation>(); }
     /// @brief Returns the destination register index
     /// @return The destination register
     constexpr u8 dest() const noexcept { return (u8)storage.get<Field::Dest>(); }
@@ -194,6 +296,33 @@ namespace clt::run
     /// @brief Returns the number of bits to keep after the operation
     /// @return The number of bits to keep after the operation
     constexpr u8 n() const noexcept { return (u8)storage.get<Field::N>(); }
+
+    /// @brief All the fields of the instruction
+    struct Unpacked
+    {
+      /// @brief The operation
+      Op op;
+      /// @brief The destination register
+      u8 dest;
+      /// @brief The first operand register
+      u8 op1;
+      /// @brief The second operand register
+      u8 op2;
+      /// @brief The number of bits to keep after the operation
+      u8 n;
+    };
+
+    /// @brief Decodes all the fields of the instruction at once
+    /// @tparam WITH How to extract the fields (see Bitfields::get_all_with)
+    /// @return The fields of the instruction
+    template<ExtractWith WITH = DEFAULT_EXTRACT>
+    constexpr Unpacked unpack() const noexcept
+    {
+      using enum BinaryBitsInst::Field;
+      const auto [op, dest, a, b, n] =
+          storage.get_all_with<WITH, Operation, Dest, A, B, N>();
+      return Unpacked{(Op)op, (u8)dest, (u8)a, (u8)b, (u8)n};
+    }
   };
 
   /// @brief Represents a branch instruction
@@ -215,6 +344,8 @@ namespace clt::run
 
     _type storage{};
 
+    constexpr BranchInst() noexcept = default;
+
   public:
     /// @brief Represents the possible operations
     enum class Op : u8
@@ -244,18 +375,133 @@ namespace clt::run
       storage.set<Offset>(    htol((u64)offset));
     }
 
+    /// @brief Decodes an instruction
+    /// @param encoded The encoded instruction (whose encoding must be BRANCH)
+    /// @return The decoded instruction
+    static constexpr BranchInst decode(u64 encoded) noexcept
+    {
+      assert_true("Invalid encoding!", encoding_of(encoded) == InstEncoding::BRANCH);
+      BranchInst inst;
+      inst.storage = _type{encoded};
+      return inst;
+    }
+
+    /// @brief Returns the encoded instruction
+    /// @return The encoded instruction
+    constexpr u64 encoded() const noexcept { return storage.value(); }
+
     /// @brief Returns the operation of the instruction
     /// @return The operation
-    constexpr Op op() const noexcept { return (Op)storage.get<Field::OpCode>(); }
+    constexpr Op op() const noexcept { return (Op)storage.get<Field::Operation>(); }
     /// @brief Returns the signed offset to add to the program counter
     /// @return The signed offset
     constexpr i64 offset() const noexcept
     {
       return sign_extend(ltoh(storage.get<Field::Offset>()), 56);
     }
+
+    /// @brief All the fields of the instruction
+    struct Unpacked
+    {
+      /// @brief The operation
+      Op op;
+      /// @brief The signed offset to add to the program counter
+      i64 offset;
+    };
+
+    /// @brief Decodes all the fields of the instruction at once.
+    /// The offset does not fit in a lane with the operation: the fields
+    /// are always extracted with shifts and masks.
+    /// @return The fields of the instruction
+    constexpr Unpacked unpack() const noexcept
+    {
+      using enum BranchInst::Field;
+      const auto [op, offset] = storage.get_all<Operation, Offset>();
+      return Unpacked{(Op)op, sign_extend(ltoh(offset), 56)};
+    }
+  };
+
+  /// @brief Represents an access to a global (variable or function).
+  /// Globals are resolved to dense slot indices at link time (see
+  /// GlobalLinker), so that no lookup is done at run time.
+  class GlobalInst
+  {
+    enum class Field
+    {
+      /// @brief [0101]
+      OpCode,
+      /// @brief The operation to execute
+      Operation,
+      /// @brief The register to load to or store from
+      Reg,
+      /// @brief Unused for now
+      Padding,
+      /// @brief The slot of the global
+      Slot,
+    };
+
+    using _type = Bitfields<
+        u64, Bitfield<Field::OpCode, 4>, Bitfield<Field::Operation, 4>,
+        Bitfield<Field::Reg, 8>, Bitfield<Field::Padding, 16>,
+        Bitfield<Field::Slot, 32>>;
+
+    _type storage{};
+
+    constexpr GlobalInst() noexcept = default;
+
+  public:
+    /// @brief Represents the possible operations
+    enum class Op : u8
+    {
+      /// @brief Loads the global variable in the register
+      load,
+      /// @brief Stores the register in the global variable
+      store,
+      /// @brief Calls the global function
+      call,
+    };
+
+    /// @brief Constructor
+    /// @param operation The operation to perform
+    /// @param reg The register to load to or store from (0 for calls)
+    /// @param slot The slot of the global
+    constexpr GlobalInst(Op operation, u8 reg, u32 slot) noexcept
+    {
+      using enum GlobalInst::Field;
+
+      storage.set<OpCode>(    (u64)InstEncoding::GLOBAL);
+      storage.set<Operation>( (u64)operation);
+      storage.set<Reg>(       (u64)reg);
+      storage.set<Slot>(      (u64)slot);
+    }
+
+    /// @brief Decodes an instruction
+    /// @param encoded The encoded instruction (whose encoding must be GLOBAL)
+    /// @return The decoded instruction
+    static constexpr GlobalInst decode(u64 encoded) noexcept
+    {
+      assert_true("Invalid encoding!", encoding_of(encoded) == InstEncoding::GLOBAL);
+      GlobalInst inst;
+      inst.storage = _type{encoded};
+      return inst;
+    }
+
+    /// @brief Returns the encoded instruction
+    /// @return The encoded instruction
+    constexpr u64 encoded() const noexcept { return storage.value(); }
+
+    /// @brief Returns the operation of the instruction
+    /// @return The operation
+    constexpr Op op() const noexcept { return (Op)storage.get<Field::Operation>(); }
+    /// @brief Returns the register to load to or store from
+    /// @return The register
+    constexpr u8 reg() const noexcept { return (u8)storage.get<Field::Reg>(); }
+    /// @brief Returns the slot of the global
+    /// @return The slot of the global
+    constexpr u32 slot() const noexcept { return (u32)storage.get<Field::Slot>(); }
   };
 
-#define COLT_INST_TYPE_LIST BinaryTypeInst, BinaryBitsInst, BranchInst
+#define COLT_INST_TYPE_LIST BinaryTypeInst, BinaryBitsInst, BranchInst, GlobalInst
 
   class Inst
   {
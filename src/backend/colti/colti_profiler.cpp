@@ -0,0 +1,203 @@
+/*****************************************************************/ /**
+ * @file   colti_profiler.cpp
+ * @brief  Contains the implementation of 'colti_profiler.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "colti_profiler.h"
+#include "colti_disassembler.h"
+
+namespace clt::run
+{
+  u32 VMProfiler::function_of(u64 address) noexcept
+  {
+    if (auto slot = function_index.find(address); slot != nullptr)
+      return slot->second;
+    const u32 index = static_cast<u32>(functions.size());
+    functions.push_back(FunctionStats{
+        String{StringView{fmt::format("fn_{:x}", address)}}, address});
+    function_index.insert(address, index);
+    return index;
+  }
+
+  u32 VMProfiler::child_of(u32 parent, u32 function) noexcept
+  {
+    const u64 key = (static_cast<u64>(parent) << 32) | function;
+    if (auto slot = node_index.find(key); slot != nullptr)
+      return slot->second;
+    const u32 index = static_cast<u32>(nodes.size());
+    nodes.push_back(CallNode{parent, function});
+    node_index.insert(key, index);
+    return index;
+  }
+
+  void VMProfiler::write_path(fmt::memory_buffer& out, u32 node) const noexcept
+  {
+    if (node == 0)
+      return;
+    if (nodes[node].parent != 0)
+    {
+      write_path(out, nodes[node].parent);
+      out.push_back(';');
+    }
+    StringView name = functions[nodes[node].function].name;
+    out.append(name.data(), name.data() + name.size());
+  }
+
+  void VMProfiler::register_function(u64 address, StringView name) noexcept
+  {
+    functions[function_of(address)].name = String{name};
+  }
+
+  void VMProfiler::on_branch(u64 address, bool taken) noexcept
+  {
+    auto [slot, _] = branches.insert(address, BranchStats{});
+    if (taken)
+      ++slot->second.taken;
+    else
+      ++slot->second.not_taken;
+  }
+
+  void VMProfiler::enter_function(u64 address) noexcept
+  {
+    const u32 function = function_of(address);
+    const u32 parent   = frames.is_empty() ? 0 : frames.back().node;
+    ++functions[function].calls;
+    ++functions[function].active;
+    frames.push_back(Frame{child_of(parent, function), profiler_timestamp()});
+  }
+
+  void VMProfiler::exit_function() noexcept
+  {
+    if (frames.is_empty())
+      return;
+    const Frame frame    = frames.back();
+    const u64 inclusive  = profiler_timestamp() - frame.start;
+    auto& function       = functions[nodes[frame.node].function];
+    frames.pop_back();
+
+    nodes[frame.node].self += inclusive - clt::min(inclusive, frame.children);
+    // Only the outermost frame of a recursive function is counted,
+    // as the inner frames are already part of its inclusive time.
+    if (--function.active == 0)
+      function.inclusive += inclusive;
+    if (!frames.is_empty())
+      frames.back().children += inclusive;
+  }
+
+  void VMProfiler::finish() noexcept
+  {
+    if (current_key != NO_INST)
+    {
+      opcodes[current_key].cycles += profiler_timestamp() - last_timestamp;
+      current_key = NO_INST;
+    }
+    while (!frames.is_empty())
+      exit_function();
+  }
+
+  Option<VMProfiler::BranchStats> VMProfiler::branch(u64 address) const noexcept
+  {
+    if (auto slot = branches.find(address); slot != nullptr)
+      return slot->second;
+    return None;
+  }
+
+  ErrorFlag VMProfiler::write_report(const char* path) const noexcept
+  {
+    auto out = io::BufferedWriter::open(path);
+    if (out.is_none())
+      return ErrorFlag::error();
+
+    const StringView unit = profiler_uses_cycles() ? "cycles" : "ns";
+    fmt::memory_buffer buffer;
+    auto it = fmt::appender(buffer);
+
+    u64 total_count  = 0;
+    u64 total_cycles = 0;
+    Vector<u8> keys;
+    for (size_t i = 0; i < opcodes.size(); i++)
+    {
+      if (opcodes[i].count == 0)
+        continue;
+      total_count += opcodes[i].count;
+      total_cycles += opcodes[i].cycles;
+      keys.push_back(static_cast<u8>(i));
+    }
+    std::sort(
+        keys.begin(), keys.end(),
+        [&](u8 a, u8 b) { return opcodes[a].cycles > opcodes[b].cycles; });
+
+    it = fmt::format_to(
+        it, "Opcodes ({} instructions, {} {}):\n", total_count, total_cycles, unit);
+    for (auto key : keys)
+    {
+      const auto& stats = opcodes[key];
+      it                = fmt::format_to(
+          it, "  {: <8} {: >12} {: >16} {}/inst: {:8.2f} ({:5.2f}%)\n",
+          opcode_key_mnemonic(key), stats.count, stats.cycles, unit,
+          static_cast<double>(stats.cycles) / static_cast<double>(stats.count),
+          total_cycles == 0 ? 0.0
+                            : 100.0 * static_cast<double>(stats.cycles)
+                                  / static_cast<double>(total_cycles));
+    }
+
+    Vector<std::pair<u64, BranchStats>> sorted_branches;
+    for (auto& [address, stats] : branches)
+      sorted_branches.push_back(std::pair{address, stats});
+    std::sort(
+        sorted_branches.begin(), sorted_branches.end(),
+        [](auto& a, auto& b)
+        {
+          return a.second.taken + a.second.not_taken
+                 > b.second.taken + b.second.not_taken;
+        });
+    it = fmt::format_to(it, "\nBranches ({}):\n", sorted_branches.size());
+    for (auto& [address, stats] : sorted_branches)
+    {
+      it = fmt::format_to(
+          it, "  {:08x}: taken {: >12}, not taken {: >12} ({:5.2f}% taken)\n",
+          address, stats.taken, stats.not_taken,
+          100.0 * static_cast<double>(stats.taken)
+              / static_cast<double>(stats.taken + stats.not_taken));
+    }
+
+    Vector<u32> sorted_functions;
+    for (u32 i = 0; i < functions.size(); i++)
+      sorted_functions.push_back(i);
+    std::sort(
+        sorted_functions.begin(), sorted_functions.end(), [&](u32 a, u32 b)
+        { return functions[a].inclusive > functions[b].inclusive; });
+    it = fmt::format_to(it, "\nFunctions ({}):\n", functions.size());
+    for (auto i : sorted_functions)
+    {
+      const auto& stats = functions[i];
+      it                = fmt::format_to(
+          it, "  {: <24} calls {: >10}, inclusive {: >16} {}\n",
+          StringView{stats.name}, stats.calls, stats.inclusive, unit);
+    }
+
+    out->write(buffer.data(), buffer.size());
+    return out->flush();
+  }
+
+  ErrorFlag VMProfiler::write_collapsed(const char* path) const noexcept
+  {
+    auto out = io::BufferedWriter::open(path);
+    if (out.is_none())
+      return ErrorFlag::error();
+
+    fmt::memory_buffer line;
+    for (u32 i = 1; i < nodes.size(); i++)
+    {
+      if (nodes[i].self == 0)
+        continue;
+      line.clear();
+      write_path(line, i);
+      fmt::format_to(fmt::appender(line), " {}\n", nodes[i].self);
+      out->write(line.data(), line.size());
+    }
+    return out->flush();
+  }
+} // namespace clt::run
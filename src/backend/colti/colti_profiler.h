@@ -0,0 +1,262 @@
+/*****************************************************************/ /**
+ * @file   colti_profiler.h
+ * @brief  Contains VMProfiler, an execution profiler for the ColtVM.
+ * The profiler records the execution count and cycles of each opcode,
+ * the taken/not-taken count of each branch, and the inclusive time of
+ * each function (through a calling context tree).
+ * It can then write a report, and a collapsed-stack file which is the
+ * input format of flame graph tools.
+ *
+ * Profiling is opt-in: the interpreter should only call the profiler
+ * through the COLT_PROFILE_* macros, which expand to nothing unless
+ * COLT_VM_PROFILE is defined (see the CMake option of the same name).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLTI_PROFILER
+#define HG_COLTI_PROFILER
+
+#include "colti_opcodes.h"
+#include "structs/map.h"
+#include "io/buffered_writer.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define COLT_PROFILER_RDTSC
+  #ifdef COLT_MSVC
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif // COLT_MSVC
+#endif
+
+#ifdef COLT_VM_PROFILE
+  /// @brief Registers the execution of an instruction
+  #define COLT_PROFILE_INST(profiler, encoded) (profiler).on_inst(encoded)
+  /// @brief Registers the outcome of a conditional branch
+  #define COLT_PROFILE_BRANCH(profiler, address, taken) \
+    (profiler).on_branch(address, taken)
+  /// @brief Registers a call to the function at 'address'
+  #define COLT_PROFILE_ENTER(profiler, address) (profiler).enter_function(address)
+  /// @brief Registers a return from the current function
+  #define COLT_PROFILE_EXIT(profiler) (profiler).exit_function()
+#else
+  /// @brief Registers the execution of an instruction
+  #define COLT_PROFILE_INST(profiler, encoded) (void)0
+  /// @brief Registers the outcome of a conditional branch
+  #define COLT_PROFILE_BRANCH(profiler, address, taken) (void)0
+  /// @brief Registers a call to the function at 'address'
+  #define COLT_PROFILE_ENTER(profiler, address) (void)0
+  /// @brief Registers a return from the current function
+  #define COLT_PROFILE_EXIT(profiler) (void)0
+#endif // COLT_VM_PROFILE
+
+namespace clt::run
+{
+  /// @brief Returns a monotonic timestamp.
+  /// On x86-64, this is the time stamp counter (in cycles),
+  /// else the steady clock (in nanoseconds).
+  /// @return The current timestamp
+  inline u64 profiler_timestamp() noexcept
+  {
+#ifdef COLT_PROFILER_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<u64>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif // COLT_PROFILER_RDTSC
+  }
+
+  /// @brief Check if the timestamps of the profiler are in cycles
+  /// @return True if the time stamp counter is used
+  constexpr bool profiler_uses_cycles() noexcept
+  {
+#ifdef COLT_PROFILER_RDTSC
+    return true;
+#else
+    return false;
+#endif // COLT_PROFILER_RDTSC
+  }
+
+  /// @brief Execution profiler of the ColtVM.
+  /// To keep the overhead low, a single timestamp is read per
+  /// instruction: the time elapsed since the previous instruction
+  /// is attributed to that previous instruction.
+  /// @code{.cpp}
+  /// VMProfiler profiler;
+  /// profiler.register_function(0, "main");
+  /// COLT_PROFILE_ENTER(profiler, 0);
+  /// // for each instruction:
+  /// COLT_PROFILE_INST(profiler, encoded);
+  /// COLT_PROFILE_EXIT(profiler);
+  /// profiler.finish();
+  /// profiler.write_report("profile.txt");
+  /// @endcode
+  class VMProfiler
+  {
+  public:
+    /// @brief The statistics of an opcode
+    struct OpcodeStats
+    {
+      /// @brief The number of executions
+      u64 count = 0;
+      /// @brief The total time spent executing the opcode
+      u64 cycles = 0;
+    };
+
+    /// @brief The statistics of a conditional branch
+    struct BranchStats
+    {
+      /// @brief The number of times the branch was taken
+      u64 taken = 0;
+      /// @brief The number of times the branch was not taken
+      u64 not_taken = 0;
+    };
+
+    /// @brief The statistics of a function
+    struct FunctionStats
+    {
+      /// @brief The name of the function
+      String name;
+      /// @brief The address of the function
+      u64 address = 0;
+      /// @brief The number of calls
+      u64 calls = 0;
+      /// @brief The inclusive time (recursive calls are only counted once)
+      u64 inclusive = 0;
+      /// @brief The number of active frames of the function
+      u32 active = 0;
+    };
+
+  private:
+    /// @brief Node of the calling context tree
+    struct CallNode
+    {
+      /// @brief The index of the parent node (0 is the root)
+      u32 parent;
+      /// @brief The index of the function in 'functions'
+      u32 function;
+      /// @brief The exclusive time spent in this context
+      u64 self = 0;
+    };
+
+    /// @brief An active call
+    struct Frame
+    {
+      /// @brief The index of the context in 'nodes'
+      u32 node;
+      /// @brief The timestamp of the call
+      u64 start;
+      /// @brief The inclusive time of the calls done by this frame
+      u64 children = 0;
+    };
+
+    /// @brief The value of 'current_key' before any instruction
+    static constexpr u16 NO_INST = 256;
+
+    /// @brief The statistics of each opcode key
+    std::array<OpcodeStats, 256> opcodes{};
+    /// @brief The opcode key of the last instruction or NO_INST
+    u16 current_key = NO_INST;
+    /// @brief The timestamp of the last instruction
+    u64 last_timestamp = 0;
+    /// @brief The statistics of each branch (by address)
+    Map<u64, BranchStats> branches{};
+    /// @brief The statistics of each function
+    Vector<FunctionStats> functions{};
+    /// @brief Maps the address of a function to its index in 'functions'
+    Map<u64, u32> function_index{};
+    /// @brief The calling context tree (whose first node is the root)
+    Vector<CallNode> nodes{};
+    /// @brief Maps [32b: parent node][32b: function] to its node
+    Map<u64, u32> node_index{};
+    /// @brief The active calls
+    Vector<Frame> frames{};
+
+    /// @brief Returns the index of the function at 'address', adding it if needed
+    /// @param address The address of the function
+    /// @return The index in 'functions'
+    u32 function_of(u64 address) noexcept;
+
+    /// @brief Returns the child context of 'parent' for a function
+    /// @param parent The parent node
+    /// @param function The function index
+    /// @return The index of the child in 'nodes'
+    u32 child_of(u32 parent, u32 function) noexcept;
+
+    /// @brief Writes the path of a context ('main;foo;bar')
+    /// @param out The buffer to write to
+    /// @param node The node whose path to write
+    void write_path(fmt::memory_buffer& out, u32 node) const noexcept;
+
+  public:
+    /// @brief Constructor
+    VMProfiler() noexcept { nodes.push_back(CallNode{0, 0}); }
+
+    /// @brief Names the function at 'address' (used by the reports)
+    /// @param address The address of the function
+    /// @param name The name of the function
+    void register_function(u64 address, StringView name) noexcept;
+
+    /// @brief Registers the execution of an instruction
+    /// @param encoded The encoded instruction
+    void on_inst(u64 encoded) noexcept
+    {
+      const u64 now = profiler_timestamp();
+      if (current_key != NO_INST)
+        opcodes[current_key].cycles += now - last_timestamp;
+      current_key = opcode_key_of(encoded);
+      ++opcodes[current_key].count;
+      last_timestamp = now;
+    }
+
+    /// @brief Registers the outcome of a conditional branch
+    /// @param address The address of the branch
+    /// @param taken True if the branch was taken
+    void on_branch(u64 address, bool taken) noexcept;
+
+    /// @brief Registers a call to the function at 'address'
+    /// @param address The address of the function
+    void enter_function(u64 address) noexcept;
+
+    /// @brief Registers a return from the current function.
+    /// Does nothing if there are no active calls.
+    void exit_function() noexcept;
+
+    /// @brief Ends profiling: attributes the time of the last instruction,
+    /// and returns from all the active calls.
+    void finish() noexcept;
+
+    /// @brief Returns the statistics of an opcode
+    /// @param key The opcode key (see 'opcode_key_of')
+    /// @return The statistics of the opcode
+    const OpcodeStats& opcode(u8 key) const noexcept { return opcodes[key]; }
+
+    /// @brief Returns the statistics of a branch
+    /// @param address The address of the branch
+    /// @return The statistics or None if the branch was never executed
+    Option<BranchStats> branch(u64 address) const noexcept;
+
+    /// @brief Returns the statistics of all the functions
+    /// @return The statistics of all the functions
+    View<FunctionStats> function_stats() const noexcept
+    {
+      return {functions.data(), functions.size()};
+    }
+
+    /// @brief Writes the hot-spot report (opcodes, branches and functions
+    /// sorted by decreasing cost).
+    /// @param path The path of the file to write
+    /// @return Success if the report could be written
+    ErrorFlag write_report(const char* path) const noexcept;
+
+    /// @brief Writes one line per calling context, of the form
+    /// 'main;foo;bar <exclusive time>'.
+    /// This is the input of 'flamegraph.pl' and compatible tools.
+    /// @param path The path of the file to write
+    /// @return Success if the file could be written
+    ErrorFlag write_collapsed(const char* path) const noexcept;
+  };
+} // namespace clt::run
+
+#endif // !HG_COLTI_PROFILER
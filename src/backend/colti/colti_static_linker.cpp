@@ -0,0 +1,293 @@
+/*****************************************************************/ /**
+ * @file   colti_static_linker.cpp
+ * @brief  Contains the implementation of 'colti_static_linker.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "colti_static_linker.h"
+#include "common/trace.h"
+
+namespace clt::run
+{
+  namespace
+  {
+    /// @brief A function, identified by its unit
+    struct FnRef
+    {
+      /// @brief The index of the unit defining the function
+      u32 unit;
+      /// @brief The index of the function in the unit
+      u32 index;
+    };
+
+    /// @brief Returns the key of the first instruction of a function of a unit
+    /// @param unit The index of the unit
+    /// @param begin The index of the first instruction
+    /// @return The key
+    constexpr u64 begin_key(u32 unit, u32 begin) noexcept
+    {
+      return (static_cast<u64>(unit) << 32) | begin;
+    }
+
+    /// @brief Check if an instruction is a relative call
+    /// @param encoded The encoded instruction
+    /// @return True if a relative call
+    constexpr bool is_relative_call(u64 encoded) noexcept
+    {
+      return encoding_of(encoded) == InstEncoding::BRANCH
+             && BranchInst::decode(encoded).op() == BranchInst::Op::call;
+    }
+
+    /// @brief Maps the callee of a canonical call through 'rep'.
+    /// In canonical bodies, the slot of 'call_global' and the offset of
+    /// relative calls are replaced by the ID of the function called.
+    /// @param encoded The canonical instruction
+    /// @param rep The representative of each function
+    /// @return The instruction calling the representative
+    u64 fold_callee(u64 encoded, View<u32> rep) noexcept
+    {
+      if (is_relative_call(encoded))
+        return BranchInst(
+                   BranchInst::Op::call, rep[BranchInst::decode(encoded).offset()])
+            .encoded();
+      if (encoding_of(encoded) == InstEncoding::GLOBAL)
+      {
+        auto inst = GlobalInst::decode(encoded);
+        if (inst.op() == GlobalInst::Op::call)
+          return GlobalInst(GlobalInst::Op::call, 0, rep[inst.slot()]).encoded();
+      }
+      return encoded;
+    }
+  } // namespace
+
+  Expect<LinkStats, LinkError> StaticLinker::link(StringView entry) noexcept
+  {
+    COLT_TRACE_SCOPE("static link");
+    assert_true("'link' can only be called once!", !linked);
+    linked = true;
+
+    LinkStats stats;
+    // Every function and variable of all the units is given an ID
+    Vector<FnRef> functions;
+    Map<StringView, u32> by_name;
+    Map<u64, u32> by_begin;
+    Vector<u32> var_base = Vector<u32>(units.size());
+    Vector<QWORD_t> initial_values;
+    for (u32 u = 0; u < units.size(); u++)
+    {
+      var_base.push_back(stats.var_total);
+      stats.var_total += static_cast<u32>(units[u]->variables.size());
+      for (auto value : units[u]->variables)
+        initial_values.push_back(value);
+      for (u32 i = 0; i < units[u]->functions.size(); i++)
+      {
+        auto& fn = units[u]->functions[i];
+        if (by_name.insert(fn.name, (u32)functions.size()).second
+            == InsertionResult::EXISTS)
+          return {Error, LinkError::DUPLICATE_FUNCTION};
+        by_begin.insert(begin_key(u, fn.begin), (u32)functions.size());
+        functions.push_back(FnRef{u, i});
+      }
+    }
+    stats.fn_total = static_cast<u32>(functions.size());
+
+    auto entry_fn = by_name.find(entry);
+    if (entry_fn == nullptr)
+      return {Error, LinkError::UNDEFINED_ENTRY};
+
+    // Reachability from the entry point, which also computes the
+    // canonical body of each reachable function
+    Vector<Vector<u64>> bodies = Vector<Vector<u64>>(functions.size(), InPlace);
+    Vector<bool> reached   = Vector<bool>(functions.size(), InPlace, false);
+    Vector<u32> order      = Vector<u32>(functions.size());
+    order.push_back(entry_fn->second);
+    reached[entry_fn->second] = true;
+    for (size_t next = 0; next < order.size(); next++)
+    {
+      const u32 id    = order[next];
+      const auto& unit = *units[functions[id].unit];
+      const auto& fn   = unit.functions[functions[id].index];
+      auto& body       = bodies[id];
+      assert_true(
+          "Invalid function bounds!", fn.begin <= fn.end, fn.end <= unit.code.size());
+
+      auto callee = Option<u32>{None};
+      for (u32 i = fn.begin; i < fn.end; i++)
+      {
+        u64 encoded = unit.code[i];
+        if (is_relative_call(encoded))
+        {
+          const i64 offset = BranchInst::decode(encoded).offset();
+          const i64 target = static_cast<i64>(i) + offset / (i64)sizeof(u64);
+          auto found       = offset % (i64)sizeof(u64) == 0 && target >= 0
+                                 ? by_begin.find(
+                                     begin_key(functions[id].unit, (u32)target))
+                                 : nullptr;
+          if (found == nullptr)
+            return {Error, LinkError::INVALID_CALL};
+          callee  = found->second;
+          encoded = BranchInst(BranchInst::Op::call, found->second).encoded();
+        }
+        else if (encoding_of(encoded) == InstEncoding::GLOBAL)
+        {
+          auto inst = GlobalInst::decode(encoded);
+          if (inst.op() == GlobalInst::Op::call)
+          {
+            if (inst.slot() >= unit.fn_refs.size())
+              return {Error, LinkError::INVALID_SLOT};
+            auto found = by_name.find(unit.fn_refs[inst.slot()]);
+            if (found == nullptr)
+              return {Error, LinkError::UNDEFINED_FUNCTION};
+            callee  = found->second;
+            encoded = GlobalInst(GlobalInst::Op::call, 0, found->second).encoded();
+          }
+          else
+          {
+            if (inst.slot() >= unit.variables.size())
+              return {Error, LinkError::INVALID_SLOT};
+            encoded = GlobalInst(
+                          inst.op(), inst.reg(),
+                          var_base[functions[id].unit] + inst.slot())
+                          .encoded();
+          }
+        }
+        body.push_back(encoded);
+        if (callee.is_value() && !reached[*callee])
+        {
+          reached[*callee] = true;
+          order.push_back(*callee);
+        }
+        callee = None;
+      }
+    }
+
+    // Identical code folding: functions whose bodies are equal once
+    // their callees are replaced by their representatives are folded.
+    // This is repeated until no more functions are folded, as folding
+    // callees can make their callers identical.
+    Vector<u32> rep = Vector<u32>(functions.size());
+    for (u32 i = 0; i < functions.size(); i++)
+      rep.push_back(i);
+    for (bool folded = true; folded;)
+    {
+      folded = false;
+      Map<u64, u32> by_hash;
+      for (auto id : order)
+      {
+        if (rep[id] != id)
+          continue;
+        u64 seed = 0;
+        for (auto encoded : bodies[id])
+          seed = hash_combine(seed, hash_value(fold_callee(encoded, rep)));
+        auto [slot, result] = by_hash.insert(seed, id);
+        if (result == InsertionResult::SUCCESS)
+          continue;
+        // On hash collisions of different bodies, nothing is folded
+        const auto& a = bodies[slot->second];
+        const auto& b = bodies[id];
+        bool equal    = a.size() == b.size();
+        for (size_t i = 0; equal && i < a.size(); i++)
+          equal = fold_callee(a[i], rep) == fold_callee(b[i], rep);
+        if (!equal)
+          continue;
+        for (auto& r : rep)
+          if (r == id)
+            r = slot->second;
+        ++stats.fn_folded;
+        folded = true;
+      }
+    }
+
+    // Layout: representatives in reachability order (the entry first)
+    Vector<u32> fn_slot = Vector<u32>(functions.size(), InPlace, 0u);
+    Vector<u32> var_slot =
+        Vector<u32>(stats.var_total, InPlace, std::numeric_limits<u32>::max());
+    u64 size = 0;
+    for (auto id : order)
+    {
+      if (rep[id] != id)
+        continue;
+      fn_slot[id] = static_cast<u32>(fn_offsets.size());
+      fn_offsets.push_back(size * sizeof(u64));
+      size += bodies[id].size();
+      for (auto encoded : bodies[id])
+      {
+        if (encoding_of(encoded) != InstEncoding::GLOBAL)
+          continue;
+        auto inst = GlobalInst::decode(encoded);
+        if (inst.op() == GlobalInst::Op::call
+            || var_slot[inst.slot()] != std::numeric_limits<u32>::max())
+          continue;
+        var_slot[inst.slot()] = static_cast<u32>(variables.size());
+        variables.push_back(initial_values[inst.slot()]);
+      }
+    }
+
+    // Relocation of the canonical bodies
+    code.reserve(size);
+    for (auto id : order)
+    {
+      if (rep[id] != id)
+        continue;
+      for (auto encoded : bodies[id])
+      {
+        if (is_relative_call(encoded))
+        {
+          const u64 target =
+              fn_offsets[fn_slot[rep[BranchInst::decode(encoded).offset()]]];
+          encoded = BranchInst(
+                        BranchInst::Op::call,
+                        static_cast<i64>(target)
+                            - static_cast<i64>(code.size() * sizeof(u64)))
+                        .encoded();
+        }
+        else if (encoding_of(encoded) == InstEncoding::GLOBAL)
+        {
+          auto inst = GlobalInst::decode(encoded);
+          encoded   = GlobalInst(
+                        inst.op(), inst.reg(),
+                        inst.op() == GlobalInst::Op::call ? fn_slot[rep[inst.slot()]]
+                                                            : var_slot[inst.slot()])
+                        .encoded();
+        }
+        code.push_back(encoded);
+      }
+    }
+
+    // Instructions do not refer to the constant pool yet, so constants
+    // and strings are merged (and deduplicated) without any stripping
+    for (auto unit : units)
+    {
+      for (auto constant : unit->constants)
+        pool.add_constant(constant);
+      for (auto str : unit->strings)
+        pool.add_string(str);
+    }
+
+    stats.fn_kept   = static_cast<u32>(fn_offsets.size());
+    stats.var_kept  = static_cast<u32>(variables.size());
+    stats.code_size = code.size() * sizeof(u64);
+    return stats;
+  }
+
+  void StaticLinker::write_to(ColtiWriter& writer, bool compress) const noexcept
+  {
+    assert_true("'link' was not called!", linked);
+    writer.begin_section(CODE_SECTION_NAME, compress);
+    for (auto encoded : code)
+      writer.write_le(encoded);
+    writer.end_section();
+
+    pool.write_to(writer, compress);
+
+    writer.begin_section(GlobalMemory::SECTION_NAME, compress);
+    writer.write_le<u64>(variables.size());
+    writer.write_le<u64>(fn_offsets.size());
+    for (auto value : variables)
+      writer.write_le(value.as<u64>());
+    for (auto offset : fn_offsets)
+      writer.write_le(offset);
+    writer.end_section();
+  }
+} // namespace clt::run
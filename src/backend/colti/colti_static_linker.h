@@ -0,0 +1,143 @@
+/*****************************************************************/ /**
+ * @file   colti_static_linker.h
+ * @brief  Contains StaticLinker, which merges the compiled code of
+ * many units into a single Colti executable.
+ * Starting from the entry point, only the functions reachable through
+ * calls and the global variables reachable through loads and stores
+ * are kept. Functions with identical bodies are folded into one (ICF).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLTI_STATIC_LINKER
+#define HG_COLTI_STATIC_LINKER
+
+#include "colti_linker.h"
+#include "structs/expect.h"
+
+DECLARE_ENUM_WITH_TYPE(
+    u8, clt::run, LinkError,
+    UNDEFINED_ENTRY,    // the entry point is not defined
+    UNDEFINED_FUNCTION, // a called function is not defined
+    DUPLICATE_FUNCTION, // a function is defined more than once
+    INVALID_CALL,       // a relative call does not target a function
+    INVALID_SLOT        // a global instruction refers to an invalid slot
+);
+
+namespace clt::run
+{
+  /// @brief A function of a LinkUnit
+  struct LinkFunction
+  {
+    /// @brief The name of the function (unique across all the units)
+    StringView name;
+    /// @brief The index of the first instruction of the function
+    u32 begin;
+    /// @brief The index past the last instruction of the function
+    u32 end;
+  };
+
+  /// @brief The compiled code of a unit, before linking.
+  /// Inside a unit, 'load_global'/'store_global' refer to the slots of
+  /// 'variables', 'call_global' refers to the slots of 'fn_refs', and
+  /// relative 'call' must target the first instruction of a function
+  /// of the same unit. Other branches must not leave their function.
+  struct LinkUnit
+  {
+    /// @brief The encoded instructions of the unit
+    Vector<u64> code{};
+    /// @brief The functions defined by the unit
+    Vector<LinkFunction> functions{};
+    /// @brief The initial values of the global variables of the unit
+    Vector<QWORD_t> variables{};
+    /// @brief The names of the functions called through 'call_global'
+    Vector<StringView> fn_refs{};
+    /// @brief The constants of the unit
+    Vector<QWORD_t> constants{};
+    /// @brief The string literals of the unit
+    Vector<StringView> strings{};
+  };
+
+  /// @brief The statistics of a link
+  struct LinkStats
+  {
+    /// @brief The number of functions of all the units
+    u32 fn_total = 0;
+    /// @brief The number of functions written
+    u32 fn_kept = 0;
+    /// @brief The number of reachable functions folded into another
+    u32 fn_folded = 0;
+    /// @brief The number of global variables of all the units
+    u32 var_total = 0;
+    /// @brief The number of global variables written
+    u32 var_kept = 0;
+    /// @brief The size in bytes of the code section
+    u64 code_size = 0;
+  };
+
+  /// @brief Links many units into a single executable.
+  /// The executable contains a 'code' section, a 'const' section (see
+  /// ConstantPool) and a 'globals' section (see GlobalMemory).
+  /// The entry point is always the function of slot 0, at offset 0.
+  /// @code{.cpp}
+  /// StaticLinker linker;
+  /// linker.add(unit1);
+  /// linker.add(unit2);
+  /// if (auto stats = linker.link("main"); stats.is_error())
+  ///   // handle error
+  /// auto writer = ColtiWriter::open(path, StaticLinker::SECTION_COUNT, version, None);
+  /// linker.write_to(*writer);
+  /// @endcode
+  class StaticLinker
+  {
+    /// @brief The units to link (which must outlive the linker)
+    Vector<const LinkUnit*> units{};
+    /// @brief The linked code
+    Vector<u64> code{};
+    /// @brief The offset of each linked function in the code section
+    Vector<u64> fn_offsets{};
+    /// @brief The initial values of the linked global variables
+    Vector<QWORD_t> variables{};
+    /// @brief The merged constants and strings
+    ConstantPool pool{};
+    /// @brief True if 'link' was already called
+    bool linked = false;
+
+  public:
+    /// @brief The name of the code section
+    static constexpr StringView CODE_SECTION_NAME = "code";
+    /// @brief The number of sections written by 'write_to'
+    static constexpr u16 SECTION_COUNT = 3;
+
+    /// @brief Adds a unit to link.
+    /// @param unit The unit (which must outlive the linker)
+    void add(const LinkUnit& unit) noexcept { units.push_back(&unit); }
+
+    /// @brief Links all the units added, starting from the entry point.
+    /// Can only be called once.
+    /// @param entry The name of the entry point
+    /// @return The statistics of the link or the error encountered
+    Expect<LinkStats, LinkError> link(StringView entry) noexcept;
+
+    /// @brief Returns the linked code
+    /// @return The linked code
+    View<u64> linked_code() const noexcept { return code; }
+    /// @brief Returns the offset of each linked function (by slot)
+    /// @return The offsets of the linked functions
+    View<u64> function_offsets() const noexcept { return fn_offsets; }
+    /// @brief Returns the initial values of the linked variables (by slot)
+    /// @return The initial values of the linked variables
+    View<QWORD_t> linked_variables() const noexcept { return variables; }
+    /// @brief Returns the merged constant pool
+    /// @return The constant pool
+    const ConstantPool& constant_pool() const noexcept { return pool; }
+
+    /// @brief Writes the SECTION_COUNT sections of the executable.
+    /// @pre 'link' was successful
+    /// @param writer The writer to which to write
+    /// @param compress True to compress the sections
+    void write_to(ColtiWriter& writer, bool compress = false) const noexcept;
+  };
+} // namespace clt::run
+
+#endif // !HG_COLTI_STATIC_LINKER
@@ -0,0 +1,147 @@
+/*****************************************************************/ /**
+ * @file   colti_writer.cpp
+ * @brief  Contains the implementation of 'colti_writer.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "colti_writer.h"
+
+namespace clt::run
+{
+  /// @brief Appends bytes to a vector, growing it geometrically
+  /// @param to The vector to which to append
+  /// @param ptr The bytes to append
+  /// @param size The count of bytes to append
+  static void append_bytes(Vector<u8>& to, const void* ptr, u64 size) noexcept
+  {
+    if (to.capacity() - to.size() < size)
+      to.reserve(clt::max<u64>(size, to.capacity()));
+    std::memcpy(to.data() + to.size(), ptr, size);
+    to._Unsafe_size(to.size() + size);
+  }
+
+  Option<ColtiWriter> ColtiWriter::open(
+      const char* path, u16 section_count, const ColtVersion& version,
+      Option<time_point> time, u64 buffer_size) noexcept
+  {
+    auto file = io::BufferedWriter::open(path, buffer_size);
+    if (file.is_none())
+      return None;
+
+    auto header =
+        ColtiHeader{section_count, version, time, ColtiHeader::FLAG_CHECKSUMS};
+    file->write(&header, sizeof(ColtiHeader));
+    // Reserve the section directory, which is patched by 'finish'
+    file->write_repeat(0, header.directory_size());
+    return ColtiWriter(std::move(*file), section_count);
+  }
+
+  void ColtiWriter::append(const void* ptr, u64 size) noexcept
+  {
+    assert_true("No section was begun!", current_size_offset != 0);
+    if (compress_current)
+    {
+      append_bytes(pending, ptr, size);
+      return;
+    }
+    current_crc = crc32c(current_crc, ptr, size);
+    writer.write(ptr, size);
+  }
+
+  void ColtiWriter::begin_section(StringView name, bool compress) noexcept
+  {
+    assert_true("Previous section was not ended!", current_size_offset == 0);
+    assert_true("Too many sections!", offsets.size() < declared_count);
+    assert_true(
+        "Invalid section name!", !name.empty(), name.size() <= MAX_SECTION_NAME_SIZE,
+        name.find('\0') == StringView::npos);
+
+    // Sections always start on an 8-byte boundary
+    writer.pad_to(8);
+    offsets.push_back(writer.position());
+    writer.write(name);
+    writer.write_repeat(0, 1);
+    writer.pad_to(8);
+    current_size_offset = writer.position();
+    current_crc         = 0;
+    compress_current    = compress;
+    // The size is patched by 'end_section'
+    writer.write_le<u64>(0);
+  }
+
+  void ColtiWriter::end_section() noexcept
+  {
+    assert_true("No section was begun!", current_size_offset != 0);
+    u64 size_flag = 0;
+    if (compress_current)
+    {
+      // Compressed content: [u64 raw_size][LZ4 block]
+      compressed._Unsafe_size(0);
+      const u64 raw_size = htol<u64>(pending.size());
+      append_bytes(compressed, &raw_size, sizeof(u64));
+      lz4::compress(pending, compressed);
+
+      // Incompressible content is stored as is
+      auto& stored = compressed.size() < pending.size() ? compressed : pending;
+      if (&stored == &compressed)
+        size_flag = ColtiHeader::SECTION_COMPRESSED;
+      current_crc = crc32c(current_crc, stored.data(), stored.size());
+      writer.write(stored);
+      pending._Unsafe_size(0);
+      compress_current = false;
+    }
+    const u64 content_start = current_size_offset + sizeof(u64);
+    writer.patch_le<u64>(
+        current_size_offset, (writer.position() - content_start) | size_flag);
+    checksums.push_back(current_crc);
+    current_size_offset = 0;
+  }
+
+  ErrorFlag ColtiWriter::finish() noexcept
+  {
+    assert_true("Section was not ended!", current_size_offset == 0);
+    assert_true("Not all sections were written!", offsets.size() == declared_count);
+
+    writer.pad_to(8);
+    for (auto& offset : offsets)
+      offset = htol(offset);
+    for (auto& checksum : checksums)
+      checksum = htol(checksum);
+    // The offset table directly follows the header, and is
+    // directly followed by the checksums
+    writer.patch(
+        sizeof(ColtiHeader), offsets.data(), offsets.size() * sizeof(u64));
+    writer.patch(
+        sizeof(ColtiHeader) + offsets.size() * sizeof(u64), checksums.data(),
+        checksums.size() * sizeof(u32));
+    return writer.flush();
+  }
+
+  u64 ConstantPool::add_string(StringView value) noexcept
+  {
+    assert_true("String must not contain NUL!", value.find('\0') == StringView::npos);
+    auto [index, result] = strings.insert(value);
+    if (result == InsertionResult::EXISTS)
+      return string_offsets[index];
+    string_offsets.push_back(strings_size);
+    // + 1 for the NUL-terminator
+    strings_size += value.size() + 1;
+    return string_offsets[index];
+  }
+
+  void ConstantPool::write_to(ColtiWriter& writer, bool compress) const noexcept
+  {
+    writer.begin_section(SECTION_NAME, compress);
+    writer.write_le<u64>(constants.size());
+    for (auto constant : constants)
+      writer.write_le(constant);
+    static constexpr u8 NUL = 0;
+    for (auto str : strings)
+    {
+      writer.write(str);
+      writer.write(View<u8>{&NUL, 1});
+    }
+    writer.end_section();
+  }
+} // namespace clt::run
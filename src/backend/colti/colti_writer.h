@@ -0,0 +1,198 @@
+/*****************************************************************/ /**
+ * @file   colti_writer.h
+ * @brief  Contains ColtiWriter, which writes Colti executables.
+ * The executable is streamed to the disk section by section: only
+ * the offset table is patched once all the sections were written.
+ * The CRC32C of each section is computed while it is streamed,
+ * and stored in the section directory.
+ * Sections can optionally be compressed (using LZ4), in which case
+ * their content is buffered until the section is ended.
+ * ConstantPool deduplicates the constants and string literals of
+ * a whole program into a single section.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLTI_WRITER
+#define HG_COLTI_WRITER
+
+#include "colti_exe.h"
+#include "io/buffered_writer.h"
+#include "common/crc32.h"
+#include "common/lz4.h"
+
+namespace clt::run
+{
+  /// @brief Streams a Colti executable to a file.
+  /// The number of sections must be known before writing any section,
+  /// as the offset table is reserved directly after the header.
+  /// @code{.cpp}
+  /// auto writer = ColtiWriter::open("a.colti", 2, version, None);
+  /// writer->write_section("code", code);
+  /// writer->begin_section("data", true); // compressed
+  /// writer->write(part1);
+  /// writer->write(part2);
+  /// writer->end_section();
+  /// if (writer->finish().is_error())
+  ///   // handle error
+  /// @endcode
+  class ColtiWriter
+  {
+    /// @brief The output
+    io::BufferedWriter writer;
+    /// @brief The offset of each section (from the start of the file)
+    Vector<u64> offsets;
+    /// @brief The CRC32C of the content of each section
+    Vector<u32> checksums;
+    /// @brief The number of sections declared in the header
+    u16 declared_count;
+    /// @brief The offset of the size of the current section or 0 if none
+    u64 current_size_offset = 0;
+    /// @brief The CRC32C of the content of the current section
+    u32 current_crc = 0;
+    /// @brief True if the current section should be compressed
+    bool compress_current = false;
+    /// @brief The content of the current section if it is compressed
+    Vector<u8> pending{};
+    /// @brief The compressed content of the current section
+    Vector<u8> compressed{};
+
+    /// @brief Constructor
+    /// @param writer The output
+    /// @param section_count The number of sections that will be written
+    ColtiWriter(io::BufferedWriter&& writer, u16 section_count) noexcept
+        : writer(std::move(writer))
+        , offsets(section_count)
+        , checksums(section_count)
+        , declared_count(section_count)
+    {
+    }
+
+  public:
+    /// @brief The maximum size of a section name (without NUL-terminator)
+    static constexpr u64 MAX_SECTION_NAME_SIZE = 31;
+
+    ColtiWriter(ColtiWriter&&) noexcept = default;
+
+    /// @brief Opens a file for writing, and writes the header.
+    /// @param path The path of the file to write to
+    /// @param section_count The number of sections that will be written
+    /// @param version The language version
+    /// @param time The compilation time stamp or None
+    /// @param buffer_size The size of the buffer used for writing
+    /// @return None if the file could not be opened, else the writer
+    static Option<ColtiWriter> open(
+        const char* path, u16 section_count, const ColtVersion& version,
+        Option<time_point> time,
+        u64 buffer_size = io::BufferedWriter::DEFAULT_BUFFER_SIZE) noexcept;
+
+    /// @brief Appends bytes to the content of the current section
+    /// @param ptr The bytes to append
+    /// @param size The count of bytes to append
+    void append(const void* ptr, u64 size) noexcept;
+
+    /// @brief Begins a new section, whose content is written using 'write'.
+    /// A compressed section is only stored compressed if that makes it smaller.
+    /// @param name The name of the section (31 characters at most)
+    /// @param compress True to compress the section
+    void begin_section(StringView name, bool compress = false) noexcept;
+
+    /// @brief Appends bytes to the content of the current section
+    /// @param bytes The bytes to append
+    void write(View<u8> bytes) noexcept { append(bytes.data(), bytes.size()); }
+
+    template<meta::UnsignedIntegral T>
+    /// @brief Appends an unsigned integer (in little endian) to the current section
+    /// @param value The value to append
+    void write_le(T value) noexcept
+    {
+      value = htol(value);
+      append(&value, sizeof(T));
+    }
+
+    /// @brief Appends a string to the content of the current section
+    /// @param str The string to append (the NUL-terminator is not written)
+    void write(StringView str) noexcept { append(str.data(), str.size()); }
+
+    /// @brief Ends the current section, patching its size.
+    /// If the section is compressed, this is where its content is written.
+    void end_section() noexcept;
+
+    /// @brief Writes a whole section
+    /// @param name The name of the section (31 characters at most)
+    /// @param content The content of the section
+    /// @param compress True to compress the section
+    void write_section(
+        StringView name, View<u8> content, bool compress = false) noexcept
+    {
+      begin_section(name, compress);
+      write(content);
+      end_section();
+    }
+
+    /// @brief Returns the number of sections that were written
+    /// @return The number of sections written
+    u16 written_count() const noexcept { return (u16)offsets.size(); }
+
+    /// @brief Patches the section directory and flushes the output.
+    /// All the declared sections must have been written.
+    /// @return Success if all the writes were successful
+    ErrorFlag finish() noexcept;
+  };
+
+  /// @brief Deduplicates the constants and string literals of a program.
+  /// The pool is written as a single section of the following layout:
+  /// [u64 constant_count] [u64 constants[constant_count]] [strings]
+  /// where each string is NUL-terminated.
+  class ConstantPool
+  {
+    /// @brief The 8-byte constants
+    IndexedSet<u64> constants{};
+    /// @brief The string literals
+    IndexedSet<StringView> strings{};
+    /// @brief The offset of each string from the beginning of the strings
+    Vector<u64> string_offsets{};
+    /// @brief The size of all the strings (including NUL-terminators)
+    u64 strings_size = 0;
+
+  public:
+    /// @brief The name of the section containing the pool
+    static constexpr StringView SECTION_NAME = "const";
+
+    /// @brief Adds a constant to the pool if it does not already exist
+    /// @param value The constant
+    /// @return The index of the constant in the pool
+    u64 add_constant(QWORD_t value) noexcept
+    {
+      return constants.insert(value.as<u64>()).first;
+    }
+
+    /// @brief Adds a string to the pool if it does not already exist.
+    /// The string must live as long as the pool.
+    /// @param value The string (which must not contain NUL characters)
+    /// @return The offset of the string from the start of the strings
+    u64 add_string(StringView value) noexcept;
+
+    /// @brief Returns the number of unique constants
+    /// @return The number of unique constants
+    u64 constant_count() const noexcept { return constants.size(); }
+
+    /// @brief Returns the number of unique strings
+    /// @return The number of unique strings
+    u64 string_count() const noexcept { return strings.size(); }
+
+    /// @brief Returns the size in bytes of the section
+    /// @return The size of the section
+    u64 byte_size() const noexcept
+    {
+      return sizeof(u64) * (1 + constants.size()) + strings_size;
+    }
+
+    /// @brief Writes the pool as a section named SECTION_NAME
+    /// @param writer The writer to which to write
+    /// @param compress True to compress the section
+    void write_to(ColtiWriter& writer, bool compress = false) const noexcept;
+  };
+} // namespace clt::run
+
+#endif // !HG_COLTI_WRITER
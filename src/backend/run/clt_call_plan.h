@@ -0,0 +1,370 @@
+/*****************************************************************/ /**
+ * @file   clt_call_plan.h
+ * @brief  Contains CallPlan and CallPlanCache, which speed up repeated
+ * FFI calls to the same function.
+ * A CallPlan is built once per signature (function, argument types and
+ * return type): the per-argument switch over TypeOp of 'push_qword' is
+ * resolved when the plan is built, so that a call only goes through
+ * precomputed function pointers.
+ * On x86-64 System V, functions whose arguments are all integers (at
+ * most 6, which are all passed in registers) are called directly,
+ * without going through Dyncall.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_CLT_CALL_PLAN
+#define HG_CLT_CALL_PLAN
+
+#include "clt_dyncall.h"
+#include "structs/map.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+  /// @brief If defined, integer-only calls do not go through Dyncall
+  #define COLT_FFI_NATIVE_SYSV
+#endif
+
+namespace clt::run
+{
+  /// @brief The signature of a function called through FFI
+  struct CallSignature
+  {
+    /// @brief The return type used for functions returning void
+    static constexpr u8 VOID_RETURN = 0xFF;
+
+    /// @brief The address of the function
+    void* fn;
+    /// @brief [4b: TypeOp] per argument, starting from the lowest bits
+    u64 args;
+    /// @brief The number of arguments
+    u8 arg_count;
+    /// @brief The TypeOp returned or VOID_RETURN
+    u8 return_t;
+
+    /// @brief Creates a signature
+    /// @param fn The address of the function
+    /// @param args The types of the arguments (at most 16)
+    /// @param return_t The return type (or None for void)
+    /// @return The signature
+    static CallSignature make(
+        void* fn, View<TypeOp> args, Option<TypeOp> return_t) noexcept
+    {
+      assert_true("Too many arguments!", args.size() <= 16);
+      u64 packed = 0;
+      for (size_t i = 0; i < args.size(); i++)
+        packed |= static_cast<u64>(args[i]) << (i * 4);
+      return CallSignature{
+          fn, packed, static_cast<u8>(args.size()),
+          return_t.is_value() ? static_cast<u8>(*return_t) : VOID_RETURN};
+    }
+
+    /// @brief Returns the type of an argument
+    /// @param index The index of the argument (< arg_count)
+    /// @return The type of the argument
+    constexpr TypeOp arg(u8 index) const noexcept
+    {
+      assert_true("Invalid index!", index < arg_count);
+      return static_cast<TypeOp>((args >> (index * 4)) & 0b1111);
+    }
+
+    /// @brief Comparison operator
+    /// @return True if equal
+    friend bool operator==(const CallSignature&, const CallSignature&) = default;
+  };
+} // namespace clt::run
+
+namespace clt
+{
+  template<>
+  /// @brief clt::hash overload for CallSignature
+  struct hash<run::CallSignature>
+  {
+    /// @brief Hashing operator
+    /// @param sig The value to hash
+    /// @return Hash
+    constexpr size_t operator()(const run::CallSignature& sig) const noexcept
+    {
+      size_t seed = hash_value(sig.fn);
+      seed ^= hash_value(sig.args) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= hash_value(
+                  (static_cast<u64>(sig.arg_count) << 8) | sig.return_t)
+              + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+} // namespace clt
+
+namespace clt::run
+{
+  namespace details
+  {
+    /// @brief Pushes an argument to a DCCallVM
+    using ffi_push_t = void (*)(DCCallVM*, QWORD_t) noexcept;
+    /// @brief Calls a function through a DCCallVM
+    using ffi_call_t = QWORD_t (*)(DCCallVM*, void*) noexcept;
+    /// @brief Calls a function directly with extended integer arguments
+    using ffi_native_t = QWORD_t (*)(void*, const u64*) noexcept;
+
+    template<TypeOp Op>
+    /// @brief Pushes an argument of type 'Op'
+    /// @param vm The call VM
+    /// @param qword The argument
+    void ffi_push(DCCallVM* vm, QWORD_t qword) noexcept
+    {
+      using Ty = TypeOp_to_type_t<Op>;
+      if constexpr (sizeof(Ty) == 1)
+        dcArgChar(vm, qword.as<char>());
+      else if constexpr (sizeof(Ty) == 2)
+        dcArgShort(vm, qword.as<short>());
+      else if constexpr (std::same_as<Ty, f32>)
+        dcArgFloat(vm, qword.as<f32>());
+      else if constexpr (std::same_as<Ty, f64>)
+        dcArgDouble(vm, qword.as<f64>());
+      else if constexpr (sizeof(Ty) == 4)
+        dcArgInt(vm, qword.as<int>());
+      else
+        dcArgLongLong(vm, qword.as<long long>());
+    }
+
+    template<TypeOp Op>
+    /// @brief Calls a function returning a value of type 'Op'
+    /// @param vm The call VM (whose arguments were pushed)
+    /// @param fn The function to call
+    /// @return The returned value
+    QWORD_t ffi_call(DCCallVM* vm, void* fn) noexcept
+    {
+      using Ty = TypeOp_to_type_t<Op>;
+      QWORD_t ret;
+      if constexpr (sizeof(Ty) == 1)
+        ret.bit_assign(dcCallChar(vm, fn));
+      else if constexpr (sizeof(Ty) == 2)
+        ret.bit_assign(dcCallShort(vm, fn));
+      else if constexpr (std::same_as<Ty, f32>)
+        ret.bit_assign(dcCallFloat(vm, fn));
+      else if constexpr (std::same_as<Ty, f64>)
+        ret.bit_assign(dcCallDouble(vm, fn));
+      else if constexpr (sizeof(Ty) == 4)
+        ret.bit_assign(dcCallInt(vm, fn));
+      else
+        ret.bit_assign(dcCallLongLong(vm, fn));
+      return ret;
+    }
+
+    /// @brief Calls a function returning void
+    /// @param vm The call VM (whose arguments were pushed)
+    /// @param fn The function to call
+    /// @return Empty QWORD_t
+    inline QWORD_t ffi_call_void(DCCallVM* vm, void* fn) noexcept
+    {
+      dcCallVoid(vm, fn);
+      return QWORD_t{};
+    }
+
+    COLT_GENERATE_TABLE_FOR(ffi_push);
+    COLT_GENERATE_TABLE_FOR(ffi_call);
+
+    template<typename Ret, size_t... I>
+    /// @brief Calls 'fn' as a function taking sizeof...(I) integers
+    /// @param fn The function to call
+    /// @param args The (already extended) arguments
+    /// @return The returned value
+    QWORD_t ffi_native_impl(
+        void* fn, const u64* args, std::index_sequence<I...>) noexcept
+    {
+      using fn_t = Ret (*)(decltype((void)I, u64{})...);
+      QWORD_t ret;
+      if constexpr (std::is_void_v<Ret>)
+        reinterpret_cast<fn_t>(fn)(args[I]...);
+      else
+        ret.bit_assign(reinterpret_cast<fn_t>(fn)(args[I]...));
+      return ret;
+    }
+
+    template<typename Ret, size_t N>
+    /// @brief Calls 'fn' as a function taking N integers
+    /// @param fn The function to call
+    /// @param args The (already extended) arguments
+    /// @return The returned value
+    QWORD_t ffi_native(void* fn, const u64* args) noexcept
+    {
+      return ffi_native_impl<Ret>(fn, args, std::make_index_sequence<N>{});
+    }
+
+    template<typename Ret, size_t... N>
+    /// @brief Generates the table of 'ffi_native' indexed by argument count
+    /// @return The table
+    consteval auto generate_ffi_native_table(std::index_sequence<N...>) noexcept
+    {
+      return std::array<ffi_native_t, sizeof...(N)>{&ffi_native<Ret, N>...};
+    }
+  } // namespace details
+
+  /// @brief Precompiled marshalling of the arguments of a function.
+  /// Building a plan resolves all the type dispatch, so that invoking
+  /// it only goes through function pointers.
+  class CallPlan
+  {
+  public:
+    /// @brief The maximum number of arguments of a plan
+    static constexpr u8 MAX_ARGS = 16;
+    /// @brief The maximum number of arguments of a native call
+    static constexpr u8 MAX_NATIVE_ARGS = 6;
+
+  private:
+    /// @brief The function to call
+    void* fn;
+    /// @brief Pushes each argument (if not native)
+    std::array<details::ffi_push_t, MAX_ARGS> pushers{};
+    /// @brief Calls the function (if not native)
+    details::ffi_call_t caller = nullptr;
+    /// @brief Calls the function (if native)
+    details::ffi_native_t native = nullptr;
+    /// @brief The shift by which to extend each argument (if native)
+    std::array<u8, MAX_NATIVE_ARGS> shifts{};
+    /// @brief Bit 'i' is set if argument 'i' is signed (if native)
+    u8 signed_mask = 0;
+    /// @brief The number of arguments
+    u8 count;
+
+  public:
+    /// @brief Builds the plan of a signature
+    /// @param sig The signature
+    CallPlan(const CallSignature& sig) noexcept
+        : fn(sig.fn)
+        , count(sig.arg_count)
+    {
+      using enum TypeOp;
+      static constexpr std::array PUSHERS = COLT_TypeOpTable(ffi_push);
+      static constexpr std::array CALLERS = COLT_TypeOpTable(ffi_call);
+
+      assert_true("Too many arguments!", count <= MAX_ARGS);
+#ifdef COLT_FFI_NATIVE_SYSV
+      bool all_integral = count <= MAX_NATIVE_ARGS;
+      for (u8 i = 0; i < count && all_integral; i++)
+      {
+        const auto type = sig.arg(i);
+        all_integral    = type != f32_t && type != f64_t;
+        if (!all_integral)
+          break;
+        shifts[i] = static_cast<u8>(64 - to_sizeof(type));
+        if (type == i8_t || type == i16_t || type == i32_t || type == i64_t)
+          signed_mask |= static_cast<u8>(1 << i);
+      }
+      if (all_integral)
+      {
+        native = native_table(sig.return_t)[count];
+        return;
+      }
+#endif // COLT_FFI_NATIVE_SYSV
+      for (u8 i = 0; i < count; i++)
+        pushers[i] = PUSHERS[static_cast<u8>(sig.arg(i))];
+      caller = sig.return_t == CallSignature::VOID_RETURN
+                   ? &details::ffi_call_void
+                   : CALLERS[sig.return_t];
+    }
+
+    /// @brief Returns the table of native calls for a return type
+    /// @param return_t The return type (or VOID_RETURN)
+    /// @return The table indexed by argument count
+    static const std::array<details::ffi_native_t, MAX_NATIVE_ARGS + 1>& native_table(
+        u8 return_t) noexcept
+    {
+      using enum TypeOp;
+      using namespace details;
+      using seq_t = std::make_index_sequence<MAX_NATIVE_ARGS + 1>;
+      static constexpr auto VOID = generate_ffi_native_table<void>(seq_t{});
+      static constexpr auto I8   = generate_ffi_native_table<i8>(seq_t{});
+      static constexpr auto I16  = generate_ffi_native_table<i16>(seq_t{});
+      static constexpr auto I32  = generate_ffi_native_table<i32>(seq_t{});
+      static constexpr auto I64  = generate_ffi_native_table<i64>(seq_t{});
+      static constexpr auto F32  = generate_ffi_native_table<f32>(seq_t{});
+      static constexpr auto F64  = generate_ffi_native_table<f64>(seq_t{});
+
+      if (return_t == CallSignature::VOID_RETURN)
+        return VOID;
+      switch_no_default(static_cast<TypeOp>(return_t))
+      {
+      case i8_t:
+      case u8_t:
+        return I8;
+      case i16_t:
+      case u16_t:
+        return I16;
+      case i32_t:
+      case u32_t:
+        return I32;
+      case i64_t:
+      case u64_t:
+        return I64;
+      case f32_t:
+        return F32;
+      case f64_t:
+        return F64;
+      }
+    }
+
+    /// @brief Check if the plan calls the function without Dyncall
+    /// @return True if native
+    bool is_native() const noexcept { return native != nullptr; }
+
+    /// @brief Returns the number of arguments of the function
+    /// @return The number of arguments
+    u8 arg_count() const noexcept { return count; }
+
+    /// @brief Calls the function.
+    /// Any argument pushed to 'binder' through 'push_arg/push_qword' is discarded.
+    /// @param binder The binder to use (if the call is not native)
+    /// @param args The arguments (at least 'arg_count()')
+    /// @return The returned value (empty if void)
+    QWORD_t invoke(DynamicBinder& binder, const QWORD_t* args) const noexcept
+    {
+      if (native != nullptr)
+      {
+        // The callee may rely on narrow arguments being extended.
+        u64 extended[MAX_NATIVE_ARGS];
+        for (u8 i = 0; i < count; i++)
+        {
+          const u64 value = args[i].to_underlying() << shifts[i];
+          extended[i]     = (signed_mask >> i) & 1
+                                ? static_cast<u64>(static_cast<i64>(value) >> shifts[i])
+                                : value >> shifts[i];
+        }
+        return native(fn, extended);
+      }
+      DCCallVM* vm = binder.call_vm();
+      dcReset(vm);
+      for (u8 i = 0; i < count; i++)
+        pushers[i](vm, args[i]);
+      return caller(vm, fn);
+    }
+  };
+
+  /// @brief Caches the CallPlan of each signature
+  class CallPlanCache
+  {
+    /// @brief The plans
+    Map<CallSignature, CallPlan> plans{};
+
+  public:
+    /// @brief Returns the plan of a signature, building it if needed.
+    /// The returned reference is invalidated by the next call to 'get'.
+    /// @param fn The address of the function
+    /// @param args The types of the arguments (at most 16)
+    /// @param return_t The return type (or None for void)
+    /// @return The plan
+    const CallPlan& get(
+        void* fn, View<TypeOp> args, Option<TypeOp> return_t) noexcept
+    {
+      const auto sig = CallSignature::make(fn, args, return_t);
+      if (auto slot = plans.find(sig); slot != nullptr)
+        return slot->second;
+      return plans.insert(sig, CallPlan{sig}).first->second;
+    }
+
+    /// @brief Returns the number of cached plans
+    /// @return The number of signatures
+    u64 size() const noexcept { return plans.size(); }
+  };
+} // namespace clt::run
+
+#endif // !HG_CLT_CALL_PLAN
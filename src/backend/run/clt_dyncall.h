@@ -40,6 +40,10 @@ namespace clt::run
     DynamicBinder& operator=(const DynamicBinder&)     = delete;
     DynamicBinder& operator=(DynamicBinder&&) noexcept = default;
 
+    /// @brief Returns the DCCallVM used to generate the calls
+    /// @return The DCCallVM
+    DCCallVM* call_vm() noexcept { return vm.get(); }
+
     /// @brief Adds a new argument to the next function call
     /// @tparam T The type of the value to add
     /// @param value The value to add
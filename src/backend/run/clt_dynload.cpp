@@ -10,31 +10,74 @@ namespace clt::run
   Option<DynamicLibrary> DynamicLibrary::load(const char* path) noexcept
   {
     assert_true("Invalid path!", path != nullptr);
-    auto lib  = dlLoadLibrary(path);
-    auto syms = dlSymsInit(path);
-    if (lib == nullptr || syms == nullptr)
+    auto lib = dlLoadLibrary(path);
+    if (lib == nullptr)
       return None;
-    return DynamicLibrary(lib, syms);
+    String str = StringView{path};
+    str.push_back('\0');
+    return DynamicLibrary(lib, std::move(str));
   }
 
   Option<DynamicLibrary> DynamicLibrary::load_current() noexcept
   {
-#ifdef _WIN32
-    auto lib  = dlLoadLibrary(nullptr);
-    auto syms = dlSymsInit(nullptr);
-    if (lib == nullptr || syms == nullptr)
+    auto lib = dlLoadLibrary(nullptr);
+    if (lib == nullptr)
       return None;
-    return DynamicLibrary(lib, syms);
+    // The path of the executable is only needed by 'symbol_table'
+    return DynamicLibrary(lib, String{});
+  }
+
+  DLSyms* DynamicLibrary::symbol_table() const noexcept
+  {
+    if (syms != nullptr)
+      return syms.get();
+#ifdef _WIN32
+    syms.reset(dlSymsInit(path.is_empty() ? nullptr : path.data()));
 #else
+    if (!path.is_empty())
+    {
+      syms.reset(dlSymsInit(path.data()));
+      return syms.get();
+    }
     char result[PATH_MAX] = {0};
-    ssize_t count         = readlink("/proc/self/exe", result, PATH_MAX);
+    ssize_t count         = readlink("/proc/self/exe", result, PATH_MAX - 1);
     if (count < 0)
-      return None;
-    auto lib  = dlLoadLibrary(nullptr);
-    auto syms = dlSymsInit(result);
-    if (lib == nullptr || syms == nullptr)
-      return None;
-    return DynamicLibrary(lib, syms);
+      return nullptr;
+    syms.reset(dlSymsInit(result));
 #endif
+    return syms.get();
+  }
+
+  void* DynamicLibrary::lookup(const char* name) noexcept
+  {
+    const StringView strv = name;
+    if (auto slot = symbols.find(strv); slot != nullptr)
+      return slot->second;
+    auto symbol = dlFindSymbol(lib.get(), name);
+    // Only found symbols are cached, as a library cannot gain symbols
+    if (symbol != nullptr)
+    {
+      names.push_back(String{strv});
+      symbols.insert(names.back(), symbol);
+    }
+    return symbol;
+  }
+
+  u64 SymbolTable::bind(DynamicLibrary& lib) noexcept
+  {
+    u64 unresolved = 0;
+    String buffer;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+      if (slots[i] != nullptr)
+        continue;
+      // 'lookup' expects a NUL-terminated name
+      buffer.clear();
+      buffer.push_back(names[i]).push_back('\0');
+      slots[i] = lib.lookup(buffer.data());
+      if (slots[i] == nullptr)
+        ++unresolved;
+    }
+    return unresolved;
   }
-} // namespace clt::run
\ No newline at end of file
+} // namespace clt::run
@@ -4,21 +4,39 @@
 #include <dynload/dynload.h>
 #include <common/types.h>
 #include <structs/option.h>
+#include <structs/string.h>
+#include <structs/map.h>
+#include <structs/set.h>
 
 namespace clt::run
 {
-  /// @brief Represents a dynamically loaded library
+  /// @brief Represents a dynamically loaded library.
+  /// Symbols are cached on first lookup, and the symbol table of the
+  /// library (which is costly to parse) is only loaded when enumerating
+  /// symbols or searching for the name of a symbol.
   class DynamicLibrary
   {
+    /// @brief The library
     RAIIResource<DLLib, &dlFreeLibrary> lib;
-    RAIIResource<DLSyms, &dlSymsCleanup> syms;
-
-    DynamicLibrary(DLLib* lib, DLSyms* syms) noexcept
+    /// @brief The symbol table (loaded on first use)
+    mutable RAIIResource<DLSyms, &dlSymsCleanup> syms = nullptr;
+    /// @brief The NUL-terminated path of the library (empty if none)
+    String path;
+    /// @brief The names of the symbols in 'symbols'
+    Vector<String> names{};
+    /// @brief The symbols already looked up
+    Map<StringView, void*> symbols{};
+
+    DynamicLibrary(DLLib* lib, String&& path) noexcept
         : lib(lib)
-        , syms(syms)
+        , path(std::move(path))
     {
     }
 
+    /// @brief Returns the symbol table, loading it if needed
+    /// @return The symbol table or nullptr on errors
+    DLSyms* symbol_table() const noexcept;
+
   public:
     DynamicLibrary(const DynamicLibrary&)                = delete;
     DynamicLibrary(DynamicLibrary&& other) noexcept      = default;
@@ -34,21 +52,30 @@ namespace clt::run
     /// @return None on errors or handle to the current library
     static Option<DynamicLibrary> load_current() noexcept;
 
-    /// @brief Searches for symbol of name 'name'
+    /// @brief Searches for symbol of name 'name'.
+    /// Found symbols are cached, so that 'dlFindSymbol' is only
+    /// called once per symbol.
     /// @param name The name of the symbol (must be mangled for C++ symbols)
     /// @return Pointer to the symbol or nullptr
-    void* lookup(const char* name) noexcept { return dlFindSymbol(lib.get(), name); }
+    void* lookup(const char* name) noexcept;
 
     /// @brief Returns the count of symbols in the current library
     /// @return The count of symbols in the current library
-    u64 count() const noexcept { return (u64)dlSymsCount(syms.get()); }
+    u64 count() const noexcept
+    {
+      auto table = symbol_table();
+      return table == nullptr ? 0 : (u64)dlSymsCount(table);
+    }
 
     /// @brief Returns the name of the symbol at address 'symbol'
     /// @param symbol The symbol's address
     /// @return The name or None on errors
     Option<const char*> name(void* symbol) const noexcept
     {
-      auto ptr = dlSymsNameFromValue(syms.get(), symbol);
+      auto table = symbol_table();
+      if (table == nullptr)
+        return None;
+      auto ptr = dlSymsNameFromValue(table, symbol);
       if (ptr == nullptr)
         return None;
       return ptr;
@@ -60,7 +87,7 @@ namespace clt::run
     Option<const char*> name(u64 index) const noexcept
     {
       assert_true("Invalid index!", index < count());
-      auto ptr = dlSymsName(syms.get(), (i32)index);
+      auto ptr = dlSymsName(symbol_table(), (i32)index);
       if (ptr == nullptr)
         return None;
       return ptr;
@@ -138,13 +165,62 @@ namespace clt::run
 
     /// @brief Iterator over symbols
     /// @return Start iterator
-    iterator begin() const noexcept { return iterator(syms.get(), 0); }
+    iterator begin() const noexcept { return iterator(symbol_table(), 0); }
     /// @brief Iterator over symbols
     /// @return End iterator
     iterator end() const noexcept
     {
-      return iterator(syms.get(), dlSymsCount(syms.get()));
+      return iterator(symbol_table(), (i32)count());
+    }
+  };
+
+  /// @brief The symbols imported by a program.
+  /// Each symbol is given a slot when imported, and all the slots are
+  /// resolved at once when binding, so that the interpreter only
+  /// needs to index the table when calling an imported function.
+  class SymbolTable
+  {
+    /// @brief The names of the imported symbols
+    IndexedSet<StringView> names{};
+    /// @brief The address of each imported symbol (or nullptr if unresolved)
+    Vector<void*> slots{};
+
+  public:
+    /// @brief Imports a symbol if it was not already imported.
+    /// The name must live as long as the table.
+    /// @param name The name of the symbol
+    /// @return The slot of the symbol
+    u64 import(StringView name) noexcept
+    {
+      auto [slot, result] = names.insert(name);
+      if (result == InsertionResult::SUCCESS)
+        slots.push_back(nullptr);
+      return slot;
     }
+
+    /// @brief Resolves all the unresolved symbols from a library.
+    /// Binding can be done once per library from which to import.
+    /// @param lib The library from which to resolve symbols
+    /// @return The number of symbols that are still unresolved
+    u64 bind(DynamicLibrary& lib) noexcept;
+
+    /// @brief Returns the address of an imported symbol
+    /// @param slot The slot returned by 'import'
+    /// @return The address or nullptr if unresolved
+    void* operator[](u64 slot) const noexcept
+    {
+      assert_true("Invalid slot!", slot < slots.size());
+      return slots[slot];
+    }
+
+    /// @brief Returns the name of an imported symbol
+    /// @param slot The slot returned by 'import'
+    /// @return The name of the symbol
+    StringView name(u64 slot) const noexcept { return names[slot]; }
+
+    /// @brief Returns the number of imported symbols
+    /// @return The number of slots
+    u64 size() const noexcept { return slots.size(); }
   };
 } // namespace clt::run
 
@@ -0,0 +1,282 @@
+/*****************************************************************/ /**
+ * @file   bench_frontend.cpp
+ * @brief  Contains the implementation of 'bench_frontend.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <chrono>
+#include <cmath>
+#include "bench_frontend.h"
+#include "ast/ast.h"
+#include "err/composable_reporter.h"
+
+#if defined(COLT_WINDOWS)
+  #define NOMINMAX
+  #include <Windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+namespace clt::bench
+{
+  /// @brief Scaling exponents above this value are reported as superlinear
+  static constexpr double SUPERLINEAR_EXPONENT = 1.25;
+  /// @brief Runs faster than this (in ns) are too noisy to compute exponents
+  static constexpr u64 MIN_SCALING_NS = 1'000'000;
+
+  u64 peak_memory_usage() noexcept
+  {
+#if defined(COLT_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return static_cast<u64>(counters.PeakWorkingSetSize);
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+  #if defined(COLT_APPLE)
+    // Bytes on macOS
+    return static_cast<u64>(usage.ru_maxrss);
+  #else
+    // KiB on Linux
+    return static_cast<u64>(usage.ru_maxrss) * 1024;
+  #endif
+#endif
+  }
+
+  FrontendBenchResult bench_frontend_on(
+      StringView source, u32 runs, mem::MemoryReport& report,
+      perf::PerfCounters* counters) noexcept
+  {
+    using namespace lng;
+    using clock = std::chrono::steady_clock;
+
+    assert_true("At least one run is required!", runs != 0);
+    const auto elapsed = [](clock::time_point start, clock::time_point end)
+    {
+      return static_cast<u64>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    };
+
+    // The AST must not be printed while timing
+    const bool print_ast = DebugPrintAST;
+    DebugPrintAST        = false;
+    ON_SCOPE_EXIT
+    {
+      DebugPrintAST = print_ast;
+    };
+
+    auto reporter = make_error_reporter<SinkReporter>();
+    const Vector<std::filesystem::path> includes = {};
+
+    // The samples are zero if the counters are not read
+    const auto start_counters = [=]() noexcept
+    {
+      if (counters != nullptr)
+        counters->start();
+    };
+    const auto stop_counters = [=]() noexcept
+    { return counters != nullptr ? counters->stop() : perf::PerfSample{}; };
+
+    FrontendBenchResult result = {source.size(), 0, UINT64_MAX, UINT64_MAX, 0, 0};
+    for (u32 i = 0; i < runs; i++)
+    {
+      start_counters();
+      auto start        = clock::now();
+      const auto buffer = lex(*reporter, source);
+      const auto ns     = elapsed(start, clock::now());
+      const auto sample = stop_counters();
+      if (ns < result.lex_ns)
+      {
+        result.lex_ns       = ns;
+        result.lex_counters = sample;
+      }
+      result.tokens = buffer.token_buffer().size();
+    }
+    for (u32 i = 0; i < runs; i++)
+    {
+      // A new program per run, so that types are interned again
+      auto program = ParsedProgram{
+          *reporter, StringView{}, includes, WarnFor::warn_all()};
+      auto unit = ParsedUnit{program, StringView{}};
+      lex(unit.token_buffer(), *reporter, source);
+
+      start_counters();
+      auto start        = clock::now();
+      make_ast(unit);
+      const auto ns     = elapsed(start, clock::now());
+      const auto sample = stop_counters();
+      if (ns < result.ast_ns)
+      {
+        result.ast_ns       = ns;
+        result.ast_counters = sample;
+      }
+
+      if (i + 1 == runs)
+      {
+        // The source is not owned by the unit
+        report.clear();
+        report.add_source(source.size());
+        program.report_memory(report);
+        unit.report_memory(report);
+      }
+    }
+    if ((*reporter).error_count() != 0)
+      io::print_warn("The program of {} bytes contains errors!", source.size());
+
+    result.peak_memory       = peak_memory_usage();
+    result.structures_memory = report.total().reserved;
+    return result;
+  }
+
+  /// @brief Computes the exponent 'k' such that time ~ size^k
+  /// @param prev The result on the previous (smaller) program
+  /// @param prev_ns The time taken on the previous program
+  /// @param current The result on the current program
+  /// @param current_ns The time taken on the current program
+  /// @return The exponent or None if the times are too noisy
+  static Option<double> scaling_exponent(
+      const FrontendBenchResult& prev, u64 prev_ns,
+      const FrontendBenchResult& current, u64 current_ns) noexcept
+  {
+    if (prev_ns < MIN_SCALING_NS || current.size <= prev.size)
+      return None;
+    return std::log(
+               static_cast<double>(current_ns) / static_cast<double>(prev_ns))
+           / std::log(
+               static_cast<double>(current.size) / static_cast<double>(prev.size));
+  }
+
+  /// @brief Formats a scaling exponent
+  /// @param exponent The exponent
+  /// @return The exponent as a string
+  static std::string format_exponent(Option<double> exponent) noexcept
+  {
+    if (exponent.is_none())
+      return "-";
+    return fmt::format(
+        "{:.2f}{}", *exponent, *exponent > SUPERLINEAR_EXPONENT ? " (!)" : "");
+  }
+
+  /// @brief Formats an optional value
+  /// @param value The value
+  /// @return The formatted value or "-" if None
+  static std::string format_optional(Option<double> value) noexcept
+  {
+    if (value.is_none())
+      return "-";
+    return fmt::format("{:.3f}", *value);
+  }
+
+  /// @brief Prints the hardware counters of each phase of each program
+  /// @param results The results of the benchmark
+  static void print_counters(View<FrontendBenchResult> results) noexcept
+  {
+    using enum perf::Counter;
+
+    io::print_message("Hardware counters (fastest run):");
+    io::print(
+        "{: >12} {: >6} {: >8} {: >10} {: >10} {: >14} {: >14}", "Size (B)", "Phase",
+        "IPC", "Instr/B", "BrMiss %", "L1D miss/KiB", "LLC miss/KiB");
+    for (auto& result : results)
+    {
+      for (auto [phase, sample] :
+           {std::pair{"Lex", &result.lex_counters},
+            std::pair{"AST", &result.ast_counters}})
+      {
+        auto instructions = sample->per_kib(INSTRUCTIONS, result.size);
+        if (instructions.is_value())
+          *instructions /= 1024.0;
+        io::print(
+            "{: >12} {: >6} {: >8} {: >10} {: >10} {: >14} {: >14}", result.size,
+            phase, format_optional(sample->ipc()), format_optional(instructions),
+            format_optional(sample->branch_miss_rate()),
+            format_optional(sample->per_kib(L1D_MISSES, result.size)),
+            format_optional(sample->per_kib(LLC_MISSES, result.size)));
+      }
+    }
+  }
+
+  void bench_frontend(const FrontendBenchOptions& options) noexcept
+  {
+    assert_true("Invalid sizes!", options.min_size != 0);
+
+    // Millions of items per second
+    const auto mega_per_second = [](u64 count, u64 ns)
+    {
+      return static_cast<double>(count) * 1e3
+             / static_cast<double>(clt::max<u64>(ns, 1));
+    };
+
+    // The counters are only opened (and read around each run) if requested
+    auto counters = options.counters ? Option<perf::PerfCounters>{InPlace}
+                                     : Option<perf::PerfCounters>{None};
+    if (counters.is_value() && !counters->is_available())
+      io::print_warn("Hardware counters are not available on this machine!");
+
+    io::print_message("Benchmarking front-end (best of {} runs)...", options.runs);
+    io::print(
+        "{: >12} {: >12} {: >10} {: >12} {: >10} {: >12} {: >12} {: >10} {: >10} "
+        "{: >10}",
+        "Size (B)", "Tokens", "Lex MB/s", "Lex Mtok/s", "AST MB/s", "AST Mtok/s",
+        "Peak (MiB)", "Mem B/B", "Lex exp", "AST exp");
+
+    Option<FrontendBenchResult> prev = None;
+    bool superlinear                 = false;
+    mem::MemoryReport report         = {};
+    Vector<FrontendBenchResult> results;
+    for (u64 size = options.min_size; size <= options.max_size; size *= 4)
+    {
+      const auto source = generate_source(options.shape, size);
+      const auto result = bench_frontend_on(
+          source, options.runs, report, counters.is_value() ? &*counters : nullptr);
+
+      Option<double> lex_exp = None;
+      Option<double> ast_exp = None;
+      if (prev.is_value())
+      {
+        lex_exp = scaling_exponent(*prev, prev->lex_ns, result, result.lex_ns);
+        ast_exp = scaling_exponent(*prev, prev->ast_ns, result, result.ast_ns);
+        superlinear |= lex_exp.is_value() && *lex_exp > SUPERLINEAR_EXPONENT;
+        superlinear |= ast_exp.is_value() && *ast_exp > SUPERLINEAR_EXPONENT;
+      }
+      io::print(
+          "{: >12} {: >12} {: >10.1f} {: >12.2f} {: >10.1f} {: >12.2f} {: >12.1f} "
+          "{: >10.2f} {: >10} {: >10}",
+          result.size, result.tokens, mega_per_second(result.size, result.lex_ns),
+          mega_per_second(result.tokens, result.lex_ns),
+          mega_per_second(result.size, result.ast_ns),
+          mega_per_second(result.tokens, result.ast_ns),
+          static_cast<double>(result.peak_memory) / (1024.0 * 1024.0),
+          static_cast<double>(result.structures_memory)
+              / static_cast<double>(result.size),
+          format_exponent(lex_exp), format_exponent(ast_exp));
+      prev = result;
+      results.push_back(result);
+
+      // The next program is 4 times bigger, so at least 4 times slower
+      if ((result.lex_ns + result.ast_ns) * 4
+          > static_cast<u64>(options.time_budget) * 1'000'000'000)
+      {
+        io::print_warn(
+            "Stopping at {} bytes: the next run would take more than {}s!",
+            result.size, options.time_budget);
+        break;
+      }
+      // Avoid overflowing
+      if (size > std::numeric_limits<u64>::max() / 4)
+        break;
+    }
+    if (superlinear)
+      io::print_warn(
+          "Time grows superlinearly with the size of the program (exponent > {})!",
+          SUPERLINEAR_EXPONENT);
+    if (counters.is_value() && counters->is_available())
+      print_counters(results);
+    if (options.mem_report)
+      report.print();
+  }
+} // namespace clt::bench
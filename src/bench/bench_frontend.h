@@ -0,0 +1,81 @@
+/*****************************************************************/ /**
+ * @file   bench_frontend.h
+ * @brief  Contains 'bench_frontend', the throughput benchmark of the
+ * front-end (lexing and AST construction) run by '-bench-frontend'.
+ * Generated programs of growing sizes are lexed and parsed, so that
+ * superlinear behavior shows up before it hits users.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_BENCH_FRONTEND
+#define HG_COLT_BENCH_FRONTEND
+
+#include "bench/source_generator.h"
+#include "mem/mem_report.h"
+#include "common/perf_counters.h"
+
+namespace clt::bench
+{
+  /// @brief The options of the front-end benchmark
+  struct FrontendBenchOptions
+  {
+    /// @brief The shape of the generated programs
+    SourceShape shape = {};
+    /// @brief The size of the smallest program
+    u64 min_size = (1_KiB).to_bytes();
+    /// @brief The size of the biggest program
+    u64 max_size = (64_MiB).to_bytes();
+    /// @brief The number of timed runs for each size (the fastest is kept)
+    u32 runs = 3;
+    /// @brief Stops increasing the size once a run would take longer (in seconds)
+    u32 time_budget = 10;
+    /// @brief If true, prints the memory report of the biggest program
+    bool mem_report = false;
+    /// @brief If true, prints the hardware counters of each phase
+    bool counters = false;
+  };
+
+  /// @brief The result of benchmarking the front-end on a program
+  struct FrontendBenchResult
+  {
+    /// @brief The size of the program in bytes
+    u64 size;
+    /// @brief The number of tokens of the program
+    u64 tokens;
+    /// @brief The fastest lexing run in nanoseconds
+    u64 lex_ns;
+    /// @brief The fastest AST construction run in nanoseconds
+    u64 ast_ns;
+    /// @brief The peak memory usage of the process after the runs
+    u64 peak_memory;
+    /// @brief The bytes reserved by the data structures of the front-end
+    u64 structures_memory;
+    /// @brief The hardware counters of the fastest lexing run
+    perf::PerfSample lex_counters;
+    /// @brief The hardware counters of the fastest AST construction run
+    perf::PerfSample ast_counters;
+  };
+
+  /// @brief Returns the peak memory usage (resident set) of the process
+  /// @return The peak memory usage in bytes (or 0 if not supported)
+  u64 peak_memory_usage() noexcept;
+
+  /// @brief Benchmarks the front-end on a single program
+  /// @param source The program
+  /// @param runs The number of timed runs (the fastest is kept)
+  /// @param report The report to fill with the memory used by the last run
+  /// @param counters The hardware counters to read around each run
+  /// (or null to not read any)
+  /// @return The result of the benchmark
+  FrontendBenchResult bench_frontend_on(
+      StringView source, u32 runs, mem::MemoryReport& report,
+      perf::PerfCounters* counters) noexcept;
+
+  /// @brief Benchmarks the front-end on programs of growing sizes
+  /// (multiplying the size by 4 each time) and prints the results.
+  /// @param options The options of the benchmark
+  void bench_frontend(const FrontendBenchOptions& options) noexcept;
+} // namespace clt::bench
+
+#endif // !HG_COLT_BENCH_FRONTEND
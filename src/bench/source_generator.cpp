@@ -0,0 +1,158 @@
+/*****************************************************************/ /**
+ * @file   source_generator.cpp
+ * @brief  Contains the implementation of 'source_generator.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "source_generator.h"
+
+namespace clt::bench
+{
+  /// @brief Helper to generate a program
+  class SourceGenerator
+  {
+    /// @brief The binary operators used in expressions.
+    /// Only operators that cannot fail when constant folding are used.
+    static constexpr std::array<StringView, 5> BINARY_OPS = {
+        " + ", " - ", " & ", " | ", " ^ "};
+
+    /// @brief The shape of the program
+    const SourceShape& shape;
+    /// @brief The program being generated
+    String& out;
+    /// @brief The state of the pseudo-random generator
+    u64 state;
+    /// @brief The name of the locals (all of size 'shape.ident_len')
+    Vector<String> names{};
+
+  public:
+    /// @brief Constructor
+    /// @param shape The shape of the program
+    /// @param out The String to which to append the program
+    SourceGenerator(const SourceShape& shape, String& out) noexcept
+        : shape(shape)
+        , out(out)
+        , state(shape.seed | 1)
+    {
+      for (u64 i = 0; i < shape.locals; i++)
+      {
+        auto formatted = fmt::format("v{}", i);
+        String name;
+        name.push_back(StringView{formatted.data(), formatted.size()});
+        if (name.size() < shape.ident_len)
+          name.push_back('_', shape.ident_len - name.size());
+        names.push_back(std::move(name));
+      }
+    }
+
+    /// @brief Returns the next pseudo-random number (xorshift64)
+    /// @return The next pseudo-random number
+    u64 next() noexcept
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    }
+
+    /// @brief Returns true with a probability of 'percent'%
+    /// @param percent The probability [0-100]
+    /// @return True with a probability of 'percent'%
+    bool chance(u8 percent) noexcept { return next() % 100 < percent; }
+
+    /// @brief Writes the indentation of a line
+    /// @param indent The indentation level
+    void indent(u64 indent) noexcept { out.push_back(' ', indent * 2); }
+
+    /// @brief Writes a comment line with a probability of 'comment_ratio'%
+    /// @param level The indentation level
+    void comment(u64 level) noexcept
+    {
+      if (!chance(shape.comment_ratio))
+        return;
+      indent(level);
+      out.push_back("// The quick brown fox jumps over the lazy dog.\n");
+    }
+
+    /// @brief Writes an integral literal
+    void literal() noexcept
+    {
+      auto formatted = fmt::format("{}", next() % 1000);
+      out.push_back(StringView{formatted.data(), formatted.size()});
+    }
+
+    /// @brief Writes an expression of 2 to 4 operands
+    /// @param depth The current nesting of parenthesis
+    void expression(u8 depth) noexcept
+    {
+      const u64 operands = 2 + next() % 3;
+      for (u64 i = 0; i < operands; i++)
+      {
+        if (i != 0)
+          out.push_back(BINARY_OPS[next() % BINARY_OPS.size()]);
+        if (depth < shape.expr_depth && !chance(shape.literal_density))
+        {
+          out.push_back('(');
+          expression(depth + 1);
+          out.push_back(')');
+        }
+        else
+          literal();
+      }
+    }
+
+    /// @brief Writes a scope containing locals, expressions and nested scopes
+    /// @param depth The current nesting of scopes
+    void scope(u64 depth) noexcept
+    {
+      out.push_back("{\n");
+      for (auto& name : names)
+      {
+        comment(depth + 1);
+        indent(depth + 1);
+        out.push_back("var ");
+        out.push_back(StringView{name});
+        out.push_back(" = ");
+        expression(0);
+        out.push_back(";\n");
+      }
+      comment(depth + 1);
+      indent(depth + 1);
+      expression(0);
+      out.push_back(";\n");
+      if (depth < shape.scope_depth)
+      {
+        comment(depth + 1);
+        indent(depth + 1);
+        if (chance(50))
+        {
+          out.push_back("if ");
+          literal();
+          out.push_back(" < ");
+          literal();
+          out.push_back(' ');
+        }
+        scope(depth + 1);
+      }
+      indent(depth);
+      out.push_back("}\n");
+    }
+  };
+
+  String generate_source(const SourceShape& shape, u64 size) noexcept
+  {
+    assert_true(
+        "Invalid shape!", shape.expr_depth <= MAX_GENERATED_EXPR_DEPTH,
+        shape.literal_density <= 100, shape.comment_ratio <= 100);
+    String out;
+    out.reserve(size + 4096);
+    auto gen = SourceGenerator{shape, out};
+    while (out.size() < size)
+    {
+      gen.comment(0);
+      gen.scope(0);
+    }
+    return out;
+  }
+} // namespace clt::bench
@@ -0,0 +1,53 @@
+/*****************************************************************/ /**
+ * @file   source_generator.h
+ * @brief  Contains 'generate_source', which produces synthetic Colt
+ * programs of arbitrary size used to benchmark the front-end.
+ * The generated programs only use the subset of the language that
+ * the front-end currently parses: scopes, local declarations, and
+ * expression statements made of integral literals.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_SOURCE_GENERATOR
+#define HG_COLT_SOURCE_GENERATOR
+
+#include "common/colt_pch.h"
+
+namespace clt::bench
+{
+  /// @brief The shape of the generated programs
+  struct SourceShape
+  {
+    /// @brief The maximum nesting of parenthesized sub-expressions
+    u8 expr_depth = 3;
+    /// @brief The length of the identifiers of local variables
+    u8 ident_len = 8;
+    /// @brief The percentage [0-100] of operands that are literals.
+    /// The other operands are parenthesized sub-expressions.
+    u8 literal_density = 70;
+    /// @brief The percentage [0-100] of lines that are comments
+    u8 comment_ratio = 10;
+    /// @brief The nesting of scopes inside each top-level scope
+    u8 scope_depth = 2;
+    /// @brief The number of local variables declared in each scope
+    u8 locals = 4;
+    /// @brief The seed of the generator (same seed, same program)
+    u64 seed = 0x9E37'79B9'7F4A'7C15;
+  };
+
+  /// @brief The maximum value of 'SourceShape::expr_depth'.
+  /// Each nesting consumes multiple recursion levels of the parser,
+  /// which stops at 'ASTMaker::MAX_RECURSION_DEPTH'.
+  static constexpr u8 MAX_GENERATED_EXPR_DEPTH = 32;
+
+  /// @brief Generates a syntactically valid Colt program.
+  /// The program is made of top-level scopes, and generation stops
+  /// after the first scope that makes the program reach 'size'.
+  /// @param shape The shape of the program
+  /// @param size The minimum size in bytes of the program
+  /// @return The generated program
+  String generate_source(const SourceShape& shape, u64 size) noexcept;
+} // namespace clt::bench
+
+#endif // !HG_COLT_SOURCE_GENERATOR
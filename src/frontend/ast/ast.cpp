@@ -6,6 +6,7 @@
  * @date   April 2024
  *********************************************************************/
 #include "ast.h"
+#include "common/trace.h"
 
 /// @brief Pops the elements added to a vector in the current scope at the end of the scope
 #define SCOPED_SAVE_VECTOR(vec)                                            \
@@ -21,11 +22,12 @@
 
 namespace clt::lng
 {
-  void make_ast(ParsedUnit& unit) noexcept
+  void make_ast(ParsedUnit& unit, u32 first_token) noexcept
   {
-    assert_true("Unit already parsed!", !unit.is_parsed());
+    assert_true("Unit already parsed!", !unit.is_parsed() || first_token != 0);
+    COLT_TRACE_SCOPE("make_ast");
     // The constructor generates the AST directly
-    ASTMaker ast = {unit};
+    ASTMaker ast = {unit, first_token};
   }
 
   ProdExprToken ASTMaker::parse_primary_literal(
@@ -409,6 +411,14 @@ namespace clt::lng
     // We add the expression to the scope
     auto& scope_ref  = Expr(scope);
     auto& statements = scope_ref.as<ScopeExpr>()->exprs();
+
+    // Local variable declarations are registered in the current scope
+    auto parent_scope = current_scope;
+    current_scope     = scope_ref.as<ScopeExpr>();
+    ON_SCOPE_EXIT
+    {
+      current_scope = parent_scope;
+    };
     if (current() == TKN_COLON && accepts_single)
     {
       consume_current(); // :
@@ -874,6 +884,7 @@ namespace clt::lng
       TokenRange range, const LiteralExpr& lhs, BinaryOp op,
       const LiteralExpr& rhs) noexcept
   {
+    COLT_TRACE_SCOPE("constant fold");
     assert_true(
         "Expected built-in type!", Type(lhs).is<BuiltinType>(),
         Type(rhs).is<BuiltinType>());
@@ -915,6 +926,7 @@ namespace clt::lng
   ProdExprToken ASTMaker::constant_fold(
       TokenRange range, UnaryOp op, const LiteralExpr& lhs) noexcept
   {
+    COLT_TRACE_SCOPE("constant fold");
     using enum clt::lng::UnaryOp;
 
     switch_no_default(op)
@@ -947,6 +959,7 @@ namespace clt::lng
   ProdExprToken ASTMaker::constant_fold(
       TokenRange range, const LiteralExpr& to_conv, const BuiltinType& to) noexcept
   {
+    COLT_TRACE_SCOPE("constant fold");
     auto [result, err] = run::cnv(
         to_conv.value(), BuiltinToTypeOp(Type(to_conv).as<BuiltinType>()->type_id()),
         BuiltinToTypeOp(to.type_id()));
@@ -15,10 +15,16 @@
 
 namespace clt::lng
 {
+  /// @brief If true, 'make_ast' prints each top-level statement it parses.
+  /// This is a debugging aid, turned off by the front-end benchmark.
+  inline bool DebugPrintAST = true;
+
   /// @brief Generates the AST and stores the result in 'unit'
   /// @param unit The unit whose AST to generate
-  /// @pre !unit.is_parsed()
-  void make_ast(ParsedUnit& unit) noexcept;
+  /// @param first_token The first token to parse (not 0 when appending
+  /// to a unit whose previous tokens were already parsed)
+  /// @pre !unit.is_parsed() || first_token != 0
+  void make_ast(ParsedUnit& unit, u32 first_token = 0) noexcept;
 
   /// @brief Prints an expression (for debugging purposes)
   /// @param tkn The token to print
@@ -220,12 +226,22 @@ namespace clt::lng
 
     /// @brief Constructor, does all the parsing
     /// @param unit The unit to parse
-    ASTMaker(ParsedUnit& unit) noexcept
+    /// @param first_token The first token to parse
+    ASTMaker(ParsedUnit& unit, u32 first_token = 0) noexcept
         : to_parse(unit)
+        , current_tkn(first_token)
     {
       auto s = scoped_set_panic(&ASTMaker::panic_consume_semicolon);
       while (current() != Lexeme::TKN_EOF)
-        print_expr(parse_statement(), to_parse);
+      {
+        // Global variables can only be declared at file scope
+        auto stmt = current() == Lexeme::TKN_KEYWORD_global
+                        ? Expr(parse_var_decl(true)).as_base()
+                        : parse_statement();
+        Expr().add_top_level(stmt);
+        if (DebugPrintAST)
+          print_expr(stmt, to_parse);
+      }
     }
 
     /*------------------
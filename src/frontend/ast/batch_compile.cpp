@@ -0,0 +1,251 @@
+/*****************************************************************/ /**
+ * @file   batch_compile.cpp
+ * @brief  Contains the implementation of 'batch_compile.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <chrono>
+#include <mutex>
+#include "batch_compile.h"
+#include "ast.h"
+#include "common/parallel.h"
+#include "common/trace.h"
+
+namespace clt::lng
+{
+  /// @brief The maximum depth of nested response files (which detects cycles)
+  static constexpr u32 MAX_RESPONSE_FILE_DEPTH = 16;
+
+  /// @brief Expands an argument, appending the result
+  /// @param arg The argument to expand
+  /// @param result The vector to which to append the expanded arguments
+  /// @param depth The count of response files being expanded
+  /// @return False if a response file could not be read (or is nested too deeply)
+  static bool expand_argument(
+      StringView arg, Vector<String>& result, u32 depth) noexcept
+  {
+    if (!arg.starts_with('@'))
+    {
+      result.push_back(String{arg});
+      return true;
+    }
+    const auto path = std::string{arg.data() + 1, arg.size() - 1};
+    if (depth == MAX_RESPONSE_FILE_DEPTH)
+    {
+      io::print_error("Response file '{}' is nested too deeply!", path);
+      return false;
+    }
+    auto file = String::getFile(path.c_str());
+    if (file.is_error())
+    {
+      io::print_error("Could not read response file '{}'!", path);
+      return false;
+    }
+    auto content = StringView{*file};
+    while (!content.empty())
+    {
+      const size_t end = content.find('\n');
+      auto line        = content.substr(0, end);
+      content = end == StringView::npos ? StringView{} : content.substr(end + 1);
+      // Support response files with Windows line endings
+      while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+        line.remove_suffix(1);
+      // A response file may reference other response files
+      if (!line.empty() && line.front() != '#'
+          && !expand_argument(line, result, depth + 1))
+        return false;
+    }
+    return true;
+  }
+
+  Option<Vector<String>> expand_response_files(
+      View<std::string_view> args) noexcept
+  {
+    Vector<String> result;
+    for (auto arg : args)
+    {
+      if (!expand_argument(StringView{arg.data(), arg.size()}, result, 0))
+        return None;
+    }
+    return result;
+  }
+
+  /// @brief The result of compiling a single file of a batch
+  struct BatchFileResult
+  {
+    /// @brief The reports of the file (formatted)
+    String diagnostics{};
+    /// @brief The result of parsing the file
+    ParsedUnit::ParseResult result = ParsedUnit::SUCCESS;
+    /// @brief The count of errors of the file
+    u64 error_count = 0;
+    /// @brief The count of warnings of the file
+    u64 warn_count = 0;
+    /// @brief The time taken to compile the file (in nanoseconds)
+    u64 time_ns = 0;
+    /// @brief True once the file was compiled
+    bool done = false;
+  };
+
+  /// @brief The state shared by the workers of a batch
+  class BatchState
+  {
+    /// @brief The paths of the files to compile
+    Vector<std::filesystem::path> paths{};
+    /// @brief The results (with the same indices as 'paths')
+    Vector<BatchFileResult> results{};
+    /// @brief The include paths
+    const Vector<std::filesystem::path> includes{};
+    /// @brief The options of the batch
+    const BatchOptions& options;
+    /// @brief The indices of the files to compile
+    IndexQueue queue;
+    /// @brief Protects 'next_print' and the 'done' field of the results
+    std::mutex print_lock{};
+    /// @brief The index of the next file whose reports to print
+    size_t next_print = 0;
+
+    /// @brief Marks a file as compiled, printing the reports of all the
+    /// compiled files that precede any file that is not yet compiled
+    /// @param index The index of the file
+    void publish(size_t index) noexcept
+    {
+      auto lock           = std::scoped_lock{print_lock};
+      results[index].done = true;
+      while (next_print < results.size() && results[next_print].done)
+      {
+        auto& diagnostics = results[next_print++].diagnostics;
+        std::fwrite(diagnostics.data(), 1, diagnostics.size(), stdout);
+        // The reports are no longer needed
+        diagnostics = String{};
+      }
+    }
+
+  public:
+    /// @brief Constructor
+    /// @param files The paths of the files to compile
+    /// @param options The options of the batch
+    BatchState(View<String> files, const BatchOptions& options) noexcept
+        : paths(files.size())
+        , results(files.size())
+        , options(options)
+        , queue(files.size())
+    {
+      for (auto& file : files)
+      {
+        paths.push_back(std::string_view{file.data(), file.size()});
+        results.push_back(BatchFileResult{});
+      }
+    }
+
+    /// @brief Compiles files until there are none left.
+    /// This is the function run by each worker.
+    void work() noexcept
+    {
+      using clock = std::chrono::steady_clock;
+
+      String output;
+      auto reporter = make_error_reporter<BufferReporter>(output);
+      // Shared by all the files compiled by the worker
+      auto program = ParsedProgram{
+          *reporter, includes, options.warn_for, options.image, options.low_memory};
+      for (auto next = queue.pop(); next.is_value(); next = queue.pop())
+      {
+        const size_t index = *next;
+        COLT_TRACE_SCOPE("batch file");
+        auto& result     = results[index];
+        const auto start = clock::now();
+        {
+          // The unit is dropped once it is lowered
+          auto unit     = ParsedUnit{program, paths[index]};
+          result.result = unit.parse();
+          if (result.result == ParsedUnit::INVALID_PATH
+              || result.result == ParsedUnit::FILE_ERROR)
+          {
+            const auto error =
+                fmt::format("Could not read '{}'!", paths[index].string());
+            format_error(output, StringView{error.data(), error.size()}, None, None);
+            result.error_count = 1;
+          }
+          else
+          {
+            result.error_count = unit.error_count();
+            result.warn_count  = unit.warn_count();
+            if (options.lower != nullptr && result.error_count == 0
+                && options.lower(unit, paths[index], output).is_error())
+              result.error_count = 1;
+          }
+        }
+        result.time_ns = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now() - start)
+                .count());
+        result.diagnostics = std::move(output);
+        output             = String{};
+        publish(index);
+      }
+    }
+
+    /// @brief Prints the status and time of each file
+    void print_summary() const noexcept
+    {
+      io::print(
+          "{: <8} {: >8} {: >10}  {}", "Status", "Errors", "Time (ms)", "File");
+      for (size_t i = 0; i < results.size(); i++)
+      {
+        auto& result      = results[i];
+        StringView status = "ok";
+        if (result.result == ParsedUnit::INVALID_PATH
+            || result.result == ParsedUnit::FILE_ERROR)
+          status = "unread";
+        else if (result.error_count != 0)
+          status = "failed";
+        io::print(
+            "{: <8} {: >8} {: >10.3f}  {}", status, result.error_count,
+            static_cast<double>(result.time_ns) / 1e6, paths[i].string());
+      }
+    }
+
+    /// @brief Returns the count of files that failed to compile
+    /// @return The count of failed files
+    u64 failed_count() const noexcept
+    {
+      u64 count = 0;
+      for (auto& result : results)
+        count += static_cast<u64>(result.error_count != 0);
+      return count;
+    }
+  };
+
+  u64 compile_batch(View<String> files, const BatchOptions& options) noexcept
+  {
+    using clock = std::chrono::steady_clock;
+    if (files.empty())
+      return 0;
+
+    // The AST of each statement would be printed by any thread
+    const bool print_ast = DebugPrintAST;
+    DebugPrintAST        = false;
+    ON_SCOPE_EXIT
+    {
+      DebugPrintAST = print_ast;
+    };
+
+    const u64 jobs   = worker_count(options.jobs, files.size());
+    const auto start = clock::now();
+    auto state       = BatchState{files, options};
+    auto work        = [&state]() noexcept { state.work(); };
+    run_on_workers(jobs, work);
+    const auto elapsed =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    if (options.summary)
+      state.print_summary();
+    const u64 failed = state.failed_count();
+    io::print_message(
+        "Compiled {} file(s) ({} failed) with {} job(s) in {:.3f}ms.",
+        files.size(), failed, jobs, elapsed);
+    return failed;
+  }
+} // namespace clt::lng
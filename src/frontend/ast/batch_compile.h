@@ -0,0 +1,67 @@
+/*****************************************************************/ /**
+ * @file   batch_compile.h
+ * @brief  Contains 'compile_batch', which compiles many files in a single
+ * process using a pool of worker threads.
+ * Each worker owns a ParsedProgram to which the files it compiles are
+ * added one after the other: the types and string literals interned by
+ * a file are reused by the next ones (without any locking, as no buffer
+ * is shared between workers). The reports of a file are buffered, and
+ * printed (grouped) in the order of the input files.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_BATCH_COMPILE
+#define HG_COLT_BATCH_COMPILE
+
+#include "parsed_program.h"
+
+namespace clt::lng
+{
+  /// @brief Lowers a unit that compiled without errors (see BatchOptions).
+  /// The unit may not be used after the call.
+  /// @param unit The unit to lower
+  /// @param path The path of the file of the unit
+  /// @param diagnostics The reports of the file, to which to append errors
+  /// @return Success if the unit was lowered
+  using LowerUnitFn = ErrorFlag (*)(
+      const ParsedUnit& unit, const std::filesystem::path& path,
+      String& diagnostics) noexcept;
+
+  /// @brief The options of 'compile_batch'
+  struct BatchOptions
+  {
+    /// @brief The number of worker threads (0 for one per hardware thread)
+    u32 jobs = 0;
+    /// @brief What to warn for
+    WarnFor warn_for = WarnFor::warn_all();
+    /// @brief If true, prints the status and time taken by each file
+    bool summary = true;
+    /// @brief If true, the tokens of each unit compiled without errors are
+    /// discarded once its AST is built (see ParsedUnit::discard_tokens)
+    bool low_memory = false;
+    /// @brief The module image linked to the program of each worker (or
+    /// null), which must outlive the batch
+    const ModuleImage* image = nullptr;
+    /// @brief If not null, called by the worker that compiled each file
+    /// without errors (before the unit is dropped)
+    LowerUnitFn lower = nullptr;
+  };
+
+  /// @brief Expands response files: an argument '@path' is replaced by the
+  /// lines of the file at 'path' (one input per line, empty lines and lines
+  /// starting with '#' are ignored). A line '@path' of a response file
+  /// is itself expanded. Other arguments are kept as is.
+  /// @param args The arguments to expand
+  /// @return The expanded arguments, or None if a response file could not be read
+  Option<Vector<String>> expand_response_files(
+      View<std::string_view> args) noexcept;
+
+  /// @brief Compiles files concurrently, printing their reports
+  /// @param files The paths of the files to compile
+  /// @param options The options of the batch
+  /// @return The count of files that failed to compile (or could not be read)
+  u64 compile_batch(View<String> files, const BatchOptions& options) noexcept;
+} // namespace clt::lng
+
+#endif // !HG_COLT_BATCH_COMPILE
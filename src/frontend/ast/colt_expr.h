@@ -612,6 +612,14 @@ namespace clt::lng
 
     MAKE_DEFAULT_COPY_AND_MOVE_FOR(VarDeclExpr);
 
+    /// @brief Returns the name of the declared variable
+    /// @return The name of the variable
+    constexpr StringView var_name() const noexcept { return name; }
+    /// @brief Sets the name of the declared variable to 'nname'.
+    /// This is used to stop referencing the source of the unit.
+    /// @param nname The new name
+    constexpr void var_name(StringView nname) noexcept { name = nname; }
+
     /// @brief Check if the variable was declared with an initial value.
     /// @return True if the variable was declared with an initial value
     constexpr bool is_init() const noexcept { return value.is_value(); }
@@ -659,6 +667,14 @@ namespace clt::lng
 
     MAKE_DEFAULT_COPY_AND_MOVE_FOR(GlobalDeclExpr);
 
+    /// @brief Returns the name of the declared variable
+    /// @return The name of the variable
+    constexpr StringView global_name() const noexcept { return name; }
+    /// @brief Sets the name of the declared variable to 'nname'.
+    /// This is used to stop referencing the source of the unit.
+    /// @param nname The new name
+    constexpr void global_name(StringView nname) noexcept { name = nname; }
+
     /// @brief Returns the initial value of the declared variable
     /// @pre is_init()
     /// @return The initial value of the variable
@@ -12,6 +12,7 @@
 #define HG_COLT_EXPR_BUFFER
 
 #include "ast/colt_expr.h"
+#include "mem/mem_report.h"
 
 namespace clt::lng
 {
@@ -258,6 +259,8 @@ namespace clt::lng
     FlatList<ProdExprVariant, 512> prod_expr{};
     /// @brief The list of StatementExpr
     FlatList<StmtExprVariant, 512> stmt_expr{};
+    /// @brief The top-level statements (in the order of their declarations)
+    Vector<ExprBase*> top_level{};
 
     /// @brief Returns the next ProdExprToken.
     /// A push_back to prod_expr must follow this call.
@@ -339,6 +342,47 @@ namespace clt::lng
       return stmt_expr[stmt.index];
     }
 
+    /// @brief Returns the producer expressions, in the order of their tokens.
+    /// Iterating is linear, while calling 'expr' for each token walks the list.
+    /// @return The producer expressions
+    const FlatList<ProdExprVariant, 512>& prod_exprs() const noexcept
+    {
+      return prod_expr;
+    }
+
+    /// @brief Returns the statement expressions, in the order of their tokens.
+    /// Iterating is linear, while calling 'expr' for each token walks the list.
+    /// @return The statement expressions
+    const FlatList<StmtExprVariant, 512>& stmt_exprs() const noexcept
+    {
+      return stmt_expr;
+    }
+    /// @brief Returns the statement expressions, in the order of their tokens.
+    /// Iterating is linear, while calling 'expr' for each token walks the list.
+    /// @return The statement expressions
+    FlatList<StmtExprVariant, 512>& stmt_exprs() noexcept { return stmt_expr; }
+
+    /// @brief Registers a top-level statement (owned by the buffer)
+    /// @param stmt The statement
+    void add_top_level(ExprBase* stmt) noexcept { top_level.push_back(stmt); }
+
+    /// @brief Returns the top-level statements, in the order of their declarations
+    /// @return The top-level statements
+    View<ExprBase*> top_level_stmts() const noexcept
+    {
+      return View<ExprBase*>{top_level.data(), top_level.size()};
+    }
+
+    /// @brief Returns the number of producer expressions.
+    /// Valid ProdExprToken are in range [0, prod_count()).
+    /// @return The number of producer expressions
+    u32 prod_count() const noexcept { return static_cast<u32>(prod_expr.size()); }
+
+    /// @brief Returns the number of statement expressions.
+    /// Valid StmtExprToken are in range [0, stmt_count()).
+    /// @return The number of statement expressions
+    u32 stmt_count() const noexcept { return static_cast<u32>(stmt_expr.size()); }
+
     /// @brief Returns the type of an expression
     /// @param prod The producer expression token
     /// @return Type of the expression represented by 'prod'
@@ -679,6 +723,43 @@ namespace clt::lng
     {
       return add_new_stmt<VarDeclExpr>(range, type, local_id, name, init, is_mut);
     }
+
+    /// @brief The sizes of the buffers, to which to roll back
+    struct Checkpoint
+    {
+      /// @brief The count of producer expressions
+      u64 prod_expr;
+      /// @brief The count of statement expressions
+      u64 stmt_expr;
+      /// @brief The count of top-level statements
+      u64 top_level;
+    };
+
+    /// @brief Returns a checkpoint to which to roll back
+    /// @return The current checkpoint
+    Checkpoint checkpoint() const noexcept
+    {
+      return Checkpoint{prod_expr.size(), stmt_expr.size(), top_level.size()};
+    }
+
+    /// @brief Pops every expression added after a checkpoint.
+    /// Expressions added before the checkpoint must not refer to them.
+    /// @param to The checkpoint to which to roll back
+    void rollback(const Checkpoint& to) noexcept
+    {
+      prod_expr.pop_back_n(prod_expr.size() - to.prod_expr);
+      stmt_expr.pop_back_n(stmt_expr.size() - to.stmt_expr);
+      top_level.pop_back_n(top_level.size() - to.top_level);
+    }
+
+    /// @brief Adds the memory used by the buffer to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept
+    {
+      report.add("ExprBuffer::prod_expr", prod_expr.memory_usage());
+      report.add("ExprBuffer::stmt_expr", stmt_expr.memory_usage());
+      report.add("ExprBuffer::top_level", top_level.memory_usage());
+    }
   };
 } // namespace clt::lng
 
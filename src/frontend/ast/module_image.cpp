@@ -0,0 +1,543 @@
+/*****************************************************************/ /**
+ * @file   module_image.cpp
+ * @brief  Contains the implementation of 'module_image.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "module_image.h"
+#include "parsed_program.h"
+#include "common/crc32.h"
+#include "common/trace.h"
+#include "io/buffered_writer.h"
+
+namespace clt::lng
+{
+  static_assert(sizeof(ModuleImageHeader) % 8 == 0);
+  static_assert(sizeof(ImageTypeRecord) == 8);
+  static_assert(sizeof(ImageFnPayloadRecord) == 16);
+  static_assert(sizeof(ImageFnArgRecord) == 8);
+  static_assert(sizeof(ImageModuleRecord) == 32);
+  static_assert(sizeof(ImageGlobalRecord) == 32);
+
+  /// @brief Compares two names (by size, then content)
+  /// @param a The first name
+  /// @param b The second name
+  /// @return <0 if a < b, 0 if a == b, >0 if a > b
+  static int compare_names(StringView a, StringView b) noexcept
+  {
+    if (a.size() != b.size())
+      return a.size() < b.size() ? -1 : 1;
+    return a.compare(b);
+  }
+
+  /*-------------------------------------------------------------------
+  | MODULE IMAGE
+  -------------------------------------------------------------------*/
+
+  u64 ModuleImage::fn_payloads_offset() const noexcept
+  {
+    return types_offset() + u64{type_count()} * sizeof(ImageTypeRecord);
+  }
+
+  u64 ModuleImage::fn_args_offset() const noexcept
+  {
+    return fn_payloads_offset()
+           + u64{ltoh(header().fn_payload_count)} * sizeof(ImageFnPayloadRecord);
+  }
+
+  u64 ModuleImage::modules_offset() const noexcept
+  {
+    return fn_args_offset()
+           + u64{ltoh(header().fn_arg_count)} * sizeof(ImageFnArgRecord);
+  }
+
+  u64 ModuleImage::globals_offset() const noexcept
+  {
+    return modules_offset() + u64{module_count()} * sizeof(ImageModuleRecord);
+  }
+
+  u64 ModuleImage::names_offset() const noexcept
+  {
+    return globals_offset() + u64{global_count()} * sizeof(ImageGlobalRecord);
+  }
+
+  Option<StringView> ModuleImage::name(u32 offset, u32 size) const noexcept
+  {
+    if (u64{offset} + size > ltoh(header().names_size))
+      return None;
+    return StringView{
+        reinterpret_cast<const char*>(bytes.data() + names_offset() + offset),
+        size};
+  }
+
+  Option<ModuleImage> ModuleImage::load(View<u8> bytes, bool verify) noexcept
+  {
+    COLT_TRACE_SCOPE("load module image");
+    assert_true(
+        "Bytes must be aligned!",
+        (uintptr_t)bytes.data() % alignof(ModuleImageHeader) == 0);
+
+    if (bytes.size() < sizeof(ModuleImageHeader))
+      return None;
+    auto image = ModuleImage(bytes);
+    if (ltoh(image.header().magic) != ModuleImageHeader::MAGIC_NUMBER
+        || ltoh(image.header().format_version)
+               != ModuleImageHeader::FORMAT_VERSION)
+      return None;
+    // The counts are u32, so the offsets cannot overflow
+    if (image.module_count() == 0
+        || image.names_offset() + ltoh(image.header().names_size) != bytes.size())
+      return None;
+    if (verify && !image.verify())
+      return None;
+    return image;
+  }
+
+  bool ModuleImage::verify() const noexcept
+  {
+    COLT_TRACE_SCOPE("verify module image");
+    return crc32c(
+               0, bytes.data() + sizeof(ModuleImageHeader),
+               bytes.size() - sizeof(ModuleImageHeader))
+           == ltoh(header().checksum);
+  }
+
+  Option<ImageModule> ModuleImage::module(u32 index) const noexcept
+  {
+    assert_true("Invalid index!", index < module_count());
+    auto& rec        = record<ImageModuleRecord>(modules_offset(), index);
+    auto module_name = name(ltoh(rec.name_offset), ltoh(rec.name_size));
+    const u32 parent = ltoh(rec.parent);
+    if (module_name.is_none() || parent >= module_count())
+      return None;
+    return ImageModule{index, *module_name, parent};
+  }
+
+  Option<ImageGlobal> ModuleImage::global(u32 index) const noexcept
+  {
+    assert_true("Invalid index!", index < global_count());
+    auto& rec        = record<ImageGlobalRecord>(globals_offset(), index);
+    auto global_name = name(ltoh(rec.name_offset), ltoh(rec.name_size));
+    const u32 type   = ltoh(rec.type);
+    const u32 flags  = ltoh(rec.flags);
+    if (global_name.is_none() || type >= type_count())
+      return None;
+    auto global = ImageGlobal{
+        *global_name, ltoh(rec.module), TypeToken{type}, None,
+        (flags & ImageGlobalRecord::FLAG_MUT) != 0};
+    if ((flags & ImageGlobalRecord::FLAG_HAS_VALUE) != 0)
+      global.value = QWORD_t{ltoh(rec.value)};
+    return global;
+  }
+
+  Option<u32> ModuleImage::find_submodule(
+      u32 parent, StringView name) const noexcept
+  {
+    auto& rec = record<ImageModuleRecord>(modules_offset(), parent);
+    u64 low   = ltoh(rec.first_submodule);
+    u64 high  = low + ltoh(rec.submodule_count);
+    if (high > module_count())
+      return None;
+    while (low < high)
+    {
+      const u64 middle = low + (high - low) / 2;
+      auto module      = this->module(static_cast<u32>(middle));
+      if (module.is_none())
+        return None;
+      const int cmp = compare_names(module->name, name);
+      if (cmp == 0)
+        return static_cast<u32>(middle);
+      if (cmp < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    return None;
+  }
+
+  Option<u32> ModuleImage::find_module(View<StringView> name) const noexcept
+  {
+    COLT_TRACE_SCOPE("image find module");
+    u32 module = 0;
+    for (auto part : name)
+    {
+      auto submodule = find_submodule(module, part);
+      if (submodule.is_none())
+        return None;
+      module = *submodule;
+    }
+    return module;
+  }
+
+  Option<ImageGlobal> ModuleImage::find_global(
+      u32 module, StringView name) const noexcept
+  {
+    COLT_TRACE_SCOPE("image find global");
+    assert_true("Invalid index!", module < module_count());
+    auto& rec = record<ImageModuleRecord>(modules_offset(), module);
+    u64 low   = ltoh(rec.first_global);
+    u64 high  = low + ltoh(rec.global_count);
+    if (high > global_count())
+      return None;
+    while (low < high)
+    {
+      const u64 middle = low + (high - low) / 2;
+      auto global      = this->global(static_cast<u32>(middle));
+      if (global.is_none())
+        return None;
+      const int cmp = compare_names(global->name, name);
+      if (cmp == 0)
+        return global;
+      if (cmp < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    return None;
+  }
+
+  ErrorFlag ModuleImage::intern_types(TypeBuffer& buffer) const noexcept
+  {
+    COLT_TRACE_SCOPE("intern image types");
+    using enum TypeID;
+    assert_true("Buffer must be empty!", buffer.type_count() == 0);
+
+    const u32 payload_count = ltoh(header().fn_payload_count);
+    const u32 arg_count     = ltoh(header().fn_arg_count);
+    for (u32 i = 0; i < type_count(); i++)
+    {
+      auto& rec         = record<ImageTypeRecord>(types_offset(), i);
+      const u32 payload = ltoh(rec.payload);
+      if (rec.id > reflect<TypeID>::max())
+        return ErrorFlag::error();
+      // A type can only refer to the types that precede it
+      TypeToken token = TypeToken{0};
+      switch_no_default(static_cast<TypeID>(rec.id))
+      {
+      case TYPE_ERROR:
+        token = buffer.error_type();
+        break;
+      case TYPE_VOID:
+        token = buffer.void_type();
+        break;
+      case TYPE_BUILTIN:
+        if (rec.builtin > reflect<BuiltinID>::max())
+          return ErrorFlag::error();
+        token = buffer.add_builtin(static_cast<BuiltinID>(rec.builtin));
+        break;
+      case TYPE_PTR:
+        if (payload >= i)
+          return ErrorFlag::error();
+        token = buffer.add_ptr(TypeToken{payload});
+        break;
+      case TYPE_MUT_PTR:
+        if (payload >= i)
+          return ErrorFlag::error();
+        token = buffer.add_mut_ptr(TypeToken{payload});
+        break;
+      case TYPE_OPTR:
+        token = buffer.add_opaque_ptr();
+        break;
+      case TYPE_MUT_OPTR:
+        token = buffer.add_mut_opaque_ptr();
+        break;
+      case TYPE_FN:
+      {
+        if (payload >= payload_count)
+          return ErrorFlag::error();
+        auto& fn = record<ImageFnPayloadRecord>(fn_payloads_offset(), payload);
+
+        const u32 first  = ltoh(fn.first_arg);
+        const u32 count  = ltoh(fn.arg_count);
+        const u32 result = ltoh(fn.return_type);
+        if (u64{first} + count > arg_count || result >= i)
+          return ErrorFlag::error();
+        Vector<FnTypeArgument> args = Vector<FnTypeArgument>(count);
+        for (u32 j = first; j < first + count; j++)
+        {
+          auto& arg           = record<ImageFnArgRecord>(fn_args_offset(), j);
+          const u32 arg_type  = ltoh(arg.type);
+          const u32 specifier = ltoh(arg.specifier);
+          if (arg_type >= i || specifier > reflect<ArgSpecifier>::max())
+            return ErrorFlag::error();
+          args.push_back(
+              FnTypeArgument{
+                  TypeToken{arg_type}, static_cast<ArgSpecifier>(specifier)});
+        }
+        token = buffer.add_fn(
+            TypeToken{result}, std::move(args), ltoh(fn.is_variadic) != 0);
+        break;
+      }
+      }
+      // Duplicated types would shift the tokens of the following types
+      if (token.getID() != i)
+        return ErrorFlag::error();
+    }
+    return ErrorFlag::success();
+  }
+
+  ErrorFlag ModuleImage::create_modules(ModuleBuffer& buffer) const noexcept
+  {
+    COLT_TRACE_SCOPE("create image modules");
+    // The tokens of the modules created (the global module is 0)
+    Vector<ModuleToken> tokens = Vector<ModuleToken>(module_count());
+    tokens.push_back(ModuleBuffer::global_token());
+    for (u32 i = 1; i < module_count(); i++)
+    {
+      auto module = this->module(i);
+      // The parent of a module precedes it
+      if (module.is_none() || module->parent >= i || module->name.empty())
+        return ErrorFlag::error();
+      auto token = buffer.create_module(module->name, tokens[module->parent]);
+      if (token.is_none())
+        return ErrorFlag::error();
+      buffer.add_submodule(tokens[module->parent], *token);
+      tokens.push_back(*token);
+    }
+    return ErrorFlag::success();
+  }
+
+  /*-------------------------------------------------------------------
+  | MODULE IMAGE BUILDER
+  -------------------------------------------------------------------*/
+
+  ModuleImageBuilder::ModuleImageBuilder(const TypeBuffer& types) noexcept
+      : types(types)
+  {
+    modules.push_back(PendingModule{0, 0, 0});
+  }
+
+  u32 ModuleImageBuilder::add_name(StringView name) noexcept
+  {
+    assert_true(
+        "Integer overflow!",
+        names.size() + name.size() <= std::numeric_limits<u32>::max());
+    const auto offset = static_cast<u32>(names.size());
+    names.push_back(name);
+    return offset;
+  }
+
+  u32 ModuleImageBuilder::get_submodule(u32 parent, StringView name) noexcept
+  {
+    for (auto submodule : modules[parent].submodules)
+    {
+      auto& module = modules[submodule];
+      if (this->name(module.name_offset, module.name_size) == name)
+        return submodule;
+    }
+    const auto index = static_cast<u32>(modules.size());
+    modules.push_back(
+        PendingModule{add_name(name), static_cast<u32>(name.size()), parent});
+    modules[parent].submodules.push_back(index);
+    return index;
+  }
+
+  ErrorFlag ModuleImageBuilder::add_unit(
+      const ParsedUnit& unit, View<StringView> module) noexcept
+  {
+    COLT_TRACE_SCOPE("image add unit");
+    assert_true("Unit must be parsed without errors!", unit.error_count() == 0);
+    assert_true(
+        "Unit must be parsed by the program of the types!",
+        &unit.program().type_buffer() == &types);
+    if (module.size() > ModuleName::max_size())
+      return ErrorFlag::error();
+    u32 index = 0;
+    for (auto part : module)
+    {
+      if (part.empty())
+        return ErrorFlag::error();
+      index = get_submodule(index, part);
+    }
+
+    auto& exprs = unit.expr_buffer();
+    for (auto stmt : exprs.top_level_stmts())
+    {
+      if (stmt->classof() != ExprID::EXPR_GLOBAL_DECL)
+        continue;
+      auto& decl      = static_cast<const GlobalDeclExpr&>(*stmt);
+      const auto name = decl.global_name();
+      for (auto& global : globals)
+      {
+        if (global.module == index
+            && this->name(global.name_offset, global.name_size) == name)
+          return ErrorFlag::error();
+      }
+      auto global = PendingGlobal{
+          add_name(name),
+          static_cast<u32>(name.size()),
+          index,
+          decl.type().getID(),
+          0,
+          decl.is_mut() ? ImageGlobalRecord::FLAG_MUT : 0};
+      // Only constant initial values are stored (see 'ImageGlobal::value')
+      auto init = exprs.expr(decl.init()).as_base();
+      if (init->classof() == ExprID::EXPR_LITERAL)
+      {
+        global.value = static_cast<const LiteralExpr*>(init)->value().as<u64>();
+        global.flags |= ImageGlobalRecord::FLAG_HAS_VALUE;
+      }
+      globals.push_back(global);
+    }
+    return ErrorFlag::success();
+  }
+
+  ErrorFlag ModuleImageBuilder::write(const char* path) const noexcept
+  {
+    COLT_TRACE_SCOPE("write module image");
+    using enum TypeID;
+
+    // Types and function payloads
+    Vector<ImageTypeRecord> type_records =
+        Vector<ImageTypeRecord>(types.type_count());
+    Vector<ImageFnPayloadRecord> fn_records =
+        Vector<ImageFnPayloadRecord>(types.fn_payload_count());
+    Vector<ImageFnArgRecord> arg_records;
+    for (u32 i = 0; i < types.type_count(); i++)
+    {
+      auto& type = types.type(TypeToken{i});
+      auto rec   = ImageTypeRecord{static_cast<u8>(type.classof()), 0, 0, 0};
+      switch_no_default(type.classof())
+      {
+      case TYPE_ERROR:
+      case TYPE_VOID:
+      case TYPE_OPTR:
+      case TYPE_MUT_OPTR:
+        break;
+      case TYPE_BUILTIN:
+        rec.builtin = static_cast<u8>(type.as<BuiltinType>()->type_id());
+        break;
+      case TYPE_PTR:
+        rec.payload = htol(type.as<PtrType>()->pointing_to().getID());
+        break;
+      case TYPE_MUT_PTR:
+        rec.payload = htol(type.as<MutPtrType>()->pointing_to().getID());
+        break;
+      case TYPE_FN:
+        rec.payload = htol(type.as<FnType>()->payload_id());
+        break;
+      }
+      type_records.push_back(rec);
+    }
+    for (u32 i = 0; i < types.fn_payload_count(); i++)
+    {
+      auto& payload = types.fn_payload(i);
+      fn_records.push_back(
+          ImageFnPayloadRecord{
+              htol(payload.return_type.getID()),
+              htol(static_cast<u32>(arg_records.size())),
+              htol(static_cast<u32>(payload.arguments_type.size())),
+              htol(static_cast<u32>(payload.is_variadic))});
+      for (auto& arg : payload.arguments_type)
+        arg_records.push_back(
+            ImageFnArgRecord{
+                htol(arg.type.getID()), htol(static_cast<u32>(arg.specifier))});
+    }
+
+    // Modules are ordered breadth first, with the submodules of a module
+    // sorted by name: the submodules of a module are then contiguous.
+    Vector<u32> order     = Vector<u32>(modules.size());
+    Vector<u32> new_index = Vector<u32>(modules.size(), InPlace, u32{0});
+    order.push_back(0);
+    for (u64 i = 0; i < order.size(); i++)
+    {
+      const u64 first = order.size();
+      for (auto submodule : modules[order[i]].submodules)
+        order.push_back(submodule);
+      std::sort(
+          order.begin() + first, order.end(),
+          [&](u32 a, u32 b)
+          {
+            return compare_names(
+                       name(modules[a].name_offset, modules[a].name_size),
+                       name(modules[b].name_offset, modules[b].name_size))
+                   < 0;
+          });
+    }
+    for (u32 i = 0; i < order.size(); i++)
+      new_index[order[i]] = i;
+
+    // Globals are sorted by (module, name)
+    Vector<u32> global_order = Vector<u32>(globals.size());
+    for (u32 i = 0; i < globals.size(); i++)
+      global_order.push_back(i);
+    std::sort(
+        global_order.begin(), global_order.end(),
+        [&](u32 a, u32 b)
+        {
+          auto& ga = globals[a];
+          auto& gb = globals[b];
+          if (new_index[ga.module] != new_index[gb.module])
+            return new_index[ga.module] < new_index[gb.module];
+          return compare_names(
+                     name(ga.name_offset, ga.name_size),
+                     name(gb.name_offset, gb.name_size))
+                 < 0;
+        });
+
+    Vector<ImageModuleRecord> module_records =
+        Vector<ImageModuleRecord>(modules.size());
+    u32 next_submodule = 1;
+    u32 next_global    = 0;
+    for (auto index : order)
+    {
+      auto& module     = modules[index];
+      u32 global_count = 0;
+      while (next_global + global_count < global_order.size()
+             && globals[global_order[next_global + global_count]].module == index)
+        ++global_count;
+      module_records.push_back(
+          ImageModuleRecord{
+              htol(module.name_offset), htol(module.name_size),
+              htol(new_index[module.parent]), htol(next_submodule),
+              htol(static_cast<u32>(module.submodules.size())),
+              htol(next_global), htol(global_count), 0});
+      next_submodule += static_cast<u32>(module.submodules.size());
+      next_global += global_count;
+    }
+
+    Vector<ImageGlobalRecord> global_records =
+        Vector<ImageGlobalRecord>(globals.size());
+    for (auto index : global_order)
+    {
+      auto& global = globals[index];
+      global_records.push_back(
+          ImageGlobalRecord{
+              htol(global.name_offset), htol(global.name_size),
+              htol(new_index[global.module]), htol(global.type),
+              htol(global.value), htol(global.flags), 0});
+    }
+
+    auto header = ModuleImageHeader{
+        htol(ModuleImageHeader::MAGIC_NUMBER),
+        htol(ModuleImageHeader::FORMAT_VERSION),
+        0,
+        htol(static_cast<u32>(type_records.size())),
+        htol(static_cast<u32>(fn_records.size())),
+        htol(static_cast<u32>(arg_records.size())),
+        htol(static_cast<u32>(module_records.size())),
+        htol(static_cast<u32>(global_records.size())),
+        htol(static_cast<u32>(names.size()))};
+
+    auto out = io::BufferedWriter::open(path);
+    if (out.is_none())
+      return ErrorFlag::error();
+    u32 checksum = 0;
+    auto emit    = [&](const void* ptr, u64 size)
+    {
+      checksum = crc32c(checksum, ptr, size);
+      out->write(ptr, size);
+    };
+    out->write(&header, sizeof(header));
+    emit(type_records.data(), type_records.size() * sizeof(ImageTypeRecord));
+    emit(fn_records.data(), fn_records.size() * sizeof(ImageFnPayloadRecord));
+    emit(arg_records.data(), arg_records.size() * sizeof(ImageFnArgRecord));
+    emit(module_records.data(), module_records.size() * sizeof(ImageModuleRecord));
+    emit(global_records.data(), global_records.size() * sizeof(ImageGlobalRecord));
+    emit(names.data(), names.size());
+    out->patch_le(offsetof(ModuleImageHeader, checksum), checksum);
+    return out->flush();
+  }
+} // namespace clt::lng
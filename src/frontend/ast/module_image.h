@@ -0,0 +1,368 @@
+/*****************************************************************/ /**
+ * @file   module_image.h
+ * @brief  Contains ModuleImage, a prebuilt binary image of modules
+ * (such as the standard library) that is mapped read-only and linked
+ * against in place, rather than lexing and parsing the modules on
+ * each compilation.
+ * An image contains the interned types, the module tree and the global
+ * variables of the modules (with their constant initial value).
+ * Every section is an array of fixed-size little endian records,
+ * sorted so that modules and globals can be searched (in O(log n))
+ * directly in the mapped bytes: loading an image only validates its
+ * header. Linking it to a program interns its types (in O(type count)),
+ * while its modules are only created as they are first imported, so the
+ * startup time does not depend on the count of modules or globals.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_MODULE_IMAGE
+#define HG_COLT_MODULE_IMAGE
+
+#include "parsed_unit.h"
+#include "lng/colt_type_buffer.h"
+#include "lng/colt_module.h"
+
+namespace clt::lng
+{
+  /// @brief The header of a module image.
+  /// The header is followed by the sections (in that order): the types,
+  /// the function payloads, the function arguments, the modules, the
+  /// globals and the names (referenced by the modules and globals).
+  struct ModuleImageHeader
+  {
+    /// @brief The magic number of module images ('CLTIMAGE')
+    static constexpr u64 MAGIC_NUMBER = 0x4547'414D'4954'4C43;
+    /// @brief The version of the format
+    static constexpr u32 FORMAT_VERSION = 1;
+
+    /// @brief The magic number
+    u64 magic;
+    /// @brief The version of the format
+    u32 format_version;
+    /// @brief The CRC32C of the bytes following the header
+    u32 checksum;
+    /// @brief The count of types
+    u32 type_count;
+    /// @brief The count of function payloads
+    u32 fn_payload_count;
+    /// @brief The count of function arguments (of all the payloads)
+    u32 fn_arg_count;
+    /// @brief The count of modules (including the global module)
+    u32 module_count;
+    /// @brief The count of globals
+    u32 global_count;
+    /// @brief The size of the names section
+    u32 names_size;
+  };
+
+  /// @brief A type of a module image
+  struct ImageTypeRecord
+  {
+    /// @brief The TypeID of the type
+    u8 id;
+    /// @brief The BuiltinID (for built-in types)
+    u8 builtin;
+    /// @brief Padding
+    u16 padding;
+    /// @brief The type pointed to (for pointers) or the payload (for functions)
+    u32 payload;
+  };
+
+  /// @brief A function payload of a module image
+  struct ImageFnPayloadRecord
+  {
+    /// @brief The return type
+    u32 return_type;
+    /// @brief The index of the first argument
+    u32 first_arg;
+    /// @brief The count of arguments
+    u32 arg_count;
+    /// @brief 1 if the function uses C variadic arguments
+    u32 is_variadic;
+  };
+
+  /// @brief A function argument of a module image
+  struct ImageFnArgRecord
+  {
+    /// @brief The type of the argument
+    u32 type;
+    /// @brief The ArgSpecifier of the argument
+    u32 specifier;
+  };
+
+  /// @brief A module of a module image.
+  /// The modules are sorted by (parent, name): the submodules of
+  /// a module (and its globals) are contiguous.
+  struct ImageModuleRecord
+  {
+    /// @brief The offset of the name in the names section
+    u32 name_offset;
+    /// @brief The size of the name
+    u32 name_size;
+    /// @brief The index of the parent (the global module is its own parent)
+    u32 parent;
+    /// @brief The index of the first submodule
+    u32 first_submodule;
+    /// @brief The count of submodules
+    u32 submodule_count;
+    /// @brief The index of the first global
+    u32 first_global;
+    /// @brief The count of globals
+    u32 global_count;
+    /// @brief Padding
+    u32 padding;
+  };
+
+  /// @brief A global variable of a module image.
+  /// The globals are sorted by (module, name).
+  struct ImageGlobalRecord
+  {
+    /// @brief Set if the global is mutable
+    static constexpr u32 FLAG_MUT = 1;
+    /// @brief Set if 'value' is the initial value of the global
+    static constexpr u32 FLAG_HAS_VALUE = 2;
+
+    /// @brief The offset of the name in the names section
+    u32 name_offset;
+    /// @brief The size of the name
+    u32 name_size;
+    /// @brief The index of the module of the global
+    u32 module;
+    /// @brief The type of the global
+    u32 type;
+    /// @brief The constant initial value (if FLAG_HAS_VALUE)
+    u64 value;
+    /// @brief The flags of the global
+    u32 flags;
+    /// @brief Padding
+    u32 padding;
+  };
+
+  /// @brief A module of a module image
+  struct ImageModule
+  {
+    /// @brief The index of the module
+    u32 index;
+    /// @brief The name of the module (empty for the global module)
+    StringView name;
+    /// @brief The index of the parent of the module
+    u32 parent;
+  };
+
+  /// @brief A global variable of a module image
+  struct ImageGlobal
+  {
+    /// @brief The name of the global
+    StringView name;
+    /// @brief The index of the module of the global
+    u32 module;
+    /// @brief The type of the global (valid once the image is linked)
+    TypeToken type;
+    /// @brief The initial value of the global (if it is constant)
+    Option<QWORD_t> value;
+    /// @brief True if the global is mutable
+    bool is_mut;
+  };
+
+  /// @brief Read-only view over a module image.
+  /// The bytes of the image are never copied: names returned by the
+  /// image point into the bytes, which must outlive the image (and any
+  /// program linked against it).
+  class ModuleImage
+  {
+    /// @brief The bytes of the image
+    View<u8> bytes;
+
+    /// @brief Constructor
+    /// @param bytes The bytes of the image
+    ModuleImage(View<u8> bytes) noexcept
+        : bytes(bytes)
+    {
+    }
+
+    /// @brief Returns the header of the image
+    /// @return The header of the image
+    const ModuleImageHeader& header() const noexcept
+    {
+      return *reinterpret_cast<const ModuleImageHeader*>(bytes.data());
+    }
+
+    template<typename T>
+    /// @brief Returns a record of a section
+    /// @param offset The offset of the section
+    /// @param index The index of the record
+    /// @return The record (with the endianness of the image)
+    const T& record(u64 offset, u64 index) const noexcept
+    {
+      return reinterpret_cast<const T*>(bytes.data() + offset)[index];
+    }
+
+    /// @brief Returns a name of the names section
+    /// @param offset The offset of the name
+    /// @param size The size of the name
+    /// @return The name, or None if out of the names section
+    Option<StringView> name(u32 offset, u32 size) const noexcept;
+
+    /// @brief Returns the offset of the types section
+    u64 types_offset() const noexcept { return sizeof(ModuleImageHeader); }
+    /// @brief Returns the offset of the function payloads section
+    u64 fn_payloads_offset() const noexcept;
+    /// @brief Returns the offset of the function arguments section
+    u64 fn_args_offset() const noexcept;
+    /// @brief Returns the offset of the modules section
+    u64 modules_offset() const noexcept;
+    /// @brief Returns the offset of the globals section
+    u64 globals_offset() const noexcept;
+    /// @brief Returns the offset of the names section
+    u64 names_offset() const noexcept;
+
+  public:
+    /// @brief Loads an image from bytes.
+    /// Only the header is validated (in O(1)): the records are validated
+    /// as they are accessed, and when the image is linked.
+    /// The bytes must be 8-byte aligned and outlive the image.
+    /// @param bytes The bytes of the image
+    /// @param verify If true, verifies the checksum of the whole image
+    /// @return None if the image is invalid, truncated or corrupted
+    static Option<ModuleImage> load(View<u8> bytes, bool verify = false) noexcept;
+
+    /// @brief Verifies the checksum of the image (in O(size))
+    /// @return True if the image is not corrupted
+    bool verify() const noexcept;
+
+    /// @brief Returns the count of types of the image
+    /// @return The count of types
+    u32 type_count() const noexcept { return ltoh(header().type_count); }
+    /// @brief Returns the count of modules of the image
+    /// @return The count of modules (including the global module)
+    u32 module_count() const noexcept { return ltoh(header().module_count); }
+    /// @brief Returns the count of globals of the image
+    /// @return The count of globals
+    u32 global_count() const noexcept { return ltoh(header().global_count); }
+
+    /// @brief Returns a module of the image
+    /// @param index The index of the module (< module_count())
+    /// @return The module, or None if its record is invalid
+    Option<ImageModule> module(u32 index) const noexcept;
+
+    /// @brief Returns a global of the image
+    /// @param index The index of the global (< global_count())
+    /// @return The global, or None if its record is invalid
+    Option<ImageGlobal> global(u32 index) const noexcept;
+
+    /// @brief Searches for a submodule of a module
+    /// @param parent The index of the module (< module_count())
+    /// @param name The name of the submodule
+    /// @return The index of the submodule or None
+    Option<u32> find_submodule(u32 parent, StringView name) const noexcept;
+
+    /// @brief Searches for a module by name (as std::io -> {std, io})
+    /// @param name The name of the module (empty for the global module)
+    /// @return The index of the module or None
+    Option<u32> find_module(View<StringView> name) const noexcept;
+
+    /// @brief Searches for a global of a module
+    /// @param module The index of the module
+    /// @param name The name of the global
+    /// @return The global or None
+    Option<ImageGlobal> find_global(u32 module, StringView name) const noexcept;
+
+    /// @brief Interns the types of the image in an empty buffer.
+    /// The tokens of the types in the buffer are the indices of the types
+    /// of the image, so that the types of the globals can be used as is.
+    /// @param buffer The (empty) buffer in which to intern the types
+    /// @return Error if a type of the image is invalid
+    ErrorFlag intern_types(TypeBuffer& buffer) const noexcept;
+
+    /// @brief Creates the modules of the image in a buffer that only
+    /// contains the global module.
+    /// The names of the modules point into the image.
+    /// @param buffer The buffer in which to create the modules
+    /// @return Error if a module of the image is invalid
+    ErrorFlag create_modules(ModuleBuffer& buffer) const noexcept;
+  };
+
+  /// @brief Builds a module image from parsed units.
+  /// All the units must be parsed by the same ParsedProgram, whose types
+  /// are written to the image.
+  class ModuleImageBuilder
+  {
+    /// @brief A module of the image being built
+    struct PendingModule
+    {
+      /// @brief The offset of the name in 'names'
+      u32 name_offset;
+      /// @brief The size of the name
+      u32 name_size;
+      /// @brief The index of the parent
+      u32 parent;
+      /// @brief The indices of the submodules
+      Vector<u32> submodules{};
+    };
+
+    /// @brief A global of the image being built
+    struct PendingGlobal
+    {
+      /// @brief The offset of the name in 'names'
+      u32 name_offset;
+      /// @brief The size of the name
+      u32 name_size;
+      /// @brief The index of the module of the global
+      u32 module;
+      /// @brief The type of the global
+      u32 type;
+      /// @brief The constant initial value (if FLAG_HAS_VALUE)
+      u64 value;
+      /// @brief The flags of the global
+      u32 flags;
+    };
+
+    /// @brief The types of the program
+    const TypeBuffer& types;
+    /// @brief The modules (0 is the global module)
+    Vector<PendingModule> modules{};
+    /// @brief The globals
+    Vector<PendingGlobal> globals{};
+    /// @brief The names of the modules and globals
+    String names{};
+
+    /// @brief Appends a name to 'names'
+    /// @param name The name
+    /// @return The offset of the name
+    u32 add_name(StringView name) noexcept;
+
+    /// @brief Returns a name of 'names'
+    /// @param offset The offset of the name
+    /// @param size The size of the name
+    /// @return The name
+    StringView name(u32 offset, u32 size) const noexcept
+    {
+      return StringView{names.data() + offset, size};
+    }
+
+    /// @brief Returns (creating it if needed) the submodule of a module
+    /// @param parent The index of the module
+    /// @param name The name of the submodule
+    /// @return The index of the submodule
+    u32 get_submodule(u32 parent, StringView name) noexcept;
+
+  public:
+    /// @brief Constructor
+    /// @param types The types of the program parsing the units
+    ModuleImageBuilder(const TypeBuffer& types) noexcept;
+
+    /// @brief Adds the globals of a unit to a module
+    /// @param unit The unit (parsed without errors)
+    /// @param module The name of the module (as std::io -> {std, io})
+    /// @return Error if the name is invalid, or a global already exists
+    ErrorFlag add_unit(const ParsedUnit& unit, View<StringView> module) noexcept;
+
+    /// @brief Writes the image
+    /// @param path The path of the image
+    /// @return Error if the image could not be written
+    ErrorFlag write(const char* path) const noexcept;
+  };
+} // namespace clt::lng
+
+#endif // !HG_COLT_MODULE_IMAGE
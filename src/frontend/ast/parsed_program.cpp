@@ -15,13 +15,19 @@ namespace clt::lng
 
   ParsedProgram::ParsedProgram(
       ErrorReporter& reporter, const std::filesystem::path& start,
-      const Vector<std::filesystem::path>& includes,
-      const WarnFor& warn_for) noexcept
+      const Vector<std::filesystem::path>& includes, const WarnFor& warn_for,
+      const ModuleImage* image, bool low_memory) noexcept
       : _reporter(reporter)
       , start_file(start)
       , includes(includes)
       , _warn_for(warn_for)
+      , _low_memory(low_memory)
   {
+    if (image != nullptr && link_image(*image).is_error())
+    {
+      _reporter.error("The module image is invalid!");
+      return;
+    }
     parsed_units.insert(EMPTY_PATH, ParsedUnit{*this, start}).first->second.parse();
   }
 
@@ -37,8 +43,85 @@ namespace clt::lng
     parsed_units.insert(EMPTY_PATH, ParsedUnit{*this, start}).first->second.parse();
   }
 
+  ParsedProgram::ParsedProgram(
+      ErrorReporter& reporter, const Vector<std::filesystem::path>& includes,
+      const WarnFor& warn_for, const ModuleImage* image, bool low_memory) noexcept
+      : _reporter(reporter)
+      , start_file(EMPTY_PATH)
+      , includes(includes)
+      , _warn_for(warn_for)
+      , _low_memory(low_memory)
+  {
+    if (image != nullptr && link_image(*image).is_error())
+      _reporter.error("The module image is invalid!");
+  }
+
+  ErrorFlag ParsedProgram::link_image(const ModuleImage& to_link) noexcept
+  {
+    COLT_TRACE_SCOPE("link module image");
+    if (to_link.intern_types(_type_buffer).is_error())
+      return ErrorFlag::error();
+    image = &to_link;
+    return ErrorFlag::success();
+  }
+
   bool ParsedProgram::import_unit(StringView import_path) noexcept
   {
-    return false;
+    if (image == nullptr || import_path.empty())
+      return false;
+    // One more part than allowed to detect names that are too long
+    std::array<StringView, ModuleName::max_size() + 1> parts{};
+    u64 count = 0;
+    while (count != parts.size())
+    {
+      const size_t dot = import_path.find('.');
+      parts[count++]   = import_path.substr(0, dot);
+      if (dot == StringView::npos)
+        break;
+      import_path = import_path.substr(dot + 1);
+    }
+    if (count > ModuleName::max_size())
+      return false;
+
+    // The modules of the path are created (parents first) if not yet imported
+    u32 index         = 0;
+    ModuleToken token = ModuleBuffer::global_token();
+    for (u64 i = 0; i < count; i++)
+    {
+      auto submodule = image->find_submodule(index, parts[i]);
+      if (submodule.is_none())
+        return false;
+      index = *submodule;
+      if (auto created = image_modules.find(index); created != nullptr)
+      {
+        token = created->second;
+        continue;
+      }
+      // The name of the module must point into the image
+      auto module = image->module(index);
+      if (module.is_none() || module->name.empty())
+        return false;
+      auto created = module_buffer.create_module(module->name, token);
+      if (created.is_none())
+        return false;
+      module_buffer.add_submodule(token, *created);
+      image_modules.insert(index, *created);
+      token = *created;
+    }
+    return true;
+  }
+
+  void ParsedProgram::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    for (auto& [path, unit] : parsed_units)
+      unit.report_memory(report);
+    _type_buffer.report_memory(report);
+    module_buffer.report_memory(report);
+    auto literals = literal_str.memory_usage();
+    for (auto& str : literal_str)
+      literals.add_owned(str.memory_usage());
+    report.add("ParsedProgram::str_literals", literals);
+    report.add("ParsedProgram::parsed_units", parsed_units.memory_usage());
+    _reporter.report_memory(report);
   }
 } // namespace clt::lng
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "lng/colt_module.h"
 #include "err/composable_reporter.h"
 #include "parsed_unit.h"
+#include "module_image.h"
 #include "structs/map.h"
 #include "err/warn.h"
 
@@ -39,6 +40,21 @@ namespace clt::lng
     const Vector<std::filesystem::path>& includes;
     /// @brief Dictates which warnings to generate
     WarnFor _warn_for;
+    /// @brief The module image linked to the program (or null)
+    const ModuleImage* image = nullptr;
+    /// @brief The modules of the image created so far (by index in the image)
+    Map<u32, ModuleToken> image_modules{};
+    /// @brief If true, the tokens of each unit are discarded once parsed
+    bool _low_memory = false;
+
+    /// @brief Links a module image to the program.
+    /// This must be done before parsing anything, as the types of
+    /// the image are interned first (so that their tokens are the same):
+    /// this is linear in the count of types of the image.
+    /// The modules of the image are created on their first import.
+    /// @param to_link The image to link
+    /// @return Error if the image is invalid
+    ErrorFlag link_image(const ModuleImage& to_link) noexcept;
 
   public:
     /// @brief Represents an empty path (used when the StringView constructor overload is used)
@@ -50,10 +66,14 @@ namespace clt::lng
     /// @param start The starting file to parse (main.ct)
     /// @param includes The include path used by the program
     /// @param warn_for The warnings to reports
+    /// @param image The module image to link before parsing (or null),
+    /// whose bytes must outlive the program
+    /// @param low_memory If true, discards the tokens of each unit once
+    /// parsed (see ParsedUnit::discard_tokens)
     explicit ParsedProgram(
         ErrorReporter& reporter, const std::filesystem::path& start,
-        const Vector<std::filesystem::path>& includes,
-        const WarnFor& warn_for) noexcept;
+        const Vector<std::filesystem::path>& includes, const WarnFor& warn_for,
+        const ModuleImage* image = nullptr, bool low_memory = false) noexcept;
 
     /// @brief Constructs a parsed program.
     /// This does not parse anything.
@@ -66,6 +86,20 @@ namespace clt::lng
         const Vector<std::filesystem::path>& includes,
         const WarnFor& warn_for) noexcept;
 
+    /// @brief Constructs an empty program, whose units are added later
+    /// (used by REPL sessions, see ReplSession).
+    /// @param reporter The reporter used for errors and warnings
+    /// @param includes The include path used by the program
+    /// @param warn_for The warnings to reports
+    /// @param image The module image to link before parsing (or null),
+    /// whose bytes must outlive the program
+    /// @param low_memory If true, discards the tokens of each unit once
+    /// parsed (see ParsedUnit::discard_tokens)
+    explicit ParsedProgram(
+        ErrorReporter& reporter, const Vector<std::filesystem::path>& includes,
+        const WarnFor& warn_for, const ModuleImage* image = nullptr,
+        bool low_memory = false) noexcept;
+
     /// @brief Returns the reporter used for errors and warnings
     /// @return The reporter
     ErrorReporter& reporter() noexcept { return _reporter; }
@@ -94,9 +128,40 @@ namespace clt::lng
     /// @return What to warn for
     const WarnFor& warn_for() const noexcept { return _warn_for; }
 
-    /// @brief Adds an import
+    /// @brief Returns all the parsed units (by path)
+    /// @return The parsed units
+    const Map<std::filesystem::path, ParsedUnit>& units() const noexcept
+    {
+      return parsed_units;
+    }
+
+    /// @brief Check if the tokens of each unit are discarded once parsed
+    /// @return True in low-memory mode
+    bool low_memory() const noexcept { return _low_memory; }
+
+    /// @brief Returns the module image linked to the program
+    /// @return The module image or null
+    const ModuleImage* linked_image() const noexcept { return image; }
+
+    /// @brief Returns the count of modules of the linked image created so far
+    /// @return The count of modules of the image that were imported
+    /// (including their parents)
+    u32 image_module_count() const noexcept
+    {
+      return static_cast<u32>(image_modules.size());
+    }
+
+    /// @brief Adds an import.
+    /// Modules of the linked image are resolved in place, without parsing,
+    /// and created (with their parents) on their first import.
+    /// @param import_path The name of the module (as 'std.io')
     /// @return True if the import was successful, false on failure
     bool import_unit(StringView import_path) noexcept;
+
+    /// @brief Adds the memory used by the program (its buffers, units and
+    /// reporter) to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
   };
 } // namespace clt::lng
 
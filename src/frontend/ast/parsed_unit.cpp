@@ -8,9 +8,25 @@
 #include "parsed_unit.h"
 #include "parsed_program.h"
 #include "ast.h"
+#include "common/crc32.h"
+#include "common/trace.h"
 
 namespace clt::lng
 {
+  /// @brief Returns the span of a StringView in a source
+  /// @param text The StringView
+  /// @param source The source
+  /// @return The span, or None if 'text' is not in 'source' (for sources
+  /// appended by parse_append)
+  static Option<SourceSpan> span_in(StringView text, StringView source) noexcept
+  {
+    if (text.data() < source.data()
+        || text.data() + text.size() > source.data() + source.size())
+      return None;
+    const auto begin = static_cast<u32>(text.data() - source.data());
+    return SourceSpan{begin, begin + static_cast<u32>(text.size())};
+  }
+
   ParsedUnit::ParsedUnit(
       ParsedProgram& program, const std::filesystem::path& path) noexcept
       : _program(program)
@@ -40,6 +56,7 @@ namespace clt::lng
     // with the right string to parse (used for REPL)
     if (path != ParsedProgram::EMPTY_PATH)
     {
+      COLT_TRACE_SCOPE("load file");
       if (std::error_code err; !std::filesystem::is_regular_file(path, err))
         return ParseResult::INVALID_PATH;
       auto file = String::getFile(path.string().c_str());
@@ -54,15 +71,215 @@ namespace clt::lng
     u64 warn_c  = reporter.warn_count();
 
     // Lexing of the file
-    lex(tokens, reporter, to_parse);
+    lex(*tokens, reporter, to_parse);
     // Create AST of the file
     make_ast(*this);
 
     // Count of errors generated by this unit
     _error_count = static_cast<u32>(reporter.error_count() - error_c);
     _warn_count  = static_cast<u32>(reporter.warn_count() - warn_c);
+    if (_error_count != 0)
+      return ParseResult::COMP_ERROR;
+
+    // Only the AST is kept: the tokens of the unit are never alive at the
+    // same time as those of the units parsed after it.
+    if (_program.low_memory() && path != ParsedProgram::EMPTY_PATH)
+    {
+      _is_parsed = true;
+      discard_tokens();
+    }
+    return ParseResult::SUCCESS;
+  }
+
+  ParsedUnit::ParseResult ParsedUnit::parse_append(StringView source) noexcept
+  {
+    assert_true("The tokens were discarded!", !is_compact());
+    auto& reporter = _program.reporter();
+    // Save the error count
+    u64 error_c = reporter.error_count();
+    u64 warn_c  = reporter.warn_count();
+
+    const auto tokens_checkpoint = tokens->checkpoint();
+    const auto exprs_checkpoint  = exprs.checkpoint();
+    // Lexing of the source, after the tokens already parsed
+    lex(*tokens, reporter, source);
+    // Create AST of the source
+    make_ast(*this, static_cast<u32>(tokens_checkpoint.tokens));
 
-    return _error_count ? ParseResult::COMP_ERROR : ParseResult::SUCCESS;
+    if (reporter.error_count() != error_c)
+    {
+      // The unit is left as it was before the call: if no source was
+      // appended yet, the next one is parsed from the first token
+      tokens->rollback(tokens_checkpoint);
+      exprs.rollback(exprs_checkpoint);
+      return ParseResult::COMP_ERROR;
+    }
+    _is_parsed = true;
+    positions.reset();
+    _warn_count += static_cast<u32>(reporter.warn_count() - warn_c);
+    return ParseResult::SUCCESS;
+  }
+
+  void ParsedUnit::discard_tokens() noexcept
+  {
+    assert_true("parse must be called before!", is_parsed());
+    assert_true(
+        "Only units parsed from a file can be compacted!",
+        path != ParsedProgram::EMPTY_PATH);
+    // The ranges of invalid expressions may not be valid
+    assert_true("The unit must not contain errors!", error_count() == 0);
+    if (is_compact())
+      return;
+    COLT_TRACE_SCOPE("discard tokens");
+
+    // The expressions are iterated (indexing a FlatList walks it)
+    for (auto& expr : exprs.prod_exprs())
+    {
+      if (auto range = expr.token_range(); !range.is_empty())
+        spans.add_range(range);
+    }
+    // The names of the declarations point into the source: they are
+    // copied to 'names', which must thus never reallocate.
+    u64 names_size = 0;
+    for (auto& stmt : exprs.stmt_exprs())
+    {
+      if (!stmt.token_range().is_empty())
+        spans.add_range(stmt.token_range());
+      if (auto var = stmt.as<VarDeclExpr>(); var != nullptr)
+        names_size += var->var_name().size();
+      else if (auto global = stmt.as<GlobalDeclExpr>(); global != nullptr)
+        names_size += global->global_name().size();
+    }
+    spans.build(*tokens, to_parse);
+
+    names.reserve(names_size);
+    const auto copy_name = [this](StringView name)
+    {
+      names.push_back(name);
+      return StringView{names.end() - name.size(), names.end()};
+    };
+    for (auto& stmt : exprs.stmt_exprs())
+    {
+      if (auto var = stmt.as<VarDeclExpr>(); var != nullptr)
+        var->var_name(copy_name(var->var_name()));
+      else if (auto global = stmt.as<GlobalDeclExpr>(); global != nullptr)
+        global->global_name(copy_name(global->global_name()));
+    }
+    tokens.reset();
+    // The indices of the tokens are no longer valid
+    positions.reset();
+    discarded_size = to_parse.size();
+    discarded_crc  = crc32c(0, to_parse.data(), to_parse.size());
+    to_parse       = String{};
+  }
+
+  Option<StringView> ParsedUnit::source() const noexcept
+  {
+    if (!is_compact())
+      return StringView{to_parse};
+    if (mapped_source.is_none())
+    {
+      mapped_source = io::MappedFile::open(path.string().c_str());
+      if (mapped_source.is_none())
+        return None;
+      // The spans are only valid for the file that was parsed
+      const auto bytes = mapped_source->bytes();
+      if (bytes.size() != discarded_size
+          || crc32c(0, bytes.data(), bytes.size()) != discarded_crc)
+      {
+        mapped_source = None;
+        return None;
+      }
+    }
+    const auto bytes = mapped_source->bytes();
+    return StringView{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  }
+
+  Option<SourceInfo> ParsedUnit::source_info(TokenRange range) const noexcept
+  {
+    if (range.is_empty())
+      return None;
+    if (!is_compact())
+      return tokens->make_source_info(range);
+    auto text = source();
+    if (text.is_none())
+      return None;
+    return spans.make_source_info(range, *text);
+  }
+
+  const PositionIndex* ParsedUnit::position_index() const noexcept
+  {
+    if (positions.is_value())
+      return &*positions;
+    auto text = source();
+    if (text.is_none())
+      return nullptr;
+
+    // The lists are iterated, as indexing a FlatList walks it
+    Vector<TokenSpan> token_spans;
+    if (!is_compact())
+    {
+      tokens->for_each_lexeme(
+          [&](Token token, StringView lexeme) noexcept
+          {
+            auto span = span_in(lexeme, *text);
+            // The tokens that follow were appended by parse_append
+            if (span.is_none())
+              return false;
+            token_spans.push_back(TokenSpan{*span, token});
+            return true;
+          });
+    }
+    // The span of a range is read from the spans of its tokens (the range
+    // of an expression may be empty, in which case it has no span)
+    const auto range_span = [&](TokenRange range) noexcept -> Option<SourceSpan>
+    {
+      if (!is_compact())
+        return PositionIndex::span_of(range, token_spans);
+      if (range.is_empty())
+        return None;
+      return spans.span(range);
+    };
+    Vector<ExprSpan> expr_spans;
+    expr_spans.reserve(exprs.prod_count() + exprs.stmt_count());
+    u32 order = 0;
+    for (auto& expr : exprs.prod_exprs())
+    {
+      if (auto span = range_span(expr.token_range()); span.is_value())
+        expr_spans.push_back(ExprSpan{*span, order, expr.as_base()});
+      ++order;
+    }
+    // Statements contain the producers they use
+    for (auto& expr : exprs.stmt_exprs())
+    {
+      if (auto span = range_span(expr.token_range()); span.is_value())
+        expr_spans.push_back(ExprSpan{*span, order, expr.as_base()});
+      ++order;
+    }
+    positions = PositionIndex{*text, token_spans, expr_spans};
+    return &*positions;
+  }
+
+  Option<Token> ParsedUnit::token_at(u32 line, u32 column) const noexcept
+  {
+    auto index = position_index();
+    if (index == nullptr)
+      return None;
+    auto offset = index->offset_of(line, column);
+    if (offset.is_none())
+      return None;
+    return index->token_at(*offset);
+  }
+
+  const ExprBase* ParsedUnit::expr_at(u32 line, u32 column) const noexcept
+  {
+    auto index = position_index();
+    if (index == nullptr)
+      return nullptr;
+    auto offset = index->offset_of(line, column);
+    if (offset.is_none())
+      return nullptr;
+    return index->expr_at(*offset);
   }
 
   const ErrorReporter& ParsedUnit::reporter() const noexcept
@@ -74,4 +291,18 @@ namespace clt::lng
   {
     return _program.reporter();
   }
+
+  void ParsedUnit::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    report.add_source(is_compact() ? discarded_size : to_parse.size());
+    report.add("ParsedUnit::source", to_parse.memory_usage());
+    report.add("ParsedUnit::names", names.memory_usage());
+    if (is_compact())
+      spans.report_memory(report);
+    else
+      tokens->report_memory(report);
+    exprs.report_memory(report);
+    if (positions.is_value())
+      positions->report_memory(report);
+  }
 } // namespace clt::lng
\ No newline at end of file
@@ -11,7 +11,10 @@
 #define HG_COLT_PARSED_UNIT
 
 #include "lex/colt_token_buffer.h"
+#include "lex/colt_source_spans.h"
 #include "ast/colt_expr_buffer.h"
+#include "ast/position_index.h"
+#include "io/mapped_file.h"
 
 namespace clt::lng
 {
@@ -25,12 +28,25 @@ namespace clt::lng
     ParsedProgram& _program;
     /// @brief File path of the current unit (or ParsedProgram::EMPTY_PATH if not a file)
     const std::filesystem::path& path;
-    /// @brief Contains the parsed lexemes
-    TokenBuffer tokens;
+    /// @brief Contains the parsed lexemes (None once discarded)
+    Option<TokenBuffer> tokens{InPlace};
     /// @brief Contains the expression
     ExprBuffer exprs;
-    /// @brief The file content
+    /// @brief The file content (empty once the tokens are discarded)
     String to_parse{};
+    /// @brief The spans of the expressions, once the tokens are discarded
+    SourceSpanTable spans{};
+    /// @brief The names of the declarations, once the tokens are discarded
+    String names{};
+    /// @brief The file content, re-mapped to report diagnostics
+    mutable Option<io::MappedFile> mapped_source{};
+    /// @brief The size of the file content, once the tokens are discarded
+    u64 discarded_size = 0;
+    /// @brief The CRC32C of the file content, once the tokens are discarded
+    /// (to detect that the re-mapped file was modified)
+    u32 discarded_crc = 0;
+    /// @brief The position index, built on the first query
+    mutable Option<PositionIndex> positions{};
     /// @brief The error count generated by this unit
     u32 _error_count = 0;
     /// @brief The warning count generated by this unit
@@ -38,6 +54,10 @@ namespace clt::lng
     /// @brief True if 'parse' was called on the current unit
     u32 _is_parsed : 1 = false;
 
+    /// @brief Returns the source of the unit (re-mapped if discarded)
+    /// @return The source, or None if the file was not found (or modified)
+    Option<StringView> source() const noexcept;
+
   public:
     /// @brief The result of parsing a file
     enum ParseResult : u8
@@ -56,13 +76,28 @@ namespace clt::lng
 
     ParsedUnit(ParsedProgram& program, StringView path) noexcept;
 
+    /// @brief Returns the path of the file of the unit
+    /// @return The path (or ParsedProgram::EMPTY_PATH if not a file)
+    const std::filesystem::path& file_path() const noexcept { return path; }
+
     /// @brief Check if the 'parse' was called on the current unit
     bool is_parsed() const noexcept { return _is_parsed; }
 
-    /// @brief Parses the current unit
+    /// @brief Parses the current unit.
+    /// If the program is in low-memory mode, the tokens of a unit parsed
+    /// from a file without errors are discarded right after its AST is
+    /// built (see discard_tokens).
     /// @return The parsing result
     ParseResult parse() noexcept;
 
+    /// @brief Lexes and parses 'source', appending the result to the unit.
+    /// If 'source' does not compile, the unit is rolled back to its state
+    /// before the call. This is used by REPL sessions, which append
+    /// one line at a time to the same unit.
+    /// @param source The source to append, which must outlive the unit
+    /// @return SUCCESS, or COMP_ERROR if the unit was rolled back
+    ParseResult parse_append(StringView source) noexcept;
+
     /// @brief Returns the count of warnings generated by this unit
     /// @return The warnings count
     u64 warn_count() const noexcept
@@ -79,6 +114,45 @@ namespace clt::lng
       return _error_count;
     }
 
+    /// @brief Frees the tokens and the source of the unit, keeping only
+    /// the AST and the spans of its expressions (low-memory mode).
+    /// The source is re-mapped from the file to report diagnostics,
+    /// so the file must not be modified afterwards.
+    /// parse_append must not be called on the unit afterwards.
+    /// @pre The unit was parsed from a file, without errors
+    void discard_tokens() noexcept;
+
+    /// @brief Check if the tokens of the unit were discarded
+    /// @return True if discard_tokens was called
+    bool is_compact() const noexcept { return tokens.is_none(); }
+
+    /// @brief Returns the source information of an expression of the unit.
+    /// This works whether or not the tokens were discarded (in which case
+    /// the source is re-mapped, which is not thread-safe).
+    /// @param range The range of the expression
+    /// @return The source information, or None if the file was not found
+    /// (or was modified) or if the range is empty
+    Option<SourceInfo> source_info(TokenRange range) const noexcept;
+
+    /// @brief Returns the position index of the unit, building it on the
+    /// first call (which is not thread-safe).
+    /// Only the source of the unit is indexed: sources appended by
+    /// parse_append are not. Tokens are not indexed if discarded.
+    /// @return The index, or null if the source was not found
+    const PositionIndex* position_index() const noexcept;
+
+    /// @brief Returns the token at a position
+    /// @param line The line (1-based)
+    /// @param column The column (1-based)
+    /// @return The token, or None if there are no tokens at the position
+    Option<Token> token_at(u32 line, u32 column) const noexcept;
+
+    /// @brief Returns the innermost expression at a position
+    /// @param line The line (1-based)
+    /// @param column The column (1-based)
+    /// @return The expression, or null if there are no expressions there
+    const ExprBase* expr_at(u32 line, u32 column) const noexcept;
+
     /// @brief Returns the error reporter
     /// @return The error reporter
     const ErrorReporter& reporter() const noexcept;
@@ -94,11 +168,21 @@ namespace clt::lng
     ParsedProgram& program() noexcept { return _program; }
 
     /// @brief Returns the token buffer representing the parsed file
+    /// @pre !is_compact()
     /// @return The token buffer representing the parsed file
-    const TokenBuffer& token_buffer() const noexcept { return tokens; }
+    const TokenBuffer& token_buffer() const noexcept
+    {
+      assert_true("The tokens were discarded!", !is_compact());
+      return *tokens;
+    }
     /// @brief Returns the token buffer representing the parsed file
+    /// @pre !is_compact()
     /// @return The token buffer representing the parsed file
-    TokenBuffer& token_buffer() noexcept { return tokens; }
+    TokenBuffer& token_buffer() noexcept
+    {
+      assert_true("The tokens were discarded!", !is_compact());
+      return *tokens;
+    }
 
     /// @brief Returns the expression buffer representing the parsed file
     /// @return The expression buffer representing the parsed file
@@ -106,6 +190,10 @@ namespace clt::lng
     /// @brief Returns the expression buffer representing the parsed file
     /// @return The expression buffer representing the parsed file
     ExprBuffer& expr_buffer() noexcept { return exprs; }
+
+    /// @brief Adds the memory used by the unit (and its source) to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
   };
 } // namespace clt::lng
 
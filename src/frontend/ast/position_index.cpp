@@ -0,0 +1,123 @@
+/*****************************************************************/ /**
+ * @file   position_index.cpp
+ * @brief  Contains the implementation of 'position_index.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "position_index.h"
+#include "common/trace.h"
+
+namespace clt::lng
+{
+  PositionIndex::PositionIndex(
+      StringView source, View<TokenSpan> tokens, Span<ExprSpan> exprs) noexcept
+      : source_size(static_cast<u32>(source.size()))
+  {
+    COLT_TRACE_SCOPE("build position index");
+    const auto end = source.data() + source.size();
+    auto next      = source.data();
+    lines.push_back(0);
+    while (auto nl = static_cast<const char*>(memchr(next, '\n', end - next)))
+    {
+      next = nl + 1;
+      lines.push_back(static_cast<u32>(next - source.data()));
+    }
+
+    this->tokens.reserve(tokens.size());
+    for (auto& token : tokens)
+      this->tokens.push_back(token);
+
+    // Outer expressions first, so that inner expressions are pushed
+    // on the stack after the expressions containing them
+    std::sort(
+        exprs.begin(), exprs.end(),
+        [](const ExprSpan& a, const ExprSpan& b)
+        {
+          if (a.span.begin != b.span.begin)
+            return a.span.begin < b.span.begin;
+          if (a.span.end != b.span.end)
+            return a.span.end > b.span.end;
+          // The scope of a single statement ('if c: stmt;') has the span
+          // of its statement, but is created before it: it is the outer
+          const bool a_scope = a.expr->classof() == ExprID::EXPR_SCOPE;
+          const bool b_scope = b.expr->classof() == ExprID::EXPR_SCOPE;
+          if (a_scope != b_scope)
+            return a_scope;
+          return a.order > b.order;
+        });
+
+    // Sweeps the spans: the top of the stack is the innermost expression
+    Vector<u32> stack;
+    const auto pop_until = [&](u32 offset)
+    {
+      while (!stack.is_empty() && exprs[stack.back()].span.end <= offset)
+      {
+        const u32 end = exprs[stack.back()].span.end;
+        stack.pop_back();
+        add_segment(end, stack.is_empty() ? nullptr : exprs[stack.back()].expr);
+      }
+    };
+    for (u32 i = 0; i < exprs.size(); i++)
+    {
+      pop_until(exprs[i].span.begin);
+      add_segment(exprs[i].span.begin, exprs[i].expr);
+      stack.push_back(i);
+    }
+    pop_until(std::numeric_limits<u32>::max());
+  }
+
+  void PositionIndex::add_segment(u32 begin, const ExprBase* node) noexcept
+  {
+    // An expression beginning where the last segment begins is nested
+    // in it (spans that are not nested are approximated the same way)
+    if (!segments.is_empty() && segments.back() >= begin)
+      nodes.back() = node;
+    else if (nodes.is_empty() ? node != nullptr : nodes.back() != node)
+    {
+      segments.push_back(begin);
+      nodes.push_back(node);
+    }
+  }
+
+  Option<u32> PositionIndex::offset_of(u32 line, u32 column) const noexcept
+  {
+    if (line == 0 || column == 0 || line > lines.size())
+      return None;
+    const u32 offset = lines[line - 1] + column - 1;
+    const u32 end    = line == lines.size() ? source_size : lines[line];
+    if (offset >= end)
+      return None;
+    return offset;
+  }
+
+  Option<Token> PositionIndex::token_at(u32 offset) const noexcept
+  {
+    auto it = std::upper_bound(
+        tokens.begin(), tokens.end(), offset,
+        [](u32 offset, const TokenSpan& token) { return offset < token.span.begin; });
+    if (it == tokens.begin())
+      return None;
+    --it;
+    if (offset >= it->span.end)
+      return None;
+    return it->token;
+  }
+
+  const ExprBase* PositionIndex::expr_at(u32 offset) const noexcept
+  {
+    auto it = std::upper_bound(segments.begin(), segments.end(), offset);
+    if (it == segments.begin())
+      return nullptr;
+    return nodes[it - segments.begin() - 1];
+  }
+
+  void PositionIndex::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    report.add("PositionIndex::lines", lines.memory_usage());
+    report.add("PositionIndex::tokens", tokens.memory_usage());
+    report.add("PositionIndex::segments", segments.memory_usage());
+    report.add("PositionIndex::nodes", nodes.memory_usage());
+  }
+} // namespace clt::lng
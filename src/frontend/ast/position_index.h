@@ -0,0 +1,112 @@
+/*****************************************************************/ /**
+ * @file   position_index.h
+ * @brief  Contains PositionIndex, which answers "which token or
+ * expression is at line L, column C" in O(log n).
+ * The index is built (lazily, see ParsedUnit::position_index) from the
+ * byte spans of the tokens and of the expressions of a unit:
+ * - the line offsets and the (sorted) token spans are binary searched.
+ * - the spans of the expressions are nested: they are flattened into
+ *   sorted segments, each mapped to the innermost expression covering
+ *   it, so that the innermost expression is also a binary search.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_POSITION_INDEX
+#define HG_COLT_POSITION_INDEX
+
+#include "colt_expr.h"
+#include "lex/colt_source_spans.h"
+
+namespace clt::lng
+{
+  /// @brief The span of an expression
+  struct ExprSpan
+  {
+    /// @brief The byte span of the expression
+    SourceSpan span;
+    /// @brief The order in which the expression was created.
+    /// Of two expressions with the same span, the first created is the
+    /// innermost (operands are created before the expression using them),
+    /// except for scopes, which are always the outermost.
+    u32 order;
+    /// @brief The expression
+    const ExprBase* expr;
+  };
+
+  /// @brief The span of a token
+  struct TokenSpan
+  {
+    /// @brief The byte span of the token
+    SourceSpan span;
+    /// @brief The token
+    Token token;
+  };
+
+  /// @brief Maps positions in a source to its tokens and expressions
+  class PositionIndex
+  {
+    /// @brief The size of the source
+    u32 source_size;
+    /// @brief The offset of the beginning of each line
+    Vector<u32> lines{};
+    /// @brief Each token and its span (sorted): a lookup never
+    /// accesses the TokenBuffer
+    Vector<TokenSpan> tokens{};
+    /// @brief The offset of the beginning of each segment (sorted)
+    Vector<u32> segments{};
+    /// @brief The innermost expression of each segment (or null)
+    Vector<const ExprBase*> nodes{};
+
+    /// @brief Adds a segment
+    /// @param begin The offset of the beginning of the segment
+    /// @param node The innermost expression of the segment
+    void add_segment(u32 begin, const ExprBase* node) noexcept;
+
+  public:
+    /// @brief Builds the index of a source
+    /// @param source The source
+    /// @param tokens The tokens of the source and their spans, in order
+    /// (may be empty if the tokens are not known)
+    /// @param exprs The spans of the expressions (in any order), which
+    /// are sorted by the function
+    PositionIndex(
+        StringView source, View<TokenSpan> tokens, Span<ExprSpan> exprs) noexcept;
+
+    /// @brief Returns the span of a range from the spans of its tokens
+    /// @param range The range
+    /// @param tokens The tokens of the source and their spans, in order
+    /// @return The span, or None if the range is empty or not in 'tokens'
+    static Option<SourceSpan> span_of(
+        TokenRange range, View<TokenSpan> tokens) noexcept
+    {
+      if (range.is_empty() || range.end_index > tokens.size())
+        return None;
+      return SourceSpan{
+          tokens[range.start_index].span.begin,
+          tokens[range.end_index - 1].span.end};
+    }
+
+    /// @brief Converts a position to an offset
+    /// @param line The line (1-based)
+    /// @param column The column (1-based)
+    /// @return The offset, or None if the position is not in the source
+    Option<u32> offset_of(u32 line, u32 column) const noexcept;
+
+    /// @brief Returns the token containing an offset
+    /// @param offset The offset
+    /// @return The token, or None (if no tokens are indexed)
+    Option<Token> token_at(u32 offset) const noexcept;
+
+    /// @brief Returns the innermost expression containing an offset
+    /// @param offset The offset
+    /// @return The expression, or null if no expression contains 'offset'
+    const ExprBase* expr_at(u32 offset) const noexcept;
+
+    /// @brief Adds the memory used by the index to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
+  };
+} // namespace clt::lng
+
+#endif // !HG_COLT_POSITION_INDEX
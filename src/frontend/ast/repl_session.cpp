@@ -0,0 +1,37 @@
+/*****************************************************************/ /**
+ * @file   repl_session.cpp
+ * @brief  Contains the implementation of 'repl_session.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "repl_session.h"
+#include "common/trace.h"
+
+namespace clt::lng
+{
+  ParsedUnit::ParseResult ReplSession::add_line(StringView line) noexcept
+  {
+    COLT_TRACE_SCOPE("repl line");
+    sources.push_back(String{line});
+    auto result = _unit.parse_append(sources.back());
+    if (result == ParsedUnit::SUCCESS)
+      ++_line_count;
+    else
+      ++_rejected_count;
+    return result;
+  }
+
+  void ReplSession::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    auto usage = sources.memory_usage();
+    for (auto& source : sources)
+    {
+      report.add_source(source.size());
+      usage.add_owned(source.memory_usage());
+    }
+    report.add("ReplSession::sources", usage);
+    _unit.report_memory(report);
+    _program.report_memory(report);
+  }
+} // namespace clt::lng
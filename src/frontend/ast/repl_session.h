@@ -0,0 +1,95 @@
+/*****************************************************************/ /**
+ * @file   repl_session.h
+ * @brief  Contains ReplSession, the state of the REPL kept between lines.
+ * A session owns a single ParsedProgram (and thus a single TypeBuffer,
+ * ModuleBuffer and set of string literals) and a single unit, to which
+ * each line is appended: types and identifiers interned by previous
+ * lines are reused, and no buffer is recreated for a new line.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_REPL_SESSION
+#define HG_COLT_REPL_SESSION
+
+#include "parsed_program.h"
+#include "parsed_unit.h"
+
+namespace clt::lng
+{
+  /// @brief The state of a REPL, which persists between lines.
+  /// A line that fails to compile is rolled back: the tokens and
+  /// expressions it added to the unit are popped.
+  /// Types and identifiers interned while parsing a rejected line are
+  /// kept: no accepted line refers to them, and they would be interned
+  /// again by the next line using them.
+  /// @code{.cpp}
+  /// auto session = ReplSession{*reporter, includes, GlobalWarnFor};
+  /// while (auto line = String::getLine(); line.is_value())
+  ///   session.add_line(*line);
+  /// @endcode
+  class ReplSession
+  {
+    /// @brief The program to which the lines are added
+    ParsedProgram _program;
+    /// @brief The unit to which the lines are appended
+    ParsedUnit _unit;
+    /// @brief The source of each line (including rejected ones, as
+    /// the identifiers interned by the unit point to them)
+    Vector<String> sources{};
+    /// @brief The count of lines that compiled successfully
+    u64 _line_count = 0;
+    /// @brief The count of lines that failed to compile
+    u64 _rejected_count = 0;
+
+  public:
+    /// @brief Constructs an empty session
+    /// @param reporter The reporter used for errors and warnings
+    /// @param includes The include path used by the program
+    /// @param warn_for The warnings to reports
+    ReplSession(
+        ErrorReporter& reporter, const Vector<std::filesystem::path>& includes,
+        const WarnFor& warn_for) noexcept
+        : _program(reporter, includes, warn_for)
+        , _unit(_program, StringView{})
+    {
+    }
+
+    // The unit references the program: the session may not be moved
+    ReplSession(const ReplSession&)            = delete;
+    ReplSession(ReplSession&&)                 = delete;
+    ReplSession& operator=(const ReplSession&) = delete;
+    ReplSession& operator=(ReplSession&&)      = delete;
+
+    /// @brief Parses a line, appending it to the unit of the session.
+    /// If the line does not compile, it is rolled back.
+    /// @param line The line to parse
+    /// @return SUCCESS if the line was accepted, else COMP_ERROR
+    ParsedUnit::ParseResult add_line(StringView line) noexcept;
+
+    /// @brief Returns the count of lines that were accepted
+    /// @return The count of accepted lines
+    u64 line_count() const noexcept { return _line_count; }
+    /// @brief Returns the count of lines that failed to compile
+    /// @return The count of rejected lines
+    u64 rejected_count() const noexcept { return _rejected_count; }
+
+    /// @brief Returns the program to which the lines are added
+    /// @return The program
+    ParsedProgram& program() noexcept { return _program; }
+    /// @brief Returns the program to which the lines are added
+    /// @return The program
+    const ParsedProgram& program() const noexcept { return _program; }
+
+    /// @brief Returns the unit to which the lines are appended
+    /// @return The unit
+    const ParsedUnit& unit() const noexcept { return _unit; }
+
+    /// @brief Adds the memory used by the session (its program and lines)
+    /// to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
+  };
+} // namespace clt::lng
+
+#endif // !HG_COLT_REPL_SESSION
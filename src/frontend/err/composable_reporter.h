@@ -78,6 +78,56 @@ namespace clt::lng
     }
   };
 
+  /// @brief Appends the reports to a string (formatted as ConsoleReporter
+  /// would print them), to print them later.
+  /// This keeps the reports of a file grouped when multiple files
+  /// are compiled concurrently.
+  struct BufferReporter
+  {
+    /// @brief The string to which to append the reports
+    String* output;
+
+    /// @brief Constructor
+    /// @param output The string to which to append the reports
+    constexpr BufferReporter(String& output) noexcept
+        : output(&output)
+    {
+    }
+
+    /// @brief Appends the message to the output
+    /// @param str The message
+    /// @param info The source information if it exist
+    /// @param nb The report information if it exist
+    void message(
+        StringView str, const Option<SourceInfo>& info,
+        const Option<ReportNumber>& nb) const noexcept
+    {
+      format_message(*output, str, info, nb);
+    }
+
+    /// @brief Appends the warning to the output
+    /// @param str The warning
+    /// @param info The source information if it exist
+    /// @param nb The report information if it exist
+    void warn(
+        StringView str, const Option<SourceInfo>& info,
+        const Option<ReportNumber>& nb) const noexcept
+    {
+      format_warn(*output, str, info, nb);
+    }
+
+    /// @brief Appends the error to the output
+    /// @param str The error
+    /// @param info The source information if it exist
+    /// @param nb The report information if it exist
+    void error(
+        StringView str, const Option<SourceInfo>& info,
+        const Option<ReportNumber>& nb) const noexcept
+    {
+      format_error(*output, str, info, nb);
+    }
+  };
+
   template<Reporter Rep>
   /// @brief Filters reports generated
   /// @tparam Rep The reporter to forward reports to if not filtered
@@ -12,6 +12,7 @@
 #include "structs/string.h"
 #include "structs/unique_ptr.h"
 #include "structs/option.h"
+#include "mem/mem_report.h"
 #include "io_reporter.h"
 
 namespace clt::lng
@@ -88,6 +89,16 @@ namespace clt::lng
     /// @return The count of messages
     u64 message_count() const noexcept { return _message_count; }
 
+    /// @brief Adds the memory used by the formatted reports to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept
+    {
+      auto usage = report_str.memory_usage();
+      for (auto& str : report_str)
+        usage.add_owned(str.memory_usage());
+      report.add("ErrorReporter::report_str", usage);
+    }
+
     /// @brief Destructor
     virtual ~ErrorReporter() noexcept {};
   };
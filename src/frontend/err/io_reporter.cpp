@@ -1,6 +1,6 @@
 /*****************************************************************/ /**
  * @file   io_reporter.cpp
- * @brief  Definitions of generate_* functions.
+ * @brief  Definitions of generate_* and format_* functions.
  *
  * @author RPC
  * @date   January 2024
@@ -9,39 +9,54 @@
 
 namespace clt::lng
 {
-  /// @brief Prints a single line
+  template<typename... Args>
+  /// @brief Formats a line (appending a new line) to a string
+  /// @param out The string to which to append
+  /// @param fmt The format string
+  /// @param ...args The arguments to format
+  static void format_line(
+      String& out, io::fmt_str<Args...> fmt, Args&&... args) noexcept
+  {
+    fmt::format_to(std::back_inserter(out), fmt, std::forward<Args>(args)...);
+    out.push_back('\n');
+  }
+
+  /// @brief Formats a single line
+  /// @param out The string to which to append
   /// @param highlight The color to use when highlighting
   /// @param src_info The information to highlight
   /// @param begin_line The beginning of the line
   /// @param end_line The end of the line
   /// @param line_nb_size The size of the line number static_cast a string
-  void print_single_line(
-      io::Color highlight, const SourceInfo& src_info, StringView begin_line,
-      StringView end_line, size_t line_nb_size) noexcept
+  static void format_single_line(
+      String& out, io::Color highlight, const SourceInfo& src_info,
+      StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
   {
     //TODO: implement HighlightCode
-    io::print(
-        " {} | {}{}{}{}{}", src_info.line_begin, /*io::HighlightCode*/ begin_line,
-        highlight, src_info.expr, io::Reset, /*io::HighlightCode*/ end_line);
+    format_line(
+        out, " {} | {}{}{}{}{}", src_info.line_begin,
+        /*io::HighlightCode*/ begin_line, highlight, src_info.expr, io::Reset,
+        /*io::HighlightCode*/ end_line);
 
     auto sz = src_info.expr.size();
     //So no overflow happens when the expr is empty
     sz += static_cast<size_t>(sz == 0);
     sz -= 1;
-    io::print(
-        " {: <{}} | {: <{}}{:~<{}}^", "", line_nb_size, "", begin_line.size(), "",
-        sz);
+    format_line(
+        out, " {: <{}} | {: <{}}{:~<{}}^", "", line_nb_size, "",
+        begin_line.size(), "", sz);
   }
 
-  /// @brief Prints multiple lines
+  /// @brief Formats multiple lines
+  /// @param out The string to which to append
   /// @param highlight The color to use when highlighting
   /// @param src_info The information to highlight
   /// @param begin_line The beginning of the line
   /// @param end_line The end of the line
   /// @param line_nb_size The size of the line number static_cast a string
-  void print_multiple_lines(
-      io::Color highlight, const SourceInfo& src_info, StringView begin_line,
-      StringView end_line, size_t line_nb_size) noexcept
+  static void format_multiple_lines(
+      String& out, io::Color highlight, const SourceInfo& src_info,
+      StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
   {
     size_t offset          = StringView::npos; //will overflow on first add
     size_t previous_offset = 0;
@@ -60,15 +75,15 @@ namespace clt::lng
         break;
       }
 
-      io::print(
-          " {: >{}} | {}", current_line, line_nb_size,
+      format_line(
+          out, " {: >{}} | {}", current_line, line_nb_size,
           /*io::HighlightCode*/
           StringView{
               begin_line.data() + previous_offset, begin_line.data() + offset});
       ++current_line;
     }
-    io::print(
-        " {: >{}} | {}{}{}{}", current_line, line_nb_size,
+    format_line(
+        out, " {: >{}} | {}{}{}{}", current_line, line_nb_size,
         /*io::HighlightCode*/
         StringView{
             begin_line.data() + previous_offset,
@@ -89,15 +104,15 @@ namespace clt::lng
         break;
       }
 
-      io::print(
-          " {: >{}} | {}{}{}", current_line, line_nb_size, highlight,
+      format_line(
+          out, " {: >{}} | {}{}{}", current_line, line_nb_size, highlight,
           StringView{
               src_info.expr.data() + previous_offset, src_info.expr.data() + offset},
           io::Reset);
       ++current_line;
     }
-    io::print(
-        " {: >{}} | {}{}{}{}", current_line, line_nb_size, highlight,
+    format_line(
+        out, " {: >{}} | {}{}{}{}", current_line, line_nb_size, highlight,
         StringView{
             src_info.expr.data() + previous_offset,
             src_info.expr.data() + src_info.expr.size()},
@@ -113,8 +128,8 @@ namespace clt::lng
       {
         if (previous_offset < end_line.size())
         {
-          io::print(
-              " {: >{}} | {}", current_line, line_nb_size,
+          format_line(
+              out, " {: >{}} | {}", current_line, line_nb_size,
               /*io::HighlightCode*/
               StringView{
                   end_line.data() + previous_offset,
@@ -123,18 +138,20 @@ namespace clt::lng
         break;
       }
 
-      io::print(
-          " {: >{}} | {}", current_line, line_nb_size,
+      format_line(
+          out, " {: >{}} | {}", current_line, line_nb_size,
           /*io::HighlightCode*/
           StringView{end_line.data() + previous_offset, end_line.data() + offset});
       ++current_line;
     }
   }
 
-  /// @brief Prints a valid source code information
-  /// @param src_info The source information to print
+  /// @brief Formats a valid source code information
+  /// @param out The string to which to append
+  /// @param src_info The source information to format
   /// @param color The highlight color
-  void handle_valid_src(const SourceInfo& src_info, io::Color color) noexcept
+  static void handle_valid_src(
+      String& out, const SourceInfo& src_info, io::Color color) noexcept
   {
     StringView begin_line = {src_info.lines.data(), src_info.expr.data()};
     StringView end_line   = {
@@ -156,47 +173,90 @@ namespace clt::lng
 
     size_t line_nb_size = fmt::formatted_size("{}", src_info.line_end);
     if (src_info.is_single_line())
-      print_single_line(color, src_info, begin_line, end_line, line_nb_size);
+      format_single_line(out, color, src_info, begin_line, end_line, line_nb_size);
     else
-      print_multiple_lines(color, src_info, begin_line, end_line, line_nb_size);
+      format_multiple_lines(
+          out, color, src_info, begin_line, end_line, line_nb_size);
   }
 
-  void generate_message(
-      StringView fmt, const Option<SourceInfo>& src,
+  /// @brief Formats a report
+  /// @param out The string to which to append
+  /// @param kind The kind of the report ("Message", "Warning" or "Error")
+  /// @param kind_color The color of the kind
+  /// @param prefix The prefix of the report number ('M', 'W' or 'E')
+  /// @param highlight The highlight color of the source information
+  /// @param str The report
+  /// @param src The source information (or None)
+  /// @param nb The report number (or None)
+  static void format_report(
+      String& out, StringView kind, io::Color kind_color, char prefix,
+      io::Color highlight, StringView str, const Option<SourceInfo>& src,
       const Option<ReportNumber>& nb) noexcept
   {
     if (nb.is_none())
-      io::print_message("{}", fmt);
+      format_line(out, "{}{}:{} {}", kind_color, kind, io::Reset, str);
     else
-      io::print_message("(M{}) {}", nb.value(), fmt);
+      format_line(
+          out, "{}{}:{} ({}{}) {}", kind_color, kind, io::Reset, prefix,
+          nb.value(), str);
 
     if (src.is_value())
-      handle_valid_src(src.value(), io::CyanF);
+      handle_valid_src(out, src.value(), highlight);
   }
 
-  void generate_warn(
+  void format_message(
+      String& out, StringView fmt, const Option<SourceInfo>& src,
+      const Option<ReportNumber>& nb) noexcept
+  {
+    format_report(out, "Message", io::BrightBlueF, 'M', io::CyanF, fmt, src, nb);
+  }
+
+  void format_warn(
+      String& out, StringView fmt, const Option<SourceInfo>& src,
+      const Option<ReportNumber>& nb) noexcept
+  {
+    format_report(
+        out, "Warning", io::BrightYellowF, 'W', io::YellowF, fmt, src, nb);
+  }
+
+  void format_error(
+      String& out, StringView fmt, const Option<SourceInfo>& src,
+      const Option<ReportNumber>& nb) noexcept
+  {
+    format_report(out, "Error", io::BrightRedF, 'E', io::BrightRedB, fmt, src, nb);
+  }
+
+  /// @brief Prints a formatted report to 'stdout' (in a single write)
+  /// @param report The formatted report
+  static void print_report(const String& report) noexcept
+  {
+    std::fwrite(report.data(), 1, report.size(), stdout);
+  }
+
+  void generate_message(
       StringView fmt, const Option<SourceInfo>& src,
       const Option<ReportNumber>& nb) noexcept
   {
-    if (nb.is_none())
-      io::print_warn("{}", fmt);
-    else
-      io::print_warn("(W{}) {}", nb.value(), fmt);
+    String report;
+    format_message(report, fmt, src, nb);
+    print_report(report);
+  }
 
-    if (src.is_value())
-      handle_valid_src(src.value(), io::YellowF);
+  void generate_warn(
+      StringView fmt, const Option<SourceInfo>& src,
+      const Option<ReportNumber>& nb) noexcept
+  {
+    String report;
+    format_warn(report, fmt, src, nb);
+    print_report(report);
   }
 
   void generate_error(
       StringView fmt, const Option<SourceInfo>& src,
       const Option<ReportNumber>& nb) noexcept
   {
-    if (nb.is_none())
-      io::print_error("{}", fmt);
-    else
-      io::print_error("(E{}) {}", nb.value(), fmt);
-
-    if (src.is_value())
-      handle_valid_src(src.value(), io::BrightRedB);
+    String report;
+    format_error(report, fmt, src, nb);
+    print_report(report);
   }
-} // namespace clt::lng
\ No newline at end of file
+} // namespace clt::lng
@@ -88,6 +88,33 @@ namespace clt::lng
   void generate_error(
       StringView str, const Option<SourceInfo>& src_info,
       const Option<ReportNumber>& nb) noexcept;
+
+  /// @brief Formats a message as 'generate_message' would print it
+  /// @param out The string to which to append the message
+  /// @param str The message
+  /// @param src_info The message information (or None)
+  /// @param nb The message number (or None)
+  void format_message(
+      String& out, StringView str, const Option<SourceInfo>& src_info,
+      const Option<ReportNumber>& nb) noexcept;
+
+  /// @brief Formats a warning as 'generate_warn' would print it
+  /// @param out The string to which to append the warning
+  /// @param str The warning
+  /// @param src_info The warning information (or None)
+  /// @param nb The warning number (or None)
+  void format_warn(
+      String& out, StringView str, const Option<SourceInfo>& src_info,
+      const Option<ReportNumber>& nb) noexcept;
+
+  /// @brief Formats an error as 'generate_error' would print it
+  /// @param out The string to which to append the error
+  /// @param str The error
+  /// @param src_info The error information (or None)
+  /// @param nb The error number (or None)
+  void format_error(
+      String& out, StringView str, const Option<SourceInfo>& src_info,
+      const Option<ReportNumber>& nb) noexcept;
 } // namespace clt::lng
 
 #endif // !HG_COLT_IO_REPORTER
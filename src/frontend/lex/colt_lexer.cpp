@@ -218,6 +218,7 @@ namespace clt::lng
       // Go to next line
       lexer._line_nb++;
       lexer._offset = 0;
+      lexer._next   = lexer.next();
       break;
     case '*':
       lexer._next = lexer.next(); // consume '*'
@@ -0,0 +1,107 @@
+/*****************************************************************/ /**
+ * @file   colt_source_spans.cpp
+ * @brief  Contains the implementation of 'colt_source_spans.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "colt_source_spans.h"
+#include "common/trace.h"
+
+namespace clt::lng
+{
+  void SourceSpanTable::add_range(TokenRange range) noexcept
+  {
+    assert_true("Spans were already built!", spans.is_empty());
+    assert_true("Invalid range!", range.start_index < range.end_index);
+    indices.push_back(range.start_index);
+    if (range.end_index - 1 != range.start_index)
+      indices.push_back(range.end_index - 1);
+  }
+
+  void SourceSpanTable::build(const TokenBuffer& buffer, StringView source) noexcept
+  {
+    COLT_TRACE_SCOPE("build source spans");
+    std::sort(indices.begin(), indices.end());
+    indices.pop_back_n(
+        indices.end() - std::unique(indices.begin(), indices.end()));
+
+    spans.reserve(indices.size());
+    // The indices are sorted, and so are the lines of the tokens: the
+    // lists are walked in step with them (indexing a FlatList walks it).
+    auto info       = buffer.tokens_info.begin();
+    auto line_start = buffer.lines.begin();
+    auto line_end   = buffer.lines.begin();
+    u32 info_at       = 0;
+    u32 line_start_at = 0;
+    u32 line_end_at   = 0;
+    for (auto index : indices)
+    {
+      info += index - info_at;
+      info_at = index;
+      assert_true(
+          "Lines are not sorted!",
+          line_start_at <= info->line_start && line_end_at <= info->line_end);
+      line_start += info->line_start - line_start_at;
+      line_start_at = info->line_start;
+      line_end += info->line_end - line_end_at;
+      line_end_at = info->line_end;
+
+      // Mirrors TokenBuffer::make_source_info
+      const auto begin = line_start->data() + info->column_nb;
+      const auto end   = line_end->data() + info->column_nb + info->size;
+      spans.push_back(SourceSpan{
+          static_cast<u32>(begin - source.data()),
+          static_cast<u32>(end - source.data())});
+    }
+  }
+
+  SourceSpan SourceSpanTable::span_of(u32 index) const noexcept
+  {
+    auto it = std::lower_bound(indices.begin(), indices.end(), index);
+    assert_true(
+        "Token was not registered!", it != indices.end() && *it == index);
+    return spans[it - indices.begin()];
+  }
+
+  SourceInfo SourceSpanTable::make_source_info(
+      TokenRange range, StringView source) const noexcept
+  {
+    const auto [begin, end] = span(range);
+    assert_true("Invalid source!", begin <= end && end <= source.size());
+
+    // Diagnostics are rare: the lines are recomputed from the source.
+    // A token may end with its '\n', in which case it ends on that line.
+    const auto text = source.data();
+    const u32 from  = begin == end ? end : end - 1;
+    u32 line_begin  = 1;
+    u32 line_end    = 1;
+    u32 first       = 0;
+    u32 last        = static_cast<u32>(source.size());
+    for (u32 i = 0; i < from; i++)
+    {
+      if (text[i] != '\n')
+        continue;
+      if (i < begin)
+      {
+        first = i + 1;
+        ++line_begin;
+      }
+      ++line_end;
+    }
+    // The lines include their '\n'
+    if (auto nl = static_cast<const char*>(
+            memchr(text + from, '\n', source.size() - from)))
+      last = static_cast<u32>(nl - text) + 1;
+    return SourceInfo{
+        line_begin, line_end, StringView{text + begin, text + end},
+        StringView{text + first, text + last}};
+  }
+
+  void SourceSpanTable::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    report.add("SourceSpanTable::indices", indices.memory_usage());
+    report.add("SourceSpanTable::spans", spans.memory_usage());
+  }
+} // namespace clt::lng
@@ -0,0 +1,80 @@
+/*****************************************************************/ /**
+ * @file   colt_source_spans.h
+ * @brief  Contains SourceSpanTable, a compact replacement of the
+ * TokenBuffer for resolving the TokenRange of expressions.
+ * Once the AST of a unit is built, only the tokens beginning or ending
+ * a TokenRange of an expression are needed to report diagnostics.
+ * The table stores the byte span of these tokens (sorted by token index),
+ * so that the TokenBuffer (and the source) can be freed: the source is
+ * then only needed (and re-read) when a diagnostic is reported.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_SOURCE_SPANS
+#define HG_COLT_SOURCE_SPANS
+
+#include "colt_token_buffer.h"
+
+namespace clt::lng
+{
+  /// @brief The byte span of a token (or of tokens) in its source
+  struct SourceSpan
+  {
+    /// @brief The offset of the first byte
+    u32 begin;
+    /// @brief The offset following the last byte
+    u32 end;
+  };
+
+  /// @brief Maps the tokens referenced by TokenRanges to their byte span.
+  /// Looking up a TokenRange is O(log n) in the count of referenced tokens.
+  class SourceSpanTable
+  {
+    /// @brief The (sorted) indices of the referenced tokens
+    Vector<u32> indices{};
+    /// @brief The span of each token of 'indices'
+    Vector<SourceSpan> spans{};
+
+    /// @brief Returns the span of a referenced token
+    /// @param index The index of the token
+    /// @return The span of the token
+    SourceSpan span_of(u32 index) const noexcept;
+
+  public:
+    /// @brief Registers the tokens of a range as referenced
+    /// @param range The range (of a TokenBuffer that was not yet freed)
+    void add_range(TokenRange range) noexcept;
+
+    /// @brief Computes the spans of the registered tokens.
+    /// This must be called once all the ranges are registered.
+    /// @param buffer The buffer owning the ranges
+    /// @param source The source that was lexed by 'buffer'
+    void build(const TokenBuffer& buffer, StringView source) noexcept;
+
+    /// @brief Returns the byte span of a range
+    /// @param range The range (whose tokens were registered)
+    /// @return The span from the first to the last token of 'range'
+    SourceSpan span(TokenRange range) const noexcept
+    {
+      return SourceSpan{
+          span_of(range.start_index).begin, span_of(range.end_index - 1).end};
+    }
+
+    /// @brief Returns the source information of a range
+    /// @param range The range (whose tokens were registered)
+    /// @param source The source that was lexed by the buffer owning 'range'
+    /// @return The source information of 'range'
+    SourceInfo make_source_info(TokenRange range, StringView source) const noexcept;
+
+    /// @brief Returns the count of referenced tokens
+    /// @return The count of referenced tokens
+    u64 size() const noexcept { return indices.size(); }
+
+    /// @brief Adds the memory used by the table to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
+  };
+} // namespace clt::lng
+
+#endif // !HG_COLT_SOURCE_SPANS
@@ -7,6 +7,7 @@
  *********************************************************************/
 #include "colt_token_buffer.h"
 #include "colt_lexer.h"
+#include "common/trace.h"
 
 namespace clt::lng
 {
@@ -24,8 +25,11 @@ namespace clt::lng
   void lex(
       TokenBuffer& buffer, ErrorReporter& reporter, StringView to_parse) noexcept
   {
+    COLT_TRACE_SCOPE("lex");
+    // When appending to 'buffer', only the new lines are lexed
+    const auto first_line = static_cast<u32>(buffer.line_buffer().size());
     create_lines(to_parse, buffer);
-    Lexer lex = {reporter, buffer};
+    Lexer lex = {reporter, buffer, first_line};
 
     lex._next = lex.next();
     while (lex._next != EOF)
@@ -44,6 +48,7 @@ namespace clt::lng
 
   void create_lines(StringView strv, TokenBuffer& buffer) noexcept
   {
+    COLT_TRACE_SCOPE("create_lines");
     const auto front       = strv.data();
     const char* const text = strv.data();
     const i64 size         = strv.size();
@@ -62,4 +67,21 @@ namespace clt::lng
     /*if (start != size)
       buffer.push_back(StringView{ front + start, 0 });*/
   }
+
+  void TokenBuffer::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    report.add("TokenBuffer::tokens", tokens.memory_usage());
+    report.add("TokenBuffer::tokens_info", tokens_info.memory_usage());
+    report.add("TokenBuffer::lines", lines.memory_usage());
+    report.add("TokenBuffer::identifiers", identifiers.memory_usage());
+    report.add("TokenBuffer::nb_literals", nb_literals.memory_usage());
+    // String literals are owned through pointers
+    auto str_usage = str_literals.memory_usage();
+    for (auto& str : str_literals)
+    {
+      str_usage.add_owned(str->memory_usage());
+      str_usage.add_owned({0, sizeof(String), sizeof(String)});
+    }
+    report.add("TokenBuffer::str_literals", str_usage);
+  }
 } // namespace clt::lng
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include "structs/list.h"
 #include "structs/set.h"
+#include "mem/mem_report.h"
 #include "colt_operators.h"
 #include "err/error_reporter.h"
 
@@ -22,6 +23,8 @@ namespace clt::lng
   class TokenBuffer;
   // Forward declaration
   struct Lexer;
+  // Forward declaration
+  class SourceSpanTable;
 
   /// @brief Lexes 'to_parse'
   /// @param reporter The reporter used to generate error/warnings/messages
@@ -30,7 +33,8 @@ namespace clt::lng
   TokenBuffer lex(ErrorReporter& reporter, StringView to_parse) noexcept;
 
   /// @brief Lexes 'to_parse'.
-  /// This does not clear 'buffer' first, use with caution!
+  /// This does not clear 'buffer' first: the tokens of 'to_parse'
+  /// are appended after the existing ones (ending with their own EOF).
   /// @param buffer The TokenBuffer in which to store lexing result
   /// @param reporter The reporter used to generate error/warnings/messages
   /// @param to_parse The StringView to parse
@@ -146,6 +150,8 @@ namespace clt::lng
     }
 #endif // COLT_DEBUG
     friend class TokenBuffer;
+    friend class SourceSpanTable;
+    friend class PositionIndex;
 
   public:
     TokenRange()                                                = delete;
@@ -153,12 +159,16 @@ namespace clt::lng
     constexpr TokenRange(const TokenRange&) noexcept            = default;
     constexpr TokenRange& operator=(TokenRange&&) noexcept      = default;
     constexpr TokenRange& operator=(const TokenRange&) noexcept = default;
+
+    /// @brief Check if the range does not contain any tokens
+    /// @return True if empty
+    constexpr bool is_empty() const noexcept { return start_index >= end_index; }
   };
 
   class TokenBuffer
   {
-    /// @brief The array of identifiers
-    StableSet<StringView> identifiers{};
+    /// @brief The set of identifiers (interned)
+    IndexedSet<StringView> identifiers{};
     /// @brief The array of lines
     FlatList<StringView, 256> lines{};
     /// @brief The array of string literals
@@ -200,6 +210,8 @@ namespace clt::lng
 
     // Friend declaration to use add_token
     friend struct Lexer;
+    // Friend declaration to convert tokens to source spans
+    friend class SourceSpanTable;
 
   public:
     /// @brief Default constructor
@@ -217,6 +229,41 @@ namespace clt::lng
     TokenBuffer(TokenBuffer&&) noexcept            = default;
     TokenBuffer& operator=(TokenBuffer&&) noexcept = delete;
 
+    /// @brief The sizes of the buffers, to which to roll back
+    struct Checkpoint
+    {
+      /// @brief The count of lines
+      u64 lines;
+      /// @brief The count of string literals
+      u64 str_literals;
+      /// @brief The count of number literals
+      u64 nb_literals;
+      /// @brief The count of tokens
+      u64 tokens;
+    };
+
+    /// @brief Returns a checkpoint to which to roll back
+    /// @return The current checkpoint
+    Checkpoint checkpoint() const noexcept
+    {
+      return Checkpoint{
+          lines.size(), str_literals.size(), nb_literals.size(), tokens.size()};
+    }
+
+    /// @brief Pops everything added after a checkpoint.
+    /// Identifiers are interned: they are kept, and the source they
+    /// point to must thus be kept alive.
+    /// @param to The checkpoint to which to roll back
+    void rollback(const Checkpoint& to) noexcept
+    {
+      assert_true("Invalid checkpoint!", to.tokens <= tokens.size());
+      lines.pop_back_n(lines.size() - to.lines);
+      str_literals.pop_back_n(str_literals.size() - to.str_literals);
+      nb_literals.pop_back_n(nb_literals.size() - to.nb_literals);
+      tokens_info.pop_back_n(tokens_info.size() - to.tokens);
+      tokens.pop_back_n(tokens.size() - to.tokens);
+    }
+
     /// @brief Clears the TokenBuffer
     void unsafe_clear() noexcept
     {
@@ -276,8 +323,8 @@ namespace clt::lng
     void add_identifier(
         StringView value, Lexeme lexeme, u32 line, u32 column_nb, u32 size) noexcept
     {
-      u64 ret = identifiers.size();
-      identifiers.push_back(value);
+      // An identifier that was already lexed reuses its index
+      u64 ret = identifiers.insert(value).first;
       assert_true("Integer overflow!", ret <= std::numeric_limits<u32>::max());
 
 #ifdef COLT_DEBUG
@@ -400,9 +447,43 @@ namespace clt::lng
     /// @return List of tokens
     auto& token_buffer() const noexcept { return tokens; }
 
+    template<typename Fn>
+    /// @brief Calls 'fn' with each token and its lexeme, in order.
+    /// The lists are walked in step, while calling 'make_source_info'
+    /// for each token would index (and thus walk) them.
+    /// @param fn Called with the Token and the StringView of its lexeme,
+    /// returning false to stop
+    void for_each_lexeme(Fn&& fn) const noexcept
+    {
+      auto info       = tokens_info.begin();
+      auto line_start = lines.begin();
+      auto line_end   = lines.begin();
+      u32 line_start_at = 0;
+      u32 line_end_at   = 0;
+      for (auto& token : tokens)
+      {
+        // The lines of the tokens are sorted
+        line_start += info->line_start - line_start_at;
+        line_start_at = info->line_start;
+        line_end += info->line_end - line_end_at;
+        line_end_at = info->line_end;
+        // Mirrors make_source_info
+        const auto lexeme = StringView{
+            line_start->data() + info->column_nb,
+            line_end->data() + info->size + info->column_nb};
+        if (!fn(token, lexeme))
+          return;
+        ++info;
+      }
+    }
+
     /// @brief Returns the list of lines
     /// @return The list of lines
     auto& line_buffer() const noexcept { return lines; }
+
+    /// @brief Adds the memory used by the buffer to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
   };
 } // namespace clt::lng
 
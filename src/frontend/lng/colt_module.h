@@ -14,6 +14,7 @@
 
 #include "colt_module_name.h"
 #include "structs/map.h"
+#include "mem/mem_report.h"
 #include "lng/colt_global.h"
 
 namespace clt::lng
@@ -129,6 +130,14 @@ namespace clt::lng
     {
       return _parent.nesting + 1 == ModuleName::max_size();
     }
+
+    /// @brief Adds the memory used by the module to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept
+    {
+      report.add("Module::submodules", submodules.memory_usage());
+      report.add("Module::global_table", global_table.memory_usage());
+    }
   };
 
   /// @brief Class responsible of storing modules
@@ -215,6 +224,15 @@ namespace clt::lng
       assert_true("Global module does not have a parent!", !tkn.is_global());
       return modules[get_module(tkn).parent().module_nb];
     }
+
+    /// @brief Adds the memory used by the buffer (and its modules) to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept
+    {
+      report.add("ModuleBuffer::modules", modules.memory_usage());
+      for (auto& module : modules)
+        module.report_memory(report);
+    }
   };
 
   template<std::forward_iterator It>
@@ -329,6 +329,10 @@ namespace clt::lng
     FnType() = delete;
     MAKE_DEFAULT_COPY_AND_MOVE_FOR(FnType);
 
+    /// @brief Returns the index into the set of FnTypePayload
+    /// @return The index of the payload of the function type
+    constexpr u32 payload_id() const noexcept { return payload_index; }
+
     /// @brief Check if two ptr types represent the same type
     /// @param b The other pointer type
     /// @return True if both types point to the same type
@@ -82,4 +82,14 @@ namespace clt::lng
   {
     return type_name(type(variant));
   }
+
+  void TypeBuffer::report_memory(mem::MemoryReport& report) const noexcept
+  {
+    report.add("TypeBuffer::type_map", type_map.memory_usage());
+    report.add("TypeBuffer::fn_payloads", fn_payloads.memory_usage());
+    auto names_usage = type_names.memory_usage();
+    for (auto& name : type_names)
+      names_usage.add_owned(name.memory_usage());
+    report.add("TypeBuffer::type_names", names_usage);
+  }
 } // namespace clt::lng
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "colt_type.h"
 #include "structs/set.h"
 #include "colt_type_token.h"
+#include "common/trace.h"
+#include "mem/mem_report.h"
 
 namespace clt::lng
 {
@@ -46,6 +48,7 @@ namespace clt::lng
     /// @return The TypeToken representing the type
     TypeToken add_type(const TypeVariant& variant) noexcept
     {
+      COLT_TRACE_SCOPE("intern type");
       auto [pair, insert] = type_map.insert(variant);
       return create_token(pair);
     }
@@ -125,6 +128,33 @@ namespace clt::lng
     {
       return type_map.internal_list()[tkn.getID()];
     }
+
+    /// @brief Returns the count of types saved in the buffer.
+    /// The tokens of the types are [0, type_count()).
+    /// @return The count of types
+    u32 type_count() const noexcept
+    {
+      return static_cast<u32>(type_map.internal_list().size());
+    }
+
+    /// @brief Returns the count of function payloads saved in the buffer
+    /// @return The count of function payloads
+    u32 fn_payload_count() const noexcept
+    {
+      return static_cast<u32>(fn_payloads.internal_list().size());
+    }
+
+    /// @brief Returns the payload of a function type
+    /// @param index The index of the payload (see FnType::payload_id)
+    /// @return The payload
+    const FnTypePayload& fn_payload(u32 index) const noexcept
+    {
+      return fn_payloads.internal_list()[index];
+    }
+
+    /// @brief Adds the memory used by the buffer to a report
+    /// @param report The report to which to add
+    void report_memory(mem::MemoryReport& report) const noexcept;
   };
 } // namespace clt::lng
 
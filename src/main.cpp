@@ -9,8 +9,17 @@
 #include "args.h"
 #include "test/run_tests.h"
 #include "ast/parsed_program.h"
+#include "ast/repl_session.h"
+#include "ast/batch_compile.h"
+#include "ast/module_image.h"
+#include "c/c_transpiler.h"
 #include "colti/colti_disassembler.h"
 #include "colti/colti_opcodes.h"
+#include "bench/bench_frontend.h"
+#include "common/trace.h"
+#include "io/mapped_file.h"
+#include "mem/mem_report.h"
+#include "server/compile_server.h"
 
 using namespace clt;
 
@@ -18,20 +27,209 @@ void REPL()
 {
   using namespace lng;
 
-  io::print_warn("REPL is not implemented...");
-
-  auto reporter    = lng::make_error_reporter<lng::ConsoleReporter>();
-  const auto& warn = GlobalWarnFor;
-  Vector<std::filesystem::path> includes = {};
+  auto reporter = lng::make_error_reporter<lng::ConsoleReporter>();
+  const Vector<std::filesystem::path> includes = {};
+  // The session keeps the program alive between lines
+  auto session = ReplSession{*reporter, includes, GlobalWarnFor};
   while (true)
   {
     io::print<"">("{}>>>{} ", io::BrightCyanF, io::Reset);
     auto a = String::getLine(64, false);
     if (a.is_error())
-      return;
-    const auto& str = *a;
-    auto program    = ParsedProgram{*reporter, StringView{str}, includes, warn};
+      break;
+    session.add_line(*a);
+  }
+  if (MemReport)
+  {
+    auto report = mem::MemoryReport{};
+    session.report_memory(report);
+    report.print();
+  }
+}
+
+/// @brief Maps the module image passed with '-image' (if any).
+/// Only the header of the image is validated, before parsing.
+/// @param mapped The file of the image, which must outlive 'image'
+/// @param image The image
+/// @return False if the image could not be loaded
+bool LoadImage(Option<io::MappedFile>& mapped, Option<lng::ModuleImage>& image)
+{
+  if (ImageFile.empty())
+    return true;
+  const auto image_path = std::string{ImageFile};
+  mapped                = io::MappedFile::open(image_path.c_str());
+  if (mapped.is_value())
+    image = lng::ModuleImage::load(mapped->bytes());
+  if (image.is_value())
+    return true;
+  io::print_error("'{}' is not a valid module image!", image_path);
+  return false;
+}
+
+/// @brief Compiles a file, lowering it to C if it has no errors
+/// @param file The file to compile
+/// @return The exit code
+int Compile(StringView file)
+{
+  using namespace lng;
+
+  Option<io::MappedFile> mapped = None;
+  Option<ModuleImage> image     = None;
+  if (!LoadImage(mapped, image))
+    return 1;
+
+  auto reporter = lng::make_error_reporter<lng::ConsoleReporter>();
+  const Vector<std::filesystem::path> includes = {};
+  const auto path =
+      std::filesystem::path{std::string_view{file.data(), file.size()}};
+  auto program = ParsedProgram{
+      *reporter, path, includes, GlobalWarnFor,
+      image.is_value() ? &*image : nullptr, LowMemory};
+  if (MemReport)
+  {
+    auto report = mem::MemoryReport{};
+    program.report_memory(report);
+    report.print();
+  }
+  if (reporter->error_count() != 0)
+    return 1;
+
+  const auto output = OutputFile.empty() ? c::default_output_path(path)
+                                          : std::filesystem::path{OutputFile};
+  if (c::transpile(program, output.string().c_str(), {OutputSpace, JobCount})
+          .is_error())
+  {
+    io::print_error("Could not write '{}'!", output.string());
+    return 1;
+  }
+  return 0;
+}
+
+/// @brief Lowers a unit compiled by 'Batch' to C
+/// @param unit The unit to lower
+/// @param path The path of the file of the unit
+/// @param diagnostics The reports of the file
+/// @return Success if the C file was written
+ErrorFlag LowerToC(
+    const lng::ParsedUnit& unit, const std::filesystem::path& path,
+    String& diagnostics) noexcept
+{
+  const auto output = c::default_output_path(path).string();
+  if (c::transpile_unit_to(unit, output.c_str(), OutputSpace).is_success())
+    return ErrorFlag::success();
+  const auto error = fmt::format("Could not write '{}'!", output);
+  lng::format_error(diagnostics, StringView{error.data(), error.size()}, None, None);
+  return ErrorFlag::error();
+}
+
+/// @brief Compiles multiple files concurrently
+/// @param files The files to compile
+/// @return The exit code
+int Batch(View<String> files)
+{
+  Option<io::MappedFile> mapped  = None;
+  Option<lng::ModuleImage> image = None;
+  if (!LoadImage(mapped, image))
+    return 1;
+
+  auto options       = lng::BatchOptions{};
+  options.jobs       = JobCount;
+  options.warn_for   = GlobalWarnFor;
+  options.low_memory = LowMemory;
+  options.image      = image.is_value() ? &*image : nullptr;
+  options.lower      = &LowerToC;
+  if (!OutputFile.empty())
+    io::print_warn("'-o' is ignored: each file is lowered to its own C file.");
+  const u64 failed = lng::compile_batch(files, options);
+  return failed == 0 ? 0 : 1;
+}
+
+/// @brief Builds a module image from files.
+/// Each file is a module named after its path ('std/io.ct' is 'std.io').
+/// @param files The files to compile
+/// @return The exit code
+int EmitImage(View<String> files)
+{
+  using namespace lng;
+
+  auto reporter = lng::make_error_reporter<lng::ConsoleReporter>();
+  const Vector<std::filesystem::path> includes = {};
+  // All the units share the types of the program
+  auto program = ParsedProgram{*reporter, includes, GlobalWarnFor};
+  auto builder = ModuleImageBuilder{program.type_buffer()};
+  int exit_code = 0;
+  for (auto& file : files)
+  {
+    const auto path =
+        std::filesystem::path{std::string_view{file.data(), file.size()}};
+    auto unit = ParsedUnit{program, path};
+    if (unit.parse() != ParsedUnit::SUCCESS)
+    {
+      exit_code = 1;
+      continue;
+    }
+    Vector<String> parts;
+    auto module_path = path;
+    module_path.replace_extension();
+    for (auto& part : module_path)
+    {
+      if (part.has_root_path() || part == ".")
+        continue;
+      const auto str = part.string();
+      parts.push_back(String{StringView{str.data(), str.size()}});
+    }
+    Vector<StringView> name;
+    for (auto& part : parts)
+      name.push_back(StringView{part});
+    if (builder.add_unit(unit, name).is_error())
+    {
+      io::print_error(
+          "Could not add '{}' to the image: its module name is invalid or it "
+          "redeclares a global!",
+          StringView{file});
+      exit_code = 1;
+    }
+  }
+  if (exit_code != 0)
+    return exit_code;
+
+  const auto output = std::string{EmitImageFile};
+  if (builder.write(output.c_str()).is_error())
+  {
+    io::print_error("Could not write '{}'!", output);
+    return 1;
   }
+  return 0;
+}
+
+/// @brief Compiles the input files through the server, or locally if the
+/// server cannot be reached
+/// @param files The files to compile
+/// @return The exit code
+int Connect(View<String> files)
+{
+  auto request = server::CompileRequest{};
+  auto cwd     = std::filesystem::current_path().string();
+  request.cwd  = StringView{cwd.data(), cwd.size()};
+  for (auto& file : files)
+    request.files.push_back(String{StringView{file}});
+  request.warn_for   = GlobalWarnFor;
+  request.color      = io::OutputColor;
+  request.mem_report = MemReport;
+  request.low_memory = LowMemory;
+  request.indent     = OutputSpace;
+  request.image      = StringView{ImageFile.data(), ImageFile.size()};
+  request.output     = StringView{OutputFile.data(), OutputFile.size()};
+
+  const auto socket = std::string{ConnectSocket};
+  if (auto response = server::send_request(socket.c_str(), request);
+      response.is_value())
+    return response->status;
+  // The local compilation uses the same options ('-image', '-low-memory')
+  io::print_warn("Could not connect to '{}', compiling locally...", socket);
+  if (files.size() == 1 && !JobCountSet)
+    return Compile(files[0]);
+  return Batch(files);
 }
 
 int main(int argc, const char** argv)
@@ -43,23 +241,74 @@ int main(int argc, const char** argv)
   // Parse command line arguments
   cl::parse_command_line_options<CMDs>(argc, argv);
 
+  int exit_code = 0;
+
   if (!DisasmFile.empty())
   {
-    clt::disassemble_file(DisasmFile);
+    clt::disassemble_file(
+        DisasmFile, DisasmOptions{DisasmSection, DisasmFrom, DisasmTo});
     io::print("\n");
   }
 
   // On debug configuration, runs tests
   if (RunTests)
     clt::run_tests();
+  else if (BenchFrontend)
+  {
+    if (BenchRuns == 0 || GenExprDepth > bench::MAX_GENERATED_EXPR_DEPTH
+        || GenLiteralDensity > 100 || GenCommentRatio > 100)
+      io::print_error("Invalid options for '-bench-frontend'!");
+    else
+    {
+      auto options  = bench::FrontendBenchOptions{};
+      options.shape = bench::SourceShape{
+          GenExprDepth,    GenIdentLen,   GenLiteralDensity,
+          GenCommentRatio, GenScopeDepth, GenLocals};
+      options.max_size    = BenchMaxSize;
+      options.runs        = BenchRuns;
+      options.time_budget = BenchTimeBudget;
+      options.mem_report  = MemReport;
+      options.counters    = BenchCounters;
+      bench::bench_frontend(options);
+    }
+  }
+  else if (!ServeSocket.empty())
+  {
+    const auto socket = std::string{ServeSocket};
+    if (server::serve(socket.c_str()).is_error())
+      exit_code = 1;
+  }
   else
   {
-    if (InputFile.empty())
+    if (InputFiles.is_empty())
       REPL();
+    else if (auto files = lng::expand_response_files(InputFiles); files.is_none())
+      exit_code = 1;
+    else if (!EmitImageFile.empty())
+      exit_code = EmitImage(*files);
+    else if (!ConnectSocket.empty())
+      exit_code = Connect(*files);
+    else if (files->size() == 1 && !JobCountSet)
+      exit_code = Compile((*files)[0]);
     else
-      io::print_warn("Transpilation is not implemented...");
+      exit_code = Batch(*files);
+  }
+
+  if ((TimeReport || !TraceFile.empty()) && !trace::is_enabled())
+    io::print_warn("Tracing requires building with the 'COLT_TRACE' CMake option!");
+  else
+  {
+    if (TimeReport)
+      trace::print_time_report();
+    if (!TraceFile.empty())
+    {
+      const auto path = std::string{TraceFile};
+      if (trace::write_chrome_trace(path.c_str()).is_error())
+        io::print_error("Could not write trace to '{}'!", path);
+    }
   }
 
   if (WaitForUserInput)
     io::press_to_continue();
+  return exit_code;
 }
\ No newline at end of file
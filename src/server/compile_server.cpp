@@ -0,0 +1,787 @@
+/*****************************************************************/ /**
+ * @file   compile_server.cpp
+ * @brief  Contains the implementation of 'compile_server.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include "compile_server.h"
+#include "ast/parsed_program.h"
+#include "c/c_transpiler.h"
+#include "structs/unique_ptr.h"
+#include "io/mapped_file.h"
+#include "io/print.h"
+
+#if !defined(COLT_WINDOWS)
+  #include <cerrno>
+  #include <csignal>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+namespace clt::server
+{
+  static_assert(sizeof(lng::WarnFor) == 1, "WarnFor is encoded as a byte!");
+
+  String encode_request(const CompileRequest& request) noexcept
+  {
+    assert_true(
+        "Paths may not contain new lines!",
+        StringView{request.cwd}.find('\n') == StringView::npos);
+    String encoded = PROTOCOL;
+    encoded.push_back('\n');
+    encoded.push_back("cwd ").push_back(request.cwd).push_back('\n');
+    const auto flags = fmt::format(
+        "flags {} {} {} {} {}\n", std::bit_cast<u8>(request.warn_for),
+        static_cast<u8>(request.color), static_cast<u8>(request.mem_report),
+        static_cast<u8>(request.low_memory), request.indent);
+    encoded.push_back(StringView{flags});
+    for (auto& [field, path] : {std::pair{"image ", &request.image},
+                                std::pair{"output ", &request.output}})
+    {
+      if (path->is_empty())
+        continue;
+      assert_true(
+          "Paths may not contain new lines!",
+          StringView{*path}.find('\n') == StringView::npos);
+      encoded.push_back(field).push_back(*path).push_back('\n');
+    }
+    for (auto& file : request.files)
+    {
+      assert_true(
+          "Paths may not contain new lines!",
+          StringView{file}.find('\n') == StringView::npos);
+      encoded.push_back("file ").push_back(file).push_back('\n');
+    }
+    return encoded;
+  }
+
+  /// @brief Parses an integer at the beginning of a string, removing it
+  /// (and the space following it)
+  /// @param str The string from which to parse
+  /// @return The integer or None on errors
+  static Option<u8> consume_u8(StringView& str) noexcept
+  {
+    u8 value        = 0;
+    auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (err != std::errc{})
+      return None;
+    str.remove_prefix(ptr - str.data());
+    if (!str.empty() && str.front() == ' ')
+      str.remove_prefix(1);
+    return value;
+  }
+
+  Option<CompileRequest> decode_request(StringView encoded) noexcept
+  {
+    if (encoded.size() > MAX_REQUEST_SIZE)
+      return None;
+    CompileRequest request;
+    bool first = true;
+    while (!encoded.empty())
+    {
+      const size_t end = encoded.find('\n');
+      auto line        = encoded.substr(0, end);
+      encoded = end == StringView::npos ? StringView{} : encoded.substr(end + 1);
+
+      if (first)
+      {
+        if (line != PROTOCOL)
+          return None;
+        first = false;
+      }
+      else if (line.starts_with("cwd "))
+        request.cwd = line.substr(4);
+      else if (line.starts_with("file "))
+        request.files.push_back(String{line.substr(5)});
+      else if (line.starts_with("image "))
+        request.image = line.substr(6);
+      else if (line.starts_with("output "))
+        request.output = line.substr(7);
+      else if (line.starts_with("flags "))
+      {
+        line.remove_prefix(6);
+        auto warn    = consume_u8(line);
+        auto color   = consume_u8(line);
+        auto mem     = consume_u8(line);
+        auto low_mem = consume_u8(line);
+        auto indent  = consume_u8(line);
+        if (warn.is_none() || color.is_none() || mem.is_none() || low_mem.is_none()
+            || indent.is_none())
+          return None;
+        request.warn_for   = std::bit_cast<lng::WarnFor>(*warn);
+        request.color      = *color != 0;
+        request.mem_report = *mem != 0;
+        request.low_memory = *low_mem != 0;
+        request.indent     = *indent;
+      }
+      else if (!line.empty())
+        return None;
+    }
+    if (first)
+      return None;
+    return request;
+  }
+
+  String encode_response(const CompileResponse& response) noexcept
+  {
+    String encoded = response.output;
+    encoded.push_back('\0').push_back(response.status == 0 ? '0' : '1');
+    for (auto& path : response.written)
+    {
+      assert_true(
+          "Paths may not contain new lines!",
+          StringView{path}.find('\n') == StringView::npos);
+      encoded.push_back('\n').push_back(path);
+    }
+    return encoded;
+  }
+
+  Option<CompileResponse> decode_response(StringView encoded) noexcept
+  {
+    // Paths cannot contain NUL bytes: the last one ends the output
+    const size_t nul = encoded.rfind('\0');
+    if (nul == StringView::npos || nul + 1 >= encoded.size()
+        || (encoded[nul + 1] != '0' && encoded[nul + 1] != '1'))
+      return None;
+    CompileResponse response;
+    response.output = encoded.substr(0, nul);
+    response.status = encoded[nul + 1] == '0' ? 0 : 1;
+    auto paths      = encoded.substr(nul + 2);
+    while (!paths.empty())
+    {
+      if (paths.front() != '\n')
+        return None;
+      paths.remove_prefix(1);
+      const size_t end = paths.find('\n');
+      response.written.push_back(String{paths.substr(0, end)});
+      paths = end == StringView::npos ? StringView{} : paths.substr(end);
+    }
+    return response;
+  }
+
+#if defined(COLT_WINDOWS)
+  ErrorFlag serve(const char* socket_path) noexcept
+  {
+    io::print_error("'-serve' is not supported on Windows!");
+    return ErrorFlag::error();
+  }
+
+  Option<CompileResponse> send_request(
+      const char* socket_path, const CompileRequest& request) noexcept
+  {
+    return None;
+  }
+#else
+  /// @brief Set by the signal handler to stop the server
+  static volatile std::sig_atomic_t StopServer = 0;
+
+  /// @brief Signal handler (SIGINT and SIGTERM) stopping the server
+  /// @param signal The signal
+  static void stop_server(int signal) noexcept
+  {
+    StopServer = 1;
+  }
+
+  /// @brief Check if the peer of a connection runs as the user of the server
+  /// @param client The connection
+  /// @return True if the peer has the same effective user ID
+  static bool is_same_user(int client) noexcept
+  {
+  #if defined(SO_PEERCRED)
+    ucred credentials;
+    socklen_t size = sizeof(credentials);
+    return getsockopt(client, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0
+           && size == sizeof(credentials) && credentials.uid == geteuid();
+  #else
+    uid_t uid;
+    gid_t gid;
+    return getpeereid(client, &uid, &gid) == 0 && uid == geteuid();
+  #endif // SO_PEERCRED
+  }
+
+  /// @brief Writes all the bytes to a file descriptor
+  /// @param fd The file descriptor
+  /// @param bytes The bytes to write
+  /// @return True on success
+  static bool write_all(int fd, StringView bytes) noexcept
+  {
+    while (!bytes.empty())
+    {
+      auto written = write(fd, bytes.data(), bytes.size());
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+        return false;
+      bytes.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+  }
+
+  /// @brief Reads from a file descriptor until the end of file
+  /// @param fd The file descriptor
+  /// @param max_size The maximum count of bytes to read
+  /// @param timeout_ms The maximum time (in milliseconds) to wait for all
+  /// the bytes, or -1 to wait indefinitely
+  /// @return The bytes read, or None on errors (or if 'max_size' or
+  /// 'timeout_ms' is exceeded)
+  static Option<String> read_all(int fd, u64 max_size, i64 timeout_ms) noexcept
+  {
+    using clock         = std::chrono::steady_clock;
+    const auto deadline = clock::now() + std::chrono::milliseconds{timeout_ms};
+
+    String result;
+    char buffer[4096];
+    for (;;)
+    {
+      if (timeout_ms >= 0)
+      {
+        // A client sending a byte at a time must not stall the server either,
+        // so the deadline applies to the whole request (not to each read)
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - clock::now());
+        if (remaining.count() <= 0)
+          return None;
+        pollfd poll_fd = {fd, POLLIN, 0};
+        const int ready = poll(&poll_fd, 1, static_cast<int>(remaining.count()));
+        if (ready < 0 && errno == EINTR)
+          continue;
+        if (ready <= 0)
+          return None;
+      }
+      auto count = read(fd, buffer, sizeof(buffer));
+      if (count < 0 && errno == EINTR)
+        continue;
+      if (count < 0)
+        return None;
+      if (count == 0)
+        return result;
+      result.push_back(StringView{buffer, static_cast<size_t>(count)});
+      if (result.size() > max_size)
+        return None;
+    }
+  }
+
+  /// @brief Fills the address of a UNIX socket
+  /// @param addr The address to fill
+  /// @param socket_path The path of the socket
+  /// @return False if the path is too long
+  static bool make_address(sockaddr_un& addr, const char* socket_path) noexcept
+  {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    const size_t size = std::strlen(socket_path);
+    if (size >= sizeof(addr.sun_path))
+      return false;
+    std::memcpy(addr.sun_path, socket_path, size);
+    return true;
+  }
+
+  /// @brief Redirects 'stdout' and 'stderr' to a temporary file, to
+  /// capture everything printed (diagnostics included).
+  class OutputCapture
+  {
+    /// @brief The temporary file (or null if it could not be created)
+    std::FILE* file;
+    /// @brief The duplicate of the original 'stdout'
+    int saved_out = -1;
+    /// @brief The duplicate of the original 'stderr'
+    int saved_err = -1;
+
+  public:
+    /// @brief Starts capturing
+    OutputCapture() noexcept
+        : file(std::tmpfile())
+    {
+      if (file == nullptr)
+        return;
+      std::fflush(stdout);
+      std::fflush(stderr);
+      saved_out = dup(STDOUT_FILENO);
+      saved_err = dup(STDERR_FILENO);
+      dup2(fileno(file), STDOUT_FILENO);
+      dup2(fileno(file), STDERR_FILENO);
+    }
+
+    OutputCapture(const OutputCapture&)            = delete;
+    OutputCapture& operator=(const OutputCapture&) = delete;
+
+    /// @brief Stops capturing if 'finish' was not called
+    ~OutputCapture() noexcept { finish(); }
+
+    /// @brief Stops capturing, returning the output captured
+    /// @return The output captured (empty if nothing could be captured)
+    String finish() noexcept
+    {
+      String output;
+      if (file == nullptr)
+        return output;
+      std::fflush(stdout);
+      std::fflush(stderr);
+      dup2(saved_out, STDOUT_FILENO);
+      dup2(saved_err, STDERR_FILENO);
+      close(saved_out);
+      close(saved_err);
+
+      std::rewind(file);
+      char buffer[4096];
+      while (auto count = std::fread(buffer, 1, sizeof(buffer), file))
+        output.push_back(StringView{buffer, count});
+      std::fclose(file);
+      file = nullptr;
+      return output;
+    }
+  };
+
+  /// @brief The module image of a request, as it was when the request
+  /// was handled
+  struct ImageStamp
+  {
+    /// @brief The absolute path of the image (or empty if there is none)
+    std::filesystem::path path = {};
+    /// @brief The modification time of the image
+    i64 mtime = 0;
+    /// @brief The size of the image
+    u64 size = 0;
+
+    /// @brief Check if two stamps refer to the same image
+    /// @param other The stamp with which to compare
+    /// @return True if the path, the modification time and the size are equal
+    bool operator==(const ImageStamp& other) const noexcept = default;
+  };
+
+  /// @brief Maps the module image of a stamp
+  /// @param stamp The stamp of the image
+  /// @return The mapped image or None
+  static Option<io::MappedFile> map_image(const ImageStamp& stamp) noexcept
+  {
+    if (stamp.path.empty())
+      return None;
+    return io::MappedFile::open(stamp.path.string().c_str());
+  }
+
+  /// @brief Loads a mapped module image
+  /// @param file The mapped image (which must outlive the image)
+  /// @return The image or None
+  static Option<lng::ModuleImage> load_image(
+      const Option<io::MappedFile>& file) noexcept
+  {
+    if (file.is_none())
+      return None;
+    return lng::ModuleImage::load(file->bytes());
+  }
+
+  /// @brief A program cached by the server
+  struct CachedProgram
+  {
+    /// @brief The modification time of the file when parsed
+    i64 mtime;
+    /// @brief The size of the file when parsed
+    u64 size;
+    /// @brief The content of the file when parsed
+    String source;
+    /// @brief The value of the server's request counter when the program
+    /// was last used (to evict the least recently used program)
+    u64 last_used = 0;
+    /// @brief The warnings the program was parsed with
+    u8 warn_for;
+    /// @brief True if the program was parsed with colored output
+    bool color;
+    /// @brief True if the program was parsed in low-memory mode
+    bool low_memory;
+    /// @brief The output of parsing the program (its diagnostics)
+    String diagnostics = {};
+    /// @brief The path of the file (which the program references)
+    std::filesystem::path path;
+    /// @brief The module image linked to the program when parsed
+    ImageStamp image_stamp;
+    /// @brief The mapped module image (which 'image' references)
+    Option<io::MappedFile> image_file;
+    /// @brief The module image linked to the program
+    Option<lng::ModuleImage> image;
+    /// @brief The reporter of the program (which owns the formatted
+    /// reports, so it is dropped with the program)
+    UniquePtr<lng::ErrorReporter> reporter =
+        lng::make_error_reporter<lng::ConsoleReporter>();
+    /// @brief The parsed program
+    lng::ParsedProgram program;
+
+    /// @brief Parses a program
+    /// @param path The path of the file to parse
+    /// @param source The content of the file (kept to detect changes)
+    /// @param includes The include paths
+    /// @param request The request which asked for the program
+    /// @param image_stamp The module image to link (already validated)
+    CachedProgram(
+        const std::filesystem::path& path,
+        String&& source, const Vector<std::filesystem::path>& includes,
+        const CompileRequest& request, const ImageStamp& image_stamp) noexcept
+        : mtime(0)
+        , size(source.size())
+        , source(std::move(source))
+        , warn_for(std::bit_cast<u8>(request.warn_for))
+        , color(request.color)
+        , low_memory(request.low_memory)
+        , path(path)
+        , image_stamp(image_stamp)
+        , image_file(map_image(image_stamp))
+        , image(load_image(image_file))
+        , program(
+              *reporter, this->path, includes, request.warn_for,
+              image.is_value() ? &*image : nullptr, request.low_memory)
+    {
+    }
+  };
+
+  /// @brief The state of the server kept between requests
+  class Server
+  {
+    /// @brief The include paths
+    const Vector<std::filesystem::path> includes = {};
+    /// @brief The cached programs (by absolute path)
+    Map<std::filesystem::path, UniquePtr<CachedProgram>> cache{};
+    /// @brief Incremented on each lookup (see CachedProgram::last_used)
+    u64 use_counter = 0;
+
+    /// @brief The result of compiling a file
+    struct FileResult
+    {
+      /// @brief The program or null if the file could not be read
+      CachedProgram* program;
+      /// @brief True if the cached program was reused
+      bool hit;
+    };
+
+    /// @brief Returns the modification time of a file
+    /// @param path The path of the file
+    /// @param err The error code set on errors
+    /// @return The modification time
+    static i64 mtime_of(
+        const std::filesystem::path& path, std::error_code& err) noexcept
+    {
+      return static_cast<i64>(
+          std::filesystem::last_write_time(path, err).time_since_epoch().count());
+    }
+
+    /// @brief Removes the least recently used program from the cache
+    void evict_one() noexcept
+    {
+      const std::filesystem::path* oldest = nullptr;
+      u64 oldest_use                      = std::numeric_limits<u64>::max();
+      for (auto& [path, program] : cache)
+      {
+        if (program->last_used < oldest_use)
+        {
+          oldest_use = program->last_used;
+          oldest     = &path;
+        }
+      }
+      if (oldest != nullptr)
+        cache.erase(std::filesystem::path{*oldest});
+    }
+
+    /// @brief Returns the program of a file, parsing it if the cached
+    /// program is outdated (or was parsed with other options)
+    /// @param path The absolute path of the file
+    /// @param request The request asking for the program
+    /// @return The program and whether it was cached
+    FileResult compile(
+        const std::filesystem::path& path, const CompileRequest& request,
+        const ImageStamp& image) noexcept
+    {
+      const u8 warn_for = std::bit_cast<u8>(request.warn_for);
+      auto slot         = cache.find(path);
+      CachedProgram* cached =
+          slot == nullptr ? nullptr : &*slot->second;
+      if (cached != nullptr
+          && (cached->warn_for != warn_for || cached->color != request.color
+              || cached->low_memory != request.low_memory
+              || cached->image_stamp != image))
+        cached = nullptr;
+
+      std::error_code err;
+      const i64 mtime = mtime_of(path, err);
+      const u64 size  = std::filesystem::file_size(path, err);
+      if (err)
+        return {nullptr, false};
+      // Cheap check: the file was not modified
+      if (cached != nullptr && cached->mtime == mtime && cached->size == size)
+      {
+        cached->last_used = ++use_counter;
+        return {cached, true};
+      }
+
+      auto file = String::getFile(path.string().c_str());
+      if (file.is_error())
+        return {nullptr, false};
+      // The file was touched without being modified
+      if (cached != nullptr && StringView{cached->source} == StringView{*file})
+      {
+        cached->mtime     = mtime;
+        cached->last_used = ++use_counter;
+        return {cached, true};
+      }
+
+      auto capture = OutputCapture{};
+      auto program = clt::make_unique<CachedProgram>(
+          path, std::move(*file), includes, request, image);
+      program->mtime       = mtime;
+      program->last_used   = ++use_counter;
+      program->diagnostics = capture.finish();
+
+      cache.erase(path);
+      if (cache.size() >= MAX_CACHED_PROGRAMS)
+        evict_one();
+      CachedProgram* ptr = &*program;
+      cache.insert(path, std::move(program));
+      return {ptr, false};
+    }
+
+    /// @brief Stamps the module image of a request, checking that it is valid
+    /// @param path The absolute path of the image
+    /// @return The stamp of the image or None if it is not a valid image
+    static Option<ImageStamp> stamp_image(const std::filesystem::path& path) noexcept
+    {
+      std::error_code mtime_err;
+      std::error_code size_err;
+      const auto stamp = ImageStamp{
+          path, mtime_of(path, mtime_err), std::filesystem::file_size(path, size_err)};
+      if (mtime_err || size_err)
+        return None;
+      // Only the header is validated, as when compiling locally
+      if (load_image(map_image(stamp)).is_none())
+        return None;
+      return stamp;
+    }
+
+    /// @brief Lowers a program compiled without errors to C
+    /// @param program The program to lower
+    /// @param output The path of the C file to write
+    /// @param request The request asking for the program
+    /// @param response The response to which to add the C file
+    /// @return Success if the C file was written
+    static ErrorFlag lower(
+        const CachedProgram& program, const std::filesystem::path& output,
+        const CompileRequest& request, CompileResponse& response) noexcept
+    {
+      const auto output_str = output.string();
+      if (c::transpile(program.program, output_str.c_str(), {request.indent, 0})
+              .is_success())
+      {
+        response.written.push_back(
+            String{StringView{output_str.data(), output_str.size()}});
+        return ErrorFlag::success();
+      }
+      auto capture = OutputCapture{};
+      io::print_error("Could not write '{}'!", output_str);
+      response.output.push_back(capture.finish());
+      return ErrorFlag::error();
+    }
+
+  public:
+    /// @brief Handles a request
+    /// @param request The request
+    /// @return The response (the output, the exit code and the C files written)
+    CompileResponse handle(const CompileRequest& request) noexcept
+    {
+      using clock      = std::chrono::steady_clock;
+      const auto start = clock::now();
+
+      const bool color = io::OutputColor;
+      io::OutputColor  = request.color;
+      ON_SCOPE_EXIT
+      {
+        io::OutputColor = color;
+      };
+
+      // Paths are resolved from the working directory of the client
+      const auto resolve = [&](const String& str) noexcept
+      {
+        auto path = std::filesystem::path{std::string_view{str.data(), str.size()}};
+        if (path.is_relative())
+          path = std::filesystem::path{std::string_view{
+                     request.cwd.data(), request.cwd.size()}}
+                 / path;
+        return path.lexically_normal();
+      };
+
+      CompileResponse response;
+      auto image = ImageStamp{};
+      if (!request.image.is_empty())
+      {
+        auto stamp = stamp_image(resolve(request.image));
+        if (stamp.is_none())
+        {
+          auto capture = OutputCapture{};
+          io::print_error("'{}' is not a valid module image!", request.image);
+          response.output = capture.finish();
+          response.status = 1;
+          return response;
+        }
+        image = std::move(*stamp);
+      }
+      // As when compiling locally, '-o' only applies to a single file
+      const bool single_output = !request.output.is_empty() && request.files.size() == 1;
+      if (!request.output.is_empty() && !single_output)
+      {
+        auto capture = OutputCapture{};
+        io::print_warn("'-o' is ignored: each file is lowered to its own C file.");
+        response.output.push_back(capture.finish());
+      }
+
+      u64 hits = 0;
+      for (auto& file : request.files)
+      {
+        const auto path     = resolve(file);
+        auto [program, hit] = compile(path, request, image);
+        if (program == nullptr)
+        {
+          auto capture = OutputCapture{};
+          io::print_error("Could not read '{}'!", file);
+          response.output.push_back(capture.finish());
+          response.status = 1;
+          continue;
+        }
+        hits += hit;
+        response.output.push_back(program->diagnostics);
+        if (program->reporter->error_count() != 0)
+          response.status = 1;
+        else if (lower(
+                     *program,
+                     single_output ? resolve(request.output)
+                                   : c::default_output_path(path),
+                     request, response)
+                     .is_error())
+          response.status = 1;
+        if (request.mem_report)
+        {
+          auto capture = OutputCapture{};
+          auto report  = mem::MemoryReport{};
+          program->program.report_memory(report);
+          report.print();
+          response.output.push_back(capture.finish());
+        }
+      }
+
+      const auto elapsed =
+          std::chrono::duration<double, std::milli>(clock::now() - start);
+      io::print_message(
+          "Compiled {} file(s) ({} cached) in {:.3f}ms.", request.files.size(),
+          hits, elapsed.count());
+      return response;
+    }
+  };
+
+  ErrorFlag serve(const char* socket_path) noexcept
+  {
+    sockaddr_un addr;
+    if (!make_address(addr, socket_path))
+    {
+      io::print_error("Socket path '{}' is too long!", socket_path);
+      return ErrorFlag::error();
+    }
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+    {
+      io::print_error("Could not create a socket!");
+      return ErrorFlag::error();
+    }
+    // Remove the socket of a previous server that was not stopped properly
+    unlink(socket_path);
+    // Only the user of the server may connect to the socket: it is created
+    // without permissions for the group and others (0600)
+    const mode_t mask = umask(0177);
+    const bool bound  = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    umask(mask);
+    if (!bound || listen(fd, 64) != 0)
+    {
+      io::print_error("Could not listen on '{}'!", socket_path);
+      close(fd);
+      return ErrorFlag::error();
+    }
+
+    // Interrupt 'accept' on SIGINT/SIGTERM to stop properly
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &stop_server;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    // A client disconnecting must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    io::print_message("Serving on '{}' (stop with Ctrl+C)...", socket_path);
+    auto server = Server{};
+    while (StopServer == 0)
+    {
+      const int client = accept(fd, nullptr, nullptr);
+      if (client == -1)
+        continue;
+      ON_SCOPE_EXIT
+      {
+        close(client);
+      };
+      // The permissions of the socket may not be enforced by every system
+      if (!is_same_user(client))
+      {
+        io::print_warn("Rejecting a connection from another user!");
+        continue;
+      }
+
+      auto encoded = read_all(client, MAX_REQUEST_SIZE, REQUEST_TIMEOUT_MS);
+      if (encoded.is_none())
+        continue;
+      auto request = decode_request(*encoded);
+      if (request.is_none())
+      {
+        io::print_warn("Ignoring an invalid request!");
+        continue;
+      }
+      write_all(client, encode_response(server.handle(*request)));
+    }
+    close(fd);
+    unlink(socket_path);
+    io::print_message("Server stopped.");
+    return ErrorFlag::success();
+  }
+
+  Option<CompileResponse> send_request(
+      const char* socket_path, const CompileRequest& request) noexcept
+  {
+    sockaddr_un addr;
+    if (!make_address(addr, socket_path))
+      return None;
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+      return None;
+    ON_SCOPE_EXIT
+    {
+      close(fd);
+    };
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+      return None;
+
+    std::signal(SIGPIPE, SIG_IGN);
+    if (!write_all(fd, encode_request(request)))
+      return None;
+    // Signals the end of the request
+    shutdown(fd, SHUT_WR);
+
+    // Compiling may take arbitrarily long: wait for the whole response
+    auto encoded = read_all(fd, std::numeric_limits<u64>::max(), -1);
+    if (encoded.is_none())
+      return None;
+    auto response = decode_response(StringView{*encoded});
+    if (response.is_none())
+      return None;
+    std::fwrite(response->output.data(), 1, response->output.size(), stdout);
+    std::fflush(stdout);
+    return response;
+  }
+#endif // COLT_WINDOWS
+} // namespace clt::server
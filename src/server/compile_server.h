@@ -0,0 +1,119 @@
+/*****************************************************************/ /**
+ * @file   compile_server.h
+ * @brief  Contains the compile server ('-serve') and its client
+ * ('-connect').
+ * The server is a long-lived process that accepts compile requests
+ * over a local UNIX socket. It keeps the parsed programs cached between
+ * requests: a file whose modification time and size did not change (or
+ * whose content did not change) is not parsed again. This
+ * saves the process startup, the allocator warm-up and the parsing of
+ * unchanged files, which dominate builds running many small invocations.
+ *
+ * Each file compiled without errors is lowered to C, as when compiling
+ * locally. Everything printed while handling a request (diagnostics
+ * included) is sent back to the client, followed by a NUL byte, the exit
+ * code and the paths of the C files written.
+ * Requests are handled one at a time.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_COMPILE_SERVER
+#define HG_COLT_COMPILE_SERVER
+
+#include "structs/string.h"
+#include "structs/vector.h"
+#include "err/warn.h"
+
+namespace clt::server
+{
+  /// @brief The first line of every request (changed on protocol changes)
+  static constexpr StringView PROTOCOL = "colt-serve 2";
+  /// @brief The maximum size of a request (bigger requests are dropped)
+  static constexpr u64 MAX_REQUEST_SIZE = 1024 * 1024;
+  /// @brief The maximum time (in milliseconds) a client may take to send
+  /// its request (slower clients are dropped)
+  static constexpr i64 REQUEST_TIMEOUT_MS = 5000;
+  /// @brief The maximum count of programs cached by the server (the least
+  /// recently used program is evicted first)
+  static constexpr size_t MAX_CACHED_PROGRAMS = 256;
+
+  /// @brief A compilation request sent to the server
+  struct CompileRequest
+  {
+    /// @brief The working directory of the client, from which relative
+    /// paths are resolved
+    String cwd;
+    /// @brief The files to compile
+    Vector<String> files;
+    /// @brief What to warn for
+    lng::WarnFor warn_for = lng::WarnFor::warn_all();
+    /// @brief If true, the output is colored
+    bool color = true;
+    /// @brief If true, prints the memory used by each program
+    bool mem_report = false;
+    /// @brief If true, the tokens of each unit are discarded once parsed
+    bool low_memory = false;
+    /// @brief The count of spaces per indentation of the C output
+    u8 indent = 2;
+    /// @brief The path of the module image to link (or empty)
+    String image = {};
+    /// @brief The path of the C file to write if a single file is compiled
+    /// (if empty, each file is lowered to its own C file)
+    String output = {};
+  };
+
+  /// @brief The response of the server to a request
+  struct CompileResponse
+  {
+    /// @brief Everything printed while handling the request
+    String output;
+    /// @brief The exit code of the request
+    int status = 0;
+    /// @brief The paths of the C files written
+    Vector<String> written = {};
+  };
+
+  /// @brief Encodes a request to send it to the server.
+  /// The encoding is textual: the protocol line, followed by one line
+  /// per field ('cwd <path>', 'flags <warn> <color> <mem> <low-mem> <indent>',
+  /// 'image <path>', 'output <path>', 'file <path>').
+  /// @param request The request to encode
+  /// @return The encoded request
+  String encode_request(const CompileRequest& request) noexcept;
+
+  /// @brief Decodes a request encoded by 'encode_request'
+  /// @param encoded The encoded request
+  /// @return The request or None if invalid (or bigger than MAX_REQUEST_SIZE)
+  Option<CompileRequest> decode_request(StringView encoded) noexcept;
+
+  /// @brief Encodes a response to send it to the client.
+  /// The encoding is the output, a NUL byte, the exit code ('0' or '1')
+  /// and one line per C file written.
+  /// @param response The response to encode
+  /// @return The encoded response
+  String encode_response(const CompileResponse& response) noexcept;
+
+  /// @brief Decodes a response encoded by 'encode_response'
+  /// @param encoded The encoded response
+  /// @return The response or None if invalid
+  Option<CompileResponse> decode_response(StringView encoded) noexcept;
+
+  /// @brief Runs the server, handling requests until SIGINT or SIGTERM.
+  /// A stale socket at 'socket_path' is removed first.
+  /// The socket is only accessible to the user of the server (0600), and
+  /// connections from other users are rejected.
+  /// @param socket_path The path of the UNIX socket to create
+  /// @return Error if the socket could not be created (or on Windows)
+  ErrorFlag serve(const char* socket_path) noexcept;
+
+  /// @brief Sends a request to a server, printing its output
+  /// @param socket_path The path of the UNIX socket of the server
+  /// @param request The request to send
+  /// @return The response of the server, or None if the server could
+  /// not be reached (in which case nothing was printed)
+  Option<CompileResponse> send_request(
+      const char* socket_path, const CompileRequest& request) noexcept;
+} // namespace clt::server
+
+#endif // !HG_COLT_COMPILE_SERVER
@@ -14,11 +14,61 @@ namespace clt
       ++run_test_count;
       test::test_lexer(LexerTestFile, error_count);
     }
+    if (!TestCorpusDir.empty())
+    {
+      ++run_test_count;
+      test::test_corpus(TestCorpusDir, JobCount, error_count);
+    }
     if (FFITest)
     {
       ++run_test_count;
       test::test_ffi(error_count);
     }
+    if (ColtiTest)
+    {
+      ++run_test_count;
+      test::test_colti(error_count);
+    }
+    if (CpuTest)
+    {
+      ++run_test_count;
+      test::test_cpu(error_count);
+    }
+    if (ReplTest)
+    {
+      ++run_test_count;
+      test::test_repl(error_count);
+    }
+    if (ServerTest)
+    {
+      ++run_test_count;
+      test::test_server(error_count);
+    }
+    if (BatchTest)
+    {
+      ++run_test_count;
+      test::test_batch(error_count);
+    }
+    if (LowMemoryTest)
+    {
+      ++run_test_count;
+      test::test_low_memory(error_count);
+    }
+    if (PositionIndexTest)
+    {
+      ++run_test_count;
+      test::test_position_index(error_count);
+    }
+    if (CBackendTest)
+    {
+      ++run_test_count;
+      test::test_c_backend(error_count);
+    }
+    if (ModuleImageTest)
+    {
+      ++run_test_count;
+      test::test_module_image(error_count);
+    }
 
     if (run_test_count == 0)
     {
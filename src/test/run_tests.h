@@ -10,7 +10,17 @@
 
 #include "io/print.h"
 #include "test/test_lexer.h"
+#include "test/test_corpus.h"
 #include "test/test_ffi.h"
+#include "test/test_colti.h"
+#include "test/test_cpu.h"
+#include "test/test_repl.h"
+#include "test/test_server.h"
+#include "test/test_batch.h"
+#include "test/test_low_memory.h"
+#include "test/test_position_index.h"
+#include "test/test_c_backend.h"
+#include "test/test_module_image.h"
 
 namespace clt
 {
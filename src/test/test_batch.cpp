@@ -0,0 +1,192 @@
+/*****************************************************************/ /**
+ * @file   test_batch.cpp
+ * @brief  Contains the implementation of 'test_batch'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <atomic>
+#include <fstream>
+
+#include "test_batch.h"
+#include "io/args_parsing.h"
+
+namespace clt::test
+{
+  /// @brief Writes a file (overwriting it)
+  /// @param path The path of the file
+  /// @param content The content of the file
+  static void write_file(
+      const std::filesystem::path& path, std::string_view content) noexcept
+  {
+    auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+
+  /// @brief Check if arguments are equal to the expected ones
+  /// @param args The arguments
+  /// @param expected The expected arguments
+  /// @return True if equal
+  static bool same_args(
+      const Vector<String>& args,
+      std::initializer_list<std::string_view> expected) noexcept
+  {
+    if (args.size() != expected.size())
+      return false;
+    for (size_t i = 0; i < args.size(); i++)
+    {
+      if (std::string_view{args[i].data(), args[i].size()}
+          != expected.begin()[i])
+        return false;
+    }
+    return true;
+  }
+
+  /// @brief Tests 'expand_response_files'
+  /// @param dir The directory in which to write the response files
+  /// @param error_count The error count to increment on errors
+  static void test_response_files(
+      const std::filesystem::path& dir, u32& error_count) noexcept
+  {
+    const auto outer  = (dir / "outer.rsp").string();
+    const auto inner  = (dir / "inner.rsp").string();
+    const auto cyclic = (dir / "cyclic.rsp").string();
+    write_file(
+        outer, fmt::format("# comment\r\na.ct\r\n\r\n@{}\nd.ct  \n", inner));
+    write_file(inner, "b.ct\nc.ct");
+    write_file(cyclic, fmt::format("e.ct\n@{}\n", cyclic));
+
+    const auto at_outer  = "@" + outer;
+    const auto at_cyclic = "@" + cyclic;
+    const auto at_none   = "@" + (dir / "missing.rsp").string();
+
+    std::string_view nested[] = {"first.ct", at_outer, "last.ct"};
+    auto result               = lng::expand_response_files(nested);
+    if (result.is_none()
+        || !same_args(*result, {"first.ct", "a.ct", "b.ct", "c.ct", "d.ct", "last.ct"}))
+    {
+      ++error_count;
+      io::print_error("Invalid expansion of nested response files!");
+    }
+
+    std::string_view missing[] = {"first.ct", at_none};
+    if (lng::expand_response_files(missing).is_value())
+    {
+      ++error_count;
+      io::print_error("Missing response file was not reported!");
+    }
+
+    std::string_view cycle[] = {at_cyclic};
+    if (lng::expand_response_files(cycle).is_value())
+    {
+      ++error_count;
+      io::print_error("Cyclic response file was not reported!");
+    }
+  }
+
+  /// @brief The first positional argument of 'test_pos_list'
+  static std::string_view TestPosFirst = {};
+  /// @brief The '-j' option of 'test_pos_list'
+  static u32 TestPosJobs = 0;
+  /// @brief The positional list of 'test_pos_list'
+  static Vector<std::string_view> TestPosList = {};
+
+  /// @brief Tests the parsing of a PosList
+  /// @param error_count The error count to increment on errors
+  static void test_pos_list(u32& error_count) noexcept
+  {
+    using Options = meta::type_list<
+        cl::Pos<"first", cl::desc<"The first argument">, cl::location<TestPosFirst>>,
+        cl::Opt<"j", cl::desc<"The jobs">, cl::location<TestPosJobs>>,
+        cl::PosList<"files", cl::desc<"The files">, cl::location<TestPosList>>>;
+
+    // Options are parsed between the positional arguments, until '--'
+    const char* argv[] = {"colt", "x.ct", "a.ct", "-j", "3", "b.ct",
+                          "--",   "-c.ct", "d.ct"};
+    cl::parse_command_line_options<Options>(
+        static_cast<int>(std::size(argv)), argv);
+
+    const std::string_view expected[] = {"a.ct", "b.ct", "-c.ct", "d.ct"};
+    bool valid = TestPosFirst == "x.ct" && TestPosJobs == 3
+                 && TestPosList.size() == std::size(expected);
+    for (size_t i = 0; valid && i < TestPosList.size(); i++)
+      valid = TestPosList[i] == expected[i];
+    if (!valid)
+    {
+      ++error_count;
+      io::print_error("Invalid parsing of a PosList!");
+    }
+  }
+
+  /// @brief The count of units lowered by 'test_compile_batch'
+  static std::atomic<u32> LoweredCount = 0;
+
+  /// @brief Counts the lowered units (see BatchOptions::lower)
+  /// @param unit The unit
+  /// @param path The path of the file of the unit
+  /// @param diagnostics The reports of the file
+  /// @return Error if the file should not have compiled
+  static ErrorFlag count_lowered(
+      const lng::ParsedUnit& unit, const std::filesystem::path& path,
+      String& diagnostics) noexcept
+  {
+    LoweredCount.fetch_add(1, std::memory_order_relaxed);
+    if (!path.filename().string().starts_with("ok"))
+      return ErrorFlag::error();
+    return ErrorFlag::success();
+  }
+
+  /// @brief Tests 'compile_batch' with multiple workers
+  /// @param dir The directory in which to write the files to compile
+  /// @param error_count The error count to increment on errors
+  static void test_compile_batch(
+      const std::filesystem::path& dir, u32& error_count) noexcept
+  {
+    Vector<String> files;
+    const auto add_file = [&](std::string_view name, std::string_view content)
+    {
+      const auto path = (dir / name).string();
+      if (!content.empty())
+        write_file(path, content);
+      files.push_back(String{StringView{path.data(), path.size()}});
+    };
+    for (u32 i = 0; i < 6; i++)
+      add_file(fmt::format("ok{}.ct", i), fmt::format("global g{} = {};", i, i));
+    add_file("bad0.ct", "global x = ;");
+    add_file("bad1.ct", "global y = 1");
+    // Never written: could not be read
+    add_file("unread.ct", "");
+
+    for (u32 jobs : {1u, 3u, 16u})
+    {
+      LoweredCount = 0;
+      const auto options =
+          lng::BatchOptions{.jobs = jobs, .summary = false, .lower = &count_lowered};
+      const u64 failed = lng::compile_batch(files, options);
+      if (failed != 3 || LoweredCount != 6)
+      {
+        ++error_count;
+        io::print_error(
+            "Invalid batch with {} job(s) ({} failed, {} lowered)!", jobs, failed,
+            LoweredCount.load());
+      }
+    }
+  }
+
+  void test_batch(u32& error_count) noexcept
+  {
+    io::print_message("Testing batch compilation...");
+    std::error_code err;
+    const auto dir = std::filesystem::temp_directory_path() / "colt_test_batch";
+    std::filesystem::remove_all(dir, err);
+    std::filesystem::create_directories(dir, err);
+    ON_SCOPE_EXIT
+    {
+      std::filesystem::remove_all(dir, err);
+    };
+
+    test_response_files(dir, error_count);
+    test_pos_list(error_count);
+    test_compile_batch(dir, error_count);
+  }
+} // namespace clt::test
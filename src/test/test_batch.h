@@ -0,0 +1,22 @@
+/*****************************************************************/ /**
+ * @file   test_batch.h
+ * @brief  Tests for the compilation of many input files ('-j N'):
+ * response files, the PosList of the input files and 'compile_batch'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_BATCH
+#define HG_COLT_TEST_BATCH
+
+#include "ast/batch_compile.h"
+
+namespace clt::test
+{
+  /// @brief Tests the expansion of response files, the parsing of
+  /// positional lists and the compilation of files by multiple workers.
+  /// @param error_count The error count to increment on errors
+  void test_batch(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_BATCH
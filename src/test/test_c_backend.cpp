@@ -0,0 +1,260 @@
+/*****************************************************************/ /**
+ * @file   test_c_backend.cpp
+ * @brief  Contains the implementation of 'test_c_backend'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstdlib>
+
+#include "test_c_backend.h"
+#include "ast/parsed_unit.h"
+#include "err/composable_reporter.h"
+
+namespace clt::test
+{
+  /// @brief A program and the code expected in its lowering
+  struct ExpectedLowering
+  {
+    /// @brief The program to lower
+    StringView source;
+    /// @brief The code that must be part of the lowering
+    StringView expected;
+  };
+
+  /// @brief The literals whose lowering is tested
+  static constexpr std::array<ExpectedLowering, 8> EXPECTED_LITERALS = {
+      ExpectedLowering{"global a = -127i8 - 1i8;", "INT8_MIN"},
+      ExpectedLowering{"global a = -32767i16 - 1i16;", "INT16_MIN"},
+      ExpectedLowering{"global a = -2147483647i32 - 1i32;", "INT32_MIN"},
+      ExpectedLowering{"global a = -9223372036854775807i64 - 1i64;", "INT64_MIN"},
+      ExpectedLowering{"global a = 1.5;", "0x1.8p+0"},
+      ExpectedLowering{"global a = 0.1f;", "0x1.99999ap-4f"},
+      ExpectedLowering{"global a = 0.0 / 0.0;", "((double)NAN)"},
+      ExpectedLowering{"global a = 1.0 / 0.0;", "((double)INFINITY)"},
+  };
+
+  /// @brief The source of the unit to which expressions are added
+  /// (as the parser cannot read variables yet)
+  static constexpr StringView BUILT_SOURCE =
+      "{ var x = 200u8; var b = true; }\n"
+      "global g = 1.5;\n"
+      "global h = 2u8;\n";
+
+  /// @brief The code expected in the lowering of the built unit
+  static constexpr std::array<StringView, 11> EXPECTED_BUILT = {
+      "static const double g0_g = 0x1.8p+0;",
+      "static const uint8_t g0_h = ((uint8_t)2u);",
+      // Initial values that are not constant expressions in C
+      "static double g0_k;",
+      "static uint8_t g0_m;",
+      "static uint64_t g0_q;",
+      "g0_k = fmod(g0_g, g0_g);",
+      "g0_m = g0_h;",
+      // Wrapping arithmetic on narrow types
+      "const uint8_t l_w_10 = ((uint8_t)((uint32_t)l_x_0 + (uint32_t)l_x_0));",
+      "const uint8_t l_w_13 = ((uint8_t)((uint32_t)l_x_0 << l_x_0));",
+      // 'elif' chains
+      "else if ((!l_b_1))",
+      "else\n",
+  };
+
+  /// @brief Returns the declaration of a variable (or global) of a unit
+  /// @param exprs The expressions of the unit
+  /// @param name The name of the declaration
+  /// @return The declaration or None
+  static lng::OptTok<lng::StmtExprToken> find_decl(
+      const lng::ExprBuffer& exprs, StringView name) noexcept
+  {
+    for (u32 i = 0; i < exprs.stmt_count(); i++)
+    {
+      auto& decl = exprs.expr(lng::StmtExprToken{i});
+      if (auto var = decl.as<lng::VarDeclExpr>(); var && var->var_name() == name)
+        return lng::StmtExprToken{i};
+      if (auto global = decl.as<lng::GlobalDeclExpr>();
+          global && global->global_name() == name)
+        return lng::StmtExprToken{i};
+    }
+    return None;
+  }
+
+  /// @brief Adds wrapping arithmetic, an 'elif' chain and globals
+  /// whose initial values are not constant expressions to BUILT_SOURCE
+  /// @param unit The unit parsed from BUILT_SOURCE
+  /// @return False if the declarations of BUILT_SOURCE were not found
+  static bool build_unit(lng::ParsedUnit& unit) noexcept
+  {
+    using enum lng::BinaryOp;
+
+    auto& exprs = unit.expr_buffer();
+    auto& types = unit.program().type_buffer();
+    auto x      = find_decl(exprs, "x");
+    auto b      = find_decl(exprs, "b");
+    auto g      = find_decl(exprs, "g");
+    auto h      = find_decl(exprs, "h");
+    if (x.is_none() || b.is_none() || g.is_none() || h.is_none())
+      return false;
+    // The scope is the only statement that is not a declaration
+    lng::OptTok<lng::StmtExprToken> parent = None;
+    for (u32 i = 0; i < exprs.stmt_count(); i++)
+      if (exprs.expr(lng::StmtExprToken{i}).is_scope())
+        parent = lng::StmtExprToken{i};
+    if (parent.is_none())
+      return false;
+    auto& scope      = *exprs.expr(parent.value()).as<lng::ScopeExpr>();
+    const auto range = scope.token_range();
+    const auto u8    = types.add_builtin(lng::BuiltinID::U8);
+
+    // Declares a variable 'w' initialized by a binary operation on 'x'
+    u32 local_id     = 10;
+    const auto add_w = [&](lng::BinaryOp op) noexcept
+    {
+      auto value = exprs.add_binary(
+          range, exprs.add_var_read(range, x.value()), op, exprs.add_var_read(range, x.value()));
+      return exprs.add_var_decl(range, u8, local_id++, "w", value, false);
+    };
+    for (auto op : {OP_SUM, OP_SUB, OP_MUL, OP_BIT_LSHIFT})
+      scope.exprs().push_back(exprs.expr(add_w(op)).as_base());
+
+    // if b: ... elif !b: ... else: ...
+    const auto add_branch = [&]() noexcept
+    {
+      auto branch = exprs.add_scope(range, parent.value());
+      exprs.expr(branch).as<lng::ScopeExpr>()->exprs().push_back(
+          exprs.expr(add_w(OP_SUM)).as_base());
+      return branch;
+    };
+    auto not_b = exprs.add_unary(
+        range, lng::UnaryOp::OP_BOOL_NOT, exprs.add_var_read(range, b.value()));
+    auto elif = exprs.add_condition(range, not_b, add_branch(), add_branch());
+    auto cond = exprs.add_condition(
+        range, exprs.add_var_read(range, b.value()), add_branch(), elif);
+    scope.exprs().push_back(exprs.expr(cond).as_base());
+
+    // global k = g % g; global m = h; global q = bit_as<QWORD>(g);
+    const auto add_global = [&](StringView name, lng::ProdExprToken value) noexcept
+    {
+      auto decl = exprs.add_global_decl(range, exprs.type_token(value), name, value, false);
+      exprs.add_top_level(exprs.expr(decl).as_base());
+    };
+    add_global(
+        "k", exprs.add_binary(
+                 range, exprs.add_global_read(range, g.value()), OP_MOD,
+                 exprs.add_global_read(range, g.value())));
+    add_global("m", exprs.add_global_read(range, h.value()));
+    add_global(
+        "q", exprs.add_bit_cast(
+                 range, types.add_builtin(lng::BuiltinID::QWORD),
+                 exprs.add_global_read(range, g.value())));
+    return true;
+  }
+
+  /// @brief Compiles the lowering of a unit with the host C compiler
+  /// @param unit The unit to lower
+  /// @param error_count The error count to increment on errors
+  static void compile_with_host(const lng::ParsedUnit& unit, u32& error_count) noexcept
+  {
+#ifdef COLT_WINDOWS
+    (void)unit;
+    (void)error_count;
+    io::print_warn("Compiling the generated C is not supported on Windows!");
+#else
+    if (std::system("cc --version > /dev/null 2>&1") != 0)
+      return io::print_warn("No host C compiler: the generated C is not compiled!");
+    std::error_code error;
+    const auto dir = std::filesystem::temp_directory_path(error);
+    if (error)
+      return io::print_warn("No temporary directory: the generated C is not compiled!");
+    const auto c_path   = (dir / "colt_test_c_backend.c").string();
+    const auto obj_path = (dir / "colt_test_c_backend.o").string();
+    if (c::transpile_unit_to(unit, c_path.c_str(), 2).is_error())
+    {
+      ++error_count;
+      return io::print_error("Could not write '{}'!", c_path);
+    }
+    const auto command =
+        fmt::format("cc -std=c99 -Werror -c \"{}\" -o \"{}\"", c_path, obj_path);
+    if (std::system(command.c_str()) != 0)
+    {
+      ++error_count;
+      io::print_error("The generated C ('{}') does not compile!", c_path);
+      return;
+    }
+    std::filesystem::remove(c_path, error);
+    std::filesystem::remove(obj_path, error);
+#endif // COLT_WINDOWS
+  }
+
+  void test_c_backend(u32& error_count) noexcept
+  {
+    io::print_message("Testing C backend...");
+    const Vector<std::filesystem::path> includes = {};
+
+    for (auto& [source, expected] : EXPECTED_LITERALS)
+    {
+      auto reporter = lng::make_error_reporter<lng::SinkReporter>();
+      auto program  = lng::ParsedProgram{
+          *reporter, source, includes, lng::WarnFor::warn_all()};
+      if (reporter->error_count() != 0)
+      {
+        ++error_count;
+        io::print_error("'{}' did not parse!", source);
+        continue;
+      }
+      String output;
+      c::transpile_unit(
+          program.units().find(lng::ParsedProgram::EMPTY_PATH)->second, 0,
+          c::IndentTable{2}, output);
+      if (StringView{output.data(), output.size()}.find(expected)
+          == StringView::npos)
+      {
+        ++error_count;
+        io::print_error("'{}' was not lowered to '{}'!", source, expected);
+      }
+    }
+
+    auto reporter = lng::make_error_reporter<lng::SinkReporter>();
+    auto program = lng::ParsedProgram{*reporter, includes, lng::WarnFor::warn_all()};
+    auto unit    = lng::ParsedUnit{program, BUILT_SOURCE};
+    if (unit.parse() != lng::ParsedUnit::SUCCESS || !build_unit(unit))
+    {
+      ++error_count;
+      io::print_error("The source of the C backend test did not parse!");
+    }
+    else
+    {
+      String output;
+      c::transpile_unit(unit, 0, c::IndentTable{2}, output);
+      const auto lowered = StringView{output.data(), output.size()};
+      for (auto expected : EXPECTED_BUILT)
+      {
+        if (lowered.find(expected) != StringView::npos)
+          continue;
+        ++error_count;
+        io::print_error("Expected '{}' in the lowering:\n{}", expected, lowered);
+      }
+      // The globals initialized at run time are initialized by the unit
+      const auto unit_fn = lowered.find("clt_unit_0");
+      if (unit_fn == StringView::npos || lowered.find("g0_q = ") < unit_fn)
+      {
+        ++error_count;
+        io::print_error("'g0_q' was not initialized by 'clt_unit_0'!");
+      }
+      compile_with_host(unit, error_count);
+    }
+
+    // 'main.ct' is lowered to 'main.c'
+    const std::array<std::pair<const char*, const char*>, 3> paths = {
+        std::pair{"dir/main.ct", "dir/main.c"}, std::pair{"main.c", "main.c.c"},
+        std::pair{"noext", "noext.c"}};
+    for (auto& [path, expected] : paths)
+    {
+      if (c::default_output_path(path) == expected)
+        continue;
+      ++error_count;
+      io::print_error(
+          "The output path of '{}' was '{}'!", path,
+          c::default_output_path(path).string());
+    }
+  }
+} // namespace clt::test
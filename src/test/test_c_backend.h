@@ -0,0 +1,22 @@
+/*****************************************************************/ /**
+ * @file   test_c_backend.h
+ * @brief  Tests for the C backend, which lowers units to C.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_C_BACKEND
+#define HG_COLT_TEST_C_BACKEND
+
+#include "backend/c/c_transpiler.h"
+
+namespace clt::test
+{
+  /// @brief Tests the C emitted for small programs (literals, wrapping
+  /// arithmetic, conditions and globals), and compiles it with the host
+  /// C compiler (if any).
+  /// @param error_count The error count to increment on errors
+  void test_c_backend(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_C_BACKEND
@@ -0,0 +1,427 @@
+/*****************************************************************/ /**
+ * @file   test_colti.cpp
+ * @brief  Contains the implementation of 'test_colti'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "test_colti.h"
+
+namespace clt::test
+{
+  void test_colti(u32& error_count) noexcept
+  {
+    using namespace run;
+
+    io::print_message("Testing Colti executables...");
+
+    auto path     = std::filesystem::temp_directory_path() / "colt_test.colti";
+    auto path_str = path.string();
+    ON_SCOPE_EXIT
+    {
+      std::error_code err;
+      std::filesystem::remove(path, err);
+    };
+
+    const u8 CODE[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    ConstantPool pool;
+    auto hello1 = pool.add_string("Hello");
+    pool.add_string("World");
+    auto hello2 = pool.add_string("Hello");
+    pool.add_constant(QWORD_t{10});
+    pool.add_constant(QWORD_t{10});
+    if (hello1 != hello2 || pool.string_count() != 2 || pool.constant_count() != 1)
+    {
+      ++error_count;
+      io::print_error("ConstantPool does not deduplicate values!");
+    }
+
+    // 'unpack' may decode using PEXT and PDEP: compare with each accessor
+    for (u32 i = 0; i < 4096; i++)
+    {
+      const auto dest = static_cast<u8>(i * 37);
+      const auto op1  = static_cast<u8>(i >> 4);
+      const auto op2  = static_cast<u8>(i * 11 + 3);
+      const auto type = BinaryTypeInst::decode(
+          BinaryTypeInst(
+              static_cast<BinaryTypeInst::Op>(i % 16), dest, op1, op2,
+              static_cast<TypeOp>(i % reflect<TypeOp>::count()))
+              .encoded());
+      const auto bits = BinaryBitsInst::decode(
+          BinaryBitsInst(
+              static_cast<BinaryBitsInst::Op>(i % 16), dest, op1, op2,
+              static_cast<u8>(i % 64))
+              .encoded());
+      const auto branch = BranchInst::decode(
+          BranchInst(static_cast<BranchInst::Op>(i % 4), (i64)i * -4099).encoded());
+      const auto t = type.unpack();
+      const auto b = bits.unpack();
+      const auto r = branch.unpack();
+      if (t.op != type.op() || t.dest != type.dest() || t.op1 != type.op1()
+          || t.op2 != type.op2() || t.type != type.type() || b.op != bits.op()
+          || b.dest != bits.dest() || b.op1 != bits.op1() || b.op2 != bits.op2()
+          || b.n != bits.n() || r.op != branch.op() || r.offset != branch.offset())
+      {
+        ++error_count;
+        io::print_error(
+            "Invalid unpacked instruction (with PEXT: {})!", pext_is_hardware());
+        break;
+      }
+    }
+
+    // Repetitive content, which compresses well
+    Vector<u8> PACKED = Vector<u8>(4096);
+    for (size_t i = 0; i < 4096; i++)
+      PACKED.push_back(CODE[i % std::size(CODE)]);
+
+    {
+      auto writer = ColtiWriter::open(
+          path_str.c_str(), 4, ColtVersion{1, 2, 3}, std::chrono::system_clock::now());
+      if (writer.is_none())
+      {
+        ++error_count;
+        return io::print_error("Could not open '{}' for writing!", path_str);
+      }
+      writer->write_section("code", View<u8>{CODE, std::size(CODE)});
+      writer->begin_section("streamed");
+      writer->write(View<u8>{CODE, 3});
+      writer->write(View<u8>{CODE + 3, 5});
+      writer->end_section();
+      writer->begin_section("packed", true);
+      writer->write(View<u8>{PACKED.data(), 1000});
+      writer->write(View<u8>{PACKED.data() + 1000, PACKED.size() - 1000});
+      writer->end_section();
+      pool.write_to(*writer);
+      if (writer->finish().is_error())
+      {
+        ++error_count;
+        return io::print_error("Could not write Colti executable!");
+      }
+    }
+
+    auto file = String::getFile(path_str.c_str());
+    if (file.is_error())
+    {
+      ++error_count;
+      return io::print_error("Could not read back '{}'!", path_str);
+    }
+    auto exe = ColtiExecutable::load(
+        {reinterpret_cast<const u8*>(file->data()), file->size()});
+    if (exe.is_none())
+    {
+      ++error_count;
+      return io::print_error("Written Colti executable is invalid!");
+    }
+    if (exe->section_count() != 4 || exe->version().minor != 2)
+    {
+      ++error_count;
+      return io::print_error("Invalid Colti executable header!");
+    }
+
+    auto code     = exe->find_section("code");
+    auto streamed = exe->find_section("streamed");
+    auto constant = exe->find_section(ConstantPool::SECTION_NAME);
+    if (code.is_none() || streamed.is_none() || constant.is_none())
+    {
+      ++error_count;
+      return io::print_error("Could not find sections of Colti executable!");
+    }
+    if (code->size != std::size(CODE)
+        || std::memcmp(code->begin, CODE, std::size(CODE)) != 0
+        || streamed->size != 8 || std::memcmp(streamed->begin, CODE, 8) != 0)
+    {
+      ++error_count;
+      io::print_error("Invalid content of Colti executable sections!");
+    }
+    if (constant->size != pool.byte_size())
+    {
+      ++error_count;
+      io::print_error("Invalid constant pool section size!");
+    }
+    auto packed = exe->find_section("packed");
+    if (packed.is_none() || !packed->is_compressed || packed->size != PACKED.size()
+        || std::memcmp(packed->begin, PACKED.data(), PACKED.size()) != 0
+        || exe->section(2).size >= PACKED.size())
+    {
+      ++error_count;
+      io::print_error("Invalid compressed Colti section!");
+    }
+    if (!exe->has_checksums() || !exe->verify_all())
+    {
+      ++error_count;
+      io::print_error("Invalid checksums of Colti executable sections!");
+    }
+
+    auto base = reinterpret_cast<const u8*>(file->data());
+    // Truncated executables must be rejected when loading
+    if (ColtiExecutable::load({base, (u64)(constant->begin - base) + constant->size - 1})
+            .is_value())
+    {
+      ++error_count;
+      io::print_error("Truncated Colti executable was not detected!");
+    }
+
+    // Corrupting a section must only invalidate that section
+    file->data()[code->begin - base] ^= 0xFF;
+    auto corrupted = ColtiExecutable::load({base, file->size()});
+    if (corrupted.is_none() || corrupted->find_section("code").is_value()
+        || corrupted->find_section("streamed").is_none())
+    {
+      ++error_count;
+      io::print_error("Corrupted Colti section was not detected lazily!");
+    }
+    if (ColtiExecutable::load({base, file->size()}, true).is_value())
+    {
+      ++error_count;
+      io::print_error("Corrupted Colti section was not detected eagerly!");
+    }
+
+    // Disassemble: [add.i32] [bt +8] [imms -1] (branch targets 'imms')
+    const u64 INSTS[] = {
+        htol(BinaryTypeInst(BinaryTypeInst::Op::add, 1, 2, 3, TypeOp::i32_t).encoded()),
+        htol(BranchInst(BranchInst::Op::bt, 8).encoded()),
+        htol(((u64)InstEncoding::SIGNED_IMM << 60) | bitmask<u64>(60))};
+    auto disasm_path = path_str + ".txt";
+    ON_SCOPE_EXIT
+    {
+      std::error_code err;
+      std::filesystem::remove(disasm_path, err);
+    };
+    InstHistogram histogram;
+    {
+      auto out = io::BufferedWriter::open(disasm_path.c_str());
+      if (out.is_none())
+      {
+        ++error_count;
+        return io::print_error("Could not open '{}' for writing!", disasm_path);
+      }
+      disassemble_code(
+          {reinterpret_cast<const u8*>(INSTS), sizeof(INSTS)}, 0,
+          std::numeric_limits<u64>::max(), *out, histogram);
+    }
+    auto disasm = String::getFile(disasm_path.c_str());
+    if (disasm.is_error() || histogram.total() != 3
+        || StringView{disasm->data(), disasm->size()}.find("add.i32 r1, r2, r3")
+               == StringView::npos
+        || StringView{disasm->data(), disasm->size()}.find("bt L10 (+8)")
+               == StringView::npos
+        || StringView{disasm->data(), disasm->size()}.find("L10:\n")
+               == StringView::npos
+        || StringView{disasm->data(), disasm->size()}.find("imms -1")
+               == StringView::npos)
+    {
+      ++error_count;
+      io::print_error("Invalid disassembly of Colti instructions!");
+    }
+
+    // A writer without a buffer writes repeated bytes through the file
+    {
+      auto out = io::BufferedWriter::open(disasm_path.c_str(), 0);
+      if (out.is_none())
+      {
+        ++error_count;
+        return io::print_error("Could not open '{}' for writing!", disasm_path);
+      }
+      out->write_repeat(7, 1000);
+      out->pad_to(16);
+      if (out->flush().is_error() || out->position() != 1008)
+      {
+        ++error_count;
+        io::print_error("Invalid repeated write without a buffer!");
+      }
+    }
+    if (std::error_code err;
+        std::filesystem::file_size(disasm_path, err) != 1008 || err)
+    {
+      ++error_count;
+      io::print_error("Invalid size of a file written without a buffer!");
+    }
+
+    // Profile: main -> rec -> rec, with a branch in 'rec'
+    VMProfiler profiler;
+    profiler.register_function(0, "main");
+    profiler.enter_function(0);
+    profiler.on_inst(ltoh(INSTS[0]));
+    for (u32 i = 0; i < 2; i++)
+    {
+      profiler.enter_function(64);
+      profiler.on_inst(ltoh(INSTS[1]));
+      profiler.on_branch(8, i == 0);
+    }
+    profiler.on_inst(ltoh(INSTS[2]));
+    profiler.finish();
+    auto branch = profiler.branch(8);
+    if (profiler.opcode(opcode_key_of(ltoh(INSTS[1]))).count != 2
+        || profiler.opcode(opcode_key_of(ltoh(INSTS[2]))).count != 1
+        || branch.is_none() || branch->taken != 1 || branch->not_taken != 1
+        || profiler.function_stats().size() != 2
+        || profiler.function_stats()[1].calls != 2
+        || profiler.function_stats()[0].inclusive
+               < profiler.function_stats()[1].inclusive)
+    {
+      ++error_count;
+      io::print_error("Invalid statistics of VMProfiler!");
+    }
+    if (profiler.write_collapsed(disasm_path.c_str()).is_error())
+    {
+      ++error_count;
+      return io::print_error("Could not write collapsed stacks!");
+    }
+    auto collapsed = String::getFile(disasm_path.c_str());
+    if (collapsed.is_error()
+        || StringView{collapsed->data(), collapsed->size()}.find("main;fn_40;fn_40 ")
+               == StringView::npos)
+    {
+      ++error_count;
+      io::print_error("Invalid collapsed stacks of VMProfiler!");
+    }
+
+    // Link: 'var a = 10; var b = a;' then 'b = a'
+    lng::TokenBuffer tokens;
+    tokens.add_token(lng::Lexeme::TKN_EOF, 0, 0, 0);
+    const auto range = tokens.range_from(tokens.token_buffer()[0]);
+    lng::TypeBuffer types;
+    lng::ExprBuffer exprs{types};
+    auto ten   = exprs.add_literal(range, QWORD_t{10}, lng::BuiltinID::I64);
+    auto decl_a = exprs.add_global_decl(range, exprs.type_token(ten), "a", ten, true);
+    auto read_a = exprs.add_global_read(range, decl_a);
+    auto decl_b = exprs.add_global_decl(range, exprs.type_token(ten), "b", read_a, true);
+    auto write_b = exprs.add_global_write(range, decl_b, read_a);
+
+    GlobalLinker linker;
+    linker.link(exprs);
+    linker.link(exprs);
+    const auto main_slot = linker.fn_slot("main");
+    linker.resolve_fn(main_slot, 64);
+    auto load  = linker.lower(exprs, read_a, 1);
+    auto store = linker.lower(exprs, write_b, 1);
+    auto call  = linker.lower_call("main");
+    if (linker.var_count() != 2 || linker.fn_count() != 1
+        || linker.var_slot(exprs, decl_b).value_or(0) != 1
+        || load.is_none() || load->op() != GlobalInst::Op::load || load->slot() != 0
+        || store.is_none() || store->op() != GlobalInst::Op::store
+        || store->slot() != 1 || store->reg() != 1 || call.slot() != main_slot
+        || linker.lower(exprs, ten, 1).is_value()
+        || GlobalInst::decode(load->encoded()).slot() != 0)
+    {
+      ++error_count;
+      io::print_error("Invalid slots assigned by GlobalLinker!");
+    }
+
+    // Link globals spanning multiple nodes of the lists, then the ones added
+    // after, one of which is initialized by an earlier literal
+    {
+      lng::ExprBuffer many{types};
+      Vector<lng::ProdExprToken> values;
+      Vector<lng::StmtExprToken> decls;
+      const auto add_globals = [&](u32 from, u32 to) noexcept
+      {
+        for (u32 i = from; i < to; i++)
+        {
+          auto value = many.add_literal(range, QWORD_t{u64{i}}, lng::BuiltinID::I64);
+          values.push_back(value);
+          decls.push_back(
+              many.add_global_decl(range, many.type_token(value), "g", value, true));
+        }
+      };
+      add_globals(0, 700);
+      GlobalLinker many_linker;
+      many_linker.link(many);
+      add_globals(700, 1200);
+      auto first = many.add_global_decl(
+          range, many.type_token(values[0]), "h", values[0], true);
+      many_linker.link(many);
+      bool valid = many_linker.var_count() == 1201
+                   && many_linker.var_slot(many, first).value_or(0) == 1200
+                   && many_linker.initial_value(1200).as<u64>() == 0;
+      for (u32 i = 0; i < decls.size(); i++)
+        valid &= many_linker.var_slot(many, decls[i]).value_or(0) == i
+                 && many_linker.initial_value(i).as<u64>() == i;
+      if (!valid)
+      {
+        ++error_count;
+        io::print_error("Invalid initial values linked by GlobalLinker!");
+      }
+    }
+
+    {
+      auto writer = ColtiWriter::open(
+          path_str.c_str(), 1, ColtVersion{1, 2, 3}, None);
+      if (writer.is_none())
+      {
+        ++error_count;
+        return io::print_error("Could not open '{}' for writing!", path_str);
+      }
+      linker.write_to(*writer);
+      if (writer->finish().is_error())
+      {
+        ++error_count;
+        return io::print_error("Could not write Colti executable!");
+      }
+    }
+    auto linked = String::getFile(path_str.c_str());
+    auto linked_exe = linked.is_error()
+                          ? None
+                          : ColtiExecutable::load(
+                              {reinterpret_cast<const u8*>(linked->data()),
+                               linked->size()});
+    auto globals = linked_exe.is_none() ? None : GlobalMemory::load(*linked_exe);
+    if (globals.is_none() || globals->var_count() != 2 || globals->fn_count() != 1
+        || (*globals)[0].as<u64>() != 10 || (*globals)[1].as<u64>() != 0
+        || globals->function(main_slot) != 64)
+    {
+      ++error_count;
+      io::print_error("Invalid globals section!");
+    }
+
+    // Static link: 'unused' is stripped, and 'twin_b' is folded into 'twin_a'
+    const u64 IMM7 = ((u64)InstEncoding::SIGNED_IMM << 60) | 7;
+    LinkUnit unit1;
+    unit1.code = {
+        GlobalInst(GlobalInst::Op::load, 1, 0).encoded(),
+        GlobalInst(GlobalInst::Op::call, 0, 0).encoded(),
+        BranchInst(BranchInst::Op::call, 16).encoded(),
+        IMM7,
+        IMM7,
+        GlobalInst(GlobalInst::Op::load, 1, 1).encoded(),
+        IMM7};
+    unit1.functions = {
+        LinkFunction{"main", 0, 4}, LinkFunction{"twin_a", 4, 5},
+        LinkFunction{"unused", 5, 7}};
+    unit1.variables = {QWORD_t{1}, QWORD_t{2}};
+    unit1.fn_refs   = {"helper"};
+    unit1.strings   = {"Hello"};
+    LinkUnit unit2;
+    unit2.code = {IMM7 + 1, BranchInst(BranchInst::Op::call, 8).encoded(), IMM7};
+    unit2.functions = {LinkFunction{"helper", 0, 2}, LinkFunction{"twin_b", 2, 3}};
+    unit2.variables = {QWORD_t{3}};
+    unit2.strings   = {"Hello"};
+
+    StaticLinker static_linker;
+    static_linker.add(unit1);
+    static_linker.add(unit2);
+    auto stats = static_linker.link("main");
+    if (stats.is_error() || stats->fn_total != 5 || stats->fn_kept != 3
+        || stats->fn_folded != 1 || stats->var_total != 3 || stats->var_kept != 1
+        || stats->code_size != 7 * sizeof(u64)
+        || static_linker.function_offsets()[1] != 32
+        || static_linker.function_offsets()[2] != 48
+        || static_linker.linked_variables()[0].as<u64>() != 1
+        || static_linker.linked_code()[1] != GlobalInst(GlobalInst::Op::call, 0, 1).encoded()
+        || static_linker.linked_code()[2] != BranchInst(BranchInst::Op::call, 32).encoded()
+        || static_linker.linked_code()[5] != BranchInst(BranchInst::Op::call, 8).encoded()
+        || static_linker.constant_pool().string_count() != 1)
+    {
+      ++error_count;
+      io::print_error("Invalid executable produced by StaticLinker!");
+    }
+    StaticLinker no_entry;
+    no_entry.add(unit2);
+    if (auto result = no_entry.link("main");
+        !result.is_error() || result.error() != LinkError::UNDEFINED_ENTRY)
+    {
+      ++error_count;
+      io::print_error("StaticLinker did not report an undefined entry point!");
+    }
+  }
+} // namespace clt::test
@@ -0,0 +1,24 @@
+/*****************************************************************/ /**
+ * @file   test_colti.h
+ * @brief  Tests for Colti executables.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_COLTI
+#define HG_COLT_TEST_COLTI
+
+#include "colti/colti_exe.h"
+#include "colti/colti_writer.h"
+#include "colti/colti_disassembler.h"
+#include "colti/colti_profiler.h"
+#include "colti/colti_static_linker.h"
+
+namespace clt::test
+{
+  /// @brief Tests writing and loading of Colti executables.
+  /// @param error_count The error count to increment on errors
+  void test_colti(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_COLTI
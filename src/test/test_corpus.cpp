@@ -0,0 +1,274 @@
+/*****************************************************************/ /**
+ * @file   test_corpus.cpp
+ * @brief  Implementation of 'test_corpus'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <regex>
+#include "test_corpus.h"
+#include "test_lexer.h"
+#include "ast/ast.h"
+#include "ast/parsed_program.h"
+#include "common/parallel.h"
+
+namespace clt::test
+{
+  /// @brief A test file of the corpus
+  struct CorpusFile
+  {
+    /// @brief The path of the file (relative to the corpus directory)
+    String name;
+    /// @brief The content of the file
+    String content;
+  };
+
+  /// @brief A case of the corpus
+  struct CorpusCase
+  {
+    /// @brief The index of the file of the case
+    u64 file;
+    /// @brief The lexer case, or None for an AST test
+    Option<LexerCase> lexer;
+  };
+
+  /// @brief The result of running a case
+  struct CaseResult
+  {
+    /// @brief The errors of the case
+    String output{};
+    /// @brief The count of errors of the case
+    u32 error_count = 0;
+    /// @brief The time taken by the case (in nanoseconds)
+    u64 time_ns = 0;
+  };
+
+  template<typename... Args>
+  /// @brief Appends an error to a string
+  /// @param output The string to which to append
+  /// @param fmt The format string
+  /// @param ...args The arguments to format
+  static void append_error(
+      String& output, io::fmt_str<Args...> fmt, Args&&... args) noexcept
+  {
+    String error;
+    fmt::format_to(std::back_inserter(error), fmt, std::forward<Args>(args)...);
+    lng::format_error(output, error, None, None);
+  }
+
+  /// @brief Returns a line of a file, without its '\r'
+  /// @param content The content of the file
+  /// @param index The index of the line (0-based)
+  /// @return The line (empty if there are not enough lines)
+  static StringView get_line(StringView content, u64 index) noexcept
+  {
+    for (u64 i = 0; i < index && !content.empty(); i++)
+    {
+      const size_t end = content.find('\n');
+      content = end == StringView::npos ? StringView{} : content.substr(end + 1);
+    }
+    auto line = content.substr(0, content.find('\n'));
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+    return line;
+  }
+
+  /// @brief Runs an AST test
+  /// @param file The test file
+  /// @param output The string to which to append the errors
+  /// @return The count of errors
+  static u32 run_ast_case(const CorpusFile& file, String& output) noexcept
+  {
+    using namespace lng;
+
+    const auto content = StringView{file.content};
+    const auto name    = StringView{file.name};
+    const auto pattern = get_line(content, 0).substr(2);
+    // The second line may be the expected count of errors
+    Option<u64> expected_errors = None;
+    if (auto line = get_line(content, 1); line.starts_with("//"))
+    {
+      u64 count       = 0;
+      auto [ptr, err] = std::from_chars(line.data() + 2, line.end(), count);
+      if (err == std::errc{} && ptr == line.end())
+        expected_errors = count;
+    }
+
+    // Each case has its own reporter and program
+    String reports;
+    auto reporter = make_error_reporter<BufferReporter>(reports);
+    const Vector<std::filesystem::path> includes = {};
+    auto program = ParsedProgram{*reporter, content, includes, WarnFor::warn_all()};
+
+    u32 error_count = 0;
+    bool matches    = false;
+    if (pattern.starts_with('`'))
+      matches = StringView{reports}.find(pattern.substr(1)) != StringView::npos;
+    else
+    {
+      try
+      {
+        const auto regex = std::regex{pattern.begin(), pattern.end()};
+        matches = std::regex_search(reports.begin(), reports.end(), regex);
+      }
+      catch (const std::regex_error&)
+      {
+        append_error(output, "'{}' has an invalid regex '{}'!", name, pattern);
+        return 1;
+      }
+    }
+    if (!matches)
+    {
+      ++error_count;
+      append_error(output, "Reports of '{}' do not match '{}':", name, pattern);
+      output.push_back(reports);
+    }
+    if (expected_errors.is_value()
+        && *expected_errors != reporter->error_count())
+    {
+      ++error_count;
+      append_error(
+          output, "'{}' generated {} error(s) instead of {}!", name,
+          reporter->error_count(), *expected_errors);
+    }
+    return error_count;
+  }
+
+  /// @brief Loads the test files of a directory (sorted by name)
+  /// @param dir The directory
+  /// @return The files or None if the directory could not be read
+  static Option<Vector<CorpusFile>> load_corpus(
+      const std::filesystem::path& dir) noexcept
+  {
+    std::error_code err;
+    Vector<std::filesystem::path> paths;
+    for (auto it = std::filesystem::recursive_directory_iterator{dir, err};
+         !err && it != std::filesystem::recursive_directory_iterator{};
+         it.increment(err))
+    {
+      if (it->is_regular_file(err) && it->path().extension() == ".ct")
+        paths.push_back(it->path());
+    }
+    if (err)
+      return None;
+    std::sort(paths.begin(), paths.end());
+
+    Vector<CorpusFile> files = Vector<CorpusFile>(paths.size());
+    for (auto& path : paths)
+    {
+      auto content = String::getFile(path.string().c_str());
+      if (content.is_error())
+        return None;
+      const auto name = path.lexically_relative(dir).generic_string();
+      files.push_back(
+          CorpusFile{
+              String{StringView{name.data(), name.size()}}, std::move(*content)});
+    }
+    return files;
+  }
+
+  void test_corpus(StringView dir_path, u32 jobs, u32& error_count) noexcept
+  {
+    using clock = std::chrono::steady_clock;
+    io::print_message("Testing corpus '{}'...", dir_path);
+
+    const auto dir =
+        std::filesystem::path{std::string_view{dir_path.data(), dir_path.size()}};
+    auto files = load_corpus(dir);
+    if (files.is_none())
+    {
+      error_count++;
+      return io::print_error("Could not read the tests of '{}'!", dir_path);
+    }
+
+    Vector<CorpusCase> cases;
+    for (u64 i = 0; i < files->size(); i++)
+    {
+      auto content = StringView{(*files)[i].content};
+      if (content.starts_with("//"))
+        cases.push_back(CorpusCase{i, None});
+      else
+      {
+        for (auto& test : split_lexer_cases(content))
+          cases.push_back(CorpusCase{i, test});
+      }
+    }
+    Vector<CaseResult> results = Vector<CaseResult>(cases.size());
+    for (size_t i = 0; i < cases.size(); i++)
+      results.push_back(CaseResult{});
+
+    // Reports are matched against regexes, and the AST of each
+    // statement would be printed by any thread
+    const bool color     = io::OutputColor;
+    const bool print_ast = lng::DebugPrintAST;
+    io::OutputColor      = false;
+    lng::DebugPrintAST   = false;
+
+    const u64 workers = worker_count(jobs, cases.size());
+    auto queue        = IndexQueue{cases.size()};
+    auto work         = [&]() noexcept
+    {
+      lng::TokenBuffer buffer;
+      for (auto next = queue.pop(); next.is_value(); next = queue.pop())
+      {
+        auto& test       = cases[*next];
+        auto& result     = results[*next];
+        const auto start = clock::now();
+        if (test.lexer.is_value())
+          result.error_count = run_lexer_case(*test.lexer, buffer, result.output);
+        else
+          result.error_count = run_ast_case((*files)[test.file], result.output);
+        result.time_ns = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now() - start)
+                .count());
+      }
+    };
+    const auto start = clock::now();
+    run_on_workers(workers, work);
+    const auto elapsed =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    io::OutputColor    = color;
+    lng::DebugPrintAST = print_ast;
+
+    // Name of a case: its file, followed by its line for lexer cases
+    auto case_name = [&](const CorpusCase& test)
+    {
+      auto name = StringView{(*files)[test.file].name};
+      if (test.lexer.is_none())
+        return fmt::format("{}", name);
+      return fmt::format("{}:{}", name, test.lexer->line_nb);
+    };
+
+    u64 failed = 0;
+    for (auto& result : results)
+    {
+      std::fwrite(result.output.data(), 1, result.output.size(), stdout);
+      failed += static_cast<u64>(result.error_count != 0);
+    }
+    error_count += static_cast<u32>(failed);
+
+    Vector<u64> slowest = Vector<u64>(cases.size());
+    for (u64 i = 0; i < cases.size(); i++)
+      slowest.push_back(i);
+    std::sort(
+        slowest.begin(), slowest.end(), [&](u64 a, u64 b)
+        { return results[a].time_ns > results[b].time_ns; });
+    io::print_message(
+        "Ran {} case(s) of {} file(s) with {} job(s) in {:.3f}ms ({} failed).",
+        cases.size(), files->size(), workers, elapsed, failed);
+    if (!slowest.is_empty())
+      io::print("Slowest cases:");
+    for (u64 i = 0; i < std::min(SLOWEST_CASES_REPORTED, slowest.size()); i++)
+    {
+      auto& result = results[slowest[i]];
+      io::print(
+          "  {: >10.3f}ms  {}{}", static_cast<double>(result.time_ns) / 1e6,
+          case_name(cases[slowest[i]]), result.error_count == 0 ? "" : " (failed)");
+    }
+  }
+} // namespace clt::test
@@ -0,0 +1,33 @@
+/*****************************************************************/ /**
+ * @file   test_corpus.h
+ * @brief  Runs all the '.ct' tests of a directory in parallel.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_CORPUS
+#define HG_COLT_TEST_CORPUS
+
+#include "structs/string.h"
+
+namespace clt::test
+{
+  /// @brief The count of slowest cases reported by 'test_corpus'
+  static constexpr u64 SLOWEST_CASES_REPORTED = 10;
+
+  /// @brief Runs all the '.ct' test files of a directory (recursively).
+  /// A file whose first line starts with '//' is an AST test, which is a
+  /// single case: the rest of the line is a regex that the reports of
+  /// compiling the file must match (or a literal if it starts with '`').
+  /// If the second line is '//N', N is the expected count of errors.
+  /// Any other file is a lexer test file (see 'test_lexer'), each of its
+  /// cases being run separately.
+  /// The cases are run on worker threads, each with its own reporter,
+  /// and the failures, timings and slowest cases are printed.
+  /// @param dir_path The directory containing the tests
+  /// @param jobs The count of worker threads (0 for one per hardware thread)
+  /// @param error_count The error count to increment for each failed case
+  void test_corpus(StringView dir_path, u32 jobs, u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_CORPUS
@@ -0,0 +1,153 @@
+/*****************************************************************/ /**
+ * @file   test_cpu.cpp
+ * @brief  Contains the implementation of 'test_cpu'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "test_cpu.h"
+
+namespace clt::test
+{
+  void test_cpu(u32& error_count) noexcept
+  {
+    io::print_message(
+        "Testing CPU dispatch (level '{:h}', detected {:#x})...", cpu::level(),
+        cpu::detected());
+
+    enum class Field : u8
+    {
+      A,
+      B,
+      C,
+      D,
+      E,
+    };
+    // The lanes of the fields fit in 64 bits (8 + 16 + 8 + 32)
+    using Fields = Bitfields<
+        u64, Bitfield<Field::A, 5>, Bitfield<Field::B, 12>, Bitfield<Field::C, 7>,
+        Bitfield<Field::D, 20>, Bitfield<Field::E, 20>>;
+
+    // Bytes whose size is not a multiple of 8 (to test the tails)
+    Vector<u8> bytes;
+    for (u32 i = 0; i < 1021; i++)
+      bytes.push_back(static_cast<u8>(i * 31 + (i >> 3)));
+    // The results of the baseline, against which other levels are compared
+    const auto old_level = cpu::level();
+    cpu::set_level(cpu::Level::baseline);
+    const u32 expected_crc = crc32c(View<u8>{bytes.data(), bytes.size()});
+    if (crc32c(0, "123456789", 9) != 0xE3069283)
+    {
+      ++error_count;
+      io::print_error("Invalid CRC32C computed by the baseline!");
+    }
+
+    // Code mixing the encodings decoded by 'decode_code'
+    using namespace run;
+    Vector<u8> code;
+    for (u32 i = 0; i < 1024; i++)
+    {
+      u64 encoded;
+      switch (i % 4)
+      {
+      case 0:
+        encoded = BinaryTypeInst(
+                      static_cast<BinaryTypeInst::Op>(i % 16), static_cast<u8>(i),
+                      static_cast<u8>(i * 7), static_cast<u8>(i >> 2),
+                      static_cast<TypeOp>(i % reflect<TypeOp>::count()))
+                      .encoded();
+        break;
+      case 1:
+        encoded = BinaryBitsInst(
+                      static_cast<BinaryBitsInst::Op>(i % 16), static_cast<u8>(i * 3),
+                      static_cast<u8>(i), static_cast<u8>(i * 5), static_cast<u8>(i % 64))
+                      .encoded();
+        break;
+      case 2:
+        encoded = BranchInst(static_cast<BranchInst::Op>(i % 4), (i64)i * -4099).encoded();
+        break;
+      default:
+        // Invalid or immediate instructions
+        encoded = static_cast<u64>(i) * 0x9E3779B97F4A7C15;
+      }
+      encoded = htol(encoded);
+      const auto* ptr = reinterpret_cast<const u8*>(&encoded);
+      for (size_t j = 0; j < sizeof(u64); j++)
+        code.push_back(ptr[j]);
+    }
+    const auto code_view = View<u8>{code.data(), code.size()};
+    const u64 inst_count = code.size() / sizeof(u64);
+    auto expected_insts  = Vector<DecodedInst>(inst_count, InPlace);
+    decode_code(code_view, 0, inst_count, expected_insts.data());
+    auto decoded_insts = Vector<DecodedInst>(inst_count, InPlace);
+
+    for (auto level : reflect<cpu::Level>::iter())
+    {
+      // Levels not supported by the current CPU cannot be tested
+      if (!cpu::set_level(level))
+        continue;
+      const auto active = cpu::active();
+      if ((active & ~cpu::detected()) != 0
+          || (active & ~cpu::features_of(level)) != 0)
+      {
+        ++error_count;
+        io::print_error("Level '{:h}' enables unsupported features!", level);
+      }
+      if (crc32c_is_hardware() != cpu::has(cpu::SSE42)
+          || crc32c(View<u8>{bytes.data(), bytes.size()}) != expected_crc
+          || crc32c(0, "123456789", 9) != 0xE3069283)
+      {
+        ++error_count;
+        io::print_error("Invalid CRC32C at level '{:h}'!", level);
+      }
+
+      // Starting at an odd index, so that the instructions are not aligned
+      decode_code(code_view, 1, inst_count - 1, decoded_insts.data());
+      for (u64 i = 1; i < inst_count; i++)
+      {
+        const auto& a = decoded_insts[i - 1];
+        const auto& b = expected_insts[i];
+        if (a.encoded != b.encoded || a.is_valid != b.is_valid || a.op != b.op
+            || a.dest != b.dest || a.op1 != b.op1 || a.op2 != b.op2
+            || a.extra != b.extra)
+        {
+          ++error_count;
+          io::print_error(
+              "Invalid decoded instruction {:#x} at level '{:h}' (with PEXT: {})!",
+              b.encoded, level, pext_is_hardware());
+          break;
+        }
+      }
+      for (u64 i = 0; i < 4096; i++)
+      {
+        Fields fields{};
+        fields.set<Field::A>(i);
+        fields.set<Field::B>(i * 0x9E3779B9);
+        fields.set<Field::C>(~i * 7919);
+        fields.set<Field::D>(i << 17 | i);
+        fields.set<Field::E>(i * 3);
+        const auto all = fields.get_all<Field::D, Field::A, Field::C, Field::B>();
+        if (all[0] != fields.get<Field::D>() || all[1] != fields.get<Field::A>()
+            || all[2] != fields.get<Field::C>() || all[3] != fields.get<Field::B>())
+        {
+          ++error_count;
+          io::print_error("Invalid Bitfields::get_all at level '{:h}'!", level);
+          break;
+        }
+        // PEXT and PDEP may only be executed if BMI2 is supported
+        if (!cpu::has(cpu::BMI2))
+          continue;
+        const auto pext =
+            fields.get_all_with<ExtractWith::pext, Field::D, Field::A, Field::C, Field::B>();
+        if (pext != all)
+        {
+          ++error_count;
+          io::print_error(
+              "Invalid Bitfields::get_all_with<pext> at level '{:h}'!", level);
+          break;
+        }
+      }
+    }
+    cpu::set_level(old_level);
+  }
+} // namespace clt::test
@@ -0,0 +1,24 @@
+/*****************************************************************/ /**
+ * @file   test_cpu.h
+ * @brief  Tests for the CPU feature levels and the dispatched kernels.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_CPU
+#define HG_COLT_TEST_CPU
+
+#include "common/cpu_features.h"
+#include "common/crc32.h"
+#include "common/bits.h"
+#include "colti/colti_disassembler.h"
+
+namespace clt::test
+{
+  /// @brief Tests that each kernel gives the same results at each level
+  /// supported by the current CPU.
+  /// @param error_count The error count to increment on errors
+  void test_cpu(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_CPU
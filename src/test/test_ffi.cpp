@@ -54,6 +54,61 @@ namespace clt::test
     TEST_IDENTITY(f32, -0.24f);
     TEST_IDENTITY(f64, -24e30);
 
+    CallPlanCache plans;
+    const TypeOp ARGS[] = {TypeOp::i8_t, TypeOp::u16_t, TypeOp::i64_t};
+    auto madd = +[](i8 a, u16 b, i64 c) -> i64 { return a * (i64)b + c; };
+    const auto& plan = plans.get((void*)madd, ARGS, TypeOp::i64_t);
+    const bool is_native = plan.is_native();
+    const QWORD_t MADD_ARGS[] = {QWORD_t{(u64)-3}, QWORD_t{0xFFFF}, QWORD_t{10}};
+    if (plan.invoke(binder, MADD_ARGS).as<i64>() != madd(-3, 0xFFFF, 10)
+        || &plans.get((void*)madd, ARGS, TypeOp::i64_t) != &plan)
+    {
+      ++error_count;
+      io::print_error("FFI call plans do not work!");
+    }
+    const TypeOp F64_ARGS[] = {TypeOp::f64_t, TypeOp::i32_t};
+    auto scale = +[](f64 a, i32 b) { return a * b; };
+    QWORD_t SCALE_ARGS[2];
+    SCALE_ARGS[0].bit_assign(1.5);
+    SCALE_ARGS[1].bit_assign((i32)-4);
+    if (plans.get((void*)scale, F64_ARGS, TypeOp::f64_t)
+            .invoke(binder, SCALE_ARGS)
+            .as<f64>()
+        != -6.0)
+    {
+      ++error_count;
+      io::print_error("FFI call plans do not work for 'f64'!");
+    }
+
+    // Throughput of repeated calls through 'push_qword' and through a plan
+    constexpr u64 CALL_COUNT = 1'000'000;
+    auto start = std::chrono::steady_clock::now();
+    i64 sum_binder = 0;
+    for (u64 i = 0; i < CALL_COUNT; i++)
+    {
+      for (size_t j = 0; j < std::size(ARGS); j++)
+        binder.push_qword(MADD_ARGS[j], ARGS[j]);
+      sum_binder += binder.call_fn((void*)madd, TypeOp::i64_t).as<i64>();
+    }
+    auto binder_time = std::chrono::steady_clock::now() - start;
+    start            = std::chrono::steady_clock::now();
+    i64 sum_plan     = 0;
+    for (u64 i = 0; i < CALL_COUNT; i++)
+      sum_plan += plans.get((void*)madd, ARGS, TypeOp::i64_t)
+                      .invoke(binder, MADD_ARGS)
+                      .as<i64>();
+    auto plan_time = std::chrono::steady_clock::now() - start;
+    if (sum_binder != sum_plan)
+    {
+      ++error_count;
+      io::print_error("FFI call plans do not match DynamicBinder!");
+    }
+    io::print_message(
+        "FFI throughput: {:.1f}ns/call (DynamicBinder), {:.1f}ns/call (CallPlan{}).",
+        std::chrono::duration<double, std::nano>(binder_time).count() / CALL_COUNT,
+        std::chrono::duration<double, std::nano>(plan_time).count() / CALL_COUNT,
+        is_native ? ", native" : "");
+
     auto current = DynamicLibrary::load_current();
     if (current.is_none())
     {
@@ -66,6 +121,22 @@ namespace clt::test
       ++error_count;
       return io::print_error("Dynamic lookup of function failed!");
     }
+    // Second lookup goes through the cache
+    if (lib.lookup("__CLT_NOP") != &__CLT_NOP)
+    {
+      ++error_count;
+      return io::print_error("Cached lookup of function failed!");
+    }
+
+    SymbolTable imports;
+    const u64 nop_slot = imports.import("__CLT_NOP");
+    imports.import("__CLT_DOES_NOT_EXIST");
+    if (imports.import("__CLT_NOP") != nop_slot || imports.size() != 2
+        || imports.bind(lib) != 1 || imports[nop_slot] != &__CLT_NOP)
+    {
+      ++error_count;
+      io::print_error("Binding of imported symbols failed!");
+    }
   }
 } // namespace clt::test
 
@@ -8,96 +8,124 @@
 #include "test_lexer.h"
 #include "lex/colt_token_buffer.h"
 #include "err/composable_reporter.h"
-#include <fstream>
 
 namespace clt::test
 {
-  void test_lexer(StringView file_path, u32& error_count) noexcept
+  template<typename... Args>
+  /// @brief Appends an error to a string
+  /// @param output The string to which to append
+  /// @param fmt The format string
+  /// @param ...args The arguments to format
+  static void append_error(
+      String& output, io::fmt_str<Args...> fmt, Args&&... args) noexcept
   {
-    io::print_message("Testing Lexer...");
-
-    using namespace lng;
-
-    auto reporter = make_error_reporter<SinkReporter>();
-
-    std::string str = {file_path.data(), file_path.size()};
-    std::ifstream is(str);
-    if (!is.good())
-    {
-      error_count++;
-      return io::print_error("Could not open file '{}'!", str);
-    }
+    String error;
+    fmt::format_to(std::back_inserter(error), fmt, std::forward<Args>(args)...);
+    lng::format_error(output, error, None, None);
+  }
 
+  Vector<LexerCase> split_lexer_cases(StringView content) noexcept
+  {
+    Vector<LexerCase> cases;
     // The line number in the file to report eventual errors
     u64 true_line_nb = 0;
-
-    bool consume_line = false;
-    // When multiple of 2, we are parsing the expected lexemes
-    // Else, we are parsing the string to lex.
-    u64 line_count = 0;
-    TokenBuffer buffer;
-    Vector<Lexeme> expected_lexemes{};
-    while (std::getline(is, str))
+    // The expected lexemes of the current case (if already read)
+    Option<StringView> expected = None;
+    u64 expected_line_nb        = 0;
+    while (!content.empty())
     {
+      const size_t end = content.find('\n');
+      auto line        = content.substr(0, end);
+      content = end == StringView::npos ? StringView{} : content.substr(end + 1);
+      if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
       true_line_nb++;
 
       // Skip lines starting with '#'
-      if (strip(str).starts_with("#"))
+      if (strip(line).starts_with("#"))
         continue;
-      if (line_count % 2 == 0)
+      if (expected.is_none())
       {
-        for (auto tkn_str : split_by_char(str, ' '))
-        {
-          auto try_cnv = reflect<Lexeme>::from(tkn_str);
-          if (try_cnv.is_none())
-          {
-            consume_line = true;
-            error_count++;
-            io::print_error(
-                "'{}' is not a valid lexeme (on line {}).", tkn_str, true_line_nb);
-            goto WHILE_END;
-          }
-          expected_lexemes.push_back(*try_cnv);
-        }
-        // add EOF
-        expected_lexemes.push_back(Lexeme::TKN_EOF);
+        expected         = line;
+        expected_line_nb = true_line_nb;
       }
       else
       {
-        // There was an error parsing expected lexemes so skip
-        if (!consume_line)
-        {
-          lex(buffer, *reporter, str);
-          for (size_t i = 0;
-               i < clt::min(buffer.token_buffer().size(), expected_lexemes.size());
-               i++)
-          {
-            if (expected_lexemes[i] != buffer.token_buffer()[i])
-            {
-              error_count++;
-              io::print_error(
-                  "Expected '{:h}' but Lexer returned '{:h}' instead (on line {})!",
-                  expected_lexemes[i], buffer.token_buffer()[i].lexeme(),
-                  true_line_nb);
-            }
-          }
-          if (buffer.token_buffer().size() != expected_lexemes.size())
-          {
-            error_count++;
-            io::print_error(
-                "Expected '{}' lexemes but Lexer returned '{}' instead (on line "
-                "{})!",
-                expected_lexemes.size(), buffer.token_buffer().size(), true_line_nb);
-          }
-          // To avoid constructing a TokenBuffer in each iteration
-          buffer.unsafe_clear();
-        }
-        else
-          consume_line = false;
-        expected_lexemes.clear();
+        cases.push_back(
+            LexerCase{*expected, line, expected_line_nb, true_line_nb});
+        expected = None;
       }
-    WHILE_END:
-      ++line_count;
     }
+    return cases;
+  }
+
+  u32 run_lexer_case(
+      const LexerCase& test, lng::TokenBuffer& buffer, String& output) noexcept
+  {
+    using namespace lng;
+
+    u32 error_count = 0;
+    Vector<Lexeme> expected_lexemes{};
+    for (auto tkn_str : split_by_char(test.expected, ' '))
+    {
+      auto try_cnv = reflect<Lexeme>::from(tkn_str);
+      if (try_cnv.is_none())
+      {
+        // The line to lex is skipped
+        append_error(
+            output, "'{}' is not a valid lexeme (on line {}).", tkn_str,
+            test.expected_line_nb);
+        return 1;
+      }
+      expected_lexemes.push_back(*try_cnv);
+    }
+    // add EOF
+    expected_lexemes.push_back(Lexeme::TKN_EOF);
+
+    // Each case has its own reporter
+    auto reporter = make_error_reporter<SinkReporter>();
+    lex(buffer, *reporter, test.to_lex);
+    for (size_t i = 0;
+         i < clt::min(buffer.token_buffer().size(), expected_lexemes.size()); i++)
+    {
+      if (expected_lexemes[i] != buffer.token_buffer()[i])
+      {
+        error_count++;
+        append_error(
+            output,
+            "Expected '{:h}' but Lexer returned '{:h}' instead (on line {})!",
+            expected_lexemes[i], buffer.token_buffer()[i].lexeme(), test.line_nb);
+      }
+    }
+    if (buffer.token_buffer().size() != expected_lexemes.size())
+    {
+      error_count++;
+      append_error(
+          output,
+          "Expected '{}' lexemes but Lexer returned '{}' instead (on line {})!",
+          expected_lexemes.size(), buffer.token_buffer().size(), test.line_nb);
+    }
+    // To avoid constructing a TokenBuffer for each case
+    buffer.unsafe_clear();
+    return error_count;
+  }
+
+  void test_lexer(StringView file_path, u32& error_count) noexcept
+  {
+    io::print_message("Testing Lexer...");
+
+    std::string str = {file_path.data(), file_path.size()};
+    auto file       = String::getFile(str.c_str());
+    if (file.is_error())
+    {
+      error_count++;
+      return io::print_error("Could not open file '{}'!", str);
+    }
+
+    lng::TokenBuffer buffer;
+    String output;
+    for (auto& test : split_lexer_cases(*file))
+      error_count += run_lexer_case(test, buffer, output);
+    std::fwrite(output.data(), 1, output.size(), stdout);
   }
-} // namespace clt::test
\ No newline at end of file
+} // namespace clt::test
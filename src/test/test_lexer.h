@@ -9,10 +9,38 @@
 #define HG_COLT_TEST_LEXER
 
 #include "lex/colt_lexer.h"
+#include "lex/colt_token_buffer.h"
 #include "err/composable_reporter.h"
 
 namespace clt::test
 {
+  /// @brief A case of a lexer test file
+  struct LexerCase
+  {
+    /// @brief The line of expected lexemes (separated by spaces)
+    StringView expected;
+    /// @brief The line to lex
+    StringView to_lex;
+    /// @brief The line number of 'expected' in the file
+    u64 expected_line_nb;
+    /// @brief The line number of 'to_lex' in the file
+    u64 line_nb;
+  };
+
+  /// @brief Splits the content of a lexer test file into cases
+  /// (see 'test_lexer' for the format).
+  /// @param content The content of the file
+  /// @return The cases of the file
+  Vector<LexerCase> split_lexer_cases(StringView content) noexcept;
+
+  /// @brief Runs a lexer test case
+  /// @param test The case to run
+  /// @param buffer The buffer in which to lex (reused between cases)
+  /// @param output The string to which to append the errors
+  /// @return The count of errors
+  u32 run_lexer_case(
+      const LexerCase& test, lng::TokenBuffer& buffer, String& output) noexcept;
+
   /// @brief Tests the lexer using a file.
   /// The file should follow a specific format:
   /// Starts with the expected tokens on a line (without TKN_EOF), followed
@@ -0,0 +1,138 @@
+/*****************************************************************/ /**
+ * @file   test_low_memory.cpp
+ * @brief  Contains the implementation of 'test_low_memory'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <fstream>
+
+#include "test_low_memory.h"
+#include "ast/parsed_unit.h"
+#include "err/composable_reporter.h"
+
+namespace clt::test
+{
+  /// @brief The source parsed by the test (whose expressions span lines)
+  static constexpr std::string_view LOW_MEMORY_SOURCE =
+      "global a = 1 + 2 * 3;\n"
+      "global b = (4 -\n"
+      "  5) << 2;\n"
+      "{\n"
+      "  var c = 7;\n"
+      "  var d = 8 * (9 +\n"
+      "    10);\n"
+      "}\n"
+      "global e = -(1 + 1);\n";
+
+  /// @brief Writes a file (overwriting it)
+  /// @param path The path of the file
+  /// @param content The content of the file
+  static void write_file(
+      const std::filesystem::path& path, std::string_view content) noexcept
+  {
+    auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+
+  /// @brief Returns the unit of the start file of a program
+  /// @param program The program
+  /// @return The unit of the start file
+  static const lng::ParsedUnit& start_unit(const lng::ParsedProgram& program) noexcept
+  {
+    return program.units().find(lng::ParsedProgram::EMPTY_PATH)->second;
+  }
+
+  /// @brief Check if two source information are equal
+  /// @param a The first source information
+  /// @param b The second source information
+  /// @return True if they describe the same lines and expression
+  static bool same_info(const lng::SourceInfo& a, const lng::SourceInfo& b) noexcept
+  {
+    return a.line_begin == b.line_begin && a.line_end == b.line_end
+           && a.lines == b.lines && a.expr == b.expr
+           && a.expr.data() - a.lines.data() == b.expr.data() - b.lines.data();
+  }
+
+  void test_low_memory(u32& error_count) noexcept
+  {
+    io::print_message("Testing low-memory mode...");
+    const auto path = std::filesystem::temp_directory_path() / "colt_test_low_memory.ct";
+    write_file(path, LOW_MEMORY_SOURCE);
+    ON_SCOPE_EXIT
+    {
+      std::error_code err;
+      std::filesystem::remove(path, err);
+    };
+
+    const Vector<std::filesystem::path> includes = {};
+    const auto warn_for = lng::WarnFor::warn_all();
+    auto reporter       = lng::make_error_reporter<lng::SinkReporter>();
+    auto full           = lng::ParsedProgram{*reporter, path, includes, warn_for};
+    auto compact =
+        lng::ParsedProgram{*reporter, path, includes, warn_for, nullptr, true};
+    auto& full_unit    = start_unit(full);
+    auto& compact_unit = start_unit(compact);
+    if (reporter->error_count() != 0 || full_unit.is_compact()
+        || !compact_unit.is_compact())
+    {
+      ++error_count;
+      io::print_error("The units were not parsed (or compacted) as expected!");
+      return;
+    }
+
+    auto& exprs         = full_unit.expr_buffer();
+    auto& compact_exprs = compact_unit.expr_buffer();
+    if (exprs.prod_count() != compact_exprs.prod_count()
+        || exprs.stmt_count() != compact_exprs.stmt_count())
+    {
+      ++error_count;
+      io::print_error("Compacted unit has a different count of expressions!");
+      return;
+    }
+    // The units are parsed from the same source: their expressions (and
+    // the ranges of their expressions) are the same
+    const auto check = [&](lng::TokenRange range, lng::TokenRange compact_range,
+                           StringView kind, u32 index)
+    {
+      auto expected = full_unit.token_buffer().make_source_info(range);
+      auto info     = compact_unit.source_info(compact_range);
+      if (info.is_none() || !same_info(expected, *info))
+      {
+        ++error_count;
+        io::print_error("Invalid source information of {} {}!", kind, index);
+      }
+    };
+    for (u32 i = 0; i < exprs.prod_count(); i++)
+    {
+      check(
+          exprs.expr(lng::ProdExprToken{i}).token_range(),
+          compact_exprs.expr(lng::ProdExprToken{i}).token_range(), "producer", i);
+    }
+    for (u32 i = 0; i < exprs.stmt_count(); i++)
+    {
+      check(
+          exprs.expr(lng::StmtExprToken{i}).token_range(),
+          compact_exprs.expr(lng::StmtExprToken{i}).token_range(), "statement", i);
+    }
+
+    // A file modified after being compacted (without changing its size)
+    // must not be used to report diagnostics
+    auto modified =
+        lng::ParsedProgram{*reporter, path, includes, warn_for, nullptr, true};
+    auto source = std::string{LOW_MEMORY_SOURCE};
+    source[source.find('7')] = '9';
+    write_file(path, source);
+    auto& modified_unit = start_unit(modified);
+    if (modified_unit.expr_buffer().stmt_count() != 0
+        && modified_unit
+               .source_info(modified_unit.expr_buffer()
+                                .expr(lng::StmtExprToken{0})
+                                .token_range())
+               .is_value())
+    {
+      ++error_count;
+      io::print_error("Modified source was used after compacting!");
+    }
+  }
+} // namespace clt::test
@@ -0,0 +1,23 @@
+/*****************************************************************/ /**
+ * @file   test_low_memory.h
+ * @brief  Tests for the low-memory mode, in which the tokens of each
+ * unit are discarded once its AST is built.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_LOW_MEMORY
+#define HG_COLT_TEST_LOW_MEMORY
+
+#include "ast/parsed_program.h"
+
+namespace clt::test
+{
+  /// @brief Tests that the source information of the expressions of a
+  /// compacted unit is the same as before compacting it, and that a
+  /// modified source is detected.
+  /// @param error_count The error count to increment on errors
+  void test_low_memory(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_LOW_MEMORY
@@ -0,0 +1,291 @@
+/*****************************************************************/ /**
+ * @file   test_module_image.cpp
+ * @brief  Contains the implementation of 'test_module_image'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstring>
+
+#include "test_module_image.h"
+#include "ast/parsed_program.h"
+#include "err/composable_reporter.h"
+#include "io/mapped_file.h"
+
+namespace clt::test
+{
+  /// @brief A unit added to the image, and its module
+  struct ImageUnit
+  {
+    /// @brief The source of the unit
+    StringView source;
+    /// @brief The name of the module
+    std::array<StringView, 2> module;
+    /// @brief The count of parts of the name of the module
+    u32 depth;
+  };
+
+  /// @brief The units from which the image is built
+  static constexpr std::array<ImageUnit, 5> IMAGE_UNITS = {
+      ImageUnit{"global a = 1; global mut b = 2.5;", {}, 0},
+      ImageUnit{"global c = 3u8;", {"std"}, 1},
+      ImageUnit{"global e = 4i16; global d = true;", {"std", "io"}, 2},
+      ImageUnit{"global f = 5u64;", {"std", "mem"}, 2},
+      ImageUnit{"global g = 6;", {"core"}, 1},
+  };
+
+  /// @brief The bytes of an image (8-byte aligned, as required by 'load')
+  struct ImageBytes
+  {
+    /// @brief The storage of the bytes
+    Vector<u64> words;
+    /// @brief The size of the image
+    u64 size;
+
+    /// @brief Returns the bytes of the image
+    /// @return The bytes of the image
+    View<u8> bytes() const noexcept
+    {
+      return View<u8>{reinterpret_cast<const u8*>(words.data()), size};
+    }
+
+    /// @brief Returns the header of the image
+    /// @return The header
+    lng::ModuleImageHeader header() const noexcept
+    {
+      lng::ModuleImageHeader header;
+      std::memcpy(&header, words.data(), sizeof(header));
+      return header;
+    }
+
+    template<typename T>
+    /// @brief Overwrites bytes of the image
+    /// @param offset The offset of the bytes
+    /// @param value The value to write (little endian)
+    void patch(u64 offset, T value) noexcept
+    {
+      value = htol(value);
+      std::memcpy(reinterpret_cast<u8*>(words.data()) + offset, &value, sizeof(T));
+    }
+
+    /// @brief Returns the offset of a record of the modules section
+    /// @param index The index of the module
+    /// @return The offset of the record
+    u64 module_offset(u32 index) const noexcept
+    {
+      const auto h = header();
+      return sizeof(lng::ModuleImageHeader)
+             + u64{ltoh(h.type_count)} * sizeof(lng::ImageTypeRecord)
+             + u64{ltoh(h.fn_payload_count)} * sizeof(lng::ImageFnPayloadRecord)
+             + u64{ltoh(h.fn_arg_count)} * sizeof(lng::ImageFnArgRecord)
+             + u64{index} * sizeof(lng::ImageModuleRecord);
+    }
+  };
+
+  /// @brief Builds the image of IMAGE_UNITS
+  /// @param error_count The error count to increment on errors
+  /// @return The bytes of the image or None
+  static Option<ImageBytes> build_image(u32& error_count) noexcept
+  {
+    using namespace lng;
+
+    const Vector<std::filesystem::path> includes = {};
+    auto reporter = make_error_reporter<SinkReporter>();
+    auto program  = ParsedProgram{*reporter, includes, WarnFor::warn_all()};
+    auto builder  = ModuleImageBuilder{program.type_buffer()};
+    for (auto& [source, module, depth] : IMAGE_UNITS)
+    {
+      auto unit = ParsedUnit{program, source};
+      if (unit.parse() != ParsedUnit::SUCCESS
+          || builder.add_unit(unit, View<StringView>{module.data(), depth}).is_error())
+      {
+        ++error_count;
+        io::print_error("'{}' could not be added to the image!", source);
+        return None;
+      }
+    }
+    // Globals of a module must have distinct names
+    auto duplicate = ParsedUnit{program, StringView{"global c = 7;"}};
+    const std::array<StringView, 1> std_module = {"std"};
+    if (duplicate.parse() != ParsedUnit::SUCCESS
+        || builder.add_unit(duplicate, std_module).is_success())
+    {
+      ++error_count;
+      io::print_error("A duplicate global was added to the image!");
+    }
+
+    std::error_code error;
+    const auto path =
+        (std::filesystem::temp_directory_path(error) / "colt_test_module_image.bin")
+            .string();
+    if (error || builder.write(path.c_str()).is_error())
+    {
+      ++error_count;
+      io::print_error("The image could not be written!");
+      return None;
+    }
+    auto mapped = io::MappedFile::open(path.c_str());
+    if (mapped.is_none())
+    {
+      ++error_count;
+      io::print_error("The image could not be mapped!");
+      return None;
+    }
+    const auto bytes = mapped->bytes();
+    auto image       = ImageBytes{
+        Vector<u64>((bytes.size() + 7) / 8, InPlace, u64{0}), bytes.size()};
+    std::memcpy(image.words.data(), bytes.data(), bytes.size());
+    mapped = None;
+    std::filesystem::remove(path, error);
+    return image;
+  }
+
+  void test_module_image(u32& error_count) noexcept
+  {
+    using namespace lng;
+
+    io::print_message("Testing module image...");
+    auto built = build_image(error_count);
+    if (built.is_none())
+      return;
+    const auto expect = [&](bool condition, StringView what) noexcept
+    {
+      if (condition)
+        return;
+      ++error_count;
+      io::print_error("Module image: {}!", what);
+    };
+
+    auto image = ModuleImage::load(built->bytes(), true);
+    if (image.is_none())
+    {
+      ++error_count;
+      io::print_error("The image could not be loaded!");
+      return;
+    }
+
+    // Modules: {} (global), core, std, std.io, std.mem
+    const std::array<StringView, 2> std_io = {"std", "io"};
+    auto global  = image->find_module(View<StringView>{});
+    auto std_mod = image->find_module(View<StringView>{std_io.data(), 1});
+    auto io_mod  = image->find_module(std_io);
+    expect(image->module_count() == 5, "invalid module count");
+    expect(global.is_value() && *global == 0, "the global module was not found");
+    expect(std_mod.is_value() && io_mod.is_value(), "'std.io' was not found");
+    if (std_mod.is_value() && io_mod.is_value())
+    {
+      auto io_rec = image->module(*io_mod);
+      expect(
+          io_rec.is_value() && io_rec->name == "io" && io_rec->parent == *std_mod,
+          "invalid record for 'std.io'");
+    }
+    const std::array<StringView, 2> missing = {"std", "missing"};
+    const std::array<StringView, 1> io_only = {"io"};
+    expect(image->find_module(missing).is_none(), "'std.missing' was found");
+    expect(image->find_module(io_only).is_none(), "'io' was found in the global module");
+
+    // Globals
+    expect(image->global_count() == 7, "invalid global count");
+    auto b = image->find_global(0, "b");
+    expect(b.is_value() && b->is_mut, "'b' was not found or is not mutable");
+    if (io_mod.is_value())
+    {
+      auto e = image->find_global(*io_mod, "e");
+      expect(
+          e.is_value() && !e->is_mut && e->value.is_value()
+              && e->value->as<i16>() == 4,
+          "'std.io.e' was not found or has an invalid value");
+      expect(image->find_global(*io_mod, "c").is_none(), "'c' was found in 'std.io'");
+
+      // The tokens of the interned types are the ones of the image
+      TypeBuffer types;
+      expect(image->intern_types(types).is_success(), "the types were not interned");
+      expect(
+          types.type_count() == image->type_count(), "invalid count of interned types");
+      expect(
+          e.is_value() && types.add_builtin(BuiltinID::I16) == e->type
+              && types.type_count() == image->type_count(),
+          "the type of 'std.io.e' was not interned with the same token");
+    }
+    if (std_mod.is_value())
+      expect(image->find_global(*std_mod, "d").is_none(), "'d' was found in 'std'");
+    ModuleBuffer modules;
+    expect(image->create_modules(modules).is_success(), "the modules were not created");
+
+    // Linking only interns the types: modules are created on first import
+    {
+      const Vector<std::filesystem::path> includes = {};
+      auto reporter = make_error_reporter<SinkReporter>();
+      auto program =
+          ParsedProgram{*reporter, includes, WarnFor::warn_all(), &*image};
+      expect(
+          reporter->error_count() == 0 && program.linked_image() == &*image
+              && program.image_module_count() == 0,
+          "modules were created when linking the image");
+      expect(
+          program.import_unit("std.io") && program.image_module_count() == 2,
+          "'std.io' and its parent were not created on import");
+      expect(
+          program.import_unit("std") && program.import_unit("std.io")
+              && program.image_module_count() == 2,
+          "an imported module was created again");
+      expect(
+          program.import_unit("core") && program.image_module_count() == 3,
+          "'core' was not created on import");
+      expect(
+          !program.import_unit("std.missing") && !program.import_unit("std..io")
+              && !program.import_unit("io") && program.image_module_count() == 3,
+          "a missing module was imported");
+    }
+
+    // Invalid images
+    const auto bytes = built->bytes();
+    expect(
+        ModuleImage::load(View<u8>{bytes.data(), bytes.size() - 1}).is_none()
+            && ModuleImage::load(View<u8>{bytes.data(), sizeof(ModuleImageHeader) - 8})
+                   .is_none(),
+        "a truncated image was loaded");
+
+    auto wrong_magic = *built;
+    wrong_magic.patch<u64>(0, ModuleImageHeader::MAGIC_NUMBER + 1);
+    expect(
+        ModuleImage::load(wrong_magic.bytes()).is_none(),
+        "an image with a wrong magic number was loaded");
+
+    // Only the header is validated on load: records are validated on use
+    auto wrong_parent = *built;
+    wrong_parent.patch<u32>(
+        wrong_parent.module_offset(1) + offsetof(ImageModuleRecord, parent), 5);
+    auto loaded = ModuleImage::load(wrong_parent.bytes());
+    ModuleBuffer wrong_modules;
+    expect(
+        loaded.is_value() && loaded->module(1).is_none()
+            && loaded->create_modules(wrong_modules).is_error(),
+        "a module with an out of range parent was created");
+    expect(
+        ModuleImage::load(wrong_parent.bytes(), true).is_none(),
+        "an image with an invalid checksum was loaded");
+
+    auto wrong_payload = *built;
+    const u32 last     = image->type_count() - 1;
+    const u64 offset   = sizeof(ModuleImageHeader) + u64{last} * sizeof(ImageTypeRecord);
+    wrong_payload.patch<u8>(
+        offset + offsetof(ImageTypeRecord, id), static_cast<u8>(TypeID::TYPE_PTR));
+    wrong_payload.patch<u32>(offset + offsetof(ImageTypeRecord, payload), last);
+    loaded = ModuleImage::load(wrong_payload.bytes());
+    TypeBuffer wrong_types;
+    expect(
+        loaded.is_value() && loaded->intern_types(wrong_types).is_error(),
+        "a pointer to an out of range type was interned");
+    wrong_payload.patch<u8>(
+        offset + offsetof(ImageTypeRecord, id), static_cast<u8>(TypeID::TYPE_FN));
+    wrong_payload.patch<u32>(
+        offset + offsetof(ImageTypeRecord, payload),
+        ltoh(wrong_payload.header().fn_payload_count));
+    loaded = ModuleImage::load(wrong_payload.bytes());
+    TypeBuffer wrong_fn_types;
+    expect(
+        loaded.is_value() && loaded->intern_types(wrong_fn_types).is_error(),
+        "a function with an out of range payload was interned");
+  }
+} // namespace clt::test
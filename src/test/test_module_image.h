@@ -0,0 +1,21 @@
+/*****************************************************************/ /**
+ * @file   test_module_image.h
+ * @brief  Tests for ModuleImage, the prebuilt binary image of modules.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_MODULE_IMAGE
+#define HG_COLT_TEST_MODULE_IMAGE
+
+#include "ast/module_image.h"
+
+namespace clt::test
+{
+  /// @brief Tests that an image built from units can be loaded and
+  /// searched, and that truncated or corrupted images are rejected.
+  /// @param error_count The error count to increment on errors
+  void test_module_image(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_MODULE_IMAGE
@@ -0,0 +1,167 @@
+/*****************************************************************/ /**
+ * @file   test_position_index.cpp
+ * @brief  Contains the implementation of 'test_position_index'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "test_position_index.h"
+#include "ast/parsed_unit.h"
+#include "err/composable_reporter.h"
+
+namespace clt::test
+{
+  /// @brief The source indexed by the test
+  static constexpr std::string_view POSITION_SOURCE =
+      "global a = 1 + 2 * 3;\n"
+      "global b = (4 -\n"
+      "  5) << 2;\n"
+      "{\n"
+      "  var c = 7;\n"
+      "  if true: var d = 8;\n"
+      "  else:  var e = (9 + 10) * 2;\n"
+      "}\n"
+      "  global f = -(1 + 1);  \n";
+
+  /// @brief An expression (or token) and its span
+  struct ExpectedSpan
+  {
+    /// @brief The beginning offset
+    u32 begin;
+    /// @brief The end offset (non-inclusive)
+    u32 end;
+    /// @brief The order of creation of the expression
+    u32 order;
+    /// @brief The expression (null for tokens)
+    const lng::ExprBase* expr;
+  };
+
+  /// @brief Converts a source information to offsets in the source
+  /// @param info The source information
+  /// @param lines The offset of the beginning of each line
+  /// @return The beginning and end offsets of the expression
+  static std::pair<u32, u32> offsets_of(
+      const lng::SourceInfo& info, const Vector<u32>& lines) noexcept
+  {
+    const u32 begin =
+        lines[info.line_begin - 1] + static_cast<u32>(info.expr.data() - info.lines.data());
+    return {begin, begin + static_cast<u32>(info.expr.size())};
+  }
+
+  /// @brief Returns the innermost expression containing an offset (linear scan)
+  /// @param spans The spans of the expressions
+  /// @param offset The offset
+  /// @return The innermost expression or null
+  static const lng::ExprBase* innermost_at(
+      const Vector<ExpectedSpan>& spans, u32 offset) noexcept
+  {
+    const ExpectedSpan* best = nullptr;
+    for (auto& span : spans)
+    {
+      if (offset < span.begin || offset >= span.end)
+        continue;
+      if (best == nullptr)
+      {
+        best = &span;
+        continue;
+      }
+      const u32 size      = span.end - span.begin;
+      const u32 best_size = best->end - best->begin;
+      // On ties, a scope is the outer expression, then the last created
+      const bool scope      = span.expr->classof() == lng::ExprID::EXPR_SCOPE;
+      const bool best_scope = best->expr->classof() == lng::ExprID::EXPR_SCOPE;
+      if (size < best_size
+          || (size == best_size
+              && (scope != best_scope ? best_scope : span.order < best->order)))
+        best = &span;
+    }
+    return best == nullptr ? nullptr : best->expr;
+  }
+
+  void test_position_index(u32& error_count) noexcept
+  {
+    io::print_message("Testing position index...");
+    const Vector<std::filesystem::path> includes = {};
+    auto reporter = lng::make_error_reporter<lng::SinkReporter>();
+    auto program  = lng::ParsedProgram{
+        *reporter, StringView{POSITION_SOURCE.data(), POSITION_SOURCE.size()},
+        includes, lng::WarnFor::warn_all()};
+    auto& unit = program.units().find(lng::ParsedProgram::EMPTY_PATH)->second;
+    if (reporter->error_count() != 0)
+    {
+      ++error_count;
+      io::print_error("The source of the position index test did not parse!");
+      return;
+    }
+
+    Vector<u32> lines;
+    lines.push_back(0);
+    for (u32 i = 0; i < POSITION_SOURCE.size(); i++)
+      if (POSITION_SOURCE[i] == '\n')
+        lines.push_back(i + 1);
+
+    auto& buffer = unit.token_buffer();
+    Vector<ExpectedSpan> tokens;
+    for (auto& token : buffer.token_buffer())
+    {
+      auto [begin, end] = offsets_of(buffer.make_source_info(token), lines);
+      if (begin != end)
+        tokens.push_back(ExpectedSpan{begin, end, 0, nullptr});
+    }
+    auto& exprs = unit.expr_buffer();
+    Vector<ExpectedSpan> spans;
+    for (u32 i = 0; i < exprs.prod_count(); i++)
+    {
+      auto& expr        = exprs.expr(lng::ProdExprToken{i});
+      auto [begin, end] = offsets_of(buffer.make_source_info(expr.token_range()), lines);
+      spans.push_back(ExpectedSpan{begin, end, i, expr.as_base()});
+    }
+    for (u32 i = 0; i < exprs.stmt_count(); i++)
+    {
+      auto& expr        = exprs.expr(lng::StmtExprToken{i});
+      auto [begin, end] = offsets_of(buffer.make_source_info(expr.token_range()), lines);
+      spans.push_back(
+          ExpectedSpan{begin, end, exprs.prod_count() + i, expr.as_base()});
+    }
+
+    u32 line   = 1;
+    u32 column = 1;
+    for (u32 offset = 0; offset < POSITION_SOURCE.size(); offset++)
+    {
+      // The beginning of the token containing the offset (linear scan)
+      u32 expected_token = std::numeric_limits<u32>::max();
+      for (auto& token : tokens)
+        if (token.begin <= offset && offset < token.end)
+          expected_token = token.begin;
+      auto token      = unit.token_at(line, column);
+      u32 token_begin = std::numeric_limits<u32>::max();
+      if (token.is_value())
+        token_begin = offsets_of(buffer.make_source_info(*token), lines).first;
+      if (token_begin != expected_token)
+      {
+        ++error_count;
+        io::print_error("Invalid token at {}:{}!", line, column);
+      }
+      if (unit.expr_at(line, column) != innermost_at(spans, offset))
+      {
+        ++error_count;
+        io::print_error("Invalid expression at {}:{}!", line, column);
+      }
+
+      if (POSITION_SOURCE[offset] == '\n')
+      {
+        ++line;
+        column = 1;
+      }
+      else
+        ++column;
+    }
+    // Positions outside of the source
+    if (unit.token_at(line + 1, 1).is_value() || unit.expr_at(1, 1000) != nullptr
+        || unit.expr_at(0, 1) != nullptr)
+    {
+      ++error_count;
+      io::print_error("Positions outside of the source were accepted!");
+    }
+  }
+} // namespace clt::test
@@ -0,0 +1,22 @@
+/*****************************************************************/ /**
+ * @file   test_position_index.h
+ * @brief  Tests for PositionIndex, which maps positions to tokens and
+ * expressions.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_POSITION_INDEX
+#define HG_COLT_TEST_POSITION_INDEX
+
+#include "ast/parsed_program.h"
+
+namespace clt::test
+{
+  /// @brief Tests that 'token_at' and 'expr_at' return the same results
+  /// as a linear scan of the tokens and expressions, at every position.
+  /// @param error_count The error count to increment on errors
+  void test_position_index(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_POSITION_INDEX
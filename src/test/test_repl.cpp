@@ -0,0 +1,189 @@
+/*****************************************************************/ /**
+ * @file   test_repl.cpp
+ * @brief  Contains the implementation of 'test_repl'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "test_repl.h"
+#include "ast/ast.h"
+
+namespace clt::test
+{
+  /// @brief Tests FlatList::operator[], pop_back_n and the iterators across nodes
+  /// @param error_count The error count to increment on errors
+  static void test_flat_list(u32& error_count) noexcept
+  {
+    // Few items per node, so that the items span many nodes
+    FlatList<u32, 4> list;
+    const auto check = [&](u32 size, StringView step)
+    {
+      bool valid = list.size() == size && (size == 0 || list.back() == size - 1);
+      // Items are accessed from both ends of the list
+      for (u32 i = 0; valid && i < size; i++)
+        valid = list[i] == i;
+      if (!valid)
+      {
+        ++error_count;
+        io::print_error("Invalid FlatList after {}!", step);
+      }
+    };
+
+    for (u32 i = 0; i < 37; i++)
+      list.push_back(i);
+    check(37, "push_back");
+    // Iterators advance across nodes (as when walking sorted indices)
+    auto it = list.begin();
+    for (u32 i : {0u, 3u, 4u, 11u, 12u, 36u})
+    {
+      it += i - *it;
+      if (*it != i)
+      {
+        ++error_count;
+        io::print_error("Invalid FlatList iterator after += {}!", i);
+        break;
+      }
+    }
+    list.pop_back_n(5);
+    check(32, "pop_back_n to the end of a node");
+    list.pop_back_n(1);
+    check(31, "pop_back_n in a full node");
+    list.pop_back_n(15);
+    check(16, "pop_back_n across nodes");
+    for (u32 i = 16; i < 50; i++)
+      list.push_back(i);
+    check(50, "push_back after pop_back_n");
+    list.pop_back_n(50);
+    check(0, "pop_back_n of all the items");
+    for (u32 i = 0; i < 9; i++)
+      list.push_back(i);
+    check(9, "push_back in an emptied list");
+  }
+
+  /// @brief Tests a session whose first line is rejected
+  /// @param error_count The error count to increment on errors
+  static void test_rejected_first_line(u32& error_count) noexcept
+  {
+    using namespace lng;
+
+    auto reporter = make_error_reporter<SinkReporter>();
+    const Vector<std::filesystem::path> includes = {};
+    auto session = ReplSession{*reporter, includes, WarnFor::warn_all()};
+    // The next line must be parsed as if it were the first one
+    if (session.add_line("global alpha = ;") != ParsedUnit::COMP_ERROR
+        || session.unit().is_parsed())
+    {
+      ++error_count;
+      return io::print_error("An invalid first REPL line was accepted!");
+    }
+    if (session.add_line("global alpha = 1;") != ParsedUnit::SUCCESS
+        || session.add_line("global beta = 2;") != ParsedUnit::SUCCESS)
+    {
+      ++error_count;
+      return io::print_error("Valid REPL lines were rejected after the first line!");
+    }
+    if (session.line_count() != 2 || session.rejected_count() != 1
+        || session.unit().expr_buffer().top_level_stmts().size() != 2)
+    {
+      ++error_count;
+      io::print_error("Invalid REPL session after a rejected first line!");
+    }
+  }
+
+  void test_repl(u32& error_count) noexcept
+  {
+    using namespace lng;
+
+    io::print_message("Testing REPL sessions...");
+    test_flat_list(error_count);
+    test_rejected_first_line(error_count);
+
+    auto reporter = make_error_reporter<SinkReporter>();
+    const Vector<std::filesystem::path> includes = {};
+    auto session = ReplSession{*reporter, includes, WarnFor::warn_all()};
+    auto& unit   = session.unit();
+
+    if (session.add_line("global alpha = 1;") != ParsedUnit::SUCCESS
+        || session.add_line("{ var beta = 2 * 3; }") != ParsedUnit::SUCCESS)
+    {
+      ++error_count;
+      return io::print_error("Valid REPL lines were rejected!");
+    }
+    const auto tokens = unit.token_buffer().checkpoint();
+    const auto exprs  = unit.expr_buffer().checkpoint();
+
+    // 'gamma' is interned by the rejected line
+    if (session.add_line("global gamma = ;") != ParsedUnit::COMP_ERROR
+        || session.add_line("{ var delta = 4;") != ParsedUnit::COMP_ERROR)
+    {
+      ++error_count;
+      return io::print_error("Invalid REPL lines were accepted!");
+    }
+    const auto rolled_tokens = unit.token_buffer().checkpoint();
+    const auto rolled_exprs  = unit.expr_buffer().checkpoint();
+    if (rolled_tokens.tokens != tokens.tokens || rolled_tokens.lines != tokens.lines
+        || rolled_tokens.nb_literals != tokens.nb_literals
+        || rolled_exprs.prod_expr != exprs.prod_expr
+        || rolled_exprs.stmt_expr != exprs.stmt_expr
+        || rolled_exprs.top_level != exprs.top_level)
+    {
+      ++error_count;
+      io::print_error("Rejected REPL lines were not rolled back!");
+    }
+
+    if (session.add_line("global gamma = 7;") != ParsedUnit::SUCCESS
+        || session.add_line("global zeta = 8;") != ParsedUnit::SUCCESS)
+    {
+      ++error_count;
+      return io::print_error("Valid REPL lines were rejected after a rollback!");
+    }
+    if (session.line_count() != 4 || session.rejected_count() != 2)
+    {
+      ++error_count;
+      io::print_error(
+          "Invalid count of REPL lines ({} accepted, {} rejected)!",
+          session.line_count(), session.rejected_count());
+    }
+
+    // The identifiers of the accepted lines, in order
+    const StringView IDENTIFIERS[] = {"alpha", "beta", "gamma", "zeta"};
+    u64 count          = 0;
+    auto& token_buffer = unit.token_buffer();
+    for (auto& token : token_buffer.token_buffer())
+    {
+      if (token != Lexeme::TKN_IDENTIFIER)
+        continue;
+      if (count == std::size(IDENTIFIERS)
+          || token_buffer.identifier(token) != IDENTIFIERS[count])
+      {
+        ++error_count;
+        io::print_error("Invalid identifier in REPL line!");
+        break;
+      }
+      ++count;
+    }
+
+    // The globals of the accepted lines, in order
+    const StringView GLOBALS[] = {"alpha", "gamma", "zeta"};
+    auto top_level             = unit.expr_buffer().top_level_stmts();
+    count                      = 0;
+    for (auto stmt : top_level)
+    {
+      if (stmt->classof() != ExprID::EXPR_GLOBAL_DECL)
+        continue;
+      auto& global = static_cast<const GlobalDeclExpr&>(*stmt);
+      if (count == std::size(GLOBALS) || global.global_name() != GLOBALS[count])
+      {
+        ++error_count;
+        io::print_error("Invalid global declared by REPL line!");
+        break;
+      }
+      ++count;
+    }
+    if (top_level.size() != 4 || count != std::size(GLOBALS))
+    {
+      ++error_count;
+      io::print_error("Invalid top-level statements after REPL lines!");
+    }
+  }
+} // namespace clt::test
@@ -0,0 +1,22 @@
+/*****************************************************************/ /**
+ * @file   test_repl.h
+ * @brief  Tests for REPL sessions, and the rollback of rejected lines.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_REPL
+#define HG_COLT_TEST_REPL
+
+#include "ast/repl_session.h"
+#include "err/composable_reporter.h"
+
+namespace clt::test
+{
+  /// @brief Tests that rejected REPL lines are rolled back, leaving the
+  /// lines accepted before them intact.
+  /// @param error_count The error count to increment on errors
+  void test_repl(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_REPL
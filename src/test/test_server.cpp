@@ -0,0 +1,147 @@
+/*****************************************************************/ /**
+ * @file   test_server.cpp
+ * @brief  Contains the implementation of 'test_server'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <bit>
+
+#include "test_server.h"
+#include "io/print.h"
+
+namespace clt::test
+{
+  /// @brief Check if two requests are equal
+  /// @param a The first request
+  /// @param b The second request
+  /// @return True if all the fields are equal
+  static bool same_request(
+      const server::CompileRequest& a, const server::CompileRequest& b) noexcept
+  {
+    if (StringView{a.cwd} != StringView{b.cwd} || a.files.size() != b.files.size()
+        || std::bit_cast<u8>(a.warn_for) != std::bit_cast<u8>(b.warn_for)
+        || a.color != b.color || a.mem_report != b.mem_report
+        || a.low_memory != b.low_memory || a.indent != b.indent
+        || StringView{a.image} != StringView{b.image}
+        || StringView{a.output} != StringView{b.output})
+      return false;
+    for (size_t i = 0; i < a.files.size(); i++)
+      if (StringView{a.files[i]} != StringView{b.files[i]})
+        return false;
+    return true;
+  }
+
+  void test_server(u32& error_count) noexcept
+  {
+    using namespace clt::server;
+    io::print_message("Testing compile server requests...");
+
+    CompileRequest request;
+    request.cwd = "/home/user/project with spaces";
+    request.files.push_back(String{"main.ct"});
+    request.files.push_back(String{"../lib/a b.ct"});
+    request.warn_for.ast_var_shadowing    = false;
+    request.warn_for.constant_folding_nan = false;
+    request.color                         = false;
+    request.mem_report                    = true;
+    request.low_memory                    = true;
+    request.indent                        = 4;
+    request.image                         = StringView{"build/std image.cti"};
+    request.output                        = StringView{"out/main.c"};
+
+    const auto encoded = encode_request(request);
+    const auto view    = StringView{encoded};
+    auto decoded       = decode_request(view);
+    if (decoded.is_none() || !same_request(request, *decoded))
+    {
+      ++error_count;
+      io::print_error("Request did not survive encoding and decoding!");
+    }
+
+    // A request without files is valid
+    CompileRequest empty;
+    decoded = decode_request(StringView{encode_request(empty)});
+    if (decoded.is_none() || !same_request(empty, *decoded))
+    {
+      ++error_count;
+      io::print_error("Empty request did not survive encoding and decoding!");
+    }
+
+    // Truncating the request must not crash, and is detected as long as
+    // the protocol or the flags line is incomplete
+    const size_t flags_end = view.find('\n', view.find("flags ")) + 1;
+    for (size_t i = 0; i < view.size(); i++)
+    {
+      auto truncated = decode_request(view.substr(0, i));
+      const bool cut_line =
+          i < PROTOCOL.size() || (i > view.find("flags ") && i < flags_end - 1);
+      if (cut_line && truncated.is_value())
+      {
+        ++error_count;
+        io::print_error("Request truncated to {} bytes was accepted!", i);
+      }
+    }
+
+    const StringView invalid[] = {
+        "",
+        "colt-serve 0\ncwd /\n",
+        "cwd /\nfile a.ct\n",
+        "colt-serve 1\ncwd /\n",
+        "colt-serve 2\nflags 1 1 0\n",
+        "colt-serve 2\nflags 256 1 0 0 2\n",
+        "colt-serve 2\nflags a b c d e\n",
+        "colt-serve 2\nunknown field\n",
+    };
+    for (auto str : invalid)
+    {
+      if (decode_request(str).is_value())
+      {
+        ++error_count;
+        io::print_error("Invalid request '{}' was accepted!", str);
+      }
+    }
+
+    // Requests bigger than MAX_REQUEST_SIZE are rejected
+    String oversized = encoded;
+    while (oversized.size() <= MAX_REQUEST_SIZE)
+      oversized.push_back("file a_file_with_a_long_name_to_fill_the_request.ct\n");
+    if (decode_request(StringView{oversized}).is_value())
+    {
+      ++error_count;
+      io::print_error("Oversized request was accepted!");
+    }
+
+    // Responses: the output, the exit code and the C files written
+    CompileResponse response;
+    response.output = StringView{"main.ct: warning\n"};
+    response.status = 1;
+    response.written.push_back(String{StringView{"/home/user/main.c"}});
+    response.written.push_back(String{StringView{"/home/user/lib/a b.c"}});
+    auto decoded_response = decode_response(StringView{encode_response(response)});
+    bool same_response    = decoded_response.is_value()
+                         && StringView{decoded_response->output} == StringView{response.output}
+                         && decoded_response->status == response.status
+                         && decoded_response->written.size() == response.written.size();
+    for (size_t i = 0; same_response && i < response.written.size(); i++)
+      same_response = StringView{decoded_response->written[i]}
+                      == StringView{response.written[i]};
+    if (!same_response)
+    {
+      ++error_count;
+      io::print_error("Response did not survive encoding and decoding!");
+    }
+    // No exit code, an invalid exit code, or a path not on its own line
+    const StringView invalid_responses[] = {
+        "", "output", StringView{"output\0", 7}, StringView{"output\0" "2", 8},
+        StringView{"output\0" "0path", 12}};
+    for (auto str : invalid_responses)
+    {
+      if (decode_response(str).is_value())
+      {
+        ++error_count;
+        io::print_error("Invalid response was accepted!");
+      }
+    }
+  }
+} // namespace clt::test
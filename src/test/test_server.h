@@ -0,0 +1,21 @@
+/*****************************************************************/ /**
+ * @file   test_server.h
+ * @brief  Tests for the encoding of the requests of the compile server.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TEST_SERVER
+#define HG_COLT_TEST_SERVER
+
+#include "server/compile_server.h"
+
+namespace clt::test
+{
+  /// @brief Tests that requests survive 'encode_request' and
+  /// 'decode_request', and that invalid requests are rejected.
+  /// @param error_count The error count to increment on errors
+  void test_server(u32& error_count) noexcept;
+} // namespace clt::test
+
+#endif // !HG_COLT_TEST_SERVER
@@ -1,7 +1,14 @@
 #ifndef HG_COLT_BITS
 #define HG_COLT_BITS
 
+#include <array>
 #include "types.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define COLT_BITS_BMI2
+  #include <immintrin.h>
+#endif
 
 namespace clt
 {
@@ -138,8 +145,8 @@ namespace clt
   constexpr std::make_signed_t<T> sign_extend(T value, u8 n)
   {
     assert_true("Invalid bit count!", n > 0 && n < sizeof(T) * 8);
-    T sign = (1 << (n - 1)) & value;
-    T mask = ((~0U) >> (n - 1)) << (n - 1);
+    T sign = (T(1) << (n - 1)) & value;
+    T mask = (static_cast<T>(~T(0)) >> (n - 1)) << (n - 1);
     if (sign != 0)
       value |= mask;
     else
@@ -147,6 +154,62 @@ namespace clt
     return static_cast<std::make_signed_t<T>>(value);
   }
 
+  namespace details
+  {
+    /// @brief The masks used to decode fields with PEXT and PDEP
+    /// @tparam N The count of fields to decode
+    template<size_t N>
+    struct PextPlan
+    {
+      /// @brief The bits of all the fields (gathered by PEXT)
+      u64 gather = 0;
+      /// @brief The lanes in which to spread the fields (by PDEP)
+      u64 deposit = 0;
+      /// @brief The offset of the lane of each field
+      std::array<u8, N> lane_offset{};
+      /// @brief The size of the lane of each field (8, 16, 32 or 64)
+      std::array<u8, N> lane_size{};
+      /// @brief False if the lanes do not fit in 64 bits
+      bool is_valid = false;
+    };
+  } // namespace details
+
+  /// @brief How Bitfields::get_all_with extracts the fields
+  enum class ExtractWith : u8
+  {
+    /// @brief A shift and a mask per field
+    shifts,
+    /// @brief A PEXT and a PDEP for all the fields (if BMI2 may be used)
+    pext,
+  };
+
+  /// @brief How Bitfields::get_all extracts the fields.
+  /// PEXT is only used if the program is compiled for BMI2 (-mbmi2):
+  /// else, checking the CPU on each call would cost more than PEXT saves,
+  /// so the loops decoding fields are compiled for BMI2 and dispatched
+  /// once (see cpu::Dispatch).
+  inline constexpr ExtractWith DEFAULT_EXTRACT =
+#if defined(COLT_BITS_BMI2) && defined(__BMI2__)
+      ExtractWith::pext;
+#else
+      ExtractWith::shifts;
+#endif // COLT_BITS_BMI2 && __BMI2__
+
+  /// @brief Check if fields are decoded using PEXT and PDEP, either by
+  /// Bitfields::get_all (if compiled for BMI2) or by the loops compiled
+  /// for BMI2 and dispatched once (see cpu::Dispatch).
+  /// @return True if BMI2 is used (and is not microcoded)
+  inline bool pext_is_hardware() noexcept
+  {
+#if defined(COLT_BITS_BMI2) && defined(__BMI2__)
+    return true;
+#elif defined(COLT_BITS_BMI2)
+    return cpu::has(cpu::BMI2 | cpu::FAST_PEXT);
+#else
+    return false;
+#endif // COLT_BITS_BMI2
+  }
+
   /// @brief Represents a field of 'Bitfields'
   /// @tparam Name The integral type used to identify the bit field
   /// @tparam Size The size of the field
@@ -224,6 +287,65 @@ namespace clt
       assert_true("Invalid field name!", false);
     }
 
+    /// @brief Computes the masks used by 'get_all' to decode fields
+    /// @tparam ...indices The IDs of the fields
+    /// @return The masks (invalid if the lanes do not fit in 64 bits)
+    template<auto... indices>
+    static consteval details::PextPlan<sizeof...(indices)> pext_plan() noexcept
+    {
+      constexpr size_t N                = sizeof...(indices);
+      const std::pair<u64, u64> info[N] = {field_info<indices>()...};
+      // PEXT gathers the fields starting from the least significant one
+      std::array<size_t, N> order{};
+      for (size_t i = 0; i < N; i++)
+      {
+        order[i] = i;
+        for (size_t j = i; j > 0 && info[order[j - 1]].first > info[i].first; j--)
+          std::swap(order[j], order[j - 1]);
+      }
+
+      details::PextPlan<N> plan{};
+      u64 lane = 0;
+      for (auto i : order)
+      {
+        const auto [offset, size] = info[i];
+        const u64 lane_size       = std::bit_ceil(size < 8 ? u64{8} : size);
+        // A field requested twice would be gathered once
+        if (lane + lane_size > 64
+            || (plan.gather & (bitmask<u64>(size) << offset)) != 0)
+          return details::PextPlan<N>{};
+        plan.gather |= bitmask<u64>(size) << offset;
+        plan.deposit |= bitmask<u64>(size) << lane;
+        plan.lane_offset[i] = static_cast<u8>(lane);
+        plan.lane_size[i]   = static_cast<u8>(lane_size);
+        lane += lane_size;
+      }
+      plan.is_valid = true;
+      return plan;
+    }
+
+#ifdef COLT_BITS_BMI2
+    /// @brief Returns the values of multiple fields using PEXT and PDEP.
+    /// The CPU must support BMI2.
+    /// @tparam ...indices The IDs of the fields
+    /// @return The values of the fields (in the order of 'indices')
+    template<auto... indices>
+  #if defined(COLT_GNU) || defined(COLT_CLANG)
+    __attribute__((target("bmi2")))
+  #endif
+    std::array<Ty, sizeof...(indices)> get_all_bmi2() const noexcept
+    {
+      static constexpr auto PLAN = pext_plan<indices...>();
+      const u64 lanes = _pdep_u64(_pext_u64(storage, PLAN.gather), PLAN.deposit);
+      // The offsets and sizes are constants: each field is a zero extension
+      return [lanes]<size_t... I>(std::index_sequence<I...>) noexcept
+      {
+        return std::array<Ty, sizeof...(indices)>{static_cast<Ty>(
+            (lanes >> PLAN.lane_offset[I]) & bitmask<u64>(PLAN.lane_size[I]))...};
+      }(std::make_index_sequence<sizeof...(indices)>{});
+    }
+#endif // COLT_BITS_BMI2
+
   public:
     /// @brief Constructs an empty Bitfields (set to all zeros)
     constexpr Bitfields() noexcept
@@ -252,6 +374,44 @@ namespace clt
       return (storage >> pair.first) & bitmask<Ty>(pair.second);
     }
 
+    /// @brief Returns the values of multiple fields at once.
+    /// The fields are extracted as specified by DEFAULT_EXTRACT.
+    /// @tparam ...indices The IDs of the fields
+    /// @return The values of the fields (in the order of 'indices')
+    template<auto... indices>
+      requires(std::same_as<index_t, decltype(indices)> && ...)
+    constexpr std::array<Ty, sizeof...(indices)> get_all() const noexcept
+    {
+      return get_all_with<DEFAULT_EXTRACT, indices...>();
+    }
+
+    /// @brief Returns the values of multiple fields at once.
+    /// With ExtractWith::pext (if each field fits in a lane of 8, 16, 32
+    /// or 64 bits, all the lanes fitting in 64 bits), the fields are gathered
+    /// by a single PEXT then spread in their lanes by a single PDEP, so that
+    /// extracting each field is a zero extension. The CPU must then support
+    /// BMI2, and the caller should be compiled for BMI2 (with -mbmi2 or
+    /// in a function targeting "bmi2") for the PEXT to be inlined.
+    /// Else each field is extracted with a shift and a mask.
+    /// @tparam WITH How to extract the fields
+    /// @tparam ...indices The IDs of the fields
+    /// @return The values of the fields (in the order of 'indices')
+    template<ExtractWith WITH, auto... indices>
+      requires(std::same_as<index_t, decltype(indices)> && ...)
+    constexpr std::array<Ty, sizeof...(indices)> get_all_with() const noexcept
+    {
+#ifdef COLT_BITS_BMI2
+      if constexpr (
+          WITH == ExtractWith::pext && sizeof(Ty) == sizeof(u64)
+          && pext_plan<indices...>().is_valid)
+      {
+        if (!std::is_constant_evaluated())
+          return get_all_bmi2<indices...>();
+      }
+#endif // COLT_BITS_BMI2
+      return {get<indices>()...};
+    }
+
     /// @brief Sets the value of the bit field of ID 'index'
     /// This will only keep as much bits from 'value' as the field can store.
     /// If this method produces an 'expression cannot be constant evaluated'
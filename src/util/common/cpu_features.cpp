@@ -0,0 +1,155 @@
+/*****************************************************************/ /**
+ * @file   cpu_features.cpp
+ * @brief  Contains the implementation of 'cpu_features.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstring>
+
+#include "cpu_features.h"
+#include "colt_config.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define COLT_CPUID_X86
+  #ifdef COLT_MSVC
+    #include <intrin.h>
+    #include <immintrin.h>
+  #else
+    #include <cpuid.h>
+  #endif // COLT_MSVC
+#endif
+
+namespace clt::cpu
+{
+#ifdef COLT_CPUID_X86
+  /// @brief The registers returned by 'cpuid'
+  struct CpuidRegs
+  {
+    u32 eax = 0;
+    u32 ebx = 0;
+    u32 ecx = 0;
+    u32 edx = 0;
+  };
+
+  /// @brief Executes 'cpuid'
+  /// @param leaf The leaf (EAX)
+  /// @param subleaf The sub-leaf (ECX)
+  /// @return The registers
+  static CpuidRegs cpuid(u32 leaf, u32 subleaf) noexcept
+  {
+    CpuidRegs regs;
+  #ifdef COLT_MSVC
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    regs = {
+        static_cast<u32>(info[0]), static_cast<u32>(info[1]),
+        static_cast<u32>(info[2]), static_cast<u32>(info[3])};
+  #else
+    __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+  #endif // COLT_MSVC
+    return regs;
+  }
+
+  /// @brief Returns the register state saved by the OS (XCR0).
+  /// OSXSAVE must be supported.
+  /// @return The value of XCR0
+  static u64 xgetbv() noexcept
+  {
+  #ifdef COLT_MSVC
+    return _xgetbv(0);
+  #else
+    u32 eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<u64>(edx) << 32) | eax;
+  #endif // COLT_MSVC
+  }
+
+  /// @brief Detects the features of the current CPU
+  /// @return The features of the current CPU
+  static Features detect() noexcept
+  {
+    const auto vendor = cpuid(0, 0);
+    const auto info   = cpuid(1, 0);
+    const auto ext    = vendor.eax >= 7 ? cpuid(7, 0) : CpuidRegs{};
+
+    Features features = NONE;
+    if (info.ecx & (1 << 20))
+      features |= SSE42;
+    if (info.ecx & (1 << 23))
+      features |= POPCNT;
+    if (ext.ebx & (1 << 8))
+      features |= BMI2;
+
+    // The OS must save the YMM (and ZMM) registers for AVX to be usable
+    const u64 xcr0 = (info.ecx & (1 << 27)) ? xgetbv() : 0;
+    if ((xcr0 & 0x6) == 0x6 && (ext.ebx & (1 << 5)))
+      features |= AVX2;
+    if ((xcr0 & 0xE6) == 0xE6 && (ext.ebx & (1 << 16)) && (ext.ebx & (1u << 30)))
+      features |= AVX512;
+
+    // PEXT and PDEP are microcoded on AMD (and Hygon) before Zen 3
+    char name[12];
+    std::memcpy(name, &vendor.ebx, 4);
+    std::memcpy(name + 4, &vendor.edx, 4);
+    std::memcpy(name + 8, &vendor.ecx, 4);
+    u32 family = (info.eax >> 8) & 0xF;
+    if (family == 0xF)
+      family += (info.eax >> 20) & 0xFF;
+    const bool slow_pext = (std::memcmp(name, "AuthenticAMD", 12) == 0
+                            || std::memcmp(name, "HygonGenuine", 12) == 0)
+                           && family < 0x19;
+    if ((features & BMI2) && !slow_pext)
+      features |= FAST_PEXT;
+    return features;
+  }
+#else
+  /// @brief Detects the features of the current CPU
+  /// @return The features of the current CPU
+  static Features detect() noexcept
+  {
+    return NONE;
+  }
+#endif // COLT_CPUID_X86
+
+  /// @brief The level to which the features are restricted
+  static Level LEVEL = Level::native;
+
+  Features detected() noexcept
+  {
+    static const Features DETECTED = detect();
+    return DETECTED;
+  }
+
+  namespace details
+  {
+    /// @brief Detects the features (before 'main' runs)
+    /// @return The detected features
+    static Features initialize() noexcept
+    {
+      const Features features = detected();
+      EPOCH.fetch_add(1, std::memory_order_release);
+      return features;
+    }
+
+    // Constant initialized: kernels called before 'ACTIVE' is initialized
+    // use the baseline, then are rebound once the epoch is incremented.
+    constinit std::atomic<u32> EPOCH = 0;
+    Features ACTIVE                  = initialize();
+  } // namespace details
+
+  Level level() noexcept
+  {
+    return LEVEL;
+  }
+
+  bool set_level(Level level) noexcept
+  {
+    LEVEL           = level;
+    details::ACTIVE = detected() & features_of(level);
+    details::EPOCH.fetch_add(1, std::memory_order_release);
+    // FAST_PEXT is not an extension: BMI2 is used even if it is slow
+    const Features missing = features_of(level) & ~details::ACTIVE & ~FAST_PEXT;
+    return level == Level::native || missing == NONE;
+  }
+} // namespace clt::cpu
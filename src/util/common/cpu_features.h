@@ -0,0 +1,217 @@
+/*****************************************************************/ /**
+ * @file   cpu_features.h
+ * @brief  Contains the detection of the CPU features (using 'cpuid'),
+ * and Dispatch, which selects the best implementation of a kernel
+ * for the current CPU.
+ * The features are detected once (before 'main' runs). The features
+ * that kernels may use can then be restricted to a level (see the
+ * '-cpu' command line option), so that each implementation of a kernel
+ * can be tested on a single machine.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_CPU_FEATURES
+#define HG_COLT_CPU_FEATURES
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+
+#include "types.h"
+#include "meta/meta_enum.h"
+
+DECLARE_ENUM_WITH_TYPE(
+    u8, clt::cpu, Level,
+    baseline, // no extensions
+    sse42,    // SSE4.2 and POPCNT (x86-64-v2)
+    avx2,     // AVX2 and BMI2 (x86-64-v3)
+    avx512,   // AVX-512 F and BW (x86-64-v4)
+    native    // all the features of the current CPU
+);
+
+namespace clt::cpu
+{
+  /// @brief A set of CPU features (a combination of the constants below)
+  using Features = u32;
+
+  /// @brief No features (always available)
+  inline constexpr Features NONE = 0;
+  /// @brief SSE4.2 (including the 'crc32' instruction)
+  inline constexpr Features SSE42 = 1 << 0;
+  /// @brief The 'popcnt' instruction
+  inline constexpr Features POPCNT = 1 << 1;
+  /// @brief AVX2 (whose registers are saved by the OS)
+  inline constexpr Features AVX2 = 1 << 2;
+  /// @brief BMI2 (including PEXT and PDEP)
+  inline constexpr Features BMI2 = 1 << 3;
+  /// @brief PEXT and PDEP are not microcoded (they are on AMD before Zen 3)
+  inline constexpr Features FAST_PEXT = 1 << 4;
+  /// @brief AVX-512 F and BW (whose registers are saved by the OS)
+  inline constexpr Features AVX512 = 1 << 5;
+
+  namespace details
+  {
+    /// @brief The features that kernels may use.
+    /// This is NONE until the features are detected (before 'main' runs),
+    /// so that kernels called during static initialization use the baseline.
+    extern Features ACTIVE;
+    /// @brief Incremented each time ACTIVE changes, to rebind the kernels
+    extern std::atomic<u32> EPOCH;
+  } // namespace details
+
+  /// @brief Returns the features supported by the current CPU
+  /// @return The detected features (detected on the first call)
+  Features detected() noexcept;
+
+  /// @brief Returns the features of a level
+  /// @param level The level
+  /// @return The features that a kernel may use at that level
+  constexpr Features features_of(Level level) noexcept
+  {
+    switch_no_default(level)
+    {
+    case Level::baseline:
+      return NONE;
+    case Level::sse42:
+      return SSE42 | POPCNT;
+    case Level::avx2:
+      return SSE42 | POPCNT | AVX2 | BMI2 | FAST_PEXT;
+    case Level::avx512:
+      return SSE42 | POPCNT | AVX2 | BMI2 | FAST_PEXT | AVX512;
+    case Level::native:
+      return ~NONE;
+    }
+  }
+
+  /// @brief Returns the level to which the features are restricted
+  /// @return The level (native by default)
+  Level level() noexcept;
+
+  /// @brief Restricts the features that kernels may use to a level.
+  /// This must be called before other threads call kernels.
+  /// @param level The level
+  /// @return False if the CPU does not support all the features of the level
+  /// (in which case only the features it supports are used)
+  bool set_level(Level level) noexcept;
+
+  /// @brief Returns the features that kernels may use
+  /// @return The detected features restricted to the current level
+  inline Features active() noexcept
+  {
+    return details::ACTIVE;
+  }
+
+  /// @brief Check if kernels may use features
+  /// @param required The features to check for
+  /// @return True if all the features of 'required' may be used
+  inline bool has(Features required) noexcept
+  {
+    return (details::ACTIVE & required) == required;
+  }
+
+  template<typename Fn>
+  class Dispatch;
+
+  /// @brief Calls the best implementation of a kernel for the current CPU.
+  /// The implementation is resolved on the first call (and after each call
+  /// to 'set_level'), similarly to an 'ifunc' resolver: calling a kernel is
+  /// otherwise an indirect call.
+  /// Dispatch can be constant initialized (and should be declared
+  /// 'constinit'), so that kernels can be called during static
+  /// initialization (using the baseline implementation).
+  /// @tparam Ret The return type of the kernel
+  /// @tparam ...Args The parameter types of the kernel
+  template<typename Ret, typename... Args>
+  class Dispatch<Ret(Args...)>
+  {
+  public:
+    /// @brief The type of an implementation
+    using fn_t = Ret (*)(Args...) noexcept;
+
+    /// @brief An implementation of the kernel
+    struct Candidate
+    {
+      /// @brief The features required by the implementation
+      Features required;
+      /// @brief The implementation
+      fn_t fn;
+    };
+
+    /// @brief The maximum number of implementations of a kernel
+    static constexpr size_t MAX_CANDIDATES = 4;
+
+  private:
+    /// @brief The implementations, from the preferred one
+    std::array<Candidate, MAX_CANDIDATES> candidates{};
+    /// @brief The number of implementations
+    u8 count;
+    /// @brief The bound implementation
+    mutable std::atomic<fn_t> bound;
+    /// @brief The value of EPOCH when 'bound' was resolved
+    mutable std::atomic<u32> epoch = 0;
+
+    /// @brief Binds the preferred implementation supported by the CPU
+    /// @return The bound implementation
+    fn_t rebind() const noexcept
+    {
+      const u32 current = details::EPOCH.load(std::memory_order_acquire);
+      const fn_t fn     = resolve();
+      bound.store(fn, std::memory_order_relaxed);
+      epoch.store(current, std::memory_order_release);
+      return fn;
+    }
+
+  public:
+    /// @brief Constructs a kernel from its implementations
+    /// @param list The implementations (from the preferred one), the last
+    /// of which must not require any features
+    constexpr Dispatch(std::initializer_list<Candidate> list) noexcept
+        : count(static_cast<u8>(list.size()))
+        , bound(list.size() == 0 ? nullptr : list.end()[-1].fn)
+    {
+      assert_true(
+          "Invalid candidates!", list.size() != 0, list.size() <= MAX_CANDIDATES);
+      assert_true(
+          "The last candidate must not require any features!",
+          list.end()[-1].required == NONE);
+      for (size_t i = 0; i < list.size(); i++)
+        candidates[i] = list.begin()[i];
+    }
+
+    Dispatch(const Dispatch&)            = delete;
+    Dispatch& operator=(const Dispatch&) = delete;
+
+    /// @brief Returns the preferred implementation that may be used
+    /// @return The implementation that would be bound
+    fn_t resolve() const noexcept
+    {
+      for (u8 i = 0; i < count; i++)
+      {
+        if (has(candidates[i].required))
+          return candidates[i].fn;
+      }
+      return candidates[count - 1].fn;
+    }
+
+    /// @brief Returns the bound implementation
+    /// @return The implementation called by the kernel
+    fn_t target() const noexcept
+    {
+      if (epoch.load(std::memory_order_acquire)
+          != details::EPOCH.load(std::memory_order_relaxed)) [[unlikely]]
+        return rebind();
+      return bound.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Calls the bound implementation
+    /// @param ...args The arguments of the kernel
+    /// @return The result of the kernel
+    Ret operator()(Args... args) const noexcept
+    {
+      return target()(static_cast<Args>(args)...);
+    }
+  };
+} // namespace clt::cpu
+
+#endif // !HG_COLT_CPU_FEATURES
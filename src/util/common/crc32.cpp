@@ -0,0 +1,111 @@
+/*****************************************************************/ /**
+ * @file   crc32.cpp
+ * @brief  Contains the implementation of 'crc32.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstring>
+#include <array>
+
+#include "crc32.h"
+#include "bits.h"
+#include "colt_config.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define COLT_CRC32_X86
+  #include <nmmintrin.h>
+#endif
+
+namespace clt
+{
+  /// @brief The reversed CRC32C (Castagnoli) polynomial
+  static constexpr u32 CRC32C_POLY = 0x82F63B78;
+
+  /// @brief Generates the slicing-by-8 lookup tables
+  /// @return The lookup tables
+  static consteval std::array<std::array<u32, 256>, 8> generate_crc32c_tables() noexcept
+  {
+    std::array<std::array<u32, 256>, 8> table{};
+    for (u32 i = 0; i < 256; i++)
+    {
+      u32 crc = i;
+      for (u32 j = 0; j < 8; j++)
+        crc = (crc >> 1) ^ (CRC32C_POLY & (0 - (crc & 1)));
+      table[0][i] = crc;
+    }
+    for (u32 i = 0; i < 256; i++)
+      for (u32 j = 1; j < 8; j++)
+        table[j][i] = (table[j - 1][i] >> 8) ^ table[0][table[j - 1][i] & 0xFF];
+    return table;
+  }
+
+  /// @brief The slicing-by-8 lookup tables
+  static constexpr auto CRC32C_TABLE = generate_crc32c_tables();
+
+  /// @brief Portable slicing-by-8 CRC32C
+  /// @param crc The inverted checksum of the previous bytes
+  /// @param bytes The bytes whose checksum to compute
+  /// @param size The count of bytes
+  /// @return The inverted checksum
+  static u32 crc32c_software(u32 crc, const u8* bytes, size_t size) noexcept
+  {
+    const auto& T = CRC32C_TABLE;
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+      u64 word;
+      std::memcpy(&word, bytes, sizeof(u64));
+      word = htol(word) ^ crc;
+      crc  = T[7][word & 0xFF] ^ T[6][(word >> 8) & 0xFF]
+            ^ T[5][(word >> 16) & 0xFF] ^ T[4][(word >> 24) & 0xFF]
+            ^ T[3][(word >> 32) & 0xFF] ^ T[2][(word >> 40) & 0xFF]
+            ^ T[1][(word >> 48) & 0xFF] ^ T[0][word >> 56];
+    }
+    while (size-- != 0)
+      crc = (crc >> 8) ^ T[0][(crc ^ *bytes++) & 0xFF];
+    return crc;
+  }
+
+#ifdef COLT_CRC32_X86
+  #if defined(COLT_GNU) || defined(COLT_CLANG)
+  __attribute__((target("sse4.2")))
+  #endif
+  /// @brief SSE4.2 CRC32C
+  /// @param crc The inverted checksum of the previous bytes
+  /// @param bytes The bytes whose checksum to compute
+  /// @param size The count of bytes
+  /// @return The inverted checksum
+  static u32 crc32c_hardware(u32 crc, const u8* bytes, size_t size) noexcept
+  {
+    u64 crc64 = crc;
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+      u64 word;
+      std::memcpy(&word, bytes, sizeof(u64));
+      crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<u32>(crc64);
+    while (size-- != 0)
+      crc = _mm_crc32_u8(crc, *bytes++);
+    return crc;
+  }
+#endif // COLT_CRC32_X86
+
+  /// @brief The CRC32C implementations, from the preferred one
+  static constinit const cpu::Dispatch<u32(u32, const u8*, size_t)> CRC32C{
+#ifdef COLT_CRC32_X86
+      {cpu::SSE42, &crc32c_hardware},
+#endif // COLT_CRC32_X86
+      {cpu::NONE, &crc32c_software}};
+
+  bool crc32c_is_hardware() noexcept
+  {
+    return CRC32C.target() != &crc32c_software;
+  }
+
+  u32 crc32c(u32 crc, const void* ptr, size_t size) noexcept
+  {
+    return ~CRC32C(~crc, static_cast<const u8*>(ptr), size);
+  }
+} // namespace clt
@@ -0,0 +1,42 @@
+/*****************************************************************/ /**
+ * @file   crc32.h
+ * @brief  Contains CRC32C (Castagnoli) checksum computation.
+ * On x86-64, the SSE4.2 'crc32' instruction is used if the current
+ * CPU supports it (and the '-cpu' level allows it), else a portable
+ * slicing-by-8 implementation is used (which processes 8 bytes per
+ * iteration).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_CRC32
+#define HG_COLT_CRC32
+
+#include "types.h"
+#include "structs/vector.h"
+
+namespace clt
+{
+  /// @brief Continues a CRC32C computation over 'size' bytes.
+  /// To compute the checksum of non-contiguous data, pass the result
+  /// of the previous call as 'crc' (the initial value being 0).
+  /// @param crc The checksum of the previous bytes (0 if none)
+  /// @param ptr The bytes whose checksum to compute
+  /// @param size The count of bytes
+  /// @return The checksum of the previous bytes followed by the new ones
+  u32 crc32c(u32 crc, const void* ptr, size_t size) noexcept;
+
+  /// @brief Computes the CRC32C of bytes
+  /// @param bytes The bytes whose checksum to compute
+  /// @return The checksum
+  inline u32 crc32c(View<u8> bytes) noexcept
+  {
+    return crc32c(0, bytes.data(), bytes.size());
+  }
+
+  /// @brief Check if the hardware accelerated CRC32C is used
+  /// @return True if the SSE4.2 'crc32' instruction is used
+  bool crc32c_is_hardware() noexcept;
+} // namespace clt
+
+#endif // !HG_COLT_CRC32
@@ -0,0 +1,186 @@
+/*****************************************************************/ /**
+ * @file   lz4.cpp
+ * @brief  Contains the implementation of 'lz4.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstring>
+
+#include "lz4.h"
+#include "bits.h"
+
+namespace clt::lz4
+{
+  /// @brief The minimum length of a match
+  static constexpr u64 MIN_MATCH = 4;
+  /// @brief The last match must start at least 12 bytes before the end
+  static constexpr u64 MF_LIMIT = 12;
+  /// @brief The last 5 bytes are always literals
+  static constexpr u64 LAST_LITERALS = 5;
+  /// @brief The maximum offset of a match
+  static constexpr u64 MAX_OFFSET = 65535;
+  /// @brief The log2 of the size of the hash table
+  static constexpr u32 HASH_LOG = 14;
+
+  /// @brief Reads 4 bytes (possibly unaligned)
+  /// @param ptr The pointer from which to read
+  /// @return The 4 bytes
+  static u32 read_u32(const u8* ptr) noexcept
+  {
+    u32 value;
+    std::memcpy(&value, ptr, sizeof(u32));
+    return value;
+  }
+
+  /// @brief Hashes 4 bytes to an index in the hash table
+  /// @param sequence The 4 bytes to hash
+  /// @return The index in the hash table
+  static u32 hash_sequence(u32 sequence) noexcept
+  {
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+  }
+
+  /// @brief Writes a length greater than 15 (as 255 bytes followed by the rest)
+  /// @param out The output
+  /// @param length The length minus 15
+  static void write_length(Vector<u8>& out, u64 length) noexcept
+  {
+    for (; length >= 255; length -= 255)
+      out.push_back(255);
+    out.push_back(static_cast<u8>(length));
+  }
+
+  /// @brief Writes literals followed by a match
+  /// @param out The output
+  /// @param literals The literals
+  /// @param literal_size The count of literals
+  /// @param offset The offset of the match (0 for the last sequence)
+  /// @param match_size The size of the match (unused for the last sequence)
+  static void write_sequence(
+      Vector<u8>& out, const u8* literals, u64 literal_size, u64 offset,
+      u64 match_size) noexcept
+  {
+    const u64 match_code = offset == 0 ? 0 : match_size - MIN_MATCH;
+    out.push_back(static_cast<u8>(
+        (clt::min<u64>(literal_size, 15) << 4) | clt::min<u64>(match_code, 15)));
+    if (literal_size >= 15)
+      write_length(out, literal_size - 15);
+    for (u64 i = 0; i < literal_size; i++)
+      out.push_back(literals[i]);
+    if (offset == 0)
+      return;
+    out.push_back(static_cast<u8>(offset));
+    out.push_back(static_cast<u8>(offset >> 8));
+    if (match_code >= 15)
+      write_length(out, match_code - 15);
+  }
+
+  void compress(View<u8> bytes, Vector<u8>& out) noexcept
+  {
+    const u8* in = bytes.data();
+    const u64 size = bytes.size();
+    if (const u64 bound = compress_bound(size); out.capacity() - out.size() < bound)
+      out.reserve(bound - (out.capacity() - out.size()));
+
+    u64 anchor = 0;
+    if (size > MF_LIMIT)
+    {
+      // Positions of the last occurrence of each hashed sequence
+      Vector<u32> table = Vector<u32>(1ULL << HASH_LOG, InPlace, 0U);
+      const u64 limit   = size - MF_LIMIT;
+      u64 ip            = 1;
+      table[hash_sequence(read_u32(in))] = 0;
+      while (ip < limit)
+      {
+        const u32 sequence = read_u32(in + ip);
+        auto& slot         = table[hash_sequence(sequence)];
+        u64 ref            = slot;
+        slot               = static_cast<u32>(ip);
+        if (ip - ref > MAX_OFFSET || read_u32(in + ref) != sequence)
+        {
+          // Skip faster over incompressible data
+          ip += 1 + ((ip - anchor) >> 6);
+          continue;
+        }
+
+        u64 match_size      = MIN_MATCH;
+        const u64 max_match = size - LAST_LITERALS - ip;
+        while (match_size < max_match && in[ref + match_size] == in[ip + match_size])
+          ++match_size;
+        // Extend the match backwards
+        while (ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1])
+        {
+          --ip;
+          --ref;
+          ++match_size;
+        }
+        write_sequence(out, in + anchor, ip - anchor, ip - ref, match_size);
+        ip += match_size;
+        anchor = ip;
+      }
+    }
+    write_sequence(out, in + anchor, size - anchor, 0, 0);
+  }
+
+  /// @brief Reads a length greater than 15
+  /// @param ip The current position in the input (updated)
+  /// @param end The end of the input
+  /// @param length The length to which to add (updated)
+  /// @return False if the input ended
+  static bool read_length(const u8*& ip, const u8* end, u64& length) noexcept
+  {
+    u8 byte;
+    do
+    {
+      if (ip == end)
+        return false;
+      byte = *ip++;
+      length += byte;
+    } while (byte == 255);
+    return true;
+  }
+
+  bool decompress(View<u8> bytes, u8* out, u64 out_size) noexcept
+  {
+    const u8* ip  = bytes.data();
+    const u8* end = ip + bytes.size();
+    u64 op        = 0;
+
+    while (ip != end)
+    {
+      const u8 token = *ip++;
+      u64 literals   = token >> 4;
+      if (literals == 15 && !read_length(ip, end, literals))
+        return false;
+      if (literals > static_cast<u64>(end - ip) || literals > out_size - op)
+        return false;
+      std::memcpy(out + op, ip, literals);
+      ip += literals;
+      op += literals;
+      // The last sequence has no match
+      if (ip == end)
+        return op == out_size;
+
+      if (end - ip < 2)
+        return false;
+      const u64 offset = static_cast<u64>(ip[0]) | (static_cast<u64>(ip[1]) << 8);
+      ip += 2;
+      u64 match_size = token & 15;
+      if (match_size == 15 && !read_length(ip, end, match_size))
+        return false;
+      match_size += MIN_MATCH;
+      if (offset == 0 || offset > op || match_size > out_size - op)
+        return false;
+
+      const u8* match = out + op - offset;
+      if (offset >= match_size)
+        std::memcpy(out + op, match, match_size);
+      else // Overlapping copy (repeating pattern)
+        for (u64 i = 0; i < match_size; i++)
+          out[op + i] = match[i];
+      op += match_size;
+    }
+    return false;
+  }
+} // namespace clt::lz4
@@ -0,0 +1,42 @@
+/*****************************************************************/ /**
+ * @file   lz4.h
+ * @brief  Contains an in-tree LZ4 block compressor and decompressor.
+ * The output follows the LZ4 block format (without frame), which
+ * favors decompression speed over compression ratio: decompressing
+ * is mostly made of 'memcpy'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_LZ4
+#define HG_COLT_LZ4
+
+#include "types.h"
+#include "structs/vector.h"
+
+namespace clt::lz4
+{
+  /// @brief Returns the maximum size of compressed data
+  /// @param size The size of the data to compress
+  /// @return The maximum size of the compressed data
+  constexpr u64 compress_bound(u64 size) noexcept
+  {
+    return size + size / 255 + 16;
+  }
+
+  /// @brief Compresses bytes, appending the result to 'out'
+  /// @param bytes The bytes to compress
+  /// @param out The vector to which to append the compressed bytes
+  void compress(View<u8> bytes, Vector<u8>& out) noexcept;
+
+  /// @brief Decompresses bytes compressed using 'compress'.
+  /// The compressed bytes are validated: malformed input never
+  /// reads or writes out of bounds.
+  /// @param bytes The compressed bytes
+  /// @param out The buffer to which to write the decompressed bytes
+  /// @param out_size The exact size of the decompressed bytes
+  /// @return True on success, false if the compressed bytes are malformed
+  bool decompress(View<u8> bytes, u8* out, u64 out_size) noexcept;
+} // namespace clt::lz4
+
+#endif // !HG_COLT_LZ4
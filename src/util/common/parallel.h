@@ -0,0 +1,76 @@
+/*****************************************************************/ /**
+ * @file   parallel.h
+ * @brief  Contains helpers to run independent tasks on worker threads.
+ * Tasks are pulled from a shared atomic index (IndexQueue) by each
+ * worker, which balances tasks of uneven durations without any lock.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_PARALLEL
+#define HG_COLT_PARALLEL
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "common/types.h"
+#include "structs/option.h"
+#include "structs/vector.h"
+
+namespace clt
+{
+  /// @brief Returns the count of workers to use for tasks
+  /// @param requested The requested count (0 for one per hardware thread)
+  /// @param task_count The count of tasks (no more workers are used)
+  /// @return The count of workers (at least 1)
+  inline u64 worker_count(u64 requested, u64 task_count) noexcept
+  {
+    if (requested == 0)
+      requested = std::max(std::thread::hardware_concurrency(), 1U);
+    return std::max<u64>(std::min(requested, task_count), 1);
+  }
+
+  /// @brief Distributes the indices [0, count) to workers
+  class IndexQueue
+  {
+    /// @brief The next index to return
+    std::atomic<u64> next = 0;
+    /// @brief The count of indices
+    u64 count;
+
+  public:
+    /// @brief Constructor
+    /// @param count The count of indices
+    IndexQueue(u64 count) noexcept
+        : count(count)
+    {
+    }
+
+    /// @brief Returns the next index to process
+    /// @return The index or None if all the indices were returned
+    Option<u64> pop() noexcept
+    {
+      const u64 index = next.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count)
+        return None;
+      return index;
+    }
+  };
+
+  template<typename Fn>
+  /// @brief Runs 'fn' on 'workers' threads (the current thread being one
+  /// of them), and waits for all of them to return
+  /// @param workers The count of threads
+  /// @param fn The function to run on each thread
+  void run_on_workers(u64 workers, Fn& fn) noexcept
+  {
+    Vector<std::thread> threads = Vector<std::thread>(workers);
+    for (u64 i = 1; i < workers; i++)
+      threads.push_back(std::thread{[&fn]() noexcept { fn(); }});
+    fn();
+    for (auto& thread : threads)
+      thread.join();
+  }
+} // namespace clt
+
+#endif // !HG_COLT_PARALLEL
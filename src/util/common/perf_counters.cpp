@@ -0,0 +1,138 @@
+/*****************************************************************/ /**
+ * @file   perf_counters.cpp
+ * @brief  Contains the implementation of 'perf_counters.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "perf_counters.h"
+
+#if defined(COLT_LINUX)
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace clt::perf
+{
+#if defined(COLT_LINUX)
+  /// @brief Returns the type and config of the perf event of a counter
+  /// @param counter The counter
+  /// @return Pair of type and config
+  static std::pair<u32, u64> event_of(Counter counter) noexcept
+  {
+    // Cache events are encoded as: cache | (operation << 8) | (result << 16)
+    constexpr u64 READ_MISS = (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                              | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    switch_no_default(counter)
+    {
+    case Counter::CYCLES:
+      return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+    case Counter::INSTRUCTIONS:
+      return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+    case Counter::BRANCHES:
+      return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS};
+    case Counter::BRANCH_MISSES:
+      return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+    case Counter::L1D_MISSES:
+      return {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | READ_MISS};
+    case Counter::LLC_MISSES:
+      return {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | READ_MISS};
+    }
+  }
+
+  /// @brief Opens a counter of the current thread (disabled)
+  /// @param counter The counter to open
+  /// @return The file descriptor or -1 on failure
+  static int open_counter(Counter counter) noexcept
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    const auto [type, config] = event_of(counter);
+    attr.size                 = sizeof(attr);
+    attr.type                 = type;
+    attr.config               = config;
+    attr.disabled             = 1;
+    // Only count user space, which does not require privileges
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  PerfCounters::PerfCounters() noexcept
+  {
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+      fds[i] = open_counter(static_cast<Counter>(i));
+  }
+
+  PerfCounters::~PerfCounters() noexcept
+  {
+    for (auto fd : fds)
+      if (fd != -1)
+        close(fd);
+  }
+
+  void PerfCounters::start() noexcept
+  {
+    for (auto fd : fds)
+    {
+      if (fd == -1)
+        continue;
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  PerfSample PerfCounters::stop() noexcept
+  {
+    for (auto fd : fds)
+      if (fd != -1)
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    PerfSample sample;
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+      // value, time enabled, time running
+      u64 values[3];
+      if (fds[i] == -1 || read(fds[i], values, sizeof(values)) != sizeof(values))
+        continue;
+      // The counter was never scheduled on the PMU
+      if (values[2] == 0)
+        continue;
+      // The counter was multiplexed with others: extrapolate
+      if (values[2] < values[1])
+        values[0] = static_cast<u64>(
+            static_cast<double>(values[0]) * static_cast<double>(values[1])
+            / static_cast<double>(values[2]));
+      sample.set(static_cast<Counter>(i), values[0]);
+    }
+    return sample;
+  }
+#else
+  PerfCounters::PerfCounters() noexcept
+  {
+    fds.fill(-1);
+  }
+
+  PerfCounters::~PerfCounters() noexcept {}
+
+  void PerfCounters::start() noexcept {}
+
+  PerfSample PerfCounters::stop() noexcept
+  {
+    return PerfSample{};
+  }
+#endif // COLT_LINUX
+
+  bool PerfCounters::is_available() const noexcept
+  {
+    for (auto fd : fds)
+      if (fd != -1)
+        return true;
+    return false;
+  }
+} // namespace clt::perf
@@ -0,0 +1,168 @@
+/*****************************************************************/ /**
+ * @file   perf_counters.h
+ * @brief  Contains PerfCounters, which reads the hardware performance
+ * counters of the current thread (cycles, instructions, branch and
+ * cache misses) around a piece of code.
+ * Counters are read through 'perf_event_open' on Linux. Each counter
+ * is opened on its own, so that a counter that is not supported (by
+ * the CPU, a virtual machine or 'perf_event_paranoid') is reported as
+ * unavailable without disabling the others. On other platforms, no
+ * counter is available.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_PERF_COUNTERS
+#define HG_COLT_PERF_COUNTERS
+
+#include <array>
+#include "types.h"
+#include "structs/option.h"
+
+namespace clt::perf
+{
+  /// @brief The hardware counters that can be read
+  enum class Counter : u8
+  {
+    /// @brief CPU cycles
+    CYCLES,
+    /// @brief Retired instructions
+    INSTRUCTIONS,
+    /// @brief Retired branch instructions
+    BRANCHES,
+    /// @brief Mispredicted branch instructions
+    BRANCH_MISSES,
+    /// @brief Level 1 data cache read misses
+    L1D_MISSES,
+    /// @brief Last level cache read misses
+    LLC_MISSES,
+  };
+
+  /// @brief The number of counters
+  static constexpr size_t COUNTER_COUNT =
+      static_cast<size_t>(Counter::LLC_MISSES) + 1;
+
+  /// @brief The value of the counters over a measured piece of code
+  class PerfSample
+  {
+    /// @brief The value of each counter
+    std::array<u64, COUNTER_COUNT> values{};
+    /// @brief Bit 'i' is set if the counter 'i' was read
+    u8 available = 0;
+
+  public:
+    /// @brief Sets the value of a counter, marking it as available
+    /// @param counter The counter
+    /// @param value The value of the counter
+    constexpr void set(Counter counter, u64 value) noexcept
+    {
+      values[static_cast<size_t>(counter)] = value;
+      available |= static_cast<u8>(1 << static_cast<size_t>(counter));
+    }
+
+    /// @brief Returns the value of a counter
+    /// @param counter The counter
+    /// @return The value or None if the counter was not read
+    constexpr Option<u64> get(Counter counter) const noexcept
+    {
+      if (!(available & (1 << static_cast<size_t>(counter))))
+        return None;
+      return values[static_cast<size_t>(counter)];
+    }
+
+    /// @brief Check if at least one counter was read
+    /// @return True if any counter is available
+    constexpr bool is_empty() const noexcept { return available == 0; }
+
+    /// @brief Divides all the counters (e.g. by a number of runs)
+    /// @param by The divisor (not 0)
+    /// @return The divided sample
+    constexpr PerfSample divided_by(u64 by) const noexcept
+    {
+      assert_true("Division by zero!", by != 0);
+      PerfSample result = *this;
+      for (auto& value : result.values)
+        value /= by;
+      return result;
+    }
+
+    /// @brief Returns the instructions per cycle
+    /// @return The IPC or None if not available
+    Option<double> ipc() const noexcept
+    {
+      return ratio(Counter::INSTRUCTIONS, Counter::CYCLES);
+    }
+
+    /// @brief Returns the percentage of mispredicted branches
+    /// @return The branch miss rate [0-100] or None if not available
+    Option<double> branch_miss_rate() const noexcept
+    {
+      auto rate = ratio(Counter::BRANCH_MISSES, Counter::BRANCHES);
+      if (rate.is_none())
+        return None;
+      return *rate * 100.0;
+    }
+
+    /// @brief Returns the value of a counter per KiB of input
+    /// @param counter The counter
+    /// @param bytes The size of the input in bytes
+    /// @return The counter per KiB or None if not available
+    Option<double> per_kib(Counter counter, u64 bytes) const noexcept
+    {
+      auto value = get(counter);
+      if (value.is_none() || bytes == 0)
+        return None;
+      return static_cast<double>(*value) * 1024.0 / static_cast<double>(bytes);
+    }
+
+    /// @brief Returns the ratio of two counters
+    /// @param num The numerator
+    /// @param den The denominator
+    /// @return The ratio or None if any is not available (or 'den' is 0)
+    Option<double> ratio(Counter num, Counter den) const noexcept
+    {
+      auto a = get(num);
+      auto b = get(den);
+      if (a.is_none() || b.is_none() || *b == 0)
+        return None;
+      return static_cast<double>(*a) / static_cast<double>(*b);
+    }
+  };
+
+  /// @brief The hardware counters of the current thread.
+  /// @code{.cpp}
+  /// PerfCounters counters;
+  /// counters.start();
+  /// lex(reporter, source);
+  /// auto sample = counters.stop();
+  /// if (auto ipc = sample.ipc(); ipc.is_value())
+  ///   io::print("IPC: {:.2f}", *ipc);
+  /// @endcode
+  class PerfCounters
+  {
+    /// @brief The file descriptor of each counter (or -1 if not available)
+    std::array<int, COUNTER_COUNT> fds;
+
+  public:
+    /// @brief Opens all the counters supported (does not start counting)
+    PerfCounters() noexcept;
+    PerfCounters(const PerfCounters&)            = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    /// @brief Closes the counters
+    ~PerfCounters() noexcept;
+
+    /// @brief Check if at least one counter could be opened
+    /// @return True if counters are available
+    bool is_available() const noexcept;
+
+    /// @brief Resets the counters and starts counting
+    void start() noexcept;
+
+    /// @brief Stops counting and reads the counters.
+    /// If the kernel multiplexed the counters, the values are scaled.
+    /// @return The value of the counters since 'start'
+    PerfSample stop() noexcept;
+  };
+} // namespace clt::perf
+
+#endif // !HG_COLT_PERF_COUNTERS
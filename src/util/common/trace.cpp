@@ -0,0 +1,186 @@
+/*****************************************************************/ /**
+ * @file   trace.cpp
+ * @brief  Contains the implementation of 'trace.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <mutex>
+#include <algorithm>
+#include "trace.h"
+#include "io/print.h"
+#include "io/buffered_writer.h"
+#include "structs/unique_ptr.h"
+
+namespace clt::trace
+{
+  /// @brief The buffers of all the threads that recorded events
+  struct TraceRegistry
+  {
+    /// @brief Protects 'buffers'
+    std::mutex mutex{};
+    /// @brief The buffers (never freed, as threads may still record)
+    Vector<UniquePtr<TraceBuffer>> buffers{};
+    /// @brief The timestamp when tracing started
+    u64 start_tick = timestamp();
+    /// @brief The steady clock when tracing started (to calibrate ticks)
+    std::chrono::steady_clock::time_point start_clock =
+        std::chrono::steady_clock::now();
+  };
+
+  /// @brief Returns the registry of buffers
+  /// @return The registry
+  static TraceRegistry& registry() noexcept
+  {
+    static TraceRegistry reg{};
+    return reg;
+  }
+
+  /// @brief Converts timestamps to nanoseconds since tracing started
+  struct TickConverter
+  {
+    /// @brief The timestamp when tracing started
+    u64 start_tick;
+    /// @brief The duration of a tick in nanoseconds
+    double ns_per_tick;
+
+    /// @brief Constructor, calibrates the ticks against the steady clock
+    /// @param reg The registry
+    TickConverter(const TraceRegistry& reg) noexcept
+        : start_tick(reg.start_tick)
+    {
+      using namespace std::chrono;
+      const u64 ticks = timestamp() - start_tick;
+      const auto ns =
+          duration_cast<nanoseconds>(steady_clock::now() - reg.start_clock).count();
+      ns_per_tick = ticks == 0
+                        ? 1.0
+                        : static_cast<double>(ns) / static_cast<double>(ticks);
+    }
+
+    /// @brief Converts a timestamp to nanoseconds since tracing started
+    /// @param tick The timestamp
+    /// @return Nanoseconds since tracing started
+    double to_ns(u64 tick) const noexcept
+    {
+      return static_cast<double>(tick - start_tick) * ns_per_tick;
+    }
+  };
+
+  /// @brief Starts tracing at startup, so that reports cover the whole run
+  [[maybe_unused]] static TraceRegistry& RegistryAtStartup = registry();
+
+  TraceBuffer* details::register_thread() noexcept
+  {
+    auto& reg  = registry();
+    auto guard = std::scoped_lock{reg.mutex};
+    reg.buffers.push_back(
+        make_unique<TraceBuffer>(static_cast<u32>(reg.buffers.size())));
+    return &*reg.buffers.back();
+  }
+
+  /// @brief The statistics of a phase
+  struct PhaseStats
+  {
+    /// @brief The name of the phase
+    StringView name;
+    /// @brief The number of events
+    u64 count;
+    /// @brief The total duration of the events in nanoseconds
+    double total_ns;
+  };
+
+  void print_time_report() noexcept
+  {
+    auto& reg            = registry();
+    auto guard           = std::scoped_lock{reg.mutex};
+    const auto converter = TickConverter{reg};
+    const double wall_ns = converter.to_ns(timestamp());
+
+    Vector<PhaseStats> phases;
+    u64 dropped = 0;
+    for (auto& buffer : reg.buffers)
+    {
+      dropped += buffer->dropped();
+      for (auto& event : buffer->kept())
+      {
+        const auto name = StringView{event.name};
+        const double ns = static_cast<double>(event.end - event.start)
+                          * converter.ns_per_tick;
+        auto it = std::find_if(
+            phases.begin(), phases.end(),
+            [&](const PhaseStats& stats) { return stats.name == name; });
+        if (it == phases.end())
+          phases.push_back(PhaseStats{name, 1, ns});
+        else
+        {
+          it->count++;
+          it->total_ns += ns;
+        }
+      }
+    }
+    std::sort(
+        phases.begin(), phases.end(), [](const auto& a, const auto& b)
+        { return a.total_ns > b.total_ns; });
+
+    io::print_message("Time report ({:.3f} ms in total):", wall_ns / 1e6);
+    io::print(
+        "{: <24} {: >10} {: >14} {: >14} {: >8}", "Phase", "Count", "Total (ms)",
+        "Mean (us)", "%");
+    for (auto& phase : phases)
+    {
+      io::print(
+          "{: <24} {: >10} {: >14.3f} {: >14.3f} {: >7.1f}%", phase.name,
+          phase.count, phase.total_ns / 1e6,
+          phase.total_ns / 1e3 / static_cast<double>(phase.count),
+          wall_ns == 0.0 ? 0.0 : phase.total_ns * 100.0 / wall_ns);
+    }
+    if (dropped != 0)
+      io::print_warn(
+          "{} events were overwritten and are not part of the report!", dropped);
+  }
+
+  ErrorFlag write_chrome_trace(const char* path) noexcept
+  {
+    auto out = io::BufferedWriter::open(path);
+    if (out.is_none())
+      return ErrorFlag::error();
+
+    auto& reg            = registry();
+    auto guard           = std::scoped_lock{reg.mutex};
+    const auto converter = TickConverter{reg};
+
+    fmt::memory_buffer buffer;
+    auto it    = fmt::appender(buffer);
+    it         = fmt::format_to(it, "{{\"traceEvents\": [");
+    bool first = true;
+    for (auto& thread : reg.buffers)
+    {
+      it = fmt::format_to(
+          it,
+          "{}\n  {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+          "\"tid\": {}, \"args\": {{\"name\": \"Thread {}\"}}}}",
+          first ? "" : ",", thread->thread(), thread->thread());
+      first = false;
+      for (auto& event : thread->kept())
+      {
+        // Timestamps are in microseconds.
+        // Names are literals, which never contain characters to escape.
+        it = fmt::format_to(
+            it,
+            ",\n  {{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, "
+            "\"ts\": {:.3f}, \"dur\": {:.3f}}}",
+            event.name, thread->thread(), converter.to_ns(event.start) / 1e3,
+            static_cast<double>(event.end - event.start) * converter.ns_per_tick
+                / 1e3);
+      }
+      // Avoid keeping the whole trace in memory
+      out->write(StringView{buffer.data(), buffer.size()});
+      buffer.clear();
+      it = fmt::appender(buffer);
+    }
+    it = fmt::format_to(it, "\n], \"displayTimeUnit\": \"ns\"}}\n");
+    out->write(StringView{buffer.data(), buffer.size()});
+    return out->flush();
+  }
+} // namespace clt::trace
@@ -0,0 +1,196 @@
+/*****************************************************************/ /**
+ * @file   trace.h
+ * @brief  Contains scoped trace points, used to time the phases of
+ * the compiler (loading files, lexing, building the AST...).
+ * Each thread records its events in its own ring buffer, so that
+ * recording an event does not require any synchronization.
+ * The events can then be summarized per phase, or written in the
+ * Chrome trace-event format (which 'chrome://tracing' and Perfetto
+ * can open).
+ *
+ * Tracing is opt-in: trace points should only be added through
+ * COLT_TRACE_SCOPE, which expands to nothing unless COLT_TRACE is
+ * defined (see the CMake option of the same name).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_TRACE
+#define HG_COLT_TRACE
+
+#include <chrono>
+#include "types.h"
+#include "macros.h"
+#include "structs/vector.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define COLT_TRACE_RDTSC
+  #ifdef COLT_MSVC
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif // COLT_MSVC
+#endif
+
+#ifdef COLT_TRACE
+  /// @brief Records the duration of the current scope as the phase 'name'.
+  /// 'name' must be a string literal.
+  #define COLT_TRACE_SCOPE(name)                                          \
+    const clt::trace::ScopedTrace COLT_CONCAT(COLT_TRACE_SCOPE_, __LINE__) \
+    {                                                                     \
+      name                                                                \
+    }
+#else
+  /// @brief Records the duration of the current scope as the phase 'name'.
+  /// 'name' must be a string literal.
+  #define COLT_TRACE_SCOPE(name) (void)0
+#endif // COLT_TRACE
+
+namespace clt::trace
+{
+  /// @brief Check if trace points were compiled in
+  /// @return True if COLT_TRACE is defined
+  constexpr bool is_enabled() noexcept
+  {
+#ifdef COLT_TRACE
+    return true;
+#else
+    return false;
+#endif // COLT_TRACE
+  }
+
+  /// @brief Returns a monotonic timestamp.
+  /// On x86-64, this is the time stamp counter (in cycles),
+  /// else the steady clock. Timestamps are converted to nanoseconds
+  /// when the events are reported.
+  /// @return The current timestamp
+  inline u64 timestamp() noexcept
+  {
+#ifdef COLT_TRACE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<u64>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif // COLT_TRACE_RDTSC
+  }
+
+  /// @brief A recorded trace point
+  struct TraceEvent
+  {
+    /// @brief The name of the phase (a string literal)
+    const char* name;
+    /// @brief The timestamp at the beginning of the phase
+    u64 start;
+    /// @brief The timestamp at the end of the phase
+    u64 end;
+  };
+
+  /// @brief The ring buffer of events of a thread.
+  /// Once full, the oldest events are overwritten.
+  class TraceBuffer
+  {
+  public:
+    /// @brief The number of events kept by the buffer (a power of 2)
+    static constexpr u64 CAPACITY = 1 << 16;
+
+  private:
+    /// @brief The events
+    TraceEvent events[CAPACITY];
+    /// @brief The number of events ever recorded
+    u64 recorded = 0;
+    /// @brief The index of the thread owning the buffer
+    u32 thread_index;
+
+  public:
+    /// @brief Constructor
+    /// @param thread_index The index of the thread owning the buffer
+    TraceBuffer(u32 thread_index) noexcept
+        : thread_index(thread_index)
+    {
+    }
+
+    /// @brief Records an event
+    /// @param name The name of the phase (a string literal)
+    /// @param start The timestamp at the beginning of the phase
+    /// @param end The timestamp at the end of the phase
+    void record(const char* name, u64 start, u64 end) noexcept
+    {
+      events[recorded++ & (CAPACITY - 1)] = TraceEvent{name, start, end};
+    }
+
+    /// @brief Returns the index of the thread owning the buffer
+    /// @return The index of the thread (0 for the first thread to record)
+    u32 thread() const noexcept { return thread_index; }
+
+    /// @brief Returns the number of events that were overwritten
+    /// @return The number of lost events
+    u64 dropped() const noexcept
+    {
+      return recorded > CAPACITY ? recorded - CAPACITY : 0;
+    }
+
+    /// @brief Returns the events kept by the buffer (in no particular order)
+    /// @return The events
+    View<TraceEvent> kept() const noexcept
+    {
+      return View<TraceEvent>{events, clt::min(recorded, CAPACITY)};
+    }
+  };
+
+  namespace details
+  {
+    /// @brief The buffer of the current thread (or nullptr)
+    inline thread_local TraceBuffer* ThreadBuffer = nullptr;
+
+    /// @brief Allocates and registers the buffer of the current thread
+    /// @return The buffer of the current thread
+    TraceBuffer* register_thread() noexcept;
+  } // namespace details
+
+  /// @brief Returns the buffer of the current thread
+  /// @return The buffer of the current thread
+  inline TraceBuffer& thread_buffer() noexcept
+  {
+    if (details::ThreadBuffer == nullptr) [[unlikely]]
+      details::ThreadBuffer = details::register_thread();
+    return *details::ThreadBuffer;
+  }
+
+  /// @brief Records the duration of its lifetime.
+  /// Use COLT_TRACE_SCOPE rather than this class directly.
+  class ScopedTrace
+  {
+    /// @brief The name of the phase (a string literal)
+    const char* name;
+    /// @brief The timestamp at construction
+    u64 start;
+
+  public:
+    /// @brief Starts recording
+    /// @param name The name of the phase (a string literal)
+    ScopedTrace(const char* name) noexcept
+        : name(name)
+        , start(timestamp())
+    {
+    }
+
+    ScopedTrace(const ScopedTrace&)            = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    /// @brief Records the event
+    ~ScopedTrace() noexcept { thread_buffer().record(name, start, timestamp()); }
+  };
+
+  /// @brief Prints the total, count and share of the time of each phase.
+  /// This must only be called once no other thread records events.
+  void print_time_report() noexcept;
+
+  /// @brief Writes the events in the Chrome trace-event format.
+  /// Each thread is written as its own track.
+  /// This must only be called once no other thread records events.
+  /// @param path The path of the file to write to
+  /// @return Success if the file was written
+  ErrorFlag write_chrome_trace(const char* path) noexcept;
+} // namespace clt::trace
+
+#endif // !HG_COLT_TRACE
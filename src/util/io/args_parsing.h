@@ -255,6 +255,28 @@ namespace clt::cl
         "specified!");
   };
 
+  template<meta::StringLiteral Name, typename T, typename... Ts>
+  /// @brief Represents a list of positional arguments, that receives all the
+  /// positional arguments left after the Pos and OptPos.
+  /// The location must provide a 'push_back(std::string_view)' method.
+  struct PosList
+  {
+    /// @brief Concept helper
+    static constexpr bool is_poslist = true;
+
+    /// @brief The name of the PosList (required, and not "")
+    static constexpr std::string_view name = Name.value;
+    /// @brief The description of the PosList (can be empty)
+    static constexpr std::string_view desc =
+        details::find_description_t<T, Ts...>::desc;
+    /// @brief The location were the results are appended
+    static constexpr auto location = details::find_location_t<T, Ts...>::ptr;
+
+    static_assert(name != "", "Empty name is not allowed!");
+    static_assert(
+        location != nullptr, "cl::location<...> of the PosList must be specified!");
+  };
+
   namespace details
   {
     template<typename T>
@@ -287,6 +309,16 @@ namespace clt::cl
       static constexpr bool value = IsOptPos<T>;
     };
 
+    template<typename T>
+    /// @brief True if PosList
+    concept IsPosList = T::is_poslist;
+
+    template<typename T>
+    struct is_poslist
+    {
+      static constexpr bool value = IsPosList<T>;
+    };
+
     template<typename... Args>
     /// @brief Counts the number of Opt specified in 'list'
     /// @param list The list of Opt
@@ -381,8 +413,30 @@ namespace clt::cl
       return clt::ParsingResult{};
     }
 
+    template<typename opt>
+    ParsingResult parse_pos_list(std::string_view strv) noexcept
+    {
+      opt::location->push_back(strv);
+      return clt::ParsingResult{};
+    }
+
     using parse_and_write_t = ParsingResult (*)(std::string_view) noexcept;
 
+    /// @brief Returns the function appending to the PosList (or nullptr)
+    /// @return The function appending to the PosList or nullptr
+    consteval parse_and_write_t generate_pos_list(meta::type_list<>) noexcept
+    {
+      return nullptr;
+    }
+
+    template<typename Arg>
+    /// @brief Returns the function appending to the PosList (or nullptr)
+    /// @return The function appending to the PosList or nullptr
+    consteval parse_and_write_t generate_pos_list(meta::type_list<Arg>) noexcept
+    {
+      return &parse_pos_list<Arg>;
+    }
+
     template<typename... Args>
     consteval auto generate_opt_table(meta::type_list<Args...> list) noexcept
     {
@@ -468,11 +522,19 @@ namespace clt::cl
       io::print<" ">("<{}>?", Arg::name);
     }
 
-    template<typename... Args, typename... Args2, typename... Args3>
+    template<typename Arg>
+    void print_help_for_poslist() noexcept
+    {
+      io::print<" ">("<{}>...", Arg::name);
+    }
+
+    template<
+        typename... Args, typename... Args2, typename... Args3,
+        typename... Args4>
     [[noreturn]] void print_help(
         meta::type_list<Args...> list, meta::type_list<Args2...> pos,
-        meta::type_list<Args3...> optpos, std::string_view name,
-        std::string_view description) noexcept
+        meta::type_list<Args3...> optpos, meta::type_list<Args4...> poslist,
+        std::string_view name, std::string_view description) noexcept
     {
       constexpr u64 max_size = max_name_size(list);
       constexpr u64 max_desc = max_desc_size(list);
@@ -485,6 +547,7 @@ namespace clt::cl
       (print_help_for_pos<Args2>(), ...);
       io::print<"">("{}", io::GreenF);
       (print_help_for_optpos<Args3>(), ...);
+      (print_help_for_poslist<Args4>(), ...);
       io::print("{}\n   {}\n\nOPTIONS:", io::Reset, description);
       //Print commands in format -NAME <VALUE_DESC> - DESC aligning all options.
       (print_help_for_arg<Args>(max_size, max_desc), ...);
@@ -540,14 +603,15 @@ namespace clt::cl
     }
 
     void handle_positional(
-        std::string_view arg, u64& pos_id, auto& POS_TABLE) noexcept
+        std::string_view arg, u64& pos_id, auto& POS_TABLE,
+        parse_and_write_t pos_list) noexcept
     {
-      if (pos_id == POS_TABLE.size())
+      if (pos_id == POS_TABLE.size() && pos_list == nullptr)
       {
         io::print_warn("Unused argument '{}'!", arg);
         return;
       }
-      auto opt = POS_TABLE[pos_id++];
+      auto opt = pos_id == POS_TABLE.size() ? pos_list : POS_TABLE[pos_id++];
       //invoke callback...
       ParsingResult err = (*opt)(arg);
       if (err != ParsingCode::GOOD)
@@ -563,9 +627,11 @@ namespace clt::cl
       int argc, const char** argv, std::string_view name = {},
       std::string_view description = {}) noexcept
   {
-    using OptList    = typename list::template remove_if_not<details::is_opt>;
-    using PosList    = typename list::template remove_if_not<details::is_pos>;
-    using OptPosList = typename list::template remove_if_not<details::is_optpos>;
+    using OptList     = typename list::template remove_if_not<details::is_opt>;
+    using PosList     = typename list::template remove_if_not<details::is_pos>;
+    using OptPosList  = typename list::template remove_if_not<details::is_optpos>;
+    using PosListList = typename list::template remove_if_not<details::is_poslist>;
+    static_assert(PosListList::size <= 1, "Only one PosList is allowed!");
 
     //Positional argument table, contains pointers to the function to call
     //when a non-positional argument is detected.
@@ -575,6 +641,8 @@ namespace clt::cl
     //when a positional argument is detected.
     static constexpr auto POS_TABLE =
         details::generate_pos_table(PosList{}, OptPosList{});
+    //Function to call on positional arguments left (or nullptr)
+    static constexpr auto POS_LIST = details::generate_pos_list(PosListList{});
 
     u64 pos_id          = 0;
     bool is_parsing_pos = false;
@@ -582,7 +650,7 @@ namespace clt::cl
     {
       std::string_view arg = argv[i];
       if (arg.empty() || arg.front() != '-' || is_parsing_pos)
-        details::handle_positional(arg, pos_id, POS_TABLE);
+        details::handle_positional(arg, pos_id, POS_TABLE, POS_LIST);
       else
       {
         if (arg == "--")
@@ -592,7 +660,9 @@ namespace clt::cl
         }
 
         if (arg == "-help")
-          details::print_help(OptList{}, PosList{}, OptPosList{}, name, description);
+          details::print_help(
+              OptList{}, PosList{}, OptPosList{}, PosListList{}, name,
+              description);
         else
           details::handle_non_positional(
               arg, i, static_cast<u64>(argc), argv, CONST_MAP);
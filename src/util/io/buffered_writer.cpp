@@ -0,0 +1,144 @@
+/*****************************************************************/ /**
+ * @file   buffered_writer.cpp
+ * @brief  Contains the implementation of 'buffered_writer.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include "buffered_writer.h"
+#include "common/colt_config.h"
+
+namespace clt::io
+{
+  /// @brief Sets the position of a file, supporting files greater than 2GB
+  /// @param file The file whose position to set
+  /// @param offset The offset from the beginning of the file
+  /// @return True on success
+  static bool seek_to(std::FILE* file, u64 offset) noexcept
+  {
+#ifdef COLT_WINDOWS
+    return _fseeki64(file, static_cast<i64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif // COLT_WINDOWS
+  }
+
+  /// @brief Sets the position of a file to its end
+  /// @param file The file whose position to set
+  /// @return True on success
+  static bool seek_to_end(std::FILE* file) noexcept
+  {
+#ifdef COLT_WINDOWS
+    return _fseeki64(file, 0, SEEK_END) == 0;
+#else
+    return fseeko(file, 0, SEEK_END) == 0;
+#endif // COLT_WINDOWS
+  }
+
+  BufferedWriter::~BufferedWriter() noexcept
+  {
+    if (file == nullptr)
+      return;
+    flush().discard();
+    if (owns_file)
+      std::fclose(file);
+  }
+
+  Option<BufferedWriter> BufferedWriter::open(
+      const char* path, u64 buffer_size) noexcept
+  {
+    assert_true("Invalid path!", path != nullptr);
+    auto file = std::fopen(path, "wb");
+    if (file == nullptr)
+      return None;
+    // We do our own buffering
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    return BufferedWriter(file, buffer_size, true);
+  }
+
+  void BufferedWriter::flush_buffer() noexcept
+  {
+    if (buffer.is_empty())
+      return;
+    if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+      has_failed = true;
+    flushed += buffer.size();
+    buffer._Unsafe_size(0);
+  }
+
+  void BufferedWriter::write(const void* ptr, u64 size) noexcept
+  {
+    auto bytes = static_cast<const u8*>(ptr);
+    if (buffer.size() + size <= buffer.capacity())
+    {
+      std::memcpy(buffer.data() + buffer.size(), bytes, size);
+      buffer._Unsafe_size(buffer.size() + size);
+      return;
+    }
+    flush_buffer();
+    // Writes greater than the buffer bypass it
+    if (size >= buffer.capacity())
+    {
+      if (std::fwrite(bytes, 1, size, file) != size)
+        has_failed = true;
+      flushed += size;
+      return;
+    }
+    std::memcpy(buffer.data(), bytes, size);
+    buffer._Unsafe_size(size);
+  }
+
+  void BufferedWriter::write_repeat(u8 byte, u64 count) noexcept
+  {
+    // Without a buffer, the bytes are written through a chunk
+    if (buffer.capacity() == 0)
+    {
+      u8 chunk[256];
+      std::memset(chunk, byte, sizeof(chunk));
+      while (count != 0)
+      {
+        u64 to_write = clt::min<u64>(count, sizeof(chunk));
+        write(chunk, to_write);
+        count -= to_write;
+      }
+      return;
+    }
+    while (count != 0)
+    {
+      if (buffer.size() == buffer.capacity())
+        flush_buffer();
+      u64 to_write = clt::min(count, buffer.capacity() - buffer.size());
+      std::memset(buffer.data() + buffer.size(), byte, to_write);
+      buffer._Unsafe_size(buffer.size() + to_write);
+      count -= to_write;
+    }
+  }
+
+  void BufferedWriter::patch(u64 offset, const void* ptr, u64 size) noexcept
+  {
+    assert_true("Patch must overwrite written bytes!", offset + size <= position());
+    auto bytes = static_cast<const u8*>(ptr);
+    // Part of the patch that is still in the buffer
+    if (offset + size > flushed)
+    {
+      u64 skip = offset < flushed ? flushed - offset : 0;
+      std::memcpy(
+          buffer.data() + (offset + skip - flushed), bytes + skip, size - skip);
+      size -= size - skip;
+    }
+    if (size == 0)
+      return;
+    // Part of the patch that was already written to the file
+    if (std::fflush(file) != 0 || !seek_to(file, offset)
+        || std::fwrite(bytes, 1, size, file) != size || !seek_to_end(file))
+      has_failed = true;
+  }
+
+  ErrorFlag BufferedWriter::flush() noexcept
+  {
+    flush_buffer();
+    if (std::fflush(file) != 0)
+      has_failed = true;
+    return has_failed ? ErrorFlag::error() : ErrorFlag::success();
+  }
+} // namespace clt::io
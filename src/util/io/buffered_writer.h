@@ -0,0 +1,163 @@
+/*****************************************************************/ /**
+ * @file   buffered_writer.h
+ * @brief  Contains BufferedWriter, a large buffered binary file writer.
+ * Writes are accumulated in a buffer which is only flushed to the
+ * file when full, which avoids a system call per small write.
+ * Writes that are greater than the buffer are written directly
+ * to the file without any intermediate copy.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_BUFFERED_WRITER
+#define HG_COLT_BUFFERED_WRITER
+
+#include <cstdio>
+
+#include "structs/vector.h"
+#include "structs/option.h"
+#include "common/bits.h"
+
+namespace clt::io
+{
+  /// @brief Buffered writer over a binary file.
+  /// Already written bytes can be overwritten using 'patch', which
+  /// is useful to fill offset tables once the content is known.
+  class BufferedWriter
+  {
+    /// @brief The file to which to write
+    std::FILE* file;
+    /// @brief The buffer in which the bytes are accumulated
+    Vector<u8> buffer;
+    /// @brief The count of bytes already written to 'file'
+    u64 flushed = 0;
+    /// @brief True if 'file' must be closed by the writer
+    bool owns_file;
+    /// @brief True if any write to 'file' failed
+    bool has_failed = false;
+
+    /// @brief Constructor
+    /// @param file The file to write to (not null)
+    /// @param buffer_size The size of the buffer
+    /// @param owns_file True if the file should be closed on destruction
+    BufferedWriter(std::FILE* file, u64 buffer_size, bool owns_file) noexcept
+        : file(file)
+        , buffer(buffer_size)
+        , owns_file(owns_file)
+    {
+    }
+
+    /// @brief Writes the content of the buffer to the file, clearing it
+    void flush_buffer() noexcept;
+
+  public:
+    /// @brief The default buffer size (1MB)
+    static constexpr u64 DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+    BufferedWriter(const BufferedWriter&)            = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /// @brief Move constructor
+    /// @param other The writer to move from
+    BufferedWriter(BufferedWriter&& other) noexcept
+        : file(std::exchange(other.file, nullptr))
+        , buffer(std::move(other.buffer))
+        , flushed(other.flushed)
+        , owns_file(other.owns_file)
+        , has_failed(other.has_failed)
+    {
+    }
+
+    BufferedWriter& operator=(BufferedWriter&&) noexcept = delete;
+
+    /// @brief Flushes the writer, closing the file if it is owned
+    ~BufferedWriter() noexcept;
+
+    /// @brief Opens (and truncates) the file at path 'path' for writing
+    /// @param path The path of the file (not null)
+    /// @param buffer_size The size of the buffer
+    /// @return None on errors or the writer
+    static Option<BufferedWriter> open(
+        const char* path, u64 buffer_size = DEFAULT_BUFFER_SIZE) noexcept;
+
+    /// @brief Creates a writer over an already opened file.
+    /// The file is not closed by the writer (useful for stdout).
+    /// @param file The file to write to (not null)
+    /// @param buffer_size The size of the buffer
+    /// @return The writer
+    static BufferedWriter from(
+        std::FILE* file, u64 buffer_size = DEFAULT_BUFFER_SIZE) noexcept
+    {
+      assert_true("Invalid file!", file != nullptr);
+      return BufferedWriter(file, buffer_size, false);
+    }
+
+    /// @brief Returns the count of bytes written (including buffered ones)
+    /// @return The current position in the output
+    u64 position() const noexcept { return flushed + buffer.size(); }
+
+    /// @brief Check if any write failed
+    /// @return True if any write failed
+    bool is_error() const noexcept { return has_failed; }
+
+    /// @brief Writes 'size' bytes starting at 'ptr'
+    /// @param ptr The bytes to write
+    /// @param size The count of bytes to write
+    void write(const void* ptr, u64 size) noexcept;
+
+    /// @brief Writes bytes
+    /// @param bytes The bytes to write
+    void write(View<u8> bytes) noexcept { write(bytes.data(), bytes.size()); }
+
+    /// @brief Writes a string (without NUL-terminator)
+    /// @param str The string to write
+    void write(StringView str) noexcept { write(str.data(), str.size()); }
+
+    /// @brief Writes a single byte 'count' times
+    /// @param byte The byte to write
+    /// @param count The number of times to write the byte
+    void write_repeat(u8 byte, u64 count) noexcept;
+
+    template<meta::UnsignedIntegral T>
+    /// @brief Writes an unsigned integer in little endian
+    /// @tparam T The unsigned integer type
+    /// @param value The value to write
+    void write_le(T value) noexcept
+    {
+      value = htol(value);
+      write(&value, sizeof(T));
+    }
+
+    /// @brief Writes zeros until the position is a multiple of 'align'
+    /// @param align The alignment (must be a power of 2)
+    void pad_to(u64 align) noexcept
+    {
+      assert_true("Alignment must be a power of 2!", std::has_single_bit(align));
+      write_repeat(0, (align - (position() & (align - 1))) & (align - 1));
+    }
+
+    /// @brief Overwrites already written bytes.
+    /// The bytes to overwrite must have been written before.
+    /// @param offset The offset from the beginning of the output
+    /// @param ptr The bytes to write
+    /// @param size The count of bytes to write
+    void patch(u64 offset, const void* ptr, u64 size) noexcept;
+
+    template<meta::UnsignedIntegral T>
+    /// @brief Overwrites an already written unsigned integer (in little endian)
+    /// @tparam T The unsigned integer type
+    /// @param offset The offset from the beginning of the output
+    /// @param value The value to write
+    void patch_le(u64 offset, T value) noexcept
+    {
+      value = htol(value);
+      patch(offset, &value, sizeof(T));
+    }
+
+    /// @brief Writes all the buffered bytes to the file
+    /// @return Success if no write failed
+    ErrorFlag flush() noexcept;
+  };
+} // namespace clt::io
+
+#endif // !HG_COLT_BUFFERED_WRITER
@@ -0,0 +1,87 @@
+/*****************************************************************/ /**
+ * @file   mapped_file.cpp
+ * @brief  Contains the implementation of 'mapped_file.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <cstdio>
+#include "mapped_file.h"
+#include "common/colt_config.h"
+#include "common/trace.h"
+
+#ifdef COLT_LINUX
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif // COLT_LINUX
+
+namespace clt::io
+{
+  MappedFile::~MappedFile() noexcept
+  {
+#ifdef COLT_LINUX
+    if (is_mapping)
+      munmap(const_cast<u8*>(begin), size);
+#endif // COLT_LINUX
+  }
+
+  Option<MappedFile> MappedFile::open(const char* path) noexcept
+  {
+    COLT_TRACE_SCOPE("map file");
+    assert_true("Invalid path!", path != nullptr);
+    auto mapped = MappedFile{};
+#ifdef COLT_LINUX
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+      return None;
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+      ::close(fd);
+      return None;
+    }
+    // Empty files cannot be mapped
+    if (info.st_size != 0)
+    {
+      void* ptr = mmap(
+          nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE,
+          fd, 0);
+      // The mapping keeps the file alive
+      ::close(fd);
+      if (ptr == MAP_FAILED)
+        return None;
+      mapped.begin      = static_cast<const u8*>(ptr);
+      mapped.size       = static_cast<u64>(info.st_size);
+      mapped.is_mapping = true;
+      return mapped;
+    }
+    ::close(fd);
+#endif // COLT_LINUX
+
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr)
+      return None;
+    ON_SCOPE_EXIT
+    {
+      std::fclose(file);
+    };
+    if (std::fseek(file, 0L, SEEK_END) != 0)
+      return None;
+    const auto size = std::ftell(file);
+    if (size == -1)
+      return None;
+    std::rewind(file);
+
+    // Stored as u64 for alignment
+    const u64 words = (static_cast<u64>(size) + sizeof(u64) - 1) / sizeof(u64);
+    mapped.fallback = Vector<u64>(words, InPlace, u64{0});
+    if (std::fread(mapped.fallback.data(), 1, static_cast<size_t>(size), file)
+        != static_cast<size_t>(size))
+      return None;
+    mapped.begin = reinterpret_cast<const u8*>(mapped.fallback.data());
+    mapped.size  = static_cast<u64>(size);
+    return mapped;
+  }
+} // namespace clt::io
@@ -0,0 +1,70 @@
+/*****************************************************************/ /**
+ * @file   mapped_file.h
+ * @brief  Contains MappedFile, a read-only view over the bytes of a file.
+ * On Linux, the file is mapped in memory (so that only the pages that
+ * are accessed are read from the disk, and the pages are shared by all
+ * the processes mapping the same file). On other platforms, the file
+ * is read in an aligned buffer.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_MAPPED_FILE
+#define HG_COLT_MAPPED_FILE
+
+#include "structs/vector.h"
+#include "structs/option.h"
+
+namespace clt::io
+{
+  /// @brief Read-only view over the bytes of a file.
+  /// The bytes are at least 8-byte aligned, and are valid as long as
+  /// the MappedFile is alive.
+  class MappedFile
+  {
+    /// @brief The beginning of the mapping (or of 'fallback')
+    const u8* begin = nullptr;
+    /// @brief The size of the file
+    u64 size = 0;
+    /// @brief The content of the file if it could not be mapped
+    Vector<u64> fallback{};
+    /// @brief True if 'begin' must be unmapped
+    bool is_mapping = false;
+
+    /// @brief Constructor
+    MappedFile() noexcept = default;
+
+  public:
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&)      = delete;
+
+    /// @brief Move constructor
+    /// @param other The file to move from
+    MappedFile(MappedFile&& other) noexcept
+        : begin(std::exchange(other.begin, nullptr))
+        , size(std::exchange(other.size, 0))
+        , fallback(std::move(other.fallback))
+        , is_mapping(std::exchange(other.is_mapping, false))
+    {
+    }
+
+    /// @brief Unmaps the file
+    ~MappedFile() noexcept;
+
+    /// @brief Maps the file at path 'path' (read-only)
+    /// @param path The path of the file (not null)
+    /// @return None if the file could not be read
+    static Option<MappedFile> open(const char* path) noexcept;
+
+    /// @brief Returns the bytes of the file
+    /// @return The bytes of the file
+    View<u8> bytes() const noexcept { return View<u8>{begin, size}; }
+
+    /// @brief Check if the file is mapped (rather than read in a buffer)
+    /// @return True if the file is mapped
+    bool is_mapped() const noexcept { return is_mapping; }
+  };
+} // namespace clt::io
+
+#endif // !HG_COLT_MAPPED_FILE
@@ -9,6 +9,7 @@
 #define HG_COLT_COMPOSABLE_ALLOC
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "simple_alloc.h"
@@ -770,6 +771,223 @@ namespace clt::mem
       return allocator::expand(blk, delta);
     }
   };
+
+  template<meta::Allocator allocator, meta::Allocator fallback>
+  /// @brief Allocator forwarding to an instance of 'allocator' per thread.
+  /// This makes allocators that are not thread safe (as FreeList) usable
+  /// from multiple threads without locking.
+  /// A block may be deallocated by another thread than the one that
+  /// allocated it, in which case it is deallocated through the instance
+  /// of the deallocating thread: 'allocator' must thus not keep per-block
+  /// state (which is the case of a FreeList over a Mallocator).
+  /// The instance of a thread is flushed when the thread exits: static
+  /// objects destroyed after the thread_local objects of the main thread
+  /// (as a static Vector) then allocate and deallocate through 'fallback',
+  /// which must be the (stateless) allocator underlying 'allocator'.
+  class ThreadLocalAllocator
+  {
+    /// @brief The storage of the instance of a thread.
+    /// Trivially destructible, so that it is never destroyed before
+    /// the thread exits.
+    struct Storage
+    {
+      /// @brief The storage of the instance
+      alignas(allocator) std::byte bytes[sizeof(allocator)];
+      /// @brief The instance or null if not yet constructed
+      allocator* ptr = nullptr;
+      /// @brief True once the instance was flushed (its thread exited)
+      bool flushed = false;
+    };
+
+    /// @brief Flushes an instance when its thread exits
+    struct Flusher
+    {
+      /// @brief The storage of the instance to flush
+      Storage* local;
+
+      /// @brief Returns the blocks kept by the instance to its underlying
+      /// allocator, through which the objects destroyed after this one
+      /// then allocate and deallocate
+      ~Flusher() noexcept
+      {
+        std::destroy_at(local->ptr);
+        local->flushed = true;
+      }
+    };
+
+    /// @brief Returns the storage of the instance of the current thread
+    /// @return The storage of the instance of the current thread
+    static Storage& storage() noexcept
+    {
+      thread_local constinit Storage local{};
+      if (local.ptr == nullptr) [[unlikely]]
+      {
+        local.ptr = std::construct_at(reinterpret_cast<allocator*>(local.bytes));
+        thread_local Flusher flusher{&local};
+      }
+      return local;
+    }
+
+  public:
+    /// @brief Alignment of returned MemBlock
+    static constexpr u64 alignment = allocator::alignment;
+
+    /// @brief Allocates a MemBlock through the instance of the current thread
+    /// @param size The size of the allocation
+    /// @return Allocated MemBlock or empty MemBlock
+    MemBlock alloc(ByteSize<Byte> size) noexcept
+    {
+      auto& local = storage();
+      if (local.flushed) [[unlikely]]
+        return fallback{}.alloc(size);
+      return local.ptr->alloc(size);
+    }
+
+    /// @brief Deallocates a MemBlock through the instance of the current thread
+    /// @param to_free The block whose resources to free
+    void dealloc(MemBlock to_free) noexcept
+    {
+      auto& local = storage();
+      if (local.flushed) [[unlikely]]
+        fallback{}.dealloc(to_free);
+      else
+        local.ptr->dealloc(to_free);
+    }
+  };
+
+  /// @brief Statistics of the blocks returned by an allocator.
+  /// The counters are atomics so that they stay consistent when the
+  /// counted allocator is shared by threads.
+  class AllocStats
+  {
+    /// @brief The number of allocations
+    std::atomic<u64> alloc_count = 0;
+    /// @brief The number of deallocations
+    std::atomic<u64> dealloc_count = 0;
+    /// @brief The bytes currently allocated
+    std::atomic<u64> live_bytes = 0;
+    /// @brief The maximum of 'live_bytes'
+    std::atomic<u64> peak_bytes = 0;
+    /// @brief The bytes ever allocated
+    std::atomic<u64> total_bytes = 0;
+
+  public:
+    /// @brief Records an allocation
+    /// @param size The size of the allocated block
+    void on_alloc(u64 size) noexcept
+    {
+      alloc_count.fetch_add(1, std::memory_order_relaxed);
+      total_bytes.fetch_add(size, std::memory_order_relaxed);
+      const u64 live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+      u64 peak       = peak_bytes.load(std::memory_order_relaxed);
+      while (live > peak
+             && !peak_bytes.compare_exchange_weak(
+                 peak, live, std::memory_order_relaxed))
+        ;
+    }
+
+    /// @brief Records a deallocation
+    /// @param size The size of the deallocated block
+    void on_dealloc(u64 size) noexcept
+    {
+      dealloc_count.fetch_add(1, std::memory_order_relaxed);
+      live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the number of allocations
+    /// @return The number of allocations
+    u64 allocations() const noexcept
+    {
+      return alloc_count.load(std::memory_order_relaxed);
+    }
+    /// @brief Returns the number of deallocations
+    /// @return The number of deallocations
+    u64 deallocations() const noexcept
+    {
+      return dealloc_count.load(std::memory_order_relaxed);
+    }
+    /// @brief Returns the bytes currently allocated
+    /// @return The bytes currently allocated
+    u64 live() const noexcept { return live_bytes.load(std::memory_order_relaxed); }
+    /// @brief Returns the maximum of bytes allocated at the same time
+    /// @return The peak of allocated bytes
+    u64 peak() const noexcept { return peak_bytes.load(std::memory_order_relaxed); }
+    /// @brief Returns the bytes ever allocated
+    /// @return The sum of the sizes of all the allocations
+    u64 total() const noexcept
+    {
+      return total_bytes.load(std::memory_order_relaxed);
+    }
+  };
+
+  template<meta::Allocator allocator, AllocStats& STATS>
+  /// @brief Allocator that records the blocks it returns in 'STATS'.
+  /// As MemBlock already carry their size, nothing is stored in the blocks.
+  class CountingAllocator : private allocator
+  {
+  public:
+    /// @brief Alignment of returned MemBlock
+    static constexpr u64 alignment = allocator::alignment;
+
+    /// @brief Allocates a MemBlock through allocator
+    /// @param size The size of the allocation
+    /// @return Allocated MemBlock or empty MemBlock
+    constexpr MemBlock alloc(ByteSize<Byte> size) noexcept
+    {
+      auto blk = allocator::alloc(size);
+      if (!blk.is_null())
+        STATS.on_alloc(blk.size().to_bytes());
+      return blk;
+    }
+
+    /// @brief Deallocates a MemBlock that was allocated using the current allocator
+    /// @param to_free The block whose resources to free
+    constexpr void dealloc(MemBlock to_free) noexcept
+    {
+      if (!to_free.is_null())
+        STATS.on_dealloc(to_free.size().to_bytes());
+      allocator::dealloc(to_free);
+    }
+
+    /// @brief Check if the current allocator owns 'blk'
+    /// @param blk The MemBlock to check
+    /// @return True if 'blk' was allocated through the current allocator
+    constexpr bool owns(MemBlock blk) noexcept
+      requires meta::OwningAllocator<allocator>
+    {
+      return allocator::owns(blk);
+    }
+
+    /// @brief Reallocates a MemBlock
+    /// @param blk The block to reallocate
+    /// @param n The new size of the block
+    /// @return True if reallocation was successful
+    constexpr bool realloc(MemBlock& blk, ByteSize<Byte> n) noexcept
+      requires meta::ReallocatableAllocator<allocator>
+    {
+      const u64 old_size = blk.size().to_bytes();
+      if (!allocator::realloc(blk, n))
+        return false;
+      STATS.on_dealloc(old_size);
+      STATS.on_alloc(blk.size().to_bytes());
+      return true;
+    }
+
+    /// @brief Expands a block in place if possible
+    /// @param blk The block to expand
+    /// @param delta The new size
+    /// @return True if expansion was done successfully
+    constexpr bool expand(MemBlock& blk, ByteSize<Byte> delta) noexcept
+      requires meta::ExpandingAllocator<allocator>
+    {
+      const u64 old_size = blk.size().to_bytes();
+      if (!allocator::expand(blk, delta))
+        return false;
+      STATS.on_dealloc(old_size);
+      STATS.on_alloc(blk.size().to_bytes());
+      return true;
+    }
+  };
 } // namespace clt::mem
 
 #endif //!HG_COLT_COMPOSABLE_ALLOC
\ No newline at end of file
@@ -12,8 +12,48 @@
 
 namespace clt::mem
 {
-  /// @brief The global allocator
-  inline AbortOnNULLAllocator<FreeList<Mallocator, 16_B, 4_KiB, 1024>>
+  /// @brief Check if the global allocator records statistics
+  /// @return True if COLT_MEM_REPORT is defined
+  constexpr bool is_mem_report_enabled() noexcept
+  {
+#ifdef COLT_MEM_REPORT
+    return true;
+#else
+    return false;
+#endif // COLT_MEM_REPORT
+  }
+
+  /// @brief Statistics of the blocks returned by the global allocator.
+  /// Only recorded if COLT_MEM_REPORT is defined.
+  inline AllocStats GlobalUsedStats{};
+  /// @brief Statistics of the blocks the global allocator obtained from 'malloc'
+  /// (which includes the blocks kept by its free list).
+  /// Only recorded if COLT_MEM_REPORT is defined.
+  inline AllocStats GlobalReservedStats{};
+
+#ifdef COLT_MEM_REPORT
+  /// @brief The allocator from which the global allocator is built
+  using GlobalAllocatorBase = CountingAllocator<
+      FreeList<CountingAllocator<Mallocator, GlobalReservedStats>, 16_B, 4_KiB, 1024>,
+      GlobalUsedStats>;
+  /// @brief GlobalAllocatorBase without its free list (used once the free
+  /// list of a thread was flushed)
+  using GlobalAllocatorFallback = CountingAllocator<
+      CountingAllocator<Mallocator, GlobalReservedStats>, GlobalUsedStats>;
+#else
+  /// @brief The allocator from which the global allocator is built
+  using GlobalAllocatorBase = FreeList<Mallocator, 16_B, 4_KiB, 1024>;
+  /// @brief GlobalAllocatorBase without its free list (used once the free
+  /// list of a thread was flushed)
+  using GlobalAllocatorFallback = Mallocator;
+#endif // COLT_MEM_REPORT
+
+  /// @brief The global allocator.
+  /// Each thread uses its own GlobalAllocatorBase (whose FreeList is not
+  /// thread safe), so that threads compiling files concurrently never
+  /// contend on a lock.
+  inline AbortOnNULLAllocator<
+      ThreadLocalAllocator<GlobalAllocatorBase, GlobalAllocatorFallback>>
       /*Segregator<1_KiB,
       ThreadSafeAllocator<
         Segregator<256, FreeList<StackAllocator<8_KiB, 16>, 16_B, 256_B, 32>,
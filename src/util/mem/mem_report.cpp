@@ -0,0 +1,92 @@
+/*****************************************************************/ /**
+ * @file   mem_report.cpp
+ * @brief  Contains the implementation of 'mem_report.h'.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#include <algorithm>
+#include "mem_report.h"
+#include "io/print.h"
+
+namespace clt::mem
+{
+  /// @brief Converts bytes to KiB
+  /// @param bytes The bytes
+  /// @return The KiB
+  static double to_kib(u64 bytes) noexcept
+  {
+    return static_cast<double>(bytes) / 1024.0;
+  }
+
+  void MemoryReport::add(StringView name, const MemUsage& usage) noexcept
+  {
+    auto it = std::find_if(
+        report_entries.begin(), report_entries.end(),
+        [&](const MemoryReportEntry& entry) { return entry.name == name; });
+    if (it == report_entries.end())
+      report_entries.push_back(MemoryReportEntry{name, usage});
+    else
+      it->usage += usage;
+  }
+
+  MemUsage MemoryReport::total() const noexcept
+  {
+    MemUsage total = {};
+    for (auto& entry : report_entries)
+      total += entry.usage;
+    return total;
+  }
+
+  void MemoryReport::print() const noexcept
+  {
+    // Bytes per byte of source code
+    const auto per_source = [this](u64 bytes)
+    {
+      return source_bytes == 0
+                 ? 0.0
+                 : static_cast<double>(bytes) / static_cast<double>(source_bytes);
+    };
+
+    io::print_message("Memory report ({} bytes of source code):", source_bytes);
+    io::print(
+        "{: <32} {: >10} {: >12} {: >14} {: >7} {: >10}", "Structure", "Count",
+        "Used (KiB)", "Reserved (KiB)", "Used %", "B/src B");
+    const auto print_line = [&](StringView name, const MemUsage& usage)
+    {
+      io::print(
+          "{: <32} {: >10} {: >12.1f} {: >14.1f} {: >6.1f}% {: >10.2f}", name,
+          usage.count, to_kib(usage.used), to_kib(usage.reserved),
+          usage.reserved == 0 ? 100.0
+                              : static_cast<double>(usage.used) * 100.0
+                                    / static_cast<double>(usage.reserved),
+          per_source(usage.reserved));
+    };
+    for (auto& entry : report_entries)
+      print_line(entry.name, entry.usage);
+    print_line("Total", total());
+    print_global_alloc_stats();
+  }
+
+  void print_global_alloc_stats() noexcept
+  {
+    if (!is_mem_report_enabled())
+    {
+      io::print_warn(
+          "Global allocator statistics require building with the "
+          "'COLT_MEM_REPORT' CMake option!");
+      return;
+    }
+    io::print_message(
+        "Global allocator: {:.1f} KiB live (peak {:.1f} KiB), {} allocations, "
+        "{} deallocations, {:.1f} KiB allocated in total.",
+        to_kib(GlobalUsedStats.live()), to_kib(GlobalUsedStats.peak()),
+        GlobalUsedStats.allocations(), GlobalUsedStats.deallocations(),
+        to_kib(GlobalUsedStats.total()));
+    io::print_message(
+        "Global allocator: {:.1f} KiB reserved from 'malloc' (peak {:.1f} KiB), "
+        "{:.1f} KiB kept by its free list.",
+        to_kib(GlobalReservedStats.live()), to_kib(GlobalReservedStats.peak()),
+        to_kib(GlobalReservedStats.live() - GlobalUsedStats.live()));
+  }
+} // namespace clt::mem
@@ -0,0 +1,78 @@
+/*****************************************************************/ /**
+ * @file   mem_report.h
+ * @brief  Contains MemoryReport, which collects the memory used by
+ * the data structures of the compiler, printed by '-mem-report'.
+ * Data structures add their usage through a 'report_memory' method,
+ * which is only called when a report is requested.
+ *
+ * The statistics of the global allocator are only recorded when
+ * building with the COLT_MEM_REPORT CMake option.
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_MEM_REPORT
+#define HG_COLT_MEM_REPORT
+
+#include "mem_usage.h"
+#include "structs/vector.h"
+
+namespace clt::mem
+{
+  /// @brief The memory used by a data structure of the report
+  struct MemoryReportEntry
+  {
+    /// @brief The name of the data structure (a literal)
+    StringView name;
+    /// @brief The memory used by the data structure
+    MemUsage usage;
+  };
+
+  /// @brief Collects the memory used by data structures
+  class MemoryReport
+  {
+    /// @brief The entries, in the order in which they were first added
+    Vector<MemoryReportEntry> report_entries{};
+    /// @brief The size of the parsed source code in bytes
+    u64 source_bytes = 0;
+
+  public:
+    /// @brief Adds the usage of a data structure.
+    /// Usages of the same name are summed (e.g. the buffers of each unit).
+    /// @param name The name of the data structure (a literal)
+    /// @param usage The memory used by the data structure
+    void add(StringView name, const MemUsage& usage) noexcept;
+
+    /// @brief Adds the size of parsed source code
+    /// @param bytes The size of the source code in bytes
+    void add_source(u64 bytes) noexcept { source_bytes += bytes; }
+
+    /// @brief Returns the size of the parsed source code
+    /// @return The size of the source code in bytes
+    u64 source_size() const noexcept { return source_bytes; }
+
+    /// @brief Returns the entries of the report
+    /// @return The entries, in the order in which they were first added
+    View<MemoryReportEntry> entries() const noexcept { return report_entries; }
+
+    /// @brief Returns the sum of the usage of all the entries
+    /// @return The total memory used by the data structures
+    MemUsage total() const noexcept;
+
+    /// @brief Clears the entries and the source size
+    void clear() noexcept
+    {
+      report_entries.clear();
+      source_bytes = 0;
+    }
+
+    /// @brief Prints the entries and the statistics of the global allocator
+    void print() const noexcept;
+  };
+
+  /// @brief Prints the statistics of the global allocator
+  /// (or a warning if they are not recorded).
+  void print_global_alloc_stats() noexcept;
+} // namespace clt::mem
+
+#endif // !HG_COLT_MEM_REPORT
@@ -0,0 +1,52 @@
+/*****************************************************************/ /**
+ * @file   mem_usage.h
+ * @brief  Contains MemUsage, the memory used by a data structure.
+ * Containers return it through 'memory_usage()', which only accounts
+ * for the memory they own directly (not the memory owned by their
+ * elements).
+ *
+ * @author RPC
+ * @date   October 2026
+ *********************************************************************/
+#ifndef HG_COLT_MEM_USAGE
+#define HG_COLT_MEM_USAGE
+
+#include "common/types.h"
+
+namespace clt::mem
+{
+  /// @brief The memory used by a data structure
+  struct MemUsage
+  {
+    /// @brief The number of elements
+    u64 count = 0;
+    /// @brief The bytes occupied by the elements (and their book-keeping)
+    u64 used = 0;
+    /// @brief The bytes allocated by the data structure
+    u64 reserved = 0;
+
+    /// @brief Accumulates the usage of another data structure
+    /// @param other The usage to add
+    /// @return Self
+    constexpr MemUsage& operator+=(const MemUsage& other) noexcept
+    {
+      count += other.count;
+      used += other.used;
+      reserved += other.reserved;
+      return *this;
+    }
+
+    /// @brief Accumulates the memory owned by an element.
+    /// The count is not modified, as the element was already counted.
+    /// @param owned The memory owned by the element
+    /// @return Self
+    constexpr MemUsage& add_owned(const MemUsage& owned) noexcept
+    {
+      used += owned.used;
+      reserved += owned.reserved;
+      return *this;
+    }
+  };
+} // namespace clt::mem
+
+#endif // !HG_COLT_MEM_USAGE
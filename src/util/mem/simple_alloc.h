@@ -275,6 +275,7 @@ namespace clt::mem
       {
         auto ptr = root;
         root     = root->next;
+        --saved_count;
         return ptr;
       }
       while (nxt != nullptr)
@@ -283,6 +284,7 @@ namespace clt::mem
         {
           auto ptr  = nxt;
           pre->next = nxt->next;
+          --saved_count;
           return ptr;
         }
         pre = nxt;
@@ -367,6 +369,7 @@ namespace clt::mem
         allocator::dealloc({static_cast<void*>(root), root->size});
         root = next;
       }
+      saved_count = 0;
     }
   };
 } // namespace clt::mem
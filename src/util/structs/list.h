@@ -9,6 +9,7 @@
 #define HG_COLT_LIST
 
 #include "static_vector.h"
+#include "mem/mem_usage.h"
 
 namespace clt
 {
@@ -79,6 +80,28 @@ namespace clt
         last_active_node = last_active_node->after;
     }
 
+    /// @brief Returns the node at index 'node_index'.
+    /// The walk starts from the closest end of the active nodes, so that
+    /// accessing the last items (the common case) does not walk the list.
+    /// @param node_index The index of the node (must be an active node)
+    /// @return The node
+    constexpr Node* node_at(size_t node_index) const noexcept
+    {
+      // All the nodes before the last active node are full
+      size_t last_index = (count - last_active_node->data.size()) / PER_NODE;
+      if (node_index > last_index / 2)
+      {
+        auto node = last_active_node;
+        while (last_index-- != node_index)
+          node = node->before;
+        return node;
+      }
+      auto node = head;
+      while (node_index-- != 0)
+        node = node->after;
+      return node;
+    }
+
   public:
     /// @brief The value type stored in the list
     using value_type = T;
@@ -175,6 +198,17 @@ namespace clt
     /// @return True if the list is empty
     constexpr bool is_empty() const noexcept { return count == 0; }
 
+    /// @brief Returns the memory used by the FlatList (not by its objects).
+    /// This walks through the nodes, and should not be called in hot paths.
+    /// @return The memory used by the FlatList
+    constexpr mem::MemUsage memory_usage() const noexcept
+    {
+      size_t nodes = 0;
+      for (const Node* node = head; node != nullptr; node = node->after)
+        nodes++;
+      return {count, count * sizeof(T), nodes * sizeof(Node)};
+    }
+
     /// @brief Returns the object at index 'index' of the FlatList.
     /// @param index The index of the object
     /// @return The object at index 'index'
@@ -182,13 +216,7 @@ namespace clt
     {
       assert_true("Invalid index for FlatList", index < this->size());
       //Compiler should optimize this into a single instruction
-      size_t div = index / PER_NODE;
-      size_t rem = index % PER_NODE;
-
-      auto head_c = head;
-      while (div-- != 0)
-        head_c = head_c->after;
-      return head_c->data[rem];
+      return node_at(index / PER_NODE)->data[index % PER_NODE];
     }
 
     /// @brief Returns a reference to the object at index 'index' of the FlatList.
@@ -198,13 +226,7 @@ namespace clt
     {
       assert_true("Invalid index for FlatList", index < this->size());
       //Compiler should optimize this into a single instruction
-      size_t div = index / PER_NODE;
-      size_t rem = index % PER_NODE;
-
-      auto head_c = head;
-      while (div-- != 0)
-        head_c = head_c->after;
-      return head_c->data[rem];
+      return node_at(index / PER_NODE)->data[index % PER_NODE];
     }
 
     /// @brief Returns the first item in the FlatList.
@@ -254,15 +276,29 @@ namespace clt
     {
       assert_true("FlatList was empty!", !this->is_empty());
       --count;
-      if (last_active_node->data.size() == 0)
-        last_active_node = last_active_node->before;
       last_active_node->data.pop_back();
+      // The last active node is only empty if the list is (so that
+      // 'back' and 'node_at' never see an empty last active node)
+      if (last_active_node->data.is_empty() && last_active_node != head)
+        last_active_node = last_active_node->before;
+    }
+
+    /// @brief Pops N items from the back of the FlatList.
+    /// @param N The number of items to pop from the back
+    constexpr void pop_back_n(size_t N) noexcept(std::is_nothrow_destructible_v<T>)
+    {
+      assert_true("FlatList does not contain enough elements!", N <= this->size());
+      for (size_t i = 0; i < N; i++)
+        pop_back();
     }
 
   private:
     template<typename Node_t>
     class Iterator
     {
+      /// @brief The type of the items (const if the nodes are)
+      using item_t = std::conditional_t<std::is_const_v<Node_t>, const T, T>;
+
       size_t node_index;
       Node_t* current_node;
 
@@ -293,6 +329,23 @@ namespace clt
         return copy;
       }
 
+      /// @brief Advances the iterator by 'n' items, skipping whole nodes.
+      /// Walking a list in step with sorted indices is thus linear,
+      /// while indexing the list for each of them is quadratic.
+      /// @param n The count of items to skip
+      /// @return Self
+      constexpr Iterator& operator+=(size_t n) noexcept
+      {
+        n += node_index;
+        while (n >= PER_NODE)
+        {
+          current_node = current_node->after;
+          n -= PER_NODE;
+        }
+        node_index = n;
+        return *this;
+      }
+
       constexpr Iterator& operator--() noexcept
       {
         if (node_index - 1 == 0)
@@ -312,11 +365,11 @@ namespace clt
         return copy;
       }
 
-      constexpr T* operator->() noexcept
+      constexpr item_t* operator->() const noexcept
       {
         return current_node->data.data() + node_index;
       }
-      constexpr const T& operator*() noexcept
+      constexpr item_t& operator*() const noexcept
       {
         return current_node->data[node_index];
       }
@@ -213,6 +213,15 @@ namespace clt
     /// @return The capacity of the current allocation
     constexpr size_t capacity() const noexcept { return slots.size(); }
 
+    /// @brief Returns the memory used by the Map (not by its keys and values)
+    /// @return The memory used by the Map
+    constexpr mem::MemUsage memory_usage() const noexcept
+    {
+      return {
+          size_v, size_v * (sizeof(Slot) + sizeof(details::KeySentinel)),
+          slots.size() * sizeof(Slot) + sentinel_metadata.memory_usage().reserved};
+    }
+
     /// @brief Returns a MapIterator to the first active slot in the Map, or end() if no slots are active
     /// @return MapIterator to the first active slot or end()
     constexpr MapIterator<Slot> begin() noexcept
@@ -115,6 +115,17 @@ namespace clt
     /// @return The capacity of the internal map of the StableSet
     constexpr size_t capacity() const noexcept { return slots_capacity; }
 
+    /// @brief Returns the memory used by the StableSet (not by its objects)
+    /// @return The memory used by the StableSet
+    constexpr mem::MemUsage memory_usage() const noexcept
+    {
+      auto usage = list.memory_usage();
+      usage.used += size() * (sizeof(Slot) + sizeof(details::KeySentinel));
+      usage.reserved += sentinel_metadata.memory_usage().reserved
+                        + slots_capacity * sizeof(Slot);
+      return usage;
+    }
+
     /// @brief Check if the StableSet is empty
     /// @return True if empty
     constexpr bool is_empty() const noexcept { return list.size() == 0; }
@@ -407,6 +418,17 @@ namespace clt
     /// @return The capacity of the internal map of the StableSet
     constexpr size_t capacity() const noexcept { return slots_capacity; }
 
+    /// @brief Returns the memory used by the IndexedSet (not by its objects)
+    /// @return The memory used by the IndexedSet
+    constexpr mem::MemUsage memory_usage() const noexcept
+    {
+      auto usage = list.memory_usage();
+      usage.used += size() * (sizeof(Slot) + sizeof(details::KeySentinel));
+      usage.reserved += sentinel_metadata.memory_usage().reserved
+                        + slots_capacity * sizeof(Slot);
+      return usage;
+    }
+
     /// @brief Check if the StableSet is empty
     /// @return True if empty
     constexpr bool is_empty() const noexcept { return list.size() == 0; }
@@ -188,7 +188,7 @@ namespace clt
     T* operator->() const noexcept
     {
       assert_true("unique_ptr was null!", !is_null());
-      return *static_cast<T*>(blk.ptr());
+      return static_cast<T*>(blk.ptr());
     }
   };
 
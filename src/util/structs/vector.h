@@ -16,6 +16,7 @@
 #include <span>
 
 #include "mem/global_alloc.h"
+#include "mem/mem_usage.h"
 #include "common.h"
 
 namespace clt
@@ -306,6 +307,12 @@ namespace clt
     /// @brief Returns the capacity of the current allocation
     /// @return The capacity of the current allocation
     constexpr size_t capacity() const noexcept { return blk_capacity; }
+    /// @brief Returns the memory used by the Vector (not by its objects)
+    /// @return The memory used by the Vector
+    constexpr mem::MemUsage memory_usage() const noexcept
+    {
+      return {blk_size, blk_size * sizeof(T), blk_capacity * sizeof(T)};
+    }
 
     /// @brief Returns the object at index 'index' of the Vector.
     /// @param index The index of the object